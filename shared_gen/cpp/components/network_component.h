@@ -1,4 +1,4 @@
-// Halley codegen version 136
+// Halley codegen version 138
 #pragma once
 
 #ifndef DONT_INCLUDE_HALLEY_HPP
@@ -17,9 +17,6 @@ public:
 	std::optional<uint8_t> ownerId{};
 	std::optional<uint8_t> authorityId{};
 	Halley::DataInterpolatorSet dataInterpolatorSet{};
-	Halley::Vector<std::pair<Halley::EntityId, uint8_t>> locks{};
-	bool sendUpdates{ false };
-
 	NetworkComponent() {
 	}
 
@@ -35,6 +32,7 @@ public:
 		using namespace Halley::EntitySerialization;
 		Halley::EntityConfigNodeSerializer<decltype(locks)>::deserialize(locks, Halley::Vector<std::pair<Halley::EntityId, uint8_t>>{}, _context, _node, componentName, "locks", makeMask(Type::Network));
 		Halley::EntityConfigNodeSerializer<decltype(sendUpdates)>::deserialize(sendUpdates, bool{ false }, _context, _node, componentName, "sendUpdates", makeMask(Type::SaveData, Type::Dynamic, Type::Network));
+		++changeRevision;
 	}
 
 	static void sanitize(Halley::ConfigNode& _node, int _mask) {
@@ -55,11 +53,42 @@ public:
 		using namespace Halley::EntitySerialization;
 		if (_fieldName == "sendUpdates") {
 			Halley::ConfigNodeHelper<decltype(sendUpdates)>::deserialize(sendUpdates, _context, _node);
+			++changeRevision;
 			return;
 		}
 		throw Halley::Exception("Unknown or non-serializable field \"" + Halley::String(_fieldName) + "\"", Halley::HalleyExceptions::Entity);
 	}
 
+	uint32_t getChangeRevision() const {
+		return changeRevision;
+	}
+
+	void markChanged() {
+		++changeRevision;
+	}
+
+	const Halley::Vector<std::pair<Halley::EntityId, uint8_t>>& getLocks() const {
+		return locks;
+	}
+
+	void setLocks(Halley::Vector<std::pair<Halley::EntityId, uint8_t>> value) {
+		if (!(locks == value)) {
+			locks = std::move(value);
+			++changeRevision;
+		}
+	}
+
+	const bool& getSendUpdates() const {
+		return sendUpdates;
+	}
+
+	void setSendUpdates(bool value) {
+		if (!(sendUpdates == value)) {
+			sendUpdates = std::move(value);
+			++changeRevision;
+		}
+	}
+
 
 	void* operator new(std::size_t size, std::align_val_t align) {
 		return doNew<NetworkComponent>(size, align);
@@ -73,4 +102,9 @@ public:
 		return doDelete<NetworkComponent>(ptr);
 	}
 
+private:
+	Halley::Vector<std::pair<Halley::EntityId, uint8_t>> locks{};
+	bool sendUpdates{ false };
+
+	uint32_t changeRevision{ 0 };
 };
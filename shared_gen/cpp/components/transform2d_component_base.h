@@ -1,4 +1,4 @@
-// Halley codegen version 136
+// Halley codegen version 138
 #pragma once
 
 #ifndef DONT_INCLUDE_HALLEY_HPP
@@ -136,6 +136,6 @@ protected:
 	float height{};
 	bool fixedHeight{ false };
 	Halley::OptionalLite<int16_t> subWorld{};
-	mutable uint16_t revision{ 0 };
+	mutable uint32_t revision{ 0 };
 
 };
@@ -1,4 +1,4 @@
-// Halley codegen version 136
+// Halley codegen version 138
 #pragma once
 
 #ifndef DONT_INCLUDE_HALLEY_HPP
@@ -7,6 +7,7 @@
 #include "halley/entity/component.h"
 #endif
 #include "halley/support/exception.h"
+#include "halley/bytes/byte_serializer.h"
 
 
 class VelocityComponent final : public Halley::Component {
@@ -58,6 +59,27 @@ public:
 		throw Halley::Exception("Unknown or non-serializable field \"" + Halley::String(_fieldName) + "\"", Halley::HalleyExceptions::Entity);
 	}
 
+	uint64_t getNetworkDeltaMask(const VelocityComponent& _previous) const {
+		uint64_t _mask = 0;
+		if (!(velocity == _previous.velocity)) _mask |= (uint64_t(1) << 0);
+		return _mask;
+	}
+
+	void serializeDelta(Halley::Serializer& _s, uint64_t _mask) const {
+		_s << _mask;
+		if (_mask & (uint64_t(1) << 0)) _s << velocity;
+	}
+
+	void applyDelta(Halley::Deserializer& _s) {
+		uint64_t _mask = 0;
+		_s >> _mask;
+		if (_mask & (uint64_t(1) << 0)) _s >> velocity;
+	}
+
+	void copyDelta(const VelocityComponent& _other, uint64_t _mask) {
+		if (_mask & (uint64_t(1) << 0)) velocity = _other.velocity;
+	}
+
 
 	void* operator new(std::size_t size, std::align_val_t align) {
 		return doNew<VelocityComponent>(size, align);
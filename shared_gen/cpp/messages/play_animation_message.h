@@ -1,4 +1,4 @@
-// Halley codegen version 124
+// Halley codegen version 138
 #pragma once
 
 #ifndef DONT_INCLUDE_HALLEY_HPP
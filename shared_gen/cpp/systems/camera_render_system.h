@@ -1,4 +1,4 @@
-// Halley codegen version 132
+// Halley codegen version 138
 #pragma once
 
 #include <halley.hpp>
@@ -39,6 +39,22 @@ namespace Halley {
 
 	class SerializerState {};
 
+	// Process-wide pool of output buffers, so hot serialization paths (network updates, saves) don't allocate every time.
+	// Buffers are often released on a different thread than the one that acquired them (e.g. packets sent by the network thread),
+	// so the pool is shared by all threads. Each slot is claimed with a compare-and-swap, and no operation ever waits on another thread.
+	class SerializerBufferPool {
+	public:
+		static Bytes acquire();
+		static void release(Bytes buffer);
+		static void clear();
+
+		// Result buffers with more than twice the capacity they need are copied to an exact-size buffer instead, and the pooled one is kept
+		static bool isTight(const Bytes& buffer);
+
+	private:
+		constexpr static size_t maxPooledCapacity = 4 * 1024 * 1024;
+	};
+
 	class ByteSerializationBase {
 	public:
 		ByteSerializationBase(SerializerOptions options)
@@ -69,22 +85,46 @@ namespace Halley {
 	public:
 		Serializer(SerializerOptions options);
 		explicit Serializer(gsl::span<gsl::byte> dst, SerializerOptions options);
+		explicit Serializer(Bytes& dst, SerializerOptions options); // Appends to dst, growing it as needed
 
 		template <typename T, typename std::enable_if<std::is_convertible<T, std::function<void(Serializer&)>>::value, int>::type = 0>
 		static Bytes toBytes(const T& f, SerializerOptions options = {})
 		{
-			auto dry = Serializer(options);
-			f(dry);
-			Bytes result(dry.getSize());
-			auto s = Serializer(gsl::as_writable_bytes(gsl::span<Halley::Byte>(result)), options);
+			// Single pass into a pooled buffer, which is returned as the result unless it's much larger than needed.
+			// In that case it's copied to an exact-size result and recycled, so results don't hold on to pooled capacity.
+			auto buffer = SerializerBufferPool::acquire();
+			auto s = Serializer(buffer, std::move(options));
 			f(s);
+			if (SerializerBufferPool::isTight(buffer)) {
+				return buffer;
+			}
+			Bytes result(buffer.begin(), buffer.end());
+			SerializerBufferPool::release(std::move(buffer));
 			return result;
 		}
 
 		template <typename T, typename std::enable_if<!std::is_convertible<T, std::function<void(Serializer&)>>::value, int>::type = 0>
 		static Bytes toBytes(const T& value, SerializerOptions options = {})
 		{
-			return toBytes([&value](Serializer& s) { s << value; }, options);
+			return toBytes([&value](Serializer& s) { s << value; }, std::move(options));
+		}
+
+		// Serializes into a buffer taken from SerializerBufferPool, starting after prePadding bytes (e.g. for packet headers).
+		// The caller owns the buffer, and should hand it back with SerializerBufferPool::release() when done with it.
+		template <typename T, typename std::enable_if<std::is_convertible<T, std::function<void(Serializer&)>>::value, int>::type = 0>
+		static Bytes toPooledBytes(const T& f, SerializerOptions options = {}, size_t prePadding = 0)
+		{
+			auto buffer = SerializerBufferPool::acquire();
+			buffer.resize_no_init(prePadding);
+			auto s = Serializer(buffer, std::move(options));
+			f(s);
+			return buffer;
+		}
+
+		template <typename T, typename std::enable_if<!std::is_convertible<T, std::function<void(Serializer&)>>::value, int>::type = 0>
+		static Bytes toPooledBytes(const T& value, SerializerOptions options = {}, size_t prePadding = 0)
+		{
+			return toPooledBytes([&value](Serializer& s) { s << value; }, std::move(options), prePadding);
 		}
 		
 		template <typename T, typename std::enable_if<std::is_convertible<T, std::function<void(Serializer&)>>::value, int>::type = 0>
@@ -280,9 +320,17 @@ namespace Halley {
 		}
 
 	private:
+		enum class Mode : uint8_t {
+			DryRun,
+			Span,
+			Growable
+		};
+
 		size_t size = 0;
 		gsl::span<gsl::byte> dst;
-		bool dryRun;
+		Bytes* buffer = nullptr;
+		size_t bufferStart = 0;
+		Mode mode;
 
 		template <typename T>
 		Serializer& serializePod(T val)
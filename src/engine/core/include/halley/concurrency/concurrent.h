@@ -72,5 +72,11 @@ namespace Halley
 		{
 			foreach(ExecutionQueue::getDefault(), begin, end, f);
 		}
+
+		// Calls f(i) for every i in [0, count), spreading the calls over the threads attached to e.
+		// The calling thread takes part and never waits on calls that haven't started yet, so this is safe to use from inside tasks running on e.
+		// Exceptions thrown by f are rethrown on the calling thread once every call has finished.
+		void parallelFor(ExecutionQueue& e, size_t count, std::function<void(size_t)> f);
+		void parallelFor(size_t count, std::function<void(size_t)> f);
 	}
 }
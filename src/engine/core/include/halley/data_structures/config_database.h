@@ -10,6 +10,7 @@
 
 namespace Halley {
     class ConfigNode;
+    class ConfigNodeView;
     class ConfigFile;
     class ConfigObserver;
     class Resources;
@@ -163,6 +164,7 @@ namespace Halley {
         void loadConfigs(Resources& resources, const std::function<bool(const String&)>& filter);
         void loadFile(Resources& resources, const String& configName);
         void loadConfig(const ConfigNode& node, bool enforceUnique);
+        void loadConfig(const ConfigNodeView& node, bool enforceUnique); // Only builds nodes for the types in this database
         void update();
 
         template <typename T>
@@ -101,10 +101,12 @@ namespace Halley {
 	};
 
 	class ConfigFile;
+	class ConfigNodeArena;
 	
 	class ConfigNode
 	{
 		friend class ConfigFile;
+		friend class ConfigNodeArena;
 
 	public:
 		template <typename T>
@@ -637,6 +639,8 @@ namespace Halley {
 
 		static const ConfigNode& getUndefined();
 
+		bool isFrozen() const; // True if this node's contents live in a ConfigNodeArena
+
 	private:
 		union {
 			String* strData;
@@ -664,6 +668,8 @@ namespace Halley {
 		std::unique_ptr<ParentingInfo> parent;
 #endif
 
+		constexpr static uintptr_t frozenTag = 1; // Set on the data pointer of frozen string, sequence and map nodes
+
 		thread_local static ConfigNode undefinedConfigNode;
 		thread_local static String undefinedConfigNodeName;
 
@@ -674,6 +680,14 @@ namespace Halley {
 			*this = std::move(v);
 		}
 
+		void setFrozen(ConfigNodeType type, const void* data);
+		const void* getFrozenData() const;
+		void thaw();
+		ConfigNode thawed() const;
+		static ConfigNode makeAlias(const ConfigNode& node);
+		const SequenceType& materializeSequence() const;
+		const MapType& materializeMap() const;
+
 		String getNodeDebugId() const;
 		String backTrackFullNodeName() const;
 
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string_view>
+#include "config_node.h"
+
+namespace Halley {
+	// Read-only storage for a whole ConfigNode tree in a single allocation.
+	// Maps are stored as sorted key/value arrays and every string (keys and values) is interned into one character pool.
+	// Frozen nodes behave like regular ones for reading; mutable access thaws the node back into regular heap storage.
+	// The arena must outlive every frozen node pointing into it.
+	class ConfigNodeArena {
+	public:
+		struct FrozenSequence {
+			const ConfigNode* values = nullptr;
+			uint32_t size = 0;
+			mutable std::atomic<ConfigNode::SequenceType*> materialized = nullptr; // Built on demand by asSequence()
+		};
+
+		struct FrozenMap {
+			const std::string_view* keys = nullptr; // Sorted
+			const ConfigNode* values = nullptr;
+			uint32_t size = 0;
+			mutable std::atomic<ConfigNode::MapType*> materialized = nullptr; // Built on demand by asMap()
+
+			const ConfigNode* tryGet(std::string_view key) const;
+		};
+
+		// Replaces node with a frozen copy of itself, returning the arena that backs it.
+		// Returns null (leaving node untouched) if the tree contains types that can't be frozen, such as delta or bytes nodes.
+		static std::shared_ptr<ConfigNodeArena> freeze(ConfigNode& node);
+
+		ConfigNodeArena(const ConfigNodeArena& other) = delete;
+		ConfigNodeArena(ConfigNodeArena&& other) = delete;
+		ConfigNodeArena& operator=(const ConfigNodeArena& other) = delete;
+		ConfigNodeArena& operator=(ConfigNodeArena&& other) = delete;
+		~ConfigNodeArena();
+
+		size_t getSizeBytes() const;
+
+	private:
+		struct Layout;
+		class Builder;
+
+		std::unique_ptr<std::max_align_t[]> storage;
+		size_t storageSize = 0;
+
+		FrozenMap* maps = nullptr;
+		size_t nMaps = 0;
+		FrozenSequence* sequences = nullptr;
+		size_t nSequences = 0;
+		ConfigNode* nodes = nullptr;
+		size_t nNodes = 0;
+
+		ConfigNodeArena() = default;
+	};
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <gsl/gsl>
+#include <string_view>
+#include "config_node.h"
+
+namespace Halley {
+	// Read-only view over a ConfigNode tree stored in a compiled binary layout, which can be queried straight from
+	// the loaded (or memory-mapped) asset data without building any nodes.
+	// Every node is a run of 32-bit words: a type tag followed by its payload. Sequences store an offset table to their
+	// elements, and maps store key/value offset pairs sorted by key, so lookups are a binary search.
+	// Strings are stored once and shared by every key and value that uses them.
+	// The view doesn't own the data, which must outlive it.
+	class ConfigNodeView {
+	public:
+		class Iterator;
+
+		ConfigNodeView() = default;
+		explicit ConfigNodeView(gsl::span<const gsl::byte> data);
+
+		static bool isCompiled(gsl::span<const gsl::byte> data);
+		static Bytes compile(const ConfigNode& node);
+
+		ConfigNodeType getType() const;
+		bool hasValue() const { return getType() != ConfigNodeType::Undefined; }
+
+		int asInt() const;
+		int64_t asInt64() const;
+		float asFloat() const;
+		bool asBool() const;
+		Vector2i asVector2i() const;
+		Vector2f asVector2f() const;
+		String asString() const;
+		std::string_view asStringView() const;
+
+		int asInt(int defaultValue) const;
+		int64_t asInt64(int64_t defaultValue) const;
+		float asFloat(float defaultValue) const;
+		bool asBool(bool defaultValue) const;
+		Vector2i asVector2i(Vector2i defaultValue) const;
+		Vector2f asVector2f(Vector2f defaultValue) const;
+		String asString(std::string_view defaultValue) const;
+		std::string_view asStringView(std::string_view defaultValue) const;
+
+		bool hasKey(std::string_view key) const;
+		ConfigNodeView operator[](std::string_view key) const; // Undefined view if missing
+		ConfigNodeView operator[](size_t idx) const;
+
+		size_t getSequenceSize() const;
+		Iterator begin() const;
+		Iterator end() const;
+
+		size_t getMapSize() const;
+		std::string_view getMapKey(size_t idx) const;
+		ConfigNodeView getMapValue(size_t idx) const;
+
+		// Builds the regular node tree for this view and everything under it
+		ConfigNode toConfigNode() const;
+
+	private:
+		const gsl::byte* data = nullptr;
+		uint32_t size = 0;
+		uint32_t offset = 0;
+
+		ConfigNodeView(const gsl::byte* data, uint32_t size, uint32_t offset);
+
+		uint32_t readWord(uint32_t pos) const;
+		uint32_t getCount(ConfigNodeType expected) const;
+		std::string_view readString(uint32_t nodeOffset) const;
+		ConfigNode toScalar() const;
+	};
+
+	class ConfigNodeView::Iterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = ConfigNodeView;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const ConfigNodeView*;
+		using reference = ConfigNodeView;
+
+		Iterator(const ConfigNodeView& sequence, size_t idx) : sequence(sequence), idx(idx) {}
+
+		ConfigNodeView operator*() const { return sequence[idx]; }
+		Iterator& operator++() { ++idx; return *this; }
+		bool operator==(const Iterator& other) const { return idx == other.idx; }
+		bool operator!=(const Iterator& other) const { return idx != other.idx; }
+
+	private:
+		ConfigNodeView sequence;
+		size_t idx;
+	};
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include "stats_view.h"
+
+namespace Halley
+{
+	class UIRoot;
+
+	// Shows how much of a UIRoot was drawn from render caches (see UIWidget::setRenderCached) on the last frame
+	class UIStatsView : public StatsView
+	{
+	public:
+		UIStatsView(Resources& resources, const HalleyAPI& api);
+
+		void setUIRoot(const UIRoot* root);
+		void paint(Painter& painter) override;
+
+	private:
+		const UIRoot* uiRoot = nullptr;
+		TextRenderer text;
+	};
+}
@@ -66,7 +66,9 @@ public:
 	void onAddedToEntity(Halley::EntityRef& entity);
 	void onHierarchyChanged();
 
-	uint16_t getRevision() const { return revision; }
+	uint32_t getRevision() const { return revision; }
+	uint32_t getChangeRevision() const { return revision; }
+	void markChanged() { markDirty(); }
 	Halley::WorldPartitionId getWorldPartition() const { return worldPartition; }
 
 	void deserialize(const Halley::EntitySerializationContext& context, const Halley::ConfigNode& node);
@@ -10,6 +10,7 @@ namespace Halley {
 		void setInterpolator(std::shared_ptr<IDataInterpolator> interpolator, EntityId entity, std::string_view componentName, std::string_view fieldName);
 		IDataInterpolator* tryGetInterpolator(EntityId entity, std::string_view componentName, std::string_view fieldName);
 		bool setInterpolatorEnabled(EntityId entity, std::string_view componentName, std::string_view fieldName, bool enabled);
+		bool hasInterpolators(EntityId entity, std::string_view componentName) const;
 
 		bool isReady() const;
 		void markReady();
@@ -32,6 +33,7 @@ namespace Halley {
 		
 		IDataInterpolator* tryGetInterpolator(const EntitySerializationContext& context, std::string_view componentName, std::string_view fieldName) const override;
 		IDataInterpolator* tryGetInterpolator(EntityId entityId, std::string_view componentName, std::string_view fieldName) const;
+		bool hasInterpolators(EntityId entityId, std::string_view componentName) const;
 		ConfigNode createComponentDelta(const UUID& instanceUUID, const String& componentName, const ConfigNode& from, const ConfigNode& to) const override;
 	
 	private:
@@ -10,6 +10,8 @@ namespace Halley {
 	class EntityRef;
 	class Component;
 	class EntitySerializationContext;
+	class Serializer;
+	class Deserializer;
 
 	class CreateComponentFunctionResult {
 	public:
@@ -26,6 +28,7 @@ namespace Halley {
 
 		virtual ConfigNode serialize(const EntitySerializationContext& context, const Component& component) const = 0;
 		virtual CreateComponentFunctionResult createComponent(const EntityFactoryContext& context, EntityRef& e, const ConfigNode& node) const = 0;
+		virtual void addComponent(const EntitySerializationContext& context, EntityRef& e, const ConfigNode& node) const = 0; // Assumes e doesn't have the component yet
 
 		virtual ConfigNode serializeField(const EntitySerializationContext& context, const Component& component, std::string_view fieldName) const = 0;
 		virtual ConfigNode serializeField(const EntitySerializationContext& context, EntityRef entity, std::string_view fieldName) const = 0;
@@ -39,6 +42,19 @@ namespace Halley {
 		virtual void rebindComponent(Component& component, EntityRef entity) const = 0;
 
 		virtual void sanitize(ConfigNode& data, int mask) const = 0;
+
+		// Binary network deltas, for components generated with networkDelta
+		// The snapshot is a standalone copy of the networked fields, which deltas are computed against
+		virtual bool hasNetworkDelta() const = 0;
+		virtual std::shared_ptr<Component> makeNetworkDeltaSnapshot(const Component& component) const = 0;
+		virtual uint64_t getNetworkDeltaMask(const Component& component, const Component& snapshot) const = 0;
+		virtual void serializeNetworkDelta(Serializer& s, const Component& component, Component& snapshot, uint64_t mask) const = 0; // Also brings snapshot up to date
+		virtual void applyNetworkDelta(Deserializer& s, Component& component) const = 0;
+
+		// Change tracking, for components generated with trackChanges (and Transform2D)
+		// Returns empty if the component isn't tracked, in which case it has to be assumed to have changed
+		virtual std::optional<uint32_t> getChangeRevision(const Component& component) const = 0;
+		virtual void markChanged(Component& component) const = 0; // No-op if not tracked
 	};
 
 	class MessageReflector {
@@ -4,6 +4,14 @@
 #include "halley/entity/entity_factory.h"
 
 namespace Halley {
+	// True if T was generated with networkDelta
+	template <class, class = std::void_t<>> struct HasNetworkDeltaMember : std::false_type {};
+	template <class T> struct HasNetworkDeltaMember<T, std::void_t<decltype(std::declval<const T&>().getNetworkDeltaMask(std::declval<const T&>()))>> : std::true_type { };
+
+	// True if T was generated with trackChanges
+	template <class, class = std::void_t<>> struct HasChangeRevisionMember : std::false_type {};
+	template <class T> struct HasChangeRevisionMember<T, std::void_t<decltype(std::declval<const T&>().getChangeRevision())>> : std::true_type { };
+
 	template <typename T>
 	class ComponentReflectorImpl final : public ComponentReflector {
 	public:
@@ -29,6 +37,13 @@ namespace Halley {
 			return context.createComponent<T>(e, node);
 		}
 
+		void addComponent(const EntitySerializationContext& context, EntityRef& e, const ConfigNode& node) const override
+		{
+			T component;
+			component.deserialize(context, node);
+			e.addComponent<T>(std::move(component));
+		}
+
 		ConfigNode serializeField(const EntitySerializationContext& context, const Component& component, std::string_view fieldName) const override
 		{
 			return static_cast<const T&>(component).serializeField(context, fieldName);
@@ -89,6 +104,72 @@ namespace Halley {
 				static_cast<T&>(component).onAddedToEntity(entity);
 			}
 		}
+
+		bool hasNetworkDelta() const override
+		{
+			return HasNetworkDeltaMember<T>::value;
+		}
+
+		std::shared_ptr<Component> makeNetworkDeltaSnapshot(const Component& component) const override
+		{
+			if constexpr (HasNetworkDeltaMember<T>::value) {
+				auto snapshot = std::shared_ptr<T>(new T());
+				snapshot->copyDelta(static_cast<const T&>(component), ~uint64_t(0));
+				return snapshot;
+			} else {
+				throwNoNetworkDelta();
+			}
+		}
+
+		uint64_t getNetworkDeltaMask(const Component& component, const Component& snapshot) const override
+		{
+			if constexpr (HasNetworkDeltaMember<T>::value) {
+				return static_cast<const T&>(component).getNetworkDeltaMask(static_cast<const T&>(snapshot));
+			} else {
+				throwNoNetworkDelta();
+			}
+		}
+
+		void serializeNetworkDelta(Serializer& s, const Component& component, Component& snapshot, uint64_t mask) const override
+		{
+			if constexpr (HasNetworkDeltaMember<T>::value) {
+				static_cast<const T&>(component).serializeDelta(s, mask);
+				static_cast<T&>(snapshot).copyDelta(static_cast<const T&>(component), mask);
+			} else {
+				throwNoNetworkDelta();
+			}
+		}
+
+		void applyNetworkDelta(Deserializer& s, Component& component) const override
+		{
+			if constexpr (HasNetworkDeltaMember<T>::value) {
+				static_cast<T&>(component).applyDelta(s);
+			} else {
+				throwNoNetworkDelta();
+			}
+		}
+
+		std::optional<uint32_t> getChangeRevision(const Component& component) const override
+		{
+			if constexpr (HasChangeRevisionMember<T>::value) {
+				return static_cast<uint32_t>(static_cast<const T&>(component).getChangeRevision());
+			} else {
+				return std::nullopt;
+			}
+		}
+
+		void markChanged(Component& component) const override
+		{
+			if constexpr (HasChangeRevisionMember<T>::value) {
+				static_cast<T&>(component).markChanged();
+			}
+		}
+
+	private:
+		[[noreturn]] static void throwNoNetworkDelta()
+		{
+			throw Exception("Component " + String(T::componentName) + " doesn't support network deltas", HalleyExceptions::Entity);
+		}
 	};
 
 	template <typename T>
@@ -165,6 +165,8 @@ namespace Halley {
 		const String& getEnableRules() const;
 		void setEnableRules(String rules);
 
+		std::optional<uint64_t> getChangeRevision(const World& world) const;
+
 	private:
 		// !!! WARNING !!!
 		// The order of elements in this class was carefully chosen to maximise cache performance!
@@ -185,9 +187,9 @@ namespace Halley {
 		uint8_t childrenRevision = 0;
 		WorldPartitionId worldPartition = 0;
 		uint8_t hierarchyRevision = 0;
-		uint8_t componentRevision = 0;
 
 		FamilyMaskType mask;
+		uint32_t componentRevision = 0; // Components added/removed, enabled status, or any of the entity's own properties changed. Wide so that getChangeRevision() never sees it wrap.
 		Entity* parent = nullptr;
 		EntityId entityId;
 		Vector<Entity*> children; // Cacheline 1 starts 16 bytes into this
@@ -620,6 +622,7 @@ namespace Halley {
 			} else {
 				entity->name = std::make_unique<String>(std::move(name));
 			}
+			++entity->componentRevision;
 		}
 
 		const String& getEnableRules() const
@@ -733,7 +736,7 @@ namespace Halley {
 			return entity->hierarchyRevision;
 		}
 
-		uint8_t getComponentRevision() const
+		uint32_t getComponentRevision() const
 		{
 			validate();
 			return entity->componentRevision;
@@ -745,6 +748,14 @@ namespace Halley {
 			return entity->childrenRevision;
 		}
 
+		// Changes whenever anything that would be serialized from this entity (or its children) changes
+		// Empty if any of the components doesn't track its changes, in which case the entity must be assumed to have changed
+		std::optional<uint64_t> getChangeRevision() const
+		{
+			validate();
+			return entity->getChangeRevision(*world);
+		}
+
 		WorldPartitionId getWorldPartition() const
 		{
 			validate();
@@ -772,6 +783,7 @@ namespace Halley {
 		{
 			validate();
 			entity->selectable = selectable;
+			++entity->componentRevision;
 		}
 
 		bool isEnabled() const
@@ -845,6 +857,7 @@ namespace Halley {
 		{
 			validate();
 			entity->serializable = serializable;
+			++entity->componentRevision;
 			return *this;
 		}
 
@@ -874,6 +887,7 @@ namespace Halley {
 			Expects(!prefab || prefabUUID.isValid());
 			entity->prefab = std::move(prefab);
 			entity->prefabUUID = prefabUUID;
+			++entity->componentRevision;
 		}
 
 		const std::shared_ptr<const Prefab>& getPrefab() const
@@ -1042,7 +1056,7 @@ namespace Halley {
 			return entity->hierarchyRevision;
 		}
 
-		uint8_t getComponentRevision() const
+		uint32_t getComponentRevision() const
 		{
 			return entity->componentRevision;
 		}
@@ -1052,6 +1066,11 @@ namespace Halley {
 			return entity->childrenRevision;
 		}
 
+		std::optional<uint64_t> getChangeRevision() const
+		{
+			return entity->getChangeRevision(*world);
+		}
+
 		size_t getNumComponents() const
 		{
 			Expects(entity);
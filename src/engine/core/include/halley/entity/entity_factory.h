@@ -7,6 +7,7 @@
 #include "halley/file_formats/config_file.h"
 #include "halley/data_structures/maybe.h"
 #include "halley/entity/entity.h"
+#include "halley/maths/angle.h"
 
 namespace Halley {
 	class World;
@@ -14,6 +15,7 @@ namespace Halley {
 	class EntityScene;
 	class EntityData;
 	class EnableRulesService;
+	class PrefabBlueprint;
 	
 	class EntityFactory {
 	public:
@@ -26,6 +28,8 @@ namespace Halley {
 		struct SerializationOptions {
 			EntitySerialization::Type type = EntitySerialization::Type::Undefined;
 			std::function<bool(EntityRef)> serializeAsStub;
+			std::function<bool(EntityRef, int)> skipComponent; // Components for which this returns true are left out
+			std::function<ConfigNode(EntityRef, int, const Component&, const std::function<ConfigNode()>&)> serializeComponent; // If set, components are serialized through this (e.g. to reuse unchanged ones), the last argument being the default serialization
 
 			SerializationOptions() = default;
 			explicit SerializationOptions(EntitySerialization::Type type, std::function<bool(EntityRef)> serializeAsStub = {})
@@ -34,6 +38,11 @@ namespace Halley {
 			{}
 		};
 
+		struct BatchTransform {
+			Vector2f position;
+			Angle1f rotation;
+		};
+
 		explicit EntityFactory(World& world, Resources& resources);
 		virtual ~EntityFactory();
 
@@ -41,6 +50,9 @@ namespace Halley {
 		
 		EntityRef createEntity(const String& prefabName, EntityRef parent = EntityRef(), EntityScene* scene = nullptr);
 		EntityRef createEntity(const EntityData& data, int mask, EntityRef parent = EntityRef(), EntityScene* scene = nullptr, EntityFactoryContext* parentContext = nullptr);
+		// Creates count copies of the blueprint's prefab, applying transforms (if not empty) to each root's Transform2DComponent
+		Vector<EntityRef> instantiateBatch(const PrefabBlueprint& blueprint, size_t count, gsl::span<const BatchTransform> transforms = {}, EntityRef parent = EntityRef());
+		Vector<EntityRef> instantiateBatch(const String& prefabName, size_t count, gsl::span<const BatchTransform> transforms = {}, EntityRef parent = EntityRef());
 		EntityScene createScene(const std::shared_ptr<const Prefab>& scene, bool allowReload, WorldPartitionId worldPartition = 0, String variant = "");
 
 		void updateEntity(EntityRef& entity, const IEntityData& data, int serializationMask, EntityScene* scene = nullptr, IDataInterpolatorSetRetriever* interpolators = nullptr);
@@ -15,6 +15,7 @@ namespace Halley {} // Get GitHub to realise this is C++ :3
 #include "halley/entity/system_message.h"
 #include "halley/entity/world.h"
 #include "halley/entity/world_scene_data.h"
+#include "halley/entity/world_saver.h"
 #include "halley/entity/family_binding.h"
 #include "halley/entity/family.h"
 #include "halley/entity/entity_data.h"
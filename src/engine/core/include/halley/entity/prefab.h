@@ -6,6 +6,8 @@
 
 namespace Halley {
 	class SceneVariant;
+	class PrefabBlueprint;
+	class WorldReflection;
 
 	class Prefab : public AsyncResource {
 	public:		
@@ -53,6 +55,8 @@ namespace Halley {
 
 		void preloadDependencies(Resources& resources) const;
 
+		std::shared_ptr<const PrefabBlueprint> getBlueprint(const WorldReflection& reflection) const; // Built on first use, dropped on reload
+
 		ResourceMemoryUsage getMemoryUsage() const override;
 
 		void generateUUIDs();
@@ -73,6 +77,8 @@ namespace Halley {
 
 		Deltas deltas;
 
+		mutable std::shared_ptr<const PrefabBlueprint> blueprint;
+
 		void doPreloadDependencies(const EntityData& entityData, Resources& resources) const;
 	};
 
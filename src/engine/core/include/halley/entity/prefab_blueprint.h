@@ -0,0 +1,53 @@
+#pragma once
+
+#include "halley/data_structures/config_node.h"
+#include "halley/data_structures/vector.h"
+#include "halley/maths/uuid.h"
+#include "halley/text/halleystring.h"
+
+namespace Halley {
+	class Prefab;
+	class EntityData;
+	class ComponentReflector;
+	class WorldReflection;
+
+	// A prefab flattened into a form that can be stamped out many times cheaply.
+	// Component names are resolved to their reflectors and component data is merged up front, so instantiating only has to
+	// create the entities and deserialize each component straight into them.
+	// Build it through Prefab::getBlueprint(), which caches it until the prefab reloads.
+	class PrefabBlueprint {
+	public:
+		struct Component {
+			const ComponentReflector* reflector = nullptr;
+			ConfigNode data;
+		};
+
+		struct Node {
+			String name;
+			UUID prefabUUID;
+			int parent = -1; // Index into nodes, always lower than this node's index
+			uint8_t flags = 0;
+			String variant;
+			String enableRules;
+			Vector<Component> components;
+		};
+
+		PrefabBlueprint(const Prefab& prefab, const WorldReflection& reflection);
+
+		const Vector<Node>& getNodes() const { return nodes; }
+		const String& getPrefabId() const { return prefabId; }
+		const WorldReflection& getReflection() const { return *reflection; }
+
+		// False if the prefab can't be flattened (e.g. it nests other prefab instances), in which case
+		// EntityFactory::instantiateBatch() falls back to instantiating each copy through the regular path.
+		bool isCompiled() const { return compiled; }
+
+	private:
+		const WorldReflection* reflection = nullptr;
+		String prefabId;
+		Vector<Node> nodes;
+		bool compiled = false;
+
+		bool addNode(const EntityData& data, int parent);
+	};
+}
@@ -28,6 +28,7 @@ namespace Halley {
 	struct SystemMessageContext;
 	class UUID;
 	class ConfigNode;
+	class ConfigNodeView;
 	class RenderContext;
 	class Entity;
 	class System;
@@ -67,6 +68,7 @@ namespace Halley {
 
 		Service& addService(std::shared_ptr<Service> service);
 		void loadSystems(const ConfigNode& config, const std::optional<String>& systemTag = {});
+		void loadSystems(const ConfigNodeView& config, const std::optional<String>& systemTag = {});
 		
 		template <typename T>
 		T* tryGetService(std::string_view systemName = "")
@@ -18,6 +18,7 @@ namespace Halley {
 		std::unique_ptr<SystemMessage> createSystemMessage(const String& name) const;
 		ComponentReflector& getComponentReflector(int id) const;
 		ComponentReflector& getComponentReflector(const String& name) const;
+		const ComponentReflector* tryGetComponentReflector(const String& name) const;
 
 	private:
 		Vector<SystemReflector> systemReflectors;
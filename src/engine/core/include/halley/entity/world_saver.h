@@ -0,0 +1,90 @@
+#pragma once
+
+#include "entity_factory.h"
+#include "halley/concurrency/future.h"
+#include "halley/data_structures/hash_map.h"
+
+namespace Halley {
+	class ISaveData;
+	class Resources;
+	class Scene;
+	class World;
+
+	// Saves a world incrementally, without stalling the frame for the whole encode and write.
+	// capture() has to run on the main thread, at a frame boundary. Top-level entities that haven't changed since the
+	// previous capture (see EntityRef::getChangeRevision) share their immutable data with the previous snapshot, and
+	// the changed ones only re-serialize the components whose change revision moved.
+	// Encoding, compression and writing then happen on the disk IO executor. Saves are written as a compressed Scene,
+	// so they load back through EntityFactory::createScene.
+	class WorldSaver {
+	public:
+		struct Report {
+			size_t entitiesSerialized = 0;
+			size_t entitiesReused = 0;
+			size_t componentsSerialized = 0;
+			size_t componentsReused = 0; // In entities that were serialized, as reused entities don't look at their components
+			size_t rawSize = 0;
+			size_t compressedSize = 0;
+			int64_t stallTimeNs = 0; // Time capturing on the calling thread
+			int64_t backgroundTimeNs = 0; // Time encoding, compressing and writing
+
+			String toString() const;
+		};
+
+		class Snapshot {
+		public:
+			const Vector<std::shared_ptr<const EntityData>>& getEntities() const { return entities; }
+			const Report& getReport() const { return report; }
+
+			std::shared_ptr<Scene> toScene() const;
+			Bytes serialize() const;
+			Bytes encode() const; // Compressed, as written by save()
+
+		private:
+			friend class WorldSaver;
+
+			Vector<std::shared_ptr<const EntityData>> entities;
+			Report report;
+		};
+
+		WorldSaver(World& world, Resources& resources, EntityFactory::SerializationOptions options = EntityFactory::SerializationOptions(EntitySerialization::Type::SaveData));
+
+		std::shared_ptr<const Snapshot> capture(); // All serializable top-level entities
+		std::shared_ptr<const Snapshot> capture(gsl::span<const EntityRef> roots);
+		void reset(); // Next capture serializes everything
+
+		// Captures now and writes in the background. saveData must be safe to use from the disk IO thread, and outlive the future.
+		Future<Report> save(ISaveData& saveData, String path);
+		static Future<Report> write(std::shared_ptr<const Snapshot> snapshot, ISaveData& saveData, String path);
+
+		static std::shared_ptr<Scene> decode(const Bytes& data);
+
+	private:
+		struct CachedEntity {
+			std::optional<uint64_t> changeRevision;
+			std::shared_ptr<const EntityData> data;
+		};
+
+		struct CachedComponent {
+			int componentId;
+			uint32_t changeRevision;
+			ConfigNode data;
+		};
+
+		struct CachedComponents {
+			Vector<CachedComponent> components;
+			uint32_t entityComponentRevision = 0; // Adding or removing components resets the cache, so a new component can't match an old revision
+			uint32_t lastCapture = 0;
+		};
+
+		World& world;
+		EntityFactory factory;
+		EntityFactory::SerializationOptions options;
+		HashMap<UUID, CachedEntity> cache;
+		HashMap<UUID, CachedComponents> componentCache; // Every entity in the hierarchy, not just the top-level ones
+		uint32_t captureCount = 0;
+
+		ConfigNode serializeComponent(EntityRef entity, int componentId, const Component& component, const std::function<ConfigNode()>& serialize, Report& report);
+		void markComponentsUsed(EntityRef entity);
+	};
+}
@@ -1,26 +1,35 @@
 #pragma once
 
 #include "halley/data_structures/config_node.h"
+#include "halley/data_structures/config_node_view.h"
 #include "halley/resources/resource.h"
 
 namespace Halley
 {
+	class ConfigNodeArena;
 	class ResourceLoader;
 	class EntityData;
 
 	class ConfigFile : public Resource
 	{
 	public:
-		ConfigFile() = default;
+		ConfigFile();
 		explicit ConfigFile(const ConfigFile& other);
 		explicit ConfigFile(ConfigNode root);
 		ConfigFile(ConfigFile&& other) noexcept;
+		~ConfigFile() override;
 
 		ConfigFile& operator=(ConfigFile&& other) noexcept;
 
 		ConfigNode& getRoot();
 		const ConfigNode& getRoot() const;
 
+		// Queries the compiled asset data in place, without building the node tree.
+		// Files that weren't loaded from compiled data compile their root the first time this is called.
+		// The view points into memory owned by the file, which the non-const getRoot() and reload() release, as the tree may change.
+		// Views obtained before either call dangle, so get a new one whenever it's needed instead of keeping it.
+		ConfigNodeView getView() const;
+
 		void serialize(Serializer& s) const;
 		void deserialize(Deserializer& s);
 
@@ -33,10 +42,16 @@ namespace Halley
 		void reload(Resource&& resource) override;
 
 	protected:
+		struct CompiledData;
+
 		ConfigNode root;
+		std::shared_ptr<ConfigNodeArena> arena; // Backs root when it's frozen
+		std::unique_ptr<CompiledData> compiled; // Root is built from this the first time it's needed
 		bool storeFilePosition = true;
 
 		void updateRoot();
+		void freeze();
+		void materializeRoot() const;
 	};
 
 	class ConfigObserver
@@ -47,6 +62,7 @@ namespace Halley
 		ConfigObserver(const ConfigFile& file);
 
 		const ConfigNode& getRoot() const;
+		ConfigNodeView getView() const; // Undefined if not observing a file
 		
 		bool needsUpdate() const;
 		void update();
@@ -20,7 +20,8 @@ namespace Halley {
         static bool isHLIF(gsl::span<const gsl::byte> data);
 
     private:
-     	constexpr static uint8_t hlifId[8] = "HLIFv01";
+     	constexpr static uint8_t hlifIdV1[8] = "HLIFv01";
+     	constexpr static uint8_t hlifIdV2[8] = "HLIFv02";
 
     	enum class Format : uint8_t {
 			RGBA,
@@ -44,6 +45,14 @@ namespace Halley {
             uint8_t reserved = 0;
 		};
 
+		// v02 only: follows the header, and is followed by numBands + 1 compressed chunk sizes and then the chunks themselves.
+		// The first chunk holds the palettes and line encodings, each of the others holds rowsPerBand rows of pixels.
+		// Each band is filtered as if the row above it were blank, so bands can be decompressed and unfiltered independently.
+		struct BandTable {
+			uint32_t rowsPerBand = 0;
+			uint32_t numBands = 0;
+		};
+
     public:
     	// Same as PNG
         enum class LineEncoding: uint8_t {
@@ -63,16 +72,19 @@ namespace Halley {
             Palette();
         };
         
+    	static void decodeBands(const Header& header, gsl::span<const gsl::byte> data, gsl::span<uint8_t> metaData, gsl::span<uint8_t> pixelData, int bpp, gsl::span<int> dst);
     	static void decodeLines(Vector2i size, gsl::span<const uint8_t> lineData, gsl::span<uint8_t> pixelData, int bpp);
     	static void encodeLines(Vector2i size, gsl::span<uint8_t> lineData, gsl::span<uint8_t> pixelData, int bpp);
         static LineEncoding findBestLineEncoding(gsl::span<const uint8_t> curLine, gsl::span<const uint8_t> prevLine, int bpp);
         static void encodeLine(LineEncoding lineEncoding, gsl::span<uint8_t> curLine, gsl::span<const uint8_t> prevLine, int bpp);
         static void decodeLine(LineEncoding lineEncoding, gsl::span<uint8_t> curLine, gsl::span<const uint8_t> prevLine, int bpp);
         static int getBPP(Format format);
+        static int getRowsPerBand(int width);
+        static Vector<Palette> readPalettes(gsl::span<const uint8_t> paletteData);
 
         static std::optional<std::pair<Vector<Palette>, Bytes>> makePalettes(gsl::span<const int> pixels, std::string_view name = {});
         static void optimizePalettes(gsl::span<Palette> palettes, gsl::span<uint8_t> pixels);
-        static void applyPalettes(gsl::span<const uint8_t> palettedImage, gsl::span<const Palette> palettes, gsl::span<int> dst);
+        static void applyPalettes(gsl::span<const uint8_t> palettedImage, gsl::span<const Palette> palettes, gsl::span<int> dst, size_t firstPixel = 0);
         static void deltaEncodePalettes(gsl::span<Palette> palettes);
         static void deltaDecodePalettes(gsl::span<Palette> palettes);
     };
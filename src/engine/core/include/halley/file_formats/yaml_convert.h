@@ -6,7 +6,6 @@
 
 namespace YAML {
 	class Node;
-	class Emitter;
 }
 
 namespace Halley {
@@ -43,12 +42,6 @@ namespace Halley {
 		
 		static String generateYAML(const ConfigFile& config, const EmitOptions& options = {});
 		static String generateYAML(const ConfigNode& node, const EmitOptions& options = {});
-
-	private:
-		static void emitNode(const ConfigNode& node, YAML::Emitter& emitter, const EmitOptions& options);
-		static void emitSequence(const ConfigNode& node, YAML::Emitter& emitter, const EmitOptions& options);
-		static void emitMap(const ConfigNode& node, YAML::Emitter& emitter, const EmitOptions& options);
-		static bool isCompactSequence(const ConfigNode& node, int depth, const EmitOptions& options);
 	};
 
 }
\ No newline at end of file
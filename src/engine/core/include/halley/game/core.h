@@ -76,6 +76,9 @@ namespace Halley
 
 		DevConClient* getDevConClient() const override;
 
+		// Writes the startup trace to this path once the first frame is rendered
+		void setStartupTracePath(Path path);
+
 	private:
 		void deInit();
 
@@ -105,6 +108,7 @@ namespace Halley
 
 		void onProfileData(std::shared_ptr<ProfilerData> data);
 		Time getProfileCaptureThreshold() const;
+		void endStartupTrace();
 
 		Vector<String> args;
 
@@ -128,6 +132,7 @@ namespace Halley
 		std::unique_ptr<BaseFrameData> frameDataRender;
 
 		bool initialized = false;
+		bool firstFrameRendered = false;
 		bool running = true;
 		bool hasError = false;
 		bool hasConsole = false;
@@ -135,6 +140,7 @@ namespace Halley
 		std::unique_ptr<RedirectStream> out;
 
 		std::unique_ptr<DevConClient> devConClient;
+		std::optional<Path> startupTracePath;
 
 		Vector<IProfileCallback*> profileCallbacks;
 		Vector<Promise<std::unique_ptr<RenderSnapshot>>> pendingSnapshots;
@@ -29,6 +29,9 @@ namespace Halley
 
 		static Vector<std::string> getWin32Args();
 		static Vector<std::string> getArgs(int argc, char* argv[]);
+
+		// Set with --startup-trace=<path> or the HALLEY_STARTUP_TRACE environment variable
+		static std::optional<Path> getStartupTracePath(const Vector<std::string>& args);
 	};
 	
 	template <typename T> constexpr static void InitEntities()
@@ -143,6 +143,8 @@ namespace Halley {
 			return false;
 		}
 
+		virtual void onTypesAssigned() const {}
+
 		uint64_t hash = 0;
 		uint64_t assetHash = 0;
 		mutable uint64_t lastAssignTypeHash = 1;
@@ -8,10 +8,10 @@
 #include "halley/maths/circle.h"
 #include "halley/maths/colour_gradient.h"
 #include "halley/maths/ellipse.h"
+#include "halley/maths/random.h"
 
 namespace Halley {
 	class Polygon;
-	class Random;
 	class Animation;
 
 	enum class ParticleSpawnAreaShape : uint8_t {
@@ -29,21 +29,46 @@ namespace Halley {
 		}
 	};
 
+	enum class ParticleOffscreenUpdate : uint8_t {
+		Always,
+		Reduced,
+		FastForward
+	};
+
+	template <>
+	struct EnumNames<ParticleOffscreenUpdate> {
+		constexpr std::array<const char*, 3> operator()() const {
+			return{{
+				"always",
+				"reduced",
+				"fastForward"
+			}};
+		}
+	};
+
 	class IParticleSpawner {
 	public:
 		virtual ~IParticleSpawner() = default;
 		virtual void spawn(Vector3f pos, EntityId target) = 0;
 	};
 	
+	// Particles are simulated independently of everything else, so different instances can be updated in parallel
+	// The same instance must not be used by two threads at once
 	class Particles {
-		struct Particle {
-			Vector3f pos;
-			Vector3f vel;
-			float scale = 1;
-			float time = 0;
-			float ttl = 1;
-			bool alive = true;
-			bool firstFrame = true;
+		// One array per attribute, so the integration loops only stream through the data they actually use
+		struct ParticleData {
+			Vector<Vector3f> pos;
+			Vector<Vector3f> vel;
+			Vector<float> time;
+			Vector<float> ttl;
+			Vector<float> scale;
+			Vector<float> animTime; // Value of time when the particle's animation was last advanced
+			Vector<uint8_t> alive;
+			Vector<uint8_t> firstFrame;
+
+			size_t size() const;
+			void resize(size_t size);
+			void move(size_t from, size_t to);
 		};
 		
 	public:
@@ -94,8 +119,22 @@ namespace Halley {
 		float getSpawnHeight() const;
 		void setSpawnPositionOffset(Vector2f offset);
 
+		// Seeds this emitter, so its simulation can be reproduced; otherwise it's seeded from the global generator every time it starts
+		void setRandomSeed(uint64_t seed);
+
 		void update(Time t);
-		void updateSprites(Time t);
+		void updateSprites(Time t); // Only needs to be called while the particles are visible
+
+		// Whether the particles were visible on the last frame, used by the offscreen update mode
+		// Reduced simulates offscreen particles once every offscreenUpdateInterval, FastForward skips them until they're visible again (or would all have died)
+		void setVisible(bool visible);
+		bool isVisible() const;
+		void setOffscreenUpdate(ParticleOffscreenUpdate mode);
+		ParticleOffscreenUpdate getOffscreenUpdate() const;
+
+		// Buckets particles into a grid of this cell size for destroyOverlapping; only worth it on emitters with lots of particles
+		void setOverlapGridCellSize(std::optional<float> cellSize);
+		std::optional<float> getOverlapGridCellSize() const;
 
 		void setSprites(Vector<Sprite> sprites);
 		void setAnimation(std::shared_ptr<const Animation> animation);
@@ -116,7 +155,6 @@ namespace Halley {
 		void destroyOverlapping(const Circle& circle);
 
 	private:
-		Random* rng;
 		std::shared_ptr<Material> material;
 
 		bool enabled = true;
@@ -125,7 +163,7 @@ namespace Halley {
 		float speedMultiplier = 1.0f;
 
 		Vector<Sprite> sprites;
-		Vector<Particle> particles;
+		ParticleData particles;
 		Vector<AnimationPlayerLite> animationPlayers;
 		
 		size_t nParticlesAlive = 0;
@@ -168,17 +206,44 @@ namespace Halley {
 
 		IParticleSpawner* secondarySpawner = nullptr;
 
+		mutable Random rng;
+		std::optional<uint64_t> randomSeed;
+
 		mutable std::optional<float> maxBorder;
 
+		ParticleOffscreenUpdate offscreenUpdate = ParticleOffscreenUpdate::Always;
+		float offscreenUpdateInterval = 0.25f;
+		float offscreenTime = 0;
+		bool visible = true;
+
+		struct OverlapGrid {
+			Vector2f origin;
+			Vector2i size;
+			float cellSize = 0;
+			Vector<uint32_t> cellStart; // Index into particles, for each cell, plus one past the end
+			Vector<uint32_t> particles; // Sorted by cell
+			Vector<uint32_t> particleCell;
+			bool dirty = true;
+			int queriesWhileDirty = 0; // Queries since it was last marked dirty
+		};
+		std::optional<float> overlapGridCellSize;
+		OverlapGrid overlapGrid;
+
+		void markOverlapGridDirty();
+		void updateOverlapGrid();
+		template <typename F> void destroyMatching(Rect4f aabb, F contains);
+
 		void start();
 		void initializeParticle(size_t index, float time, float totalTime);
 		void updateParticles(float t);
+		void catchUp(float t);
 		void removeDeadParticles();
 		void spawn(size_t n, float time);
 
 		Vector3f getSpawnPosition() const;
 
-		void onSecondarySpawn(const Particle& particle, EntityId target);
+		void onSecondarySpawn(Vector3f pos, EntityId target);
+		bool needsSpriteSwap() const;
 
 		float getSpriteBorder(const Sprite& sprite) const;
 		void computeMaxBorder() const;
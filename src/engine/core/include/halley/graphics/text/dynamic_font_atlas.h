@@ -0,0 +1,149 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include "halley/graphics/text/font.h"
+#include "halley/data_structures/hash_map.h"
+#include "halley/concurrency/future.h"
+#include "halley/text/i18n.h"
+
+namespace Halley
+{
+	class Image;
+	class MaterialDefinition;
+	class VideoAPI;
+
+	// Produces glyph images for a DynamicFontAtlas
+	// rasterize() is called from worker threads, and may be called concurrently
+	class IGlyphRasterizer {
+	public:
+		struct FontMetrics {
+			String name;
+			float ascender = 0;
+			float height = 0;
+			float sizePt = 0;
+			float smoothRadius = 0; // 0 for plain bitmaps, otherwise the distance field radius
+			bool floorGlyphPosition = false;
+		};
+
+		struct Glyph {
+			std::unique_ptr<Image> image; // RGBA, already padded; null for glyphs with nothing to draw, such as spaces
+			Vector2f horizontalBearing;
+			Vector2f verticalBearing;
+			Vector2f advance;
+		};
+
+		virtual ~IGlyphRasterizer() = default;
+
+		virtual FontMetrics getFontMetrics() const = 0;
+		virtual Vector2i getMaxGlyphSize() const = 0; // Every glyph image must fit this, as it's the size of an atlas slot
+		virtual bool hasGlyph(int charcode) const = 0;
+		virtual std::optional<Glyph> rasterize(int charcode) const = 0;
+	};
+
+	struct DynamicFontAtlasConfig {
+		Vector2i pageSize = Vector2i(1024, 1024);
+		size_t maxPages = 4;
+		bool useWorkerThreads = true; // If false, or if there are no executors, glyphs are rasterized on the thread calling update()
+	};
+
+	struct DynamicFontAtlasStats {
+		size_t hits = 0;
+		size_t misses = 0;
+		size_t evictions = 0;
+		size_t glyphs = 0;
+		size_t pages = 0;
+		size_t pending = 0;
+
+		float getHitRate() const;
+	};
+
+	// Glyph cache for fonts rasterized at runtime, for character sets too large to bake into an atlas up front (e.g. CJK)
+	// Glyphs are requested as text asks for them, rasterized by an IGlyphRasterizer on worker threads, and stored in
+	// fixed size slots spread over up to maxPages textures. Once all slots are taken, the least recently used glyph is evicted.
+	// Each page is exposed as its own Font, so TextRenderer batches per page the same way it does for fallback fonts.
+	//
+	// Use Font(std::shared_ptr<DynamicFontAtlas>) to make a font out of it, and call Font::updateDynamicGlyphs() once a frame.
+	class DynamicFontAtlas {
+	public:
+		DynamicFontAtlas(VideoAPI& video, std::shared_ptr<const MaterialDefinition> material, std::shared_ptr<IGlyphRasterizer> rasterizer, DynamicFontAtlasConfig config = {});
+
+		DynamicFontAtlas(const DynamicFontAtlas& other) = delete;
+		DynamicFontAtlas& operator=(const DynamicFontAtlas& other) = delete;
+
+		const IGlyphRasterizer::FontMetrics& getFontMetrics() const;
+		Vector2i getPageSize() const;
+		bool canRasterize(int charcode) const;
+
+		// Returns the glyph and the page font that holds it. If it's not in the atlas yet, it's queued and an empty glyph in placeholderFont is returned.
+		// Thread-safe, but the result is only valid until the next update()
+		std::pair<const Font::Glyph&, const Font&> getGlyph(int charcode, const Font& placeholderFont);
+
+		// Queues characters that will be needed soon, without counting towards the hit rate
+		void prewarm(gsl::span<const int> characters);
+		void prewarm(const I18N& i18n, const std::optional<I18NLanguage>& language = {});
+
+		// Moves rasterized glyphs into the atlas and uploads any pages that changed, returning whether any glyph was added or evicted
+		// Must be called from the main thread, while no text is being laid out
+		bool update();
+
+		// Blocks until every queued glyph is rasterized (they still need update() to be moved into the atlas)
+		void waitForPending();
+
+		const std::shared_ptr<Material>& getMaterial() const; // Material of the first page
+		DynamicFontAtlasStats getStats() const;
+		void resetStats();
+
+	private:
+		struct Page {
+			std::shared_ptr<Font> font;
+			std::shared_ptr<Texture> texture;
+			std::unique_ptr<Image> image;
+			bool dirty = false;
+		};
+
+		struct Slot {
+			size_t page = 0;
+			Vector2i pos;
+		};
+
+		struct Entry {
+			size_t page = 0;
+			std::optional<Slot> slot; // Glyphs with nothing to draw don't take a slot, and are never evicted
+			std::list<int>::iterator lruPos;
+		};
+
+		struct Results {
+			std::mutex mutex;
+			Vector<std::pair<int, std::optional<IGlyphRasterizer::Glyph>>> glyphs;
+		};
+
+		VideoAPI& video;
+		std::shared_ptr<const MaterialDefinition> materialDefinition;
+		std::shared_ptr<IGlyphRasterizer> rasterizer;
+		DynamicFontAtlasConfig config;
+		IGlyphRasterizer::FontMetrics metrics;
+		Vector2i slotSize;
+		Font::Glyph placeholderGlyph;
+
+		mutable std::mutex mutex;
+		Vector<Page> pages;
+		Vector<Slot> freeSlots;
+		HashMap<int, Entry> entries;
+		std::list<int> lru; // Most recently used first
+		HashSet<int> pending;
+		HashSet<int> failed;
+		Vector<int> queued; // Only used without worker threads
+		Vector<Future<void>> tasks;
+		std::shared_ptr<Results> results;
+		DynamicFontAtlasStats stats;
+
+		void request(int charcode);
+		void addGlyph(int charcode, std::optional<IGlyphRasterizer::Glyph> glyph);
+		std::optional<Slot> allocateSlot();
+		void addPage();
+		void uploadPage(Page& page);
+	};
+}
@@ -10,6 +10,7 @@ namespace Halley
 {
 	class Deserializer;
 	class Serializer;
+	class DynamicFontAtlas;
 
 	class Font final : public Resource
 	{
@@ -23,7 +24,7 @@ namespace Halley
 			Vector2f horizontalBearing;
 			Vector2f verticalBearing;
 			Vector2f advance;
-			HashMap<int32_t, Vector2f> kerning;
+			HashMap<int32_t, Vector2f> kerning; // Only used to hand kerning over to Font::addGlyph and for serialization; once added, the Font owns it
 			
 			Glyph();
 			Glyph(const Glyph& other) = default;
@@ -33,8 +34,6 @@ namespace Halley
 			Glyph& operator=(const Glyph& o) = default;
 			Glyph& operator=(Glyph&& o) noexcept = default;
 
-			Vector2f getKerning(int32_t charcode) const;
-
 			void serialize(Serializer& serializer) const;
 			void deserialize(Deserializer& deserializer);
 		};
@@ -42,6 +41,7 @@ namespace Halley
 		Font() = default;
 		Font(String name, String imageName, float ascender, float height, float sizePt, float replacementScale, Vector2i imageSize);
 		Font(String name, String imageName, float ascender, float height, float sizePt, float replacementScale, Vector2i imageSize, float distanceFieldSmoothRadius, Vector<String> fallback, bool floorGlyphPosition);
+		explicit Font(std::shared_ptr<DynamicFontAtlas> atlas); // Rasterizes glyphs at runtime as they're needed, see DynamicFontAtlas
 
 		static std::unique_ptr<Font> loadResource(ResourceLoader& loader);
 		constexpr static AssetType getAssetType() { return AssetType::Font; }
@@ -50,7 +50,16 @@ namespace Halley
 
 		std::pair<const Glyph&, const Font&> getGlyph(int code) const;
 		const Glyph& getGlyphHere(int code) const;
+		const Glyph* tryGetGlyphHere(int code) const;
 		const Font& getFontForGlyph(int code) const;
+		bool hasGlyph(int code) const; // Including fallbacks
+
+		// Fraction of characters that can be drawn with this font (or its fallbacks), and the ones that can't
+		// Use with I18N::getCharacters to check whether a font covers a localisation
+		float getCoverage(gsl::span<const int> characters) const;
+		Vector<int> getMissingCharacters(gsl::span<const int> characters) const;
+
+		Vector2f getKerning(int left, int right) const;
 		float getLineHeightAtSize(float size) const;
 		float getAscenderDistance() const;
 		float getHeight() const;
@@ -63,8 +72,15 @@ namespace Halley
 		bool shouldFloorGlyphPosition() const;
 
 		void addGlyph(const Glyph& glyph);
+		void removeGlyph(int code);
+
+		// For fonts made from a DynamicFontAtlas. Call once a frame, from the main thread, to add the glyphs rasterized since the last call.
+		// Text using this font is reshaped when it changes.
+		DynamicFontAtlas* getDynamicAtlas() const;
+		bool updateDynamicGlyphs();
 
-		std::shared_ptr<Material> getMaterial() const;
+		const std::shared_ptr<Material>& getMaterial() const;
+		void setMaterial(std::shared_ptr<Material> material); // Only needed for fonts that weren't loaded from assets
 
 		void serialize(Serializer& deserializer) const;
 		void deserialize(Deserializer& deserializer);
@@ -85,8 +101,22 @@ namespace Halley
 		Vector<String> fallback;
 		bool floorGlyphPosition;
 
+		struct KerningPair {
+			int32_t left;
+			int32_t right;
+			Vector2f kerning;
+
+			bool operator<(const KerningPair& other) const;
+		};
+
 		std::shared_ptr<Material> material;
-		HashMap<int, Glyph> glyphs;
+		std::shared_ptr<DynamicFontAtlas> dynamicAtlas;
+		Vector<Glyph> glyphs; // Sorted by charcode
+		Vector<uint32_t> glyphTable; // Index + 1 into glyphs for each charcode below glyphTableLimit, 0 if absent
+		Vector<KerningPair> kerning; // Sorted by left, then right
+
+		void takeKerning(Glyph& glyph);
+		void updateGlyphTable();
 	};
 	
 }
@@ -104,12 +104,14 @@ namespace Halley
 		TextRenderer clone() const;
 
 		void generateSprites() const;
+		gsl::span<const Sprite> getSprites() const;
 		void draw(Painter& painter, const std::optional<Rect4f>& extClip = {}) const;
 
 		void setSpriteFilter(SpriteFilter f);
 
 		Vector2f getExtents() const;
 		Vector2f getExtents(const StringUTF32& str) const;
+		Vector2f getExtents(const String& str) const;
 		Vector2f getCharacterPosition(size_t character) const;
 		size_t getCharacterAt(const Vector2f& position) const;
 
@@ -135,6 +137,14 @@ namespace Halley
 
 		bool isCompatibleWith(const TextRenderer& other) const; // Can be drawn as part of the same draw call
 
+		// Lays out and generates the sprites of many renderers at once, spread over the CPU executors
+		// Call this during update, so that drawing them only has to consume the prebuilt sprites
+		// A renderer must not appear more than once per batch, nor be modified by anything else while it runs
+		// Batches smaller than minParallelBatchSize are generated serially, as scheduling them costs more than it saves
+		static constexpr size_t minParallelBatchSize = 256;
+		static void generateSprites(gsl::span<const TextRenderer> renderers);
+		static void generateSprites(gsl::span<const TextRenderer* const> renderers);
+
 	private:
 		struct GlyphLayout {
 			Vector2f pos;
@@ -145,6 +155,19 @@ namespace Halley
 			float ascender;
 		};
 
+		// A character with its glyph, font and metrics resolved, so layout, extents, splitting and sprite generation don't need to look them up again
+		struct ShapedGlyph {
+			const Font* font;
+			Rect4f area;
+			Vector2f size;
+			Vector2f offset; // From the pen position, including bearing and kerning
+			float advance;
+			float scale;
+			float lineHeight;
+			float ascender;
+			char32_t c;
+		};
+
 		std::shared_ptr<const Font> font;
 		mutable HashMap<const Font*, std::shared_ptr<Material>> materials;
 		StringUTF32 text;
@@ -172,15 +195,18 @@ namespace Halley
 		Vector<FontOverride> fontOverrides;
 		Vector<FontSizeOverride> fontSizeOverrides;
 
+		mutable Vector<ShapedGlyph> shapeCache;
 		mutable Vector<GlyphLayout> layoutCache;
 		mutable Vector<Sprite> spritesCache;
 		mutable bool materialDirty = true;
+		mutable bool shapeDirty = true;
 		mutable bool glyphsDirty = true;
 		mutable bool layoutDirty = true;
 		mutable bool positionDirty = true;
 		mutable bool hasExtents = false;
 
 		mutable Vector2f extents;
+		mutable int shapedFontVersion = -1;
 
 		const std::shared_ptr<Material>& getMaterial(const Font& font) const;
 		void updateMaterial(Material& material, const Font& font) const;
@@ -189,12 +215,18 @@ namespace Halley
 		float getScale(const Font& font) const;
 		float getScale(const Font& font, float size) const;
 
+		void markShapeDirty() const;
 		void markLayoutDirty() const;
 		void markSpritesDirty() const;
 
+		void shapeIfNeeded() const;
 		void generateLayoutIfNeeded() const;
 		void generateGlyphsIfNeeded() const;
-		void generateLayout(const StringUTF32& text, Vector<GlyphLayout>* layouts, Vector2f& extents) const;
+		template <typename Iter>
+		void shape(Iter begin, size_t n, const Vector<FontOverride>& fontOverrides, const Vector<FontSizeOverride>& fontSizeOverrides, Vector<ShapedGlyph>& result) const;
+		void generateLayout(const Vector<ShapedGlyph>& glyphs, Vector<GlyphLayout>* layouts, Vector2f& extents) const;
+		template <typename Iter>
+		StringUTF32 doSplit(Iter begin, Iter end, const Vector<ShapedGlyph>& glyphs, float maxWidth, const std::function<bool(int32_t)>& filter) const;
 		void generateSprites(Vector<Sprite>& sprites, const Vector<GlyphLayout>& layouts) const;
 		static size_t getGlyphCount(const StringUTF32& text);
 	};
@@ -44,6 +44,7 @@ namespace Halley {} // Get GitHub to realise this is C++ :3
 #include "halley/graphics/render_target/render_target_screen.h"
 #include "halley/graphics/render_target/render_target_texture.h"
 
+#include "halley/graphics/text/dynamic_font_atlas.h"
 #include "halley/graphics/text/font.h"
 #include "halley/graphics/text/text_renderer.h"
 
@@ -68,6 +69,7 @@ namespace Halley {} // Get GitHub to realise this is C++ :3
 
 #include "halley/resources/asset_database.h"
 #include "halley/resources/asset_pack.h"
+#include "halley/resources/asset_pack_index.h"
 #include "halley/resources/resources.h"
 #include "halley/resources/resource_locator.h"
 #include "halley/resources/resource_reference.h"
@@ -18,6 +18,8 @@ namespace Halley {} // Get GitHub to realise this is C++ :3
 #include "data_structures/bin_pack.h"
 #include "data_structures/config_database.h"
 #include "data_structures/config_node.h"
+#include "data_structures/config_node_arena.h"
+#include "data_structures/config_node_view.h"
 #include "data_structures/dynamic_grid.h"
 #include "data_structures/hash_map.h"
 #include "data_structures/mapped_pool.h"
@@ -41,6 +43,7 @@ namespace Halley {} // Get GitHub to realise this is C++ :3
 
 #include "file_formats/binary_file.h"
 #include "file_formats/config_file.h"
+#include "file_formats/hlif_file.h"
 #include "file_formats/image.h"
 #include "file_formats/ini_reader.h"
 #include "file_formats/json_file.h"
@@ -100,6 +103,7 @@ namespace Halley {} // Get GitHub to realise this is C++ :3
 #include "support/redirect_stream.h"
 #include "support/profiler.h"
 
+#include "text/atom.h"
 #include "text/encode.h"
 #include "text/fuzzy_text_matcher.h"
 #include "text/halleystring.h"
@@ -41,9 +41,10 @@ namespace Halley {
 		Random(gsl::span<const gsl::byte> data, bool threadSafe = false);
 		~Random();
 
-		Random(const Random& other) = delete;
+		// Copies carry on from the same point in the sequence as the original, independently of it
+		Random(const Random& other);
 		Random(Random&& other) noexcept;
-		Random& operator=(const Random& other) = delete;
+		Random& operator=(const Random& other);
 		Random& operator=(Random&& other) noexcept;
 
 		// NOTE THAT THIS IS INCLUSIVE ON MAX FOR INTEGER TYPES ONLY
@@ -101,7 +102,7 @@ namespace Halley {
 		std::unique_ptr<MT199937AR> generator;
 		bool canSeed = true;
 		bool threadSafe = false;
-		std::mutex mutex;
+		mutable std::mutex mutex;
 
 		uint32_t getRawIntUnsafe();
 	};
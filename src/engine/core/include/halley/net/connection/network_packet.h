@@ -2,6 +2,7 @@
 #include "halley/data_structures/vector.h"
 #include <gsl/gsl>
 #include "halley/utils/utils.h"
+#include "halley/bytes/byte_serializer.h"
 
 namespace Halley
 {
@@ -20,16 +21,27 @@ namespace Halley
 		NetworkPacketBase(gsl::span<const gsl::byte> data, size_t prePadding);
 
 		size_t dataStart;
-		Vector<gsl::byte> data;
+		Bytes data;
 	};
 
 	class OutboundNetworkPacket : public NetworkPacketBase
 	{
 	public:
+		constexpr static size_t headerSpace = 128;
+
 		OutboundNetworkPacket(const OutboundNetworkPacket& other);
 		OutboundNetworkPacket(OutboundNetworkPacket&& other) noexcept;
 		explicit OutboundNetworkPacket(gsl::span<const gsl::byte> data);
 		explicit OutboundNetworkPacket(const Bytes& data);
+		OutboundNetworkPacket(Bytes data, size_t dataStart); // Takes ownership of data, the first dataStart bytes are free for headers
+		~OutboundNetworkPacket();
+
+		// Serializes straight into the packet's buffer, which goes back to SerializerBufferPool once the packet is gone
+		template <typename T>
+		static OutboundNetworkPacket fromSerialized(const T& value, SerializerOptions options = {})
+		{
+			return OutboundNetworkPacket(Serializer::toPooledBytes(value, std::move(options), headerSpace), headerSpace);
+		}
 		
 		void addHeader(gsl::span<const gsl::byte> src);
 
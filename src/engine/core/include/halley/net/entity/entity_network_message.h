@@ -51,10 +51,11 @@ namespace Halley {
 	class EntityNetworkMessageUpdate final : public IEntityNetworkMessage {
 	public:
         EntityNetworkId entityId;
-        Bytes bytes;
+        Bytes bytes; // EntityDataDelta, empty if unchanged
+        Bytes componentDeltas; // Binary deltas for networkDelta components, empty if unchanged
 
         EntityNetworkMessageUpdate() = default;
-		EntityNetworkMessageUpdate(EntityNetworkId id, Bytes bytes) : entityId(id), bytes(std::move(bytes)) {}
+		EntityNetworkMessageUpdate(EntityNetworkId id, Bytes bytes, Bytes componentDeltas = {}) : entityId(id), bytes(std::move(bytes)), componentDeltas(std::move(componentDeltas)) {}
 
 		EntityNetworkHeaderType getType() const override { return EntityNetworkHeaderType::Update; }
         bool needsWorld() const override { return true; }
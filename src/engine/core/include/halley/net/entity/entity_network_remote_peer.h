@@ -45,7 +45,9 @@ namespace Halley {
             bool alive = true;
             Time timeSinceSend = 0;
             EntityNetworkId networkId = 0;
-            EntityData data;
+            EntityData data; // Excludes components in deltaSnapshots
+            HashMap<int, std::shared_ptr<Component>> deltaSnapshots; // Last sent state of components using binary deltas, by component id
+            std::optional<uint64_t> changeRevision; // Entity change revision when data was last brought fully up to date
         };
 
         class InboundEntity {
@@ -72,12 +74,15 @@ namespace Halley {
         void sendCreateEntity(EntityRef entity);
         void sendUpdateEntity(Time t, OutboundEntity& remote, EntityRef entity);
         void sendDestroyEntity(OutboundEntity& remote);
+        void startComponentDeltas(OutboundEntity& remote, EntityRef entity);
+        Bytes serializeComponentDeltas(OutboundEntity& remote, EntityRef entity);
         void sendKeepAlive();
         void send(EntityNetworkMessage message);
 
         void receiveCreateEntity(const EntityNetworkMessageCreate& msg);
         void receiveUpdateEntity(const EntityNetworkMessageUpdate& msg);
         void receiveDestroyEntity(const EntityNetworkMessageDestroy& msg);
+        void applyComponentDeltas(EntityRef entity, const Bytes& bytes);
 
         void destroyRemoteEntity(EntityId id);
 
@@ -39,6 +39,10 @@ namespace Halley {
 			virtual ConfigNode getServerSideData(String uniqueKey) = 0;
 		};
 
+		// Version of the engine's own wire format (e.g. entity updates), checked on join on top of the game's networkVersion
+		// 1: entity updates carry binary component deltas
+		static constexpr uint32_t engineNetworkVersion = 1;
+
 		NetworkSession(NetworkService& service, uint32_t networkVersion, String userName, ISharedDataHandler* sharedDataHandler = nullptr);
 		virtual ~NetworkSession();
 
@@ -22,6 +22,7 @@ namespace Halley {
 	struct ControlMsgJoin {
 		uint32_t networkVersion;
 		String userName;
+		uint32_t engineNetworkVersion = 0; // Absent (0) from peers predating it
 
 		void serialize(Serializer& s) const;
 		void deserialize(Deserializer& s);
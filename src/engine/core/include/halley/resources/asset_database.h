@@ -53,6 +53,7 @@ namespace Halley
 		void addAsset(const String& name, AssetType type, Entry&& entry);
 		const TypedDB& getDatabase(AssetType type) const;
 		bool hasDatabase(AssetType type) const;
+		Vector<AssetType> getTypes() const;
 		Vector<String> getAssets() const;
 
 		void serialize(Serializer& s) const;
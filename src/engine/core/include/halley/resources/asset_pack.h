@@ -11,6 +11,8 @@ namespace Halley {
 	class Deserializer;
 	class Serializer;
 	class AssetDatabase;
+	class AssetPackIndex;
+	class Metadata;
 	class ResourceData;
 	class ResourceDataReader;
 
@@ -20,7 +22,8 @@ namespace Halley {
 		uint64_t assetDbStartPos;
 		uint64_t dataStartPos;
 
-		void init(size_t assetDbSize);
+		void init(size_t assetDbSize, size_t indexSize = 0);
+		bool hasIndex() const;
 	};
 
     class AssetPack {
@@ -43,6 +46,9 @@ namespace Halley {
 
 		std::unique_ptr<ResourceData> getData(const String& asset, AssetType type, bool stream);
 
+		const AssetPackIndex* getIndex() const;
+		const Metadata* getMetadata(const String& asset, AssetType type) const;
+
 		void readToMemory();
 		void encrypt(Encrypt::AESKey key);
 		void decrypt(Encrypt::AESKey key);
@@ -56,7 +62,11 @@ namespace Halley {
 		size_t getMemoryUsage() const;
 
     private:
-		std::unique_ptr<AssetDatabase> assetDb;
+		mutable std::unique_ptr<AssetDatabase> assetDb;
+		mutable std::mutex assetDbMutex;
+		std::unique_ptr<AssetPackIndex> index;
+		mutable Vector<std::unique_ptr<Metadata>> indexMetadata;
+		mutable std::mutex indexMetadataMutex;
 		std::unique_ptr<ResourceDataReader> reader;
 		std::atomic<bool> hasReader;
 		std::mutex readerMutex;
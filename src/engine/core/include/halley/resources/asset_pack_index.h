@@ -0,0 +1,74 @@
+#pragma once
+
+#include "halley/utils/utils.h"
+#include "halley/text/halleystring.h"
+#include "halley/data_structures/vector.h"
+#include <gsl/span>
+#include <optional>
+
+namespace Halley {
+	enum class AssetType;
+	class AssetDatabase;
+
+	// Flat, position-independent index of every asset in a pack.
+	// Lookups use a minimal perfect hash (hash-and-displace) over (type, name), and are performed directly
+	// against the binary image, so opening a pack doesn't need to deserialize or build any maps.
+	// The image is uncompressed and only uses offsets, so it can be read in place from a memory-mapped file.
+	class AssetPackIndex {
+	public:
+		constexpr static uint32_t currentVersion = 1;
+
+		struct Header {
+			std::array<char, 4> identifier;
+			uint32_t version;
+			uint32_t numEntries;
+			uint32_t numBuckets;
+			uint32_t bucketsOffset;
+			uint32_t entriesOffset;
+			uint32_t blobOffset;
+			uint32_t totalSize;
+		};
+
+		struct Entry {
+			uint64_t hash;
+			uint64_t dataPos;
+			uint64_t dataSize;
+			uint32_t nameOffset;
+			uint32_t nameLength;
+			uint32_t metadataOffset;
+			uint32_t metadataSize;
+			int32_t type;
+			uint32_t padding;
+		};
+
+		AssetPackIndex() = default;
+		explicit AssetPackIndex(Bytes data);
+
+		static Bytes build(const AssetDatabase& db);
+
+		bool isValid() const;
+		size_t size() const;
+
+		const Entry* find(AssetType type, std::string_view name) const;
+		const Entry& getEntry(size_t idx) const;
+		AssetType getType(const Entry& entry) const;
+		std::string_view getName(const Entry& entry) const;
+		gsl::span<const gsl::byte> getMetadataBytes(const Entry& entry) const;
+		size_t getEntryIndex(const Entry& entry) const;
+
+		Vector<String> enumerate(AssetType type) const;
+		std::unique_ptr<AssetDatabase> makeAssetDatabase() const;
+
+		size_t getMemoryUsage() const;
+
+	private:
+		Bytes data;
+		const Header* header = nullptr;
+		const uint32_t* buckets = nullptr;
+		const Entry* entries = nullptr;
+		const char* blob = nullptr;
+
+		static uint64_t hashKey(AssetType type, std::string_view name);
+		static uint32_t getSlot(uint64_t hash, uint32_t displacement, uint32_t numSlots);
+	};
+}
@@ -35,12 +35,16 @@ namespace Halley {
 	class ResourceData;
 	class SystemAPI;
 	class AssetDatabase;
+	class AssetPackIndex;
 
 	class IResourceLocatorProvider {
 	public:
 		virtual ~IResourceLocatorProvider() {}
 		virtual std::unique_ptr<ResourceData> getData(const String& path, AssetType type, bool stream) = 0;
 		virtual const AssetDatabase& getAssetDatabase() = 0;
+		virtual const AssetPackIndex* getAssetIndex() { return nullptr; }
+		virtual const Metadata* getMetaData(const String& asset, AssetType type);
+		virtual Vector<String> enumerate(AssetType type);
 		virtual int getPriority() const { return 0; }
 		virtual void purgeAll(SystemAPI& system) = 0;
 		virtual bool purgeIfAffected(SystemAPI& system, gsl::span<const String> assetIds, gsl::span<const String> packIds) = 0;
@@ -76,12 +80,15 @@ namespace Halley {
 		SystemAPI& system;
 		HashMap<String, IResourceLocatorProvider*> locatorPaths;
 		HashMap<String, IResourceLocatorProvider*> assetToLocator;
+		Vector<IResourceLocatorProvider*> indexedLocators;
 		Vector<std::unique_ptr<IResourceLocatorProvider>> locators;
 		static const Metadata dummyMetadata;
 
 		void add(std::unique_ptr<IResourceLocatorProvider> locator, const Path& path);
 
 		std::unique_ptr<ResourceData> getResource(const String& asset, AssetType type, bool stream, bool throwOnFail) const;
+		IResourceLocatorProvider* findLocator(const String& asset, AssetType type) const;
+		bool isAddedBefore(const IResourceLocatorProvider& a, const IResourceLocatorProvider& b) const;
 		void loadLocatorData(IResourceLocatorProvider& locator);
 	};
 }
@@ -74,6 +74,15 @@ namespace Halley {
 
     	virtual void update(Time time, ScriptState& graphState, EntityId curEntity, ScriptVariables& entityVariables);
 
+        // Workers update entity-local scripts (see ScriptGraph::isEntityLocal) in parallel, one worker per thread.
+        // prepareWorker() must be called before each parallel update, and mergeWorker() after it, always in the same worker order,
+        // so that anything the workers queued up gets sent in a deterministic order.
+        // The default worker is a plain ScriptEnvironment, which is all the engine's entity-local nodes need. Subclasses whose
+        // overrides those nodes rely on should return a new instance of themselves instead, or null to keep every script on the main thread.
+        virtual std::unique_ptr<ScriptEnvironment> makeWorker() const;
+        void prepareWorker(ScriptEnvironment& worker) const;
+        void mergeWorker(ScriptEnvironment& worker);
+
     	void stopState(ScriptState& graphState, EntityId curEntity, ScriptVariables& entityVariables, bool allThreads);
     	void terminateState(ScriptState& graphState, EntityId curEntity, ScriptVariables& entityVariables);
 		ConfigNode readNodeElementDevConData(ScriptState& graphState, EntityId curEntity, ScriptVariables& entityVariables, GraphNodeId nodeId, GraphPinId pinId);
@@ -84,6 +93,9 @@ namespace Halley {
         IScriptStateData* getNodeData(GraphNodeId nodeId);
         void assignTypes(const ScriptGraph& graph);
 
+        // Data pins are evaluated through the graph's ScriptProgram where possible; disabling it reads every node through its type
+        void setCompiledExpressionsEnabled(bool enabled);
+
     	ConfigNode readInputDataPin(const ScriptGraphNode& node, GraphPinId pinN);
         ConfigNode readOutputDataPin(const ScriptGraphNode& node, GraphPinId pinN);
         EntityId readInputEntityId(const ScriptGraphNode& node, GraphPinId pinN, bool disconnectedIsSelf);
@@ -97,7 +109,7 @@ namespace Halley {
         const ScriptVariables& getVariables(ScriptVariableScope scope) const;
         const ScriptVariables& getEntityVariables(EntityId entityId) const;
 
-        void setEntityVariable(EntityId entityId, const String& name, ConfigNode data) const;
+        void setEntityVariable(EntityId entityId, const Atom& name, ConfigNode data) const;
         void setVariableTable(const VariableTable& variableTable);
         const VariableTable* getVariableTable() const;
 
@@ -174,6 +186,8 @@ namespace Halley {
     	std::shared_ptr<ScriptNodeTypeCollection> nodeTypeCollection;
         bool isHost = false;
         bool inputEnabled = true;
+        bool compiledExpressionsEnabled = true;
+        bool isWorker = false;
 
         GraphPinId currentInputPin = 0;
     	const ScriptGraph* currentGraph = nullptr;
@@ -3,6 +3,8 @@
 #include "halley/entity/entity_id.h"
 #include "halley/bytes/config_node_serializer.h"
 #include "halley/graph/base_graph.h"
+#include "halley/scripting/script_program.h"
+#include "halley/text/atom.h"
 
 namespace Halley {
 	class GraphNodeTypeCollection;
@@ -13,6 +15,18 @@ namespace Halley {
 
 	class ScriptGraphNode final : public BaseGraphNode {
 	public:
+		// Resolved once, when the node type is assigned, so evaluation doesn't have to re-parse settings or pin configurations
+		struct Compiled {
+			Atom variable; // Variable name, for nodes that access variables
+			int mode = 0; // Enum setting, e.g. scope or operator
+			ConfigNode constant; // Value, for nodes that evaluate to a constant
+
+			std::array<GraphPinId, 8> flowOutputPins;
+			uint8_t nFlowOutputs = 0;
+			bool entityLocal = false;
+			bool valid = false;
+		};
+
 		ScriptGraphNode();
 		ScriptGraphNode(String type, Vector2f position);
 		ScriptGraphNode(const ConfigNode& node);
@@ -27,6 +41,7 @@ namespace Halley {
 		void clearType() const override;
 		const IGraphNodeType& getGraphNodeType() const override;
 		const IScriptNodeType& getNodeType() const;
+		const Compiled& getCompiled() const { return compiled; }
 
 		OptionalLite<GraphNodeId> getParentNode() const { return parentNode; }
 		void setParentNode(OptionalLite<GraphNodeId> id) { parentNode = id; }
@@ -37,6 +52,7 @@ namespace Halley {
 
 	private:
 		mutable const IScriptNodeType* nodeType = nullptr;
+		mutable Compiled compiled;
 		OptionalLite<GraphNodeId> parentNode;
 	};
 
@@ -132,6 +148,15 @@ namespace Halley {
 
 		const ScriptGraph* getPreviousVersion(uint64_t hash) const;
 
+		// True if every node is entity-local (see IScriptNodeType::isEntityLocal), so its states can be updated off the main thread
+		bool isEntityLocal(const ScriptNodeTypeCollection& nodeTypeCollection) const;
+
+		// Data pins lowered when types are assigned, see ScriptProgram
+		const ScriptProgram& getProgram() const;
+
+	protected:
+		void onTypesAssigned() const override;
+
 	private:
 		Vector<std::pair<GraphNodeId, GraphNodeId>> callerToCallee;
 		Vector<std::pair<GraphNodeId, GraphNodeId>> returnToCaller;
@@ -143,6 +168,11 @@ namespace Halley {
 
 		std::shared_ptr<ScriptGraph> previousVersion;
 
+		mutable std::optional<uint64_t> entityLocalHash;
+		mutable bool entityLocal = false;
+
+		mutable ScriptProgram program;
+
 		GraphNodeId findNodeRoot(GraphNodeId nodeId) const;
 		void generateRoots();
 		[[nodiscard]] bool isMultiConnection(GraphNodePinType pinType) const override;
@@ -3,6 +3,7 @@
 #include "script_graph.h"
 #include "script_state.h"
 #include "script_node_enums.h"
+#include "script_program.h"
 #include "halley/graph/base_graph_type.h"
 #include "halley/graphics/text/text_renderer.h"
 #include "halley/time/halleytime.h"
@@ -42,6 +43,14 @@ namespace Halley {
 		virtual bool hasDestructor(const ScriptGraphNode& node) const { return false; }
 		virtual bool showDestructor() const { return true; }
 
+		virtual void compile(const ScriptGraphNode& node, ScriptGraphNode::Compiled& compiled) const {}
+		// Emits the code computing outputPin into builder, returning false if this node can't be lowered, so it's read through getData()
+		virtual bool lower(const ScriptGraphNode& node, GraphPinId outputPin, ScriptProgram::Builder& builder) const { return false; }
+
+		// Entity-local nodes only touch the state of their own script and the variables of their own entity,
+		// and never mutate the world or send messages, so they're safe to run on a worker thread
+		virtual bool isEntityLocal(const ScriptGraphNode& node) const { return false; }
+
 		virtual std::unique_ptr<IScriptStateData> makeData() const { return {}; }
         virtual void initData(IScriptStateData& data, const ScriptGraphNode& node, const EntitySerializationContext& context, const ConfigNode& nodeData) const {}
 
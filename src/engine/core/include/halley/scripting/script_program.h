@@ -0,0 +1,105 @@
+#pragma once
+
+#include "halley/data_structures/vector.h"
+#include "halley/data_structures/config_node.h"
+#include "halley/graph/base_graph_enums.h"
+#include "halley/maths/ops.h"
+#include "halley/text/atom.h"
+
+namespace Halley {
+	class ScriptEnvironment;
+	class ScriptGraph;
+	class ScriptGraphNode;
+	enum class ScriptVariableScope;
+
+	// Data pins lowered into a flat instruction stream for a small stack machine.
+	// Nodes that know how to lower themselves (see IScriptNodeType::lower) are inlined into the expressions that read them,
+	// with their constants folded and their variables resolved into slots; anything else is read through its node type.
+	class ScriptProgram {
+	public:
+		enum class OpCode : uint8_t {
+			PushConstant, // arg = constant index
+			LoadVariable, // arg = slot index
+			ReadPin, // arg = node id, pin = output pin of that node
+			Arithmetic, // mode = MathOp
+			Compare // mode = MathRelOp
+		};
+
+		struct Instruction {
+			OpCode op;
+			uint8_t mode = 0;
+			GraphPinId pin = 0;
+			uint32_t arg = 0;
+		};
+
+		struct VariableSlot {
+			Atom name;
+			ScriptVariableScope scope;
+		};
+
+		constexpr static size_t maxStackSize = 8;
+		constexpr static size_t maxSlots = 8;
+
+		class Builder {
+		public:
+			Builder(const ScriptGraph& graph, ScriptProgram& program);
+
+			void emitInput(const ScriptGraphNode& node, GraphPinId inputPin);
+			void emitConstant(ConfigNode value);
+			void emitVariable(Atom name, ScriptVariableScope scope);
+			void emitArithmetic(MathOp op);
+			void emitComparison(MathRelOp op);
+
+			bool lowerOutput(const ScriptGraphNode& node, GraphPinId outputPin);
+
+		private:
+			struct Checkpoint {
+				size_t nInstructions;
+				size_t nConstants;
+				size_t nSlots;
+				size_t stackSize;
+			};
+
+			const ScriptGraph& graph;
+			ScriptProgram& program;
+			size_t firstSlot = 0;
+			size_t stackSize = 0;
+			size_t depth = 0;
+			bool failed = false;
+
+			Checkpoint makeCheckpoint() const;
+			void restore(const Checkpoint& checkpoint);
+			void emitReadPin(GraphNodeId nodeId, GraphPinId outputPin);
+			void push(Instruction instruction, int stackDelta);
+			bool lastInstructionsAreConstants(size_t n) const;
+			ConfigNode popConstant();
+		};
+
+		void compile(const ScriptGraph& graph);
+		void clear();
+
+		// Index of the expression computing that output pin, or -1 if it wasn't lowered
+		int getExpression(GraphNodeId nodeId, GraphPinId outputPin) const;
+		ConfigNode evaluate(int expression, ScriptEnvironment& environment) const;
+
+		size_t getNumExpressions() const { return expressions.size(); }
+		gsl::span<const Instruction> getInstructions(int expression) const;
+		gsl::span<const VariableSlot> getVariableSlots(int expression) const;
+
+	private:
+		struct Expression {
+			GraphNodeId node;
+			GraphPinId outputPin;
+			uint32_t start;
+			uint32_t length;
+			uint32_t firstSlot;
+			uint32_t nSlots;
+		};
+
+		Vector<Instruction> instructions;
+		Vector<ConfigNode> constants;
+		Vector<VariableSlot> slots;
+		Vector<Expression> expressions;
+		Vector<int> nodeExpressions; // Indexed by node id, first expression of each node
+	};
+}
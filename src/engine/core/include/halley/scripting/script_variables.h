@@ -1,6 +1,7 @@
 #pragma once
 #include "halley/data_structures/config_node.h"
 #include "halley/bytes/config_node_serializer_base.h"
+#include "halley/text/atom.h"
 
 namespace Halley {
 	class EntitySerializationContext;
@@ -13,16 +14,23 @@ namespace Halley {
 		void load(const ConfigNode& node, const EntitySerializationContext& context);
 		ConfigNode toConfigNode(const EntitySerializationContext& context) const;
 
-		const ConfigNode& getVariable(const String& name) const;
-    	void setVariable(const String& name, ConfigNode value);
-		bool hasVariable(const String& name) const;
+		const ConfigNode& getVariable(std::string_view name) const;
+		const ConfigNode& getVariable(const Atom& name) const;
+    	void setVariable(std::string_view name, ConfigNode value);
+    	void setVariable(const Atom& name, ConfigNode value);
+		bool hasVariable(std::string_view name) const;
+		void eraseVariable(std::string_view name);
 
 		bool empty() const;
 		void clear();
 
 	private:
 		ConfigNode dummy;
-		HashMap<String, ConfigNode> variables;
+		HashMap<Atom, ConfigNode> variables;
+		HashMap<String, ConfigNode> uninternedVariables; // Names that weren't atoms when they were set (e.g. from save data or the network) stay strings
+
+		const ConfigNode* tryGetVariable(std::string_view name) const;
+		ConfigNode& getOrAddVariable(std::string_view name);
 	};
 
 	template <>
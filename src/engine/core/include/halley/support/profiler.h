@@ -7,6 +7,7 @@
 
 #include "halley/data_structures/hash_map.h"
 #include "halley/time/halleytime.h"
+#include <mutex>
 
 namespace Halley {
 	enum class ProfilerEventType : uint8_t {
@@ -46,7 +47,13 @@ namespace Halley {
 		Game,
 
         ExternalCode,
-        UserDefined
+        UserDefined,
+
+		CoreStartup,
+		WorldInit,
+		EntityInstantiate,
+		ResourcesOpenPack,
+		ExecutorTask
     };	
 
     class ProfilerData {
@@ -88,7 +95,7 @@ namespace Halley {
     	};
 
     	ProfilerData() = default;
-    	ProfilerData(TimePoint frameStartTime, TimePoint frameEndTime, Vector<Event> events);
+    	ProfilerData(TimePoint frameStartTime, TimePoint frameEndTime, Vector<Event> events, HashMap<std::thread::id, String> threadNames = {});
 
     	TimePoint getStartTime() const;
     	TimePoint getEndTime() const;
@@ -99,10 +106,14 @@ namespace Halley {
 
     	gsl::span<const ThreadInfo> getThreads() const;
 
+    	// Chrome trace-event format, can be opened in chrome://tracing or Perfetto
+    	String toChromeTrace() const;
+
     private:
     	TimePoint frameStartTime;
     	TimePoint frameEndTime;
     	Vector<Event> events;
+    	HashMap<std::thread::id, String> threadNames;
 
     	Vector<ThreadInfo> threads;
 
@@ -111,7 +122,13 @@ namespace Halley {
 	
     class ProfilerCapture {
     public:
-        using EventId = uint64_t;
+        // Events started while both boot tracing and frame recording are active are recorded in both
+        struct EventId {
+        	uint64_t frameId = 0;
+        	uint64_t bootId = 0; // 1-based index into the boot trace
+
+        	[[nodiscard]] bool isValid() const { return frameId != 0 || bootId != 0; }
+        };
     	
         ProfilerCapture(size_t maxEvents = 16384);
     	
@@ -130,6 +147,13 @@ namespace Halley {
 
     	Time getFrameTime() const;
 
+    	// Startup tracing records every event from every thread, regardless of frames, until the trace is ended
+    	void startBootTrace();
+    	ProfilerData endBootTrace();
+    	[[nodiscard]] bool isBootTracing() const;
+
+    	void setThreadName(String name);
+
     private:
     	enum class State {
     		Idle,
@@ -147,6 +171,16 @@ namespace Halley {
     	std::chrono::steady_clock::time_point frameEndTime;
 
     	Vector<ProfilerData::Event> events;
+
+    	std::atomic<bool> bootTracing;
+    	std::mutex bootMutex;
+    	std::chrono::steady_clock::time_point bootStartTime;
+    	Vector<ProfilerData::Event> bootEvents;
+
+    	mutable std::mutex threadNamesMutex;
+    	HashMap<std::thread::id, String> threadNames;
+
+    	HashMap<std::thread::id, String> getThreadNames() const;
     };
 
 	class ProfilerEvent {
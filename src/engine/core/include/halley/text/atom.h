@@ -0,0 +1,73 @@
+#pragma once
+
+#include <optional>
+#include <string_view>
+#include "halleystring.h"
+#include "halley/data_structures/hash_map.h"
+
+namespace Halley {
+	// An interned string. Every Atom with the same contents refers to the same entry in a global table, so comparing
+	// two atoms is a pointer comparison, and the hash is computed only once, when the string is first interned.
+	// Interning is lock-free, and entries are never freed, so atoms are cheap to copy and safe to share across threads.
+	// The hash matches std::hash<String>, which lets a HashMap keyed by Atom still be looked up with String or std::string_view.
+	// Constructing an Atom interns its string for the lifetime of the process, so strings that come from outside (e.g. the
+	// network or the console) should only be looked up, with tryFind() or a heterogeneous lookup, never turned into atoms.
+	class Atom {
+	public:
+		Atom() = default;
+		explicit Atom(std::string_view str);
+		explicit Atom(const String& str) : Atom(std::string_view(str)) {}
+		explicit Atom(const char* str) : Atom(std::string_view(str)) {}
+
+		static std::optional<Atom> tryFind(std::string_view str); // The atom for str if it has already been interned, without interning it
+
+		const String& getString() const { return entry ? entry->str : String::emptyString(); }
+		std::string_view getView() const { return entry ? entry->view : std::string_view(); }
+		operator std::string_view() const { return getView(); }
+
+		size_t getHash() const { return entry ? entry->hash : std::hash<std::string_view>()({}); }
+		bool isEmpty() const { return entry == nullptr; }
+
+		bool operator==(const Atom& other) const { return entry == other.entry; }
+		bool operator!=(const Atom& other) const { return entry != other.entry; }
+		bool operator<(const Atom& other) const { return entry != other.entry && getView() < other.getView(); }
+
+		static size_t getInternedCount();
+
+	private:
+		struct Entry {
+			size_t hash;
+			std::string_view view; // Into str, so comparisons don't go through String
+			String str;
+			const Entry* next;
+		};
+
+		const Entry* entry = nullptr; // Empty string
+
+		static const Entry* find(size_t hash, std::string_view str, const Entry* from, const Entry* until);
+	};
+
+	struct AtomEqualTo {
+		using is_transparent = void;
+
+		bool operator()(const Atom& a, const Atom& b) const { return a == b; }
+		bool operator()(std::string_view a, const Atom& b) const { return a == b.getView(); }
+		bool operator()(const Atom& a, std::string_view b) const { return a.getView() == b; }
+	};
+
+	template <>
+	struct EqualToPicker<Atom> {
+		using type = AtomEqualTo;
+	};
+}
+
+namespace std {
+	template<>
+	struct hash<Halley::Atom>
+	{
+		using is_transparent = void;
+
+		size_t operator()(const Halley::Atom& a) const noexcept { return a.getHash(); }
+		size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>()(s); }
+	};
+}
@@ -28,6 +28,7 @@
 #include <gsl/span>
 #include <cstdint>
 #include <limits>
+#include <algorithm>
 
 namespace Halley {
 
@@ -37,6 +38,8 @@ namespace Halley {
 	typedef std::wstring StringUTF16;
 	typedef std::u32string StringUTF32;
 
+	class UTF8CodePoints;
+
 	// String class
 	class String {
 	public:
@@ -147,6 +150,7 @@ namespace Halley {
 		StringUTF32 getUTF32() const;
 		size_t getUTF32Len() const;
 		static size_t getUTF32Len(std::string_view str);
+		UTF8CodePoints getCodePoints() const; // Iterates the UTF-32 code points without allocating
 
 		// Static unicode routines
 		static size_t getUTF8Len(const wchar_t *utf16);
@@ -235,6 +239,92 @@ namespace Halley {
 	bool operator== (const std::basic_string_view<char32_t>& lhp, const StringUTF32& rhp);
 
 	using StringArray = Vector<String>;
+
+	// Decodes UTF-8 one code point at a time, with the same results as String::getUTF32()
+	class UTF8CodePointIterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = char32_t;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const char32_t*;
+		using reference = char32_t;
+
+		UTF8CodePointIterator() = default;
+		UTF8CodePointIterator(const char* pos, const char* end) : pos(pos), end(end) {}
+
+		char32_t operator*() const
+		{
+			const auto byte = [&] (size_t i) { return static_cast<unsigned int>(static_cast<unsigned char>(pos[i])); };
+			const unsigned int c0 = byte(0);
+			const size_t len = getSequenceLength(c0);
+			if (len == 1) {
+				return (c0 >> 7) == 0 ? char32_t(c0) : char32_t(0);
+			}
+			if (len > size_t(end - pos)) {
+				return 0;
+			}
+			char32_t result = c0 & (0x7F >> len);
+			for (size_t i = 1; i < len; ++i) {
+				const unsigned int c = byte(i);
+				if ((c >> 6) != 0x02) {
+					return 0;
+				}
+				result = (result << 6) | (c & 0x3F);
+			}
+			return result;
+		}
+
+		UTF8CodePointIterator& operator++()
+		{
+			pos += std::min(getSequenceLength(static_cast<unsigned char>(*pos)), size_t(end - pos));
+			return *this;
+		}
+
+		UTF8CodePointIterator operator++(int)
+		{
+			auto prev = *this;
+			++*this;
+			return prev;
+		}
+
+		bool operator==(const UTF8CodePointIterator& other) const { return pos == other.pos; }
+		bool operator!=(const UTF8CodePointIterator& other) const { return pos != other.pos; }
+
+		const char* getPosition() const { return pos; }
+
+	private:
+		const char* pos = nullptr;
+		const char* end = nullptr;
+
+		static size_t getSequenceLength(unsigned int c0)
+		{
+			if ((c0 >> 5) == 0x06) {
+				return 2;
+			} else if ((c0 >> 4) == 0x0E) {
+				return 3;
+			} else if ((c0 >> 3) == 0x1E) {
+				return 4;
+			}
+			return 1;
+		}
+	};
+
+	class UTF8CodePoints {
+	public:
+		explicit UTF8CodePoints(std::string_view str) : str(str) {}
+
+		UTF8CodePointIterator begin() const { return UTF8CodePointIterator(str.data(), str.data() + str.size()); }
+		UTF8CodePointIterator end() const { return UTF8CodePointIterator(str.data() + str.size(), str.data() + str.size()); }
+		size_t size() const { return String::getUTF32Len(str); } // Linear
+
+	private:
+		std::string_view str;
+	};
+
+	inline UTF8CodePoints String::getCodePoints() const
+	{
+		return UTF8CodePoints(str);
+	}
 }
 
 namespace std {
@@ -10,6 +10,7 @@
 
 namespace Halley {
 	class ConfigNode;
+	class ConfigNodeView;
 	class ConfigFile;
 	class ConfigObserver;
 	class I18N;
@@ -139,6 +140,11 @@ namespace Halley {
 		
 		char getDecimalSeparator() const;
 
+		// Sorted list of every character used by the strings of a language (or all languages, if none is given)
+		// Useful to pre-warm or validate fonts, see Font::getCoverage
+		Vector<int> getCharacters(const std::optional<I18NLanguage>& language = {}) const;
+		static Vector<int> getCharacters(const ConfigNode& stringTable, const Vector<I18NLanguage>& languages = {});
+
 	private:
 		I18NLanguage currentLanguage;
 		std::optional<I18NLanguage> fallbackLanguage;
@@ -146,7 +152,7 @@ namespace Halley {
 		std::map<String, ConfigObserver> observers;
 		int version = 0;
 
-		void loadLocalisation(const ConfigNode& node);
+		void loadLocalisation(const ConfigNodeView& node);
 	};
 }
 
@@ -51,3 +51,4 @@ namespace Halley {} // Get GitHub to realise this is C++ :3
 #include "widgets/ui_textinput.h"
 #include "widgets/ui_tooltip.h"
 #include "widgets/ui_tree_list.h"
+#include "widgets/ui_virtual_list.h"
@@ -7,11 +7,13 @@
 namespace Halley {
 	class Resources;
 	class ConfigNode;
+	class ConfigNodeView;
 
 	class UIColourScheme {
     public:
 		UIColourScheme();
         UIColourScheme(const ConfigNode& config, Resources& resources);
+        UIColourScheme(const ConfigNodeView& config, Resources& resources);
     	
 		const String& getName() const;
 		bool isEnabled() const;
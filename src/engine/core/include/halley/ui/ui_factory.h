@@ -193,6 +193,7 @@ namespace Halley
 		std::shared_ptr<UIWidget> makeDebugConsole(const ConfigNode& node);
 		std::shared_ptr<UIWidget> makeList(const ConfigNode& node);
 		std::shared_ptr<UIWidget> makeTreeList(const ConfigNode& node);
+		std::shared_ptr<UIWidget> makeVirtualList(const ConfigNode& node);
 		std::shared_ptr<UIWidget> makeRenderSurface(const ConfigNode& node);
 		std::shared_ptr<UIWidget> makeCustomPaint(const ConfigNode& node);
 		std::shared_ptr<UIWidget> makeResizeDivider(const ConfigNode& node);
@@ -225,6 +226,7 @@ namespace Halley
 		UIFactoryWidgetProperties getBaseListProperties() const;
 		UIFactoryWidgetProperties getListProperties() const;
 		UIFactoryWidgetProperties getTreeListProperties() const;
+		UIFactoryWidgetProperties getVirtualListProperties() const;
 		UIFactoryWidgetProperties getRenderSurfaceProperties() const;
 		UIFactoryWidgetProperties getCustomPaintProperties() const;
 		UIFactoryWidgetProperties getResizeDividerProperties() const;
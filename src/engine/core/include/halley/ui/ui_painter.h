@@ -8,6 +8,16 @@ namespace Halley {
 	class Sprite;
 	class SpritePainter;
 	class Painter;
+	class UIRenderCache;
+
+	struct UIRenderStats {
+		size_t widgetsDrawn = 0;
+		size_t widgetsReused = 0;
+		size_t subtreesRecorded = 0;
+		size_t subtreesReused = 0;
+
+		float getReuseRatio() const;
+	};
 
 	class UIPainter {
 	public:
@@ -34,6 +44,14 @@ namespace Halley {
 		std::optional<Rect4f> getClip() const;
 		int getMask() const;
 
+		void setStats(UIRenderStats* stats);
+		void notifyWidgetDrawn(bool hasRender);
+
+		[[nodiscard]] UIPainter startRecording(UIRenderCache& cache) const;
+		void endRecording(UIRenderCache& cache);
+		bool canReplay(const UIRenderCache& cache) const;
+		void replay(const UIRenderCache& cache);
+
 	private:
 		SpritePainter* painter = nullptr;
 		std::optional<Rect4f> clip;
@@ -42,10 +60,17 @@ namespace Halley {
 		std::optional<Colour4f> colourMultiplier;
 		mutable int currentPriority = 0;
 		const UIPainter* rootPainter = nullptr;
+		UIRenderCache* recorder = nullptr;
+		UIRenderStats* stats = nullptr;
 
 		float getCurrentPriorityAndIncrement() const;
 
 		[[nodiscard]] TextRenderer applyColour(TextRenderer text) const;
 		[[nodiscard]] Sprite applyColour(Sprite sprite) const;
+
+		void record(const Sprite& sprite) const;
+		void record(const TextRenderer& text) const;
+		void record(const std::function<void(Painter&)>& f) const;
+		void recordBounds(Rect4f bounds) const;
 	};
 }
@@ -36,6 +36,8 @@ namespace Halley {
 		bool isWaitingToSpawnChildren() const;
 
 		virtual void markAsNeedingLayout();
+		virtual void markAsNeedingLayout(const UIWidget& source);
+		virtual void markAsNeedingRedraw() {}
 		virtual void onChildrenAdded() {}
 		virtual void onChildrenRemoved() {}
 		virtual void onChildAdded(UIWidget& child) {}
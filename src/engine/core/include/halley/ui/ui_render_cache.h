@@ -0,0 +1,59 @@
+#pragma once
+
+#include <functional>
+#include <optional>
+#include "halley/data_structures/vector.h"
+#include "halley/graphics/sprite/sprite.h"
+#include "halley/graphics/text/text_renderer.h"
+#include "halley/maths/colour.h"
+#include "halley/maths/rect.h"
+#include "ui_painter.h"
+
+namespace Halley {
+	class Painter;
+
+	// Everything a widget subtree submitted to the UIPainter on the frame it was recorded
+	// As long as the subtree isn't marked as needing redraw, this is replayed instead of drawing the widgets again
+	class UIRenderCache {
+	public:
+		void clear();
+		bool isValid() const;
+		size_t getWidgetCount() const;
+
+	private:
+		friend class UIPainter;
+
+		enum class EntryType : uint8_t {
+			Sprite,
+			Text,
+			Callback,
+			Bounds
+		};
+
+		struct Entry {
+			EntryType type;
+			uint32_t idx;
+			int mask;
+			int layer;
+			std::optional<Rect4f> clip;
+		};
+
+		Vector<Entry> entries;
+		Vector<Sprite> sprites;
+		Vector<TextRenderer> texts;
+		Vector<std::function<void(Painter&)>> callbacks;
+		Vector<Rect4f> bounds;
+
+		// State of the painter the subtree was drawn with; replaying is only valid with the same state
+		std::optional<Rect4f> baseClip;
+		std::optional<Colour4f> baseColour;
+		int baseMask = 0;
+		int baseLayer = 0;
+
+		size_t widgetCount = 0;
+		bool valid = false;
+		bool replayable = true;
+
+		void append(const UIRenderCache& other);
+	};
+}
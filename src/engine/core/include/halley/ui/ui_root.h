@@ -4,6 +4,7 @@
 #include "ui_event.h"
 #include "ui_parent.h"
 #include "ui_input.h"
+#include "ui_painter.h"
 
 namespace Halley {
 	enum class JoystickType;
@@ -35,7 +36,18 @@ namespace Halley {
 		virtual ConfigNode getUISetting(std::string_view key) = 0;
 	};
 	
+	// How much work the incremental layout did on the last update, see UIRoot::setIncrementalLayout
+	struct UILayoutStats {
+		size_t widgetsMeasured = 0;
+		size_t widgetsArranged = 0;
+		size_t widgetsSkipped = 0;
+		size_t invalidations = 0;
+		String firstInvalidatedBy; // Id of the widget whose change caused the first layout invalidation
+	};
+
 	class UIRoot final : public UIParent {
+		friend class UIWidget;
+
 	public:
 		explicit UIRoot(const HalleyAPI& api, Rect4f rect = {});
 		~UIRoot();
@@ -51,9 +63,18 @@ namespace Halley {
 		void draw(SpritePainter& painter, int mask, int layer);
 		void prepareRender();
 		void render(RenderContext& rc);
+		const UIRenderStats& getRenderStats() const;
 
 		void mouseOverNext(bool forward = true);
 		void runLayout();
+
+		// When enabled (the default), layout only measures and arranges widgets along the paths that were marked as needing layout,
+		// and any widget whose rect didn't change keeps its previous layout
+		void setIncrementalLayout(bool enabled);
+		bool isIncrementalLayout() const;
+		const UILayoutStats& getLayoutStats() const;
+		void markAsNeedingLayout(const UIWidget& source) override;
+		using UIParent::markAsNeedingLayout;
 		
 		std::optional<std::shared_ptr<IAudioHandle>> playSound(const String& eventName);
 		void sendEvent(UIEvent event, bool includeSelf) const override;
@@ -123,6 +144,10 @@ namespace Halley {
 		UIInputType lastInputType = UIInputType::Keyboard;
 
 		Vector<std::shared_ptr<UIWidget>> widgetsCache;
+		UIRenderStats renderStats;
+		UILayoutStats layoutStats;
+		UILayoutStats lastLayoutStats;
+		bool incrementalLayout = true;
 
 		void updateWidgets(UIWidgetUpdateType type, Time t, UIInputType activeInputType, JoystickType joystickType);
 
@@ -21,6 +21,7 @@ namespace Halley {
 	class UIBehaviour;
 	class UIEventHandler;
 	class TextInputData;
+	class UIRenderCache;
 
 	enum class UIWidgetUpdateType {
 		First,
@@ -161,6 +162,7 @@ namespace Halley {
 		}
 
 		void setMouseClip(std::optional<Rect4f> mouseClip, bool force);
+		const std::optional<Rect4f>& getMouseClip() const;
 
 		virtual void onManualControlCycleValue(int delta);
 		virtual void onManualControlAnalogueAdjustValue(float delta, Time t);
@@ -168,6 +170,12 @@ namespace Halley {
 
 		UIGamepadInput::Priority getInputPriority() const;
 
+		// When enabled, whatever this widget and its children draw is recorded, and replayed on later frames until something marks it as needing redraw
+		// Layout, state changes and most widget setters do that already; call markAsNeedingRedraw() for any other visual change
+		void setRenderCached(bool enabled);
+		bool isRenderCached() const;
+		void markAsNeedingRedraw() override;
+
 		void setChildLayerAdjustment(int delta);
 		int getChildLayerAdjustment() const;
 		void setNoClipChildren(bool noClip);
@@ -185,6 +193,8 @@ namespace Halley {
 
 		bool needsLayout() const;
 		void markAsNeedingLayout() final override;
+		void markAsNeedingLayout(const UIWidget& source) final override;
+		void markAsNeedingArrange(); // Children must be placed again, but no sizes changed, so nothing is measured again
 
 		virtual bool canReceiveFocus() const;
 		virtual bool canReceiveMouseExclusive() const;
@@ -286,6 +296,9 @@ namespace Halley {
 		UIInputType lastInputType = UIInputType::Undefined;
 	private:
 		mutable int layoutNeeded = 1;
+		bool arrangeNeeded = true;
+		Vector2f arrangedOrigin;
+		Vector2f arrangedSize;
 		
 		Vector2f position;
 		Vector2f size;
@@ -305,6 +318,7 @@ namespace Halley {
 		Vector<std::shared_ptr<UIBehaviour>> behaviours;
 
 		std::unique_ptr<LocalisedString> toolTip;
+		std::unique_ptr<UIRenderCache> renderCache;
 
 		int childLayerAdjustment = 0;
 
@@ -323,6 +337,12 @@ namespace Halley {
 		bool canSendEvents = true;
 		bool dontClipChildren = false;
 		bool propagateMouseToChildren = true;
+		mutable bool redrawNeeded = true;
+		bool renderListNeeded = true;
+		bool renderListEmpty = false;
+
+		void doDrawWidget(UIPainter& painter) const;
+		bool isPlacedBySizer() const;
 	};
 
 	template <typename F>
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "../ui_widget.h"
+#include "../ui_style.h"
+#include "halley/data_structures/hash_map.h"
+#include "halley/graphics/sprite/sprite.h"
+#include "halley/maths/range.h"
+#include "ui_clickable.h"
+#include "ui_list.h"
+
+namespace Halley {
+	class UILabel;
+	class UIImage;
+	class UIVirtualListRow;
+
+	// Provides the rows of a UIVirtualList
+	// Rows are only queried while they're visible, so this can sit directly on top of whatever container holds the data
+	class IUIVirtualListSource {
+	public:
+		virtual ~IUIVirtualListSource() = default;
+
+		virtual size_t getCount() const = 0;
+		virtual String getId(size_t idx) const = 0;
+		virtual LocalisedString getLabel(size_t idx) const = 0;
+		virtual Sprite getIcon(size_t idx) const { return {}; }
+		virtual int getDepth(size_t idx) const { return 0; }
+		virtual bool isEnabled(size_t idx) const { return true; }
+
+		// Called while dragging rows, if drag is enabled on the list. Return false to refuse.
+		virtual bool swapItems(size_t idxA, size_t idxB) { return false; }
+	};
+
+	// A vertical list of fixed height rows, which only has widgets for the rows that are inside the clip area (e.g. of a UIScrollPane)
+	// Those widgets are recycled as the list scrolls, so this scales to lists with tens of thousands of entries, where UIList doesn't
+	// Selection is tracked by id, so it survives the source being reordered or refreshed
+	class UIVirtualList : public UIClickable {
+		friend class UIVirtualListRow;
+
+	public:
+		using SelectionMode = UIList::SelectionMode;
+
+		UIVirtualList(String id, UIStyle style, std::shared_ptr<IUIVirtualListSource> source = {});
+
+		void setSource(std::shared_ptr<IUIVirtualListSource> source);
+		const std::shared_ptr<IUIVirtualListSource>& getSource() const;
+
+		// Call this whenever the contents of the source change
+		void refresh();
+
+		size_t getCount() const;
+		float getRowHeight() const;
+		size_t getNumberOfRowWidgets() const;
+
+		bool setSelectedOption(int option, SelectionMode mode = SelectionMode::Normal);
+		bool setSelectedOptionId(const String& id, SelectionMode mode = SelectionMode::Normal);
+		int getSelectedOption() const;
+		String getSelectedOptionId() const;
+		Vector<int> getSelectedOptions() const;
+		Vector<String> getSelectedOptionIds() const;
+		bool isSelected(int option) const;
+		std::optional<int> getHoveredOption() const;
+
+		Rect4f getOptionRect(int option) const;
+		void showCurSelection(bool centre);
+
+		bool isMultiSelect() const;
+		void setMultiSelect(bool enabled);
+		bool isDragEnabled() const;
+		void setDragEnabled(bool drag);
+		void setSingleClickAccept(bool enabled);
+		void setScrollToSelection(bool value);
+		void setRequiresSelection(bool requireSelection);
+		void setAcceptKeyboardInput(bool value);
+
+		bool canReceiveFocus() const override;
+		Vector2f getLayoutMinimumSize(bool force) const override;
+
+		void onDoubleClicked(Vector2f mousePos, KeyMods keyMods) override;
+
+	protected:
+		void draw(UIPainter& painter) const override;
+		void update(Time t, bool moved) override;
+		void doSetState(State state) override;
+
+		void pressMouse(Vector2f mousePos, int button, KeyMods keyMods) override;
+		void releaseMouse(Vector2f mousePos, int button) override;
+		void onMouseOver(Vector2f mousePos) override;
+		void onMouseLeft(Vector2f mousePos) override;
+
+		void onGamepadInput(const UIInputResults& input, Time time) override;
+		bool onKeyPress(KeyboardKeyPress key) override;
+
+	private:
+		UIStyle style;
+		UIStyle itemStyle;
+		Sprite sprite;
+		std::shared_ptr<IUIVirtualListSource> source;
+
+		size_t count = 0;
+		float rowHeight = 0;
+		float gap = 0;
+		uint32_t revision = 0;
+
+		Vector<std::shared_ptr<UIVirtualListRow>> rows;
+		int firstVisible = 0;
+		int lastVisible = 0;
+
+		HashSet<String> selectedIds;
+		int curOption = -1;
+		String curOptionId;
+		int curHover = -1;
+
+		int heldOption = -1;
+		bool deferredSelect = false;
+		bool dragging = false;
+		Vector2f mouseStartPos;
+		KeyMods heldMods = KeyMods::None;
+
+		bool multiSelect = false;
+		bool dragEnabled = false;
+		bool singleClickAccept = true;
+		bool scrollToSelection = true;
+		bool requiresSelection = true;
+		bool acceptKeyboardInput = true;
+		bool firstUpdate = true;
+
+		float getStride() const;
+		std::optional<int> getOptionAt(Vector2f mousePos) const;
+		Range<int> getVisibleRange() const;
+		void updateRows();
+
+		bool changeSelection(int option, SelectionMode mode);
+		void moveSelection(int delta, KeyMods mods);
+		void notifyNewItemSelected();
+		void setHovered(int option);
+		void dragTo(int option);
+		void onAccept();
+		void onCancel();
+		SelectionMode getMode(KeyMods mods) const;
+	};
+
+	class UIVirtualListRow : public UIWidget {
+	public:
+		UIVirtualListRow(UIVirtualList& parent, UIStyle style);
+
+		void setData(int index, uint32_t revision);
+		void setState(bool selected, bool hovered);
+		int getIndex() const;
+
+	protected:
+		void draw(UIPainter& painter) const override;
+		void update(Time t, bool moved) override;
+
+	private:
+		UIVirtualList& parent;
+		UIStyle style;
+		Sprite sprite;
+		Vector4f baseBorder;
+		std::shared_ptr<UIImage> icon;
+		std::shared_ptr<UILabel> label;
+
+		int index = -1;
+		uint32_t revision = 0;
+		bool enabled = true;
+		bool selected = false;
+		bool hovered = false;
+
+		void updateSprite();
+	};
+}
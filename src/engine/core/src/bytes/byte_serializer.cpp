@@ -1,3 +1,5 @@
+#include <array>
+#include <atomic>
 #include <cstring>
 #include <string>
 #include "halley/bytes/byte_serializer.h"
@@ -13,15 +15,94 @@ SerializerState* ByteSerializationBase::setState(SerializerState* s)
 	return oldState;
 }
 
+namespace {
+	constexpr size_t maxPooledBuffers = 32;
+
+	struct PooledBufferSlot {
+		enum State : uint8_t {
+			Empty,
+			Busy,
+			Full
+		};
+
+		std::atomic<uint8_t> state = Empty;
+		Bytes buffer;
+	};
+
+	// Function-local, so serializing from another static's initializer can't find the pool not constructed yet
+	std::array<PooledBufferSlot, maxPooledBuffers>& getPooledBuffers()
+	{
+		static std::array<PooledBufferSlot, maxPooledBuffers> pooledBuffers;
+		return pooledBuffers;
+	}
+
+	bool tryClaim(PooledBufferSlot& slot, uint8_t from)
+	{
+		uint8_t expected = from;
+		return slot.state.load(std::memory_order_relaxed) == from && slot.state.compare_exchange_strong(expected, PooledBufferSlot::Busy, std::memory_order_acquire);
+	}
+}
+
+Bytes SerializerBufferPool::acquire()
+{
+	for (auto& slot: getPooledBuffers()) {
+		if (tryClaim(slot, PooledBufferSlot::Full)) {
+			auto buffer = std::move(slot.buffer);
+			slot.buffer = Bytes();
+			slot.state.store(PooledBufferSlot::Empty, std::memory_order_release);
+			return buffer;
+		}
+	}
+	return Bytes();
+}
+
+void SerializerBufferPool::release(Bytes buffer)
+{
+	if (buffer.capacity() == 0 || buffer.capacity() > maxPooledCapacity) {
+		return;
+	}
+
+	buffer.clear();
+	for (auto& slot: getPooledBuffers()) {
+		if (tryClaim(slot, PooledBufferSlot::Empty)) {
+			slot.buffer = std::move(buffer);
+			slot.state.store(PooledBufferSlot::Full, std::memory_order_release);
+			return;
+		}
+	}
+}
+
+void SerializerBufferPool::clear()
+{
+	for (auto& slot: getPooledBuffers()) {
+		if (tryClaim(slot, PooledBufferSlot::Full)) {
+			slot.buffer = Bytes();
+			slot.state.store(PooledBufferSlot::Empty, std::memory_order_release);
+		}
+	}
+}
+
+bool SerializerBufferPool::isTight(const Bytes& buffer)
+{
+	return buffer.capacity() <= buffer.size() * 2;
+}
+
 Serializer::Serializer(SerializerOptions options)
 	: ByteSerializationBase(std::move(options))
-	, dryRun(true)
+	, mode(Mode::DryRun)
 {}
 
 Serializer::Serializer(gsl::span<gsl::byte> dst, SerializerOptions options)
 	: ByteSerializationBase(std::move(options))
 	, dst(dst)
-	, dryRun(false)
+	, mode(Mode::Span)
+{}
+
+Serializer::Serializer(Bytes& dst, SerializerOptions options)
+	: ByteSerializationBase(std::move(options))
+	, buffer(&dst)
+	, bufferStart(dst.size())
+	, mode(Mode::Growable)
 {}
 
 Serializer& Serializer::operator<<(const std::string& str)
@@ -145,11 +226,16 @@ void Serializer::serializeVariableInteger(uint64_t val, std::optional<bool> sign
 
 void Serializer::copyBytes(const void* src, size_t srcSize)
 {
-	if (!dryRun) {
+	if (mode == Mode::Span) {
 		if (dst.size() - size < srcSize) {
 			throw Exception("Insufficient bytes to serialize data.", HalleyExceptions::Utils);
 		}
 		memcpy(dst.data() + size, src, srcSize);
+	} else if (mode == Mode::Growable) {
+		const size_t pos = bufferStart + size;
+		buffer->reserve(pos + srcSize);
+		buffer->resize_no_init(pos + srcSize);
+		memcpy(buffer->data() + pos, src, srcSize);
 	}
 	size += srcSize;
 }
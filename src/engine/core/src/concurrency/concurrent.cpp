@@ -22,6 +22,7 @@
 #include "halley/concurrency/concurrent.h"
 #include <thread>
 #include <sstream>
+#include <condition_variable>
 
 using namespace Halley;
 
@@ -30,3 +31,78 @@ using namespace Halley;
 static thread_local String threadName;
 #endif
 
+
+namespace {
+	struct ParallelForState {
+		std::function<void(size_t)> f;
+		size_t count = 0;
+		std::atomic<size_t> next{0};
+		std::atomic<size_t> done{0};
+
+		std::mutex mutex;
+		std::condition_variable condition;
+		std::exception_ptr exception;
+
+		void run()
+		{
+			size_t nDone = 0;
+			for (size_t i = next++; i < count; i = next++) {
+				try {
+					f(i);
+				} catch (...) {
+					std::unique_lock<std::mutex> lock(mutex);
+					if (!exception) {
+						exception = std::current_exception();
+					}
+				}
+				++nDone;
+			}
+
+			if (nDone > 0 && (done += nDone) == count) {
+				std::unique_lock<std::mutex> lock(mutex);
+				condition.notify_all();
+			}
+		}
+	};
+}
+
+void Concurrent::parallelFor(ExecutionQueue& e, size_t count, std::function<void(size_t)> f)
+{
+	const size_t nHelpers = std::min(count, std::min(size_t(8), e.threadCount())) - (count > 0 ? 1 : 0);
+	if (nHelpers == 0 || count <= 1) {
+		for (size_t i = 0; i < count; ++i) {
+			f(i);
+		}
+		return;
+	}
+
+	// Helpers that only get to run after all the work is done just find nothing left, so the state is shared with them
+	auto state = std::make_shared<ParallelForState>();
+	state->f = std::move(f);
+	state->count = count;
+	for (size_t i = 0; i < nHelpers; ++i) {
+		e.addToQueue([state] ()
+		{
+			state->run();
+		});
+	}
+
+	state->run();
+
+	std::unique_lock<std::mutex> lock(state->mutex);
+	state->condition.wait(lock, [&] () { return state->done == state->count; });
+	if (state->exception) {
+		std::rethrow_exception(state->exception);
+	}
+}
+
+void Concurrent::parallelFor(size_t count, std::function<void(size_t)> f)
+{
+	if (Executors::hasInstance()) {
+		parallelFor(Executors::getCPU(), count, std::move(f));
+	} else {
+		for (size_t i = 0; i < count; ++i) {
+			f(i);
+		}
+	}
+}
@@ -5,6 +5,7 @@
 #include "halley/game/game_platform.h"
 #include "halley/text/string_converter.h"
 #include "halley/support/logger.h"
+#include "halley/support/profiler.h"
 
 using namespace Halley;
 
@@ -89,6 +90,11 @@ void Executors::setInstance(Executors& e)
 	instance = &e;
 }
 
+bool Executors::hasInstance()
+{
+	return instance != nullptr;
+}
+
 size_t ExecutionQueue::threadCount() const
 {
 	return attachedCount.load();
@@ -167,6 +173,10 @@ void Executor::runForever()
 	while (running)	{
 		auto next = queue.getNext();
 		try {
+			std::optional<ProfilerEvent> event;
+			if (ProfilerCapture::get().isBootTracing()) {
+				event.emplace(ProfilerEventType::ExecutorTask);
+			}
 			next();
 		} catch (std::exception& e) {
 			Logger::logException(e);
@@ -219,8 +229,10 @@ ThreadPool::ThreadPool(const String& name, ExecutionQueue& queue, size_t n, Make
 	threads.resize(n);
 
 	for (size_t i = 0; i < n; i++) {
-		threads[i] = makeThread(name + " Pool " + toString(i), [this, i]()
+		const auto threadName = name + " Pool " + toString(i);
+		threads[i] = makeThread(threadName, [this, i, threadName]()
 		{
+			ProfilerCapture::get().setThreadName(threadName);
 			try {
 				executors[i]->runForever();
 			} catch (std::exception& e) {
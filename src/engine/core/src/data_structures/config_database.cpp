@@ -50,7 +50,7 @@ void ConfigDatabase::loadFile(Resources& resources, const String& configName)
 {
 	auto configFile = resources.get<ConfigFile>(configName);
 
-	loadConfig(configFile->getRoot(), true);
+	loadConfig(configFile->getView(), true);
 
 	if (allowHotReload) {
 		auto lock = std::unique_lock(mutex);
@@ -81,6 +81,25 @@ void ConfigDatabase::generateMemoryReport()
 	}
 }
 
+void ConfigDatabase::loadConfig(const ConfigNodeView& node, bool enforceUnique)
+{
+	if (node.getType() == ConfigNodeType::Map) {
+		for (size_t i = 0; i < node.getMapSize(); ++i) {
+			const auto key = node.getMapKey(i);
+			if (onlyLoad && !std_ex::contains(*onlyLoad, key)) {
+				continue;
+			}
+
+			for (auto& db: dbs) {
+				if (db && db->getKey() == key) {
+					db->loadConfigs(node.getMapValue(i).toConfigNode(), enforceUnique);
+					break;
+				}
+			}
+		}
+	}
+}
+
 void ConfigDatabase::loadConfig(const ConfigNode& node, bool enforceUnique)
 {
 	if (node.getType() == ConfigNodeType::Map) {
@@ -106,7 +125,7 @@ void ConfigDatabase::update()
 		if (o.needsUpdate()) {
 			changed = true;
 			o.update();
-			loadConfig(o.getRoot(), false);
+			loadConfig(o.getView(), false);
 		}
 	}
 
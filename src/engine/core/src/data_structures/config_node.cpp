@@ -6,6 +6,7 @@
 #include "halley/entity/world.h"
 #include "halley/maths/ops.h"
 #include "halley/utils/hash.h"
+#include "halley/data_structures/config_node_arena.h"
 using namespace Halley;
 
 ConfigNode::ConfigNode()
@@ -173,6 +174,11 @@ ConfigNode::~ConfigNode()
 
 ConfigNode& ConfigNode::operator=(const ConfigNode& other)
 {
+	if (other.isFrozen()) {
+		// Copies never point into the arena, so they don't depend on its lifetime
+		return *this = other.thawed();
+	}
+
 	switch (other.type) {
 		case ConfigNodeType::String:
 			*this = other.asString();
@@ -1068,7 +1074,7 @@ Range<int> ConfigNode::asIntRange(Range<int> defaultValue) const
 String ConfigNode::asString() const
 {
 	if (type == ConfigNodeType::String) {
-		return *strData;
+		return isFrozen() ? String(*static_cast<const std::string_view*>(getFrozenData())) : *strData;
 	} else if (type == ConfigNodeType::Int) {
 		return toString(asInt());
 	} else if (type == ConfigNodeType::Int64) {
@@ -1134,7 +1140,7 @@ String ConfigNode::asStringNoUndefined() const
 std::string_view ConfigNode::asStringView() const
 {
 	if (type == ConfigNodeType::String) {
-		return *strData;
+		return isFrozen() ? *static_cast<const std::string_view*>(getFrozenData()) : std::string_view(*strData);
 	} else {
 		throw Exception("Can't convert " + getNodeDebugId() + " from " + toString(getType()) + " to StringView.", HalleyExceptions::Resources);
 	}
@@ -1206,7 +1212,7 @@ std::string_view ConfigNode::asStringView(const std::string_view& defaultValue)
 const ConfigNode::SequenceType& ConfigNode::asSequence() const
 {
 	if (type == ConfigNodeType::Sequence || type == ConfigNodeType::DeltaSequence) {
-		return *sequenceData;
+		return isFrozen() ? materializeSequence() : *sequenceData;
 	} else {
 		throw Exception(getNodeDebugId() + " is not a sequence type", HalleyExceptions::Resources);
 	}
@@ -1215,7 +1221,7 @@ const ConfigNode::SequenceType& ConfigNode::asSequence() const
 const ConfigNode::MapType& ConfigNode::asMap() const
 {
 	if (type == ConfigNodeType::Map || type == ConfigNodeType::DeltaMap) {
-		return *mapData;
+		return isFrozen() ? materializeMap() : *mapData;
 	} else {
 		throw Exception(getNodeDebugId() + " is not a map type", HalleyExceptions::Resources);
 	}
@@ -1223,6 +1229,7 @@ const ConfigNode::MapType& ConfigNode::asMap() const
 
 ConfigNode::SequenceType& ConfigNode::asSequence()
 {
+	thaw();
 	if (type == ConfigNodeType::Sequence || type == ConfigNodeType::DeltaSequence) {
 		return *sequenceData;
 	} else if (type == ConfigNodeType::Undefined) {
@@ -1235,6 +1242,7 @@ ConfigNode::SequenceType& ConfigNode::asSequence()
 
 ConfigNode::MapType& ConfigNode::asMap()
 {
+	thaw();
 	if (type == ConfigNodeType::Map || type == ConfigNodeType::DeltaMap) {
 		return *mapData;
 	} else if (type == ConfigNodeType::Undefined) {
@@ -1248,6 +1256,9 @@ ConfigNode::MapType& ConfigNode::asMap()
 size_t ConfigNode::getSequenceSize(size_t defaultValue) const
 {
 	if (type == ConfigNodeType::Sequence || type == ConfigNodeType::DeltaSequence) {
+		if (isFrozen()) {
+			return static_cast<const ConfigNodeArena::FrozenSequence*>(getFrozenData())->size;
+		}
 		return asSequence().size();
 	} else {
 		return defaultValue;
@@ -1257,6 +1268,7 @@ size_t ConfigNode::getSequenceSize(size_t defaultValue) const
 void ConfigNode::ensureType(ConfigNodeType t)
 {
 	if (type != t) {
+		thaw();
 		switch (t) {
 		case ConfigNodeType::Int:
 			*this = 0;
@@ -1311,6 +1323,10 @@ void ConfigNode::ensureType(ConfigNodeType t)
 bool ConfigNode::hasKey(std::string_view key) const
 {
 	if (type == ConfigNodeType::Map || type == ConfigNodeType::DeltaMap) {
+		if (isFrozen()) {
+			const auto* value = static_cast<const ConfigNodeArena::FrozenMap*>(getFrozenData())->tryGet(key);
+			return value && value->getType() != ConfigNodeType::Undefined;
+		}
 		auto& map = asMap();
 		auto iter = map.find(key);
 		return iter != map.end() && iter->second.getType() != ConfigNodeType::Undefined;
@@ -1340,6 +1356,17 @@ const ConfigNode& ConfigNode::operator[](std::string_view key) const
 		return undefinedConfigNode;		
 	}
 
+	if (isFrozen() && type == ConfigNodeType::Map) {
+		if (const auto* value = static_cast<const ConfigNodeArena::FrozenMap*>(getFrozenData())->tryGet(key)) {
+			return *value;
+		}
+#if defined(STORE_CONFIG_NODE_PARENTING)
+		undefinedConfigNode.setParent(this, -1);
+		undefinedConfigNode.parent->file = parent ? parent->file : nullptr;
+#endif
+		return undefinedConfigNode;
+	}
+
 	const auto& map = asMap();
 	const auto iter = map.find(key);
 	if (iter != map.end()) {
@@ -1356,6 +1383,13 @@ const ConfigNode& ConfigNode::operator[](std::string_view key) const
 
 const ConfigNode& ConfigNode::operator[](size_t idx) const
 {
+	if (isFrozen() && type == ConfigNodeType::Sequence) {
+		const auto& seq = *static_cast<const ConfigNodeArena::FrozenSequence*>(getFrozenData());
+		if (idx >= seq.size) {
+			throw std::out_of_range("ConfigNode sequence index out of range");
+		}
+		return seq.values[idx];
+	}
 	return asSequence().at(idx);
 }
 
@@ -1377,6 +1411,10 @@ ConfigNode& ConfigNode::at(std::string_view key)
 
 const ConfigNode& ConfigNode::at(std::string_view key) const
 {
+	if (isFrozen() && type == ConfigNodeType::Map) {
+		return (*this)[key];
+	}
+
 	const auto& map = asMap();
 	const auto iter = map.find(key);
 	if (iter != map.end()) {
@@ -1403,16 +1441,134 @@ Vector<ConfigNode>::iterator ConfigNode::end()
 
 Vector<ConfigNode>::const_iterator ConfigNode::begin() const
 {
+	if (isFrozen() && type == ConfigNodeType::Sequence) {
+		return Vector<ConfigNode>::const_iterator(static_cast<const ConfigNodeArena::FrozenSequence*>(getFrozenData())->values);
+	}
 	return asSequence().begin();
 }
 
 Vector<ConfigNode>::const_iterator ConfigNode::end() const
 {
+	if (isFrozen() && type == ConfigNodeType::Sequence) {
+		const auto* seq = static_cast<const ConfigNodeArena::FrozenSequence*>(getFrozenData());
+		return Vector<ConfigNode>::const_iterator(seq->values + seq->size);
+	}
 	return asSequence().end();
 }
 
+bool ConfigNode::isFrozen() const
+{
+	return (type == ConfigNodeType::String || type == ConfigNodeType::Sequence || type == ConfigNodeType::Map)
+		&& (reinterpret_cast<uintptr_t>(rawPtrData) & frozenTag) != 0;
+}
+
+void ConfigNode::setFrozen(ConfigNodeType t, const void* data)
+{
+	reset();
+	type = t;
+	rawPtrData = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(data) | frozenTag);
+}
+
+const void* ConfigNode::getFrozenData() const
+{
+	return reinterpret_cast<const void*>(reinterpret_cast<uintptr_t>(rawPtrData) & ~frozenTag);
+}
+
+void ConfigNode::thaw()
+{
+	if (isFrozen()) {
+		*this = thawed();
+	}
+}
+
+ConfigNode ConfigNode::thawed() const
+{
+	switch (type) {
+	case ConfigNodeType::String:
+		return ConfigNode(asStringView());
+	case ConfigNodeType::Sequence:
+	{
+		SequenceType result;
+		result.reserve(getSequenceSize());
+		for (const auto& e: *this) {
+			result.push_back(ConfigNode(e));
+		}
+		return ConfigNode(std::move(result));
+	}
+	case ConfigNodeType::Map:
+	{
+		const auto& map = *static_cast<const ConfigNodeArena::FrozenMap*>(getFrozenData());
+		MapType result;
+		result.reserve(map.size);
+		for (uint32_t i = 0; i < map.size; ++i) {
+			result.emplace(String(map.keys[i]), ConfigNode(map.values[i]));
+		}
+		return ConfigNode(std::move(result));
+	}
+	default:
+		return ConfigNode(*this);
+	}
+}
+
+ConfigNode ConfigNode::makeAlias(const ConfigNode& node)
+{
+	// Shares the frozen data instead of copying it, only valid while the arena is alive
+	ConfigNode result;
+	result.type = node.type;
+	result.int64Data = node.int64Data;
+	result.auxData = node.auxData;
+	return result;
+}
+
+const ConfigNode::SequenceType& ConfigNode::materializeSequence() const
+{
+	const auto& seq = *static_cast<const ConfigNodeArena::FrozenSequence*>(getFrozenData());
+	if (auto* result = seq.materialized.load(std::memory_order_acquire)) {
+		return *result;
+	}
+
+	auto result = std::make_unique<SequenceType>();
+	result->reserve(seq.size);
+	for (uint32_t i = 0; i < seq.size; ++i) {
+		result->push_back(makeAlias(seq.values[i]));
+	}
+
+	SequenceType* expected = nullptr;
+	if (seq.materialized.compare_exchange_strong(expected, result.get(), std::memory_order_acq_rel)) {
+		return *result.release();
+	}
+	return *expected;
+}
+
+const ConfigNode::MapType& ConfigNode::materializeMap() const
+{
+	const auto& map = *static_cast<const ConfigNodeArena::FrozenMap*>(getFrozenData());
+	if (auto* result = map.materialized.load(std::memory_order_acquire)) {
+		return *result;
+	}
+
+	auto result = std::make_unique<MapType>();
+	result->reserve(map.size);
+	for (uint32_t i = 0; i < map.size; ++i) {
+		result->emplace(String(map.keys[i]), makeAlias(map.values[i]));
+	}
+
+	MapType* expected = nullptr;
+	if (map.materialized.compare_exchange_strong(expected, result.get(), std::memory_order_acq_rel)) {
+		return *result.release();
+	}
+	return *expected;
+}
+
 void ConfigNode::reset()
 {
+	if (isFrozen()) {
+		// Owned by the arena
+		rawPtrData = nullptr;
+		type = ConfigNodeType::Undefined;
+		return;
+	}
+
 	if (type == ConfigNodeType::Map || type == ConfigNodeType::DeltaMap) {
 		delete mapData;
 	} else if (type == ConfigNodeType::Sequence || type == ConfigNodeType::DeltaSequence) {
@@ -2017,8 +2173,8 @@ void ConfigNode::feedToHash(Hash::Hasher& hasher) const
 		hasher.feed(vec2fData);
 		break;
 	case ConfigNodeType::Sequence:
-		hasher.feed(asSequence().size());
-		for (const auto& e: asSequence()) {
+		hasher.feed(getSequenceSize());
+		for (const auto& e: *this) {
 			e.feedToHash(hasher);
 		}
 		break;
@@ -2034,7 +2190,7 @@ void ConfigNode::feedToHash(Hash::Hasher& hasher) const
 		hasher.feedBytes(bytesData->byte_span());
 		break;
 	case ConfigNodeType::String:
-		hasher.feed(*strData);
+		hasher.feed(asStringView());
 		break;
 	case ConfigNodeType::Undefined:
 		break;
@@ -2100,6 +2256,11 @@ size_t ConfigNode::getSizeBytes() const
 {
 	size_t result = sizeof(ConfigNode);
 
+	if (isFrozen()) {
+		// Everything else lives in the arena, which reports its own size
+		return result;
+	}
+
 	switch (type) {
 	case ConfigNodeType::Bytes:
 		result += sizeof(Bytes) + bytesData->size();
@@ -0,0 +1,257 @@
+#include "halley/data_structures/config_node_arena.h"
+#include <algorithm>
+
+using namespace Halley;
+
+const ConfigNode* ConfigNodeArena::FrozenMap::tryGet(std::string_view key) const
+{
+	const auto* end = keys + size;
+	const auto* iter = std::lower_bound(keys, end, key);
+	if (iter != end && *iter == key) {
+		return &values[iter - keys];
+	}
+	return nullptr;
+}
+
+struct ConfigNodeArena::Layout {
+	size_t nMaps = 0;
+	size_t nSequences = 0;
+	size_t nNodes = 0;
+	size_t nKeys = 0;
+	size_t nChars = 0;
+
+	size_t mapsOffset = 0;
+	size_t sequencesOffset = 0;
+	size_t nodesOffset = 0;
+	size_t keysOffset = 0;
+	size_t stringsOffset = 0;
+	size_t charsOffset = 0;
+	size_t totalSize = 0;
+
+	void computeOffsets(size_t nStrings)
+	{
+		size_t pos = 0;
+		auto add = [&] (size_t& offset, size_t count, size_t size, size_t align)
+		{
+			pos = (pos + align - 1) / align * align;
+			offset = pos;
+			pos += count * size;
+		};
+		add(mapsOffset, nMaps, sizeof(FrozenMap), alignof(FrozenMap));
+		add(sequencesOffset, nSequences, sizeof(FrozenSequence), alignof(FrozenSequence));
+		add(nodesOffset, nNodes, sizeof(ConfigNode), alignof(ConfigNode));
+		add(keysOffset, nKeys, sizeof(std::string_view), alignof(std::string_view));
+		add(stringsOffset, nStrings, sizeof(std::string_view), alignof(std::string_view));
+		add(charsOffset, nChars, 1, 1);
+		totalSize = pos;
+	}
+};
+
+class ConfigNodeArena::Builder {
+public:
+	bool measure(const ConfigNode& node)
+	{
+		switch (node.getType()) {
+		case ConfigNodeType::Undefined:
+		case ConfigNodeType::Int:
+		case ConfigNodeType::Int64:
+		case ConfigNodeType::Bool:
+		case ConfigNodeType::EntityId:
+		case ConfigNodeType::Float:
+		case ConfigNodeType::Int2:
+		case ConfigNodeType::Float2:
+			return true;
+
+		case ConfigNodeType::String:
+			intern(node.asStringView());
+			return true;
+
+		case ConfigNodeType::Sequence:
+			++layout.nSequences;
+			layout.nNodes += node.getSequenceSize();
+			for (const auto& e: node) {
+				if (!measure(e)) {
+					return false;
+				}
+			}
+			return true;
+
+		case ConfigNodeType::Map:
+			++layout.nMaps;
+			layout.nNodes += node.asMap().size();
+			layout.nKeys += node.asMap().size();
+			for (const auto& [k, v]: node.asMap()) {
+				intern(k);
+				if (!measure(v)) {
+					return false;
+				}
+			}
+			return true;
+
+		default:
+			return false;
+		}
+	}
+
+	void allocate(ConfigNodeArena& arena)
+	{
+		layout.computeOffsets(internedStrings.size());
+
+		const auto nBlocks = (layout.totalSize + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+		arena.storage = std::unique_ptr<std::max_align_t[]>(new std::max_align_t[std::max(nBlocks, size_t(1))]);
+		arena.storageSize = nBlocks * sizeof(std::max_align_t);
+
+		auto* base = reinterpret_cast<char*>(arena.storage.get());
+		arena.maps = reinterpret_cast<FrozenMap*>(base + layout.mapsOffset);
+		arena.sequences = reinterpret_cast<FrozenSequence*>(base + layout.sequencesOffset);
+		arena.nodes = reinterpret_cast<ConfigNode*>(base + layout.nodesOffset);
+		keys = reinterpret_cast<std::string_view*>(base + layout.keysOffset);
+		strings = reinterpret_cast<std::string_view*>(base + layout.stringsOffset);
+
+		// Lay out the interned characters, pointing each string slot at them
+		auto* chars = base + layout.charsOffset;
+		for (const auto& [str, idx]: internedStrings) {
+			memcpy(chars, str.data(), str.size());
+			new (&strings[idx]) std::string_view(chars, str.size());
+			chars += str.size();
+		}
+	}
+
+	void build(ConfigNodeArena& arena, const ConfigNode& src, ConfigNode& dst)
+	{
+		switch (src.getType()) {
+		case ConfigNodeType::String:
+			dst.setFrozen(ConfigNodeType::String, &strings[internedStrings.at(src.asStringView())]);
+			break;
+
+		case ConfigNodeType::Sequence:
+		{
+			const auto size = src.getSequenceSize();
+			auto* values = claimNodes(arena, size);
+			auto* seq = new (&arena.sequences[arena.nSequences++]) FrozenSequence();
+			seq->values = values;
+			seq->size = static_cast<uint32_t>(size);
+
+			size_t i = 0;
+			for (const auto& e: src) {
+				build(arena, e, values[i++]);
+			}
+			dst.setFrozen(ConfigNodeType::Sequence, seq);
+			break;
+		}
+
+		case ConfigNodeType::Map:
+		{
+			const auto& srcMap = src.asMap();
+			sortedEntries.clear();
+			for (const auto& [k, v]: srcMap) {
+				sortedEntries.emplace_back(std::string_view(k), &v);
+			}
+			std::sort(sortedEntries.begin(), sortedEntries.end(), [] (const auto& a, const auto& b) { return a.first < b.first; });
+			auto entries = sortedEntries; // Recursion below reuses sortedEntries
+
+			const auto size = entries.size();
+			auto* values = claimNodes(arena, size);
+			auto* map = new (&arena.maps[arena.nMaps++]) FrozenMap();
+			map->keys = keys + nKeysUsed;
+			map->values = values;
+			map->size = static_cast<uint32_t>(size);
+
+			// Claim all keys before recursing, so nested maps don't interleave theirs
+			for (size_t i = 0; i < size; ++i) {
+				new (&keys[nKeysUsed++]) std::string_view(strings[internedStrings.at(entries[i].first)]);
+			}
+			for (size_t i = 0; i < size; ++i) {
+				build(arena, *entries[i].second, values[i]);
+			}
+			dst.setFrozen(ConfigNodeType::Map, map);
+			break;
+		}
+
+		case ConfigNodeType::Undefined:
+			break;
+
+		default:
+			dst = ConfigNode(src);
+			break;
+		}
+	}
+
+private:
+	Layout layout;
+	HashMap<std::string_view, uint32_t> internedStrings;
+	Vector<std::pair<std::string_view, const ConfigNode*>> sortedEntries;
+
+	std::string_view* keys = nullptr;
+	std::string_view* strings = nullptr;
+	size_t nKeysUsed = 0;
+
+	void intern(std::string_view str)
+	{
+		if (internedStrings.emplace(str, static_cast<uint32_t>(internedStrings.size())).second) {
+			layout.nChars += str.size();
+		}
+	}
+
+	ConfigNode* claimNodes(ConfigNodeArena& arena, size_t count)
+	{
+		auto* result = arena.nodes + arena.nNodes;
+		for (size_t i = 0; i < count; ++i) {
+			new (&result[i]) ConfigNode();
+		}
+		arena.nNodes += count;
+		return result;
+	}
+};
+
+std::shared_ptr<ConfigNodeArena> ConfigNodeArena::freeze(ConfigNode& node)
+{
+	if (node.isFrozen()) {
+		return {};
+	}
+
+	Builder builder;
+	if (!builder.measure(node)) {
+		return {};
+	}
+
+	auto arena = std::shared_ptr<ConfigNodeArena>(new ConfigNodeArena());
+	builder.allocate(*arena);
+
+	ConfigNode frozen;
+	builder.build(*arena, node, frozen);
+	node = std::move(frozen);
+
+	return arena;
+}
+
+ConfigNodeArena::~ConfigNodeArena()
+{
+	for (size_t i = 0; i < nMaps; ++i) {
+		delete maps[i].materialized.load();
+		maps[i].~FrozenMap();
+	}
+	for (size_t i = 0; i < nSequences; ++i) {
+		delete sequences[i].materialized.load();
+		sequences[i].~FrozenSequence();
+	}
+	for (size_t i = 0; i < nNodes; ++i) {
+		nodes[i].~ConfigNode();
+	}
+}
+
+size_t ConfigNodeArena::getSizeBytes() const
+{
+	size_t result = sizeof(ConfigNodeArena) + storageSize;
+	for (size_t i = 0; i < nMaps; ++i) {
+		if (const auto* map = maps[i].materialized.load()) {
+			result += sizeof(ConfigNode::MapType) + map->size() * (sizeof(String) + sizeof(ConfigNode));
+		}
+	}
+	for (size_t i = 0; i < nSequences; ++i) {
+		if (const auto* seq = sequences[i].materialized.load()) {
+			result += sizeof(ConfigNode::SequenceType) + seq->size() * sizeof(ConfigNode);
+		}
+	}
+	return result;
+}
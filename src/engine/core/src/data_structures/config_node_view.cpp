@@ -0,0 +1,509 @@
+#include "halley/data_structures/config_node_view.h"
+#include "halley/support/exception.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace Halley;
+
+namespace {
+	constexpr uint32_t compiledVersion = 1;
+	constexpr uint32_t headerWords = 4; // Magic, version, root offset, total size
+	constexpr char compiledMagic[4] = { 'H', 'C', 'N', 'V' };
+
+	class ConfigNodeCompiler {
+	public:
+		Bytes compile(const ConfigNode& node)
+		{
+			result.resize(headerWords * 4);
+			const auto root = write(node);
+
+			memcpy(result.data(), compiledMagic, 4);
+			setWord(1, compiledVersion);
+			setWord(2, root);
+			setWord(3, static_cast<uint32_t>(result.size()));
+			return std::move(result);
+		}
+
+	private:
+		Bytes result;
+		HashMap<std::string_view, uint32_t> strings;
+
+		uint32_t write(const ConfigNode& node)
+		{
+			switch (node.getType()) {
+			case ConfigNodeType::Undefined:
+				return beginNode(node.getType());
+
+			case ConfigNodeType::String:
+				return writeString(node.asStringView());
+
+			case ConfigNodeType::Int:
+			{
+				const auto pos = beginNode(node.getType());
+				pushWord(static_cast<uint32_t>(node.asInt()));
+				return pos;
+			}
+
+			case ConfigNodeType::Bool:
+			{
+				const auto pos = beginNode(node.getType());
+				pushWord(node.asBool() ? 1 : 0);
+				return pos;
+			}
+
+			case ConfigNodeType::Float:
+			{
+				const auto pos = beginNode(node.getType());
+				pushFloat(node.asFloat());
+				return pos;
+			}
+
+			case ConfigNodeType::Int2:
+			{
+				const auto v = node.asVector2i();
+				const auto pos = beginNode(node.getType());
+				pushWord(static_cast<uint32_t>(v.x));
+				pushWord(static_cast<uint32_t>(v.y));
+				return pos;
+			}
+
+			case ConfigNodeType::Float2:
+			{
+				const auto v = node.asVector2f();
+				const auto pos = beginNode(node.getType());
+				pushFloat(v.x);
+				pushFloat(v.y);
+				return pos;
+			}
+
+			case ConfigNodeType::Int64:
+			case ConfigNodeType::EntityId:
+			{
+				const auto v = static_cast<uint64_t>(node.asInt64());
+				const auto pos = beginNode(node.getType());
+				pushWord(static_cast<uint32_t>(v & 0xFFFFFFFFull));
+				pushWord(static_cast<uint32_t>(v >> 32));
+				return pos;
+			}
+
+			case ConfigNodeType::Bytes:
+			{
+				const auto& bytes = node.asBytes();
+				const auto pos = beginNode(node.getType());
+				pushBlob(bytes.data(), bytes.size());
+				return pos;
+			}
+
+			case ConfigNodeType::Sequence:
+			{
+				Vector<uint32_t> offsets;
+				offsets.reserve(node.getSequenceSize());
+				for (const auto& e: node) {
+					offsets.push_back(write(e));
+				}
+
+				const auto pos = beginNode(node.getType());
+				pushWord(static_cast<uint32_t>(offsets.size()));
+				for (const auto o: offsets) {
+					pushWord(o);
+				}
+				return pos;
+			}
+
+			case ConfigNodeType::Map:
+			{
+				Vector<std::pair<std::string_view, const ConfigNode*>> entries;
+				entries.reserve(node.asMap().size());
+				for (const auto& [k, v]: node.asMap()) {
+					entries.emplace_back(k, &v);
+				}
+				std::sort(entries.begin(), entries.end(), [] (const auto& a, const auto& b) { return a.first < b.first; });
+
+				Vector<uint32_t> offsets;
+				offsets.reserve(entries.size() * 2);
+				for (const auto& [k, v]: entries) {
+					offsets.push_back(writeString(k));
+					offsets.push_back(write(*v));
+				}
+
+				const auto pos = beginNode(node.getType());
+				pushWord(static_cast<uint32_t>(entries.size()));
+				for (const auto o: offsets) {
+					pushWord(o);
+				}
+				return pos;
+			}
+
+			default:
+				throw Exception("ConfigNode of type " + toString(node.getType()) + " can't be compiled.", HalleyExceptions::Resources);
+			}
+		}
+
+		uint32_t writeString(std::string_view str)
+		{
+			const auto iter = strings.find(str);
+			if (iter != strings.end()) {
+				return iter->second;
+			}
+
+			const auto pos = beginNode(ConfigNodeType::String);
+			pushBlob(str.data(), str.size());
+			strings[str] = pos;
+			return pos;
+		}
+
+		uint32_t beginNode(ConfigNodeType type)
+		{
+			const auto pos = static_cast<uint32_t>(result.size());
+			pushWord(static_cast<uint32_t>(type));
+			return pos;
+		}
+
+		void pushWord(uint32_t value)
+		{
+			const auto pos = result.size();
+			result.resize(pos + 4);
+			memcpy(result.data() + pos, &value, 4);
+		}
+
+		void pushFloat(float value)
+		{
+			uint32_t word;
+			memcpy(&word, &value, 4);
+			pushWord(word);
+		}
+
+		void pushBlob(const void* data, size_t size)
+		{
+			pushWord(static_cast<uint32_t>(size));
+			const auto pos = result.size();
+			result.resize(pos + (size + 3) / 4 * 4, 0);
+			if (size > 0) {
+				memcpy(result.data() + pos, data, size);
+			}
+		}
+
+		void setWord(size_t idx, uint32_t value)
+		{
+			memcpy(result.data() + idx * 4, &value, 4);
+		}
+	};
+}
+
+ConfigNodeView::ConfigNodeView(gsl::span<const gsl::byte> data)
+{
+	if (!isCompiled(data)) {
+		throw Exception("Data is not a compiled ConfigNode.", HalleyExceptions::Resources);
+	}
+
+	this->data = data.data();
+	this->size = headerWords * 4;
+	const auto totalSize = readWord(12);
+	if (readWord(4) != compiledVersion || totalSize > data.size()) {
+		throw Exception("Unsupported or truncated compiled ConfigNode.", HalleyExceptions::Resources);
+	}
+	this->size = totalSize;
+	offset = readWord(8);
+}
+
+ConfigNodeView::ConfigNodeView(const gsl::byte* data, uint32_t size, uint32_t offset)
+	: data(data)
+	, size(size)
+	, offset(offset)
+{
+}
+
+bool ConfigNodeView::isCompiled(gsl::span<const gsl::byte> data)
+{
+	return data.size() >= headerWords * 4 && memcmp(data.data(), compiledMagic, 4) == 0;
+}
+
+Bytes ConfigNodeView::compile(const ConfigNode& node)
+{
+	return ConfigNodeCompiler().compile(node);
+}
+
+ConfigNodeType ConfigNodeView::getType() const
+{
+	return data ? static_cast<ConfigNodeType>(readWord(offset)) : ConfigNodeType::Undefined;
+}
+
+int ConfigNodeView::asInt() const
+{
+	return getType() == ConfigNodeType::Int ? static_cast<int>(readWord(offset + 4)) : toScalar().asInt();
+}
+
+int64_t ConfigNodeView::asInt64() const
+{
+	return toScalar().asInt64();
+}
+
+float ConfigNodeView::asFloat() const
+{
+	if (getType() == ConfigNodeType::Float) {
+		const auto word = readWord(offset + 4);
+		float result;
+		memcpy(&result, &word, 4);
+		return result;
+	}
+	return toScalar().asFloat();
+}
+
+bool ConfigNodeView::asBool() const
+{
+	return toScalar().asBool();
+}
+
+Vector2i ConfigNodeView::asVector2i() const
+{
+	return toScalar().asVector2i();
+}
+
+Vector2f ConfigNodeView::asVector2f() const
+{
+	return toScalar().asVector2f();
+}
+
+String ConfigNodeView::asString() const
+{
+	return getType() == ConfigNodeType::String ? String(readString(offset)) : toScalar().asString();
+}
+
+std::string_view ConfigNodeView::asStringView() const
+{
+	const auto type = getType();
+	if (type != ConfigNodeType::String) {
+		throw Exception("Can't convert compiled node from " + toString(type) + " to StringView.", HalleyExceptions::Resources);
+	}
+	return readString(offset);
+}
+
+int ConfigNodeView::asInt(int defaultValue) const
+{
+	return hasValue() ? asInt() : defaultValue;
+}
+
+int64_t ConfigNodeView::asInt64(int64_t defaultValue) const
+{
+	return hasValue() ? asInt64() : defaultValue;
+}
+
+float ConfigNodeView::asFloat(float defaultValue) const
+{
+	return hasValue() ? asFloat() : defaultValue;
+}
+
+bool ConfigNodeView::asBool(bool defaultValue) const
+{
+	return hasValue() ? asBool() : defaultValue;
+}
+
+Vector2i ConfigNodeView::asVector2i(Vector2i defaultValue) const
+{
+	return hasValue() ? asVector2i() : defaultValue;
+}
+
+Vector2f ConfigNodeView::asVector2f(Vector2f defaultValue) const
+{
+	return hasValue() ? asVector2f() : defaultValue;
+}
+
+String ConfigNodeView::asString(std::string_view defaultValue) const
+{
+	return hasValue() ? asString() : String(defaultValue);
+}
+
+std::string_view ConfigNodeView::asStringView(std::string_view defaultValue) const
+{
+	return hasValue() ? asStringView() : defaultValue;
+}
+
+bool ConfigNodeView::hasKey(std::string_view key) const
+{
+	return (*this)[key].hasValue();
+}
+
+ConfigNodeView ConfigNodeView::operator[](std::string_view key) const
+{
+	if (getType() != ConfigNodeType::Map) {
+		return {};
+	}
+
+	// Binary search over the sorted key/value offset pairs
+	size_t lo = 0;
+	size_t hi = readWord(offset + 4);
+	const auto pairs = offset + 8;
+	while (lo < hi) {
+		const auto mid = (lo + hi) / 2;
+		const auto cmp = readString(readWord(static_cast<uint32_t>(pairs + mid * 8))).compare(key);
+		if (cmp == 0) {
+			return ConfigNodeView(data, size, readWord(static_cast<uint32_t>(pairs + mid * 8 + 4)));
+		} else if (cmp < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return {};
+}
+
+ConfigNodeView ConfigNodeView::operator[](size_t idx) const
+{
+	if (idx >= getCount(ConfigNodeType::Sequence)) {
+		throw Exception("Compiled ConfigNode sequence index out of range.", HalleyExceptions::Resources);
+	}
+	return ConfigNodeView(data, size, readWord(static_cast<uint32_t>(offset + 8 + idx * 4)));
+}
+
+size_t ConfigNodeView::getSequenceSize() const
+{
+	return getType() == ConfigNodeType::Sequence ? readWord(offset + 4) : 0;
+}
+
+ConfigNodeView::Iterator ConfigNodeView::begin() const
+{
+	return Iterator(*this, 0);
+}
+
+ConfigNodeView::Iterator ConfigNodeView::end() const
+{
+	return Iterator(*this, getSequenceSize());
+}
+
+size_t ConfigNodeView::getMapSize() const
+{
+	return getType() == ConfigNodeType::Map ? readWord(offset + 4) : 0;
+}
+
+std::string_view ConfigNodeView::getMapKey(size_t idx) const
+{
+	if (idx >= getCount(ConfigNodeType::Map)) {
+		throw Exception("Compiled ConfigNode map index out of range.", HalleyExceptions::Resources);
+	}
+	return readString(readWord(static_cast<uint32_t>(offset + 8 + idx * 8)));
+}
+
+ConfigNodeView ConfigNodeView::getMapValue(size_t idx) const
+{
+	if (idx >= getCount(ConfigNodeType::Map)) {
+		throw Exception("Compiled ConfigNode map index out of range.", HalleyExceptions::Resources);
+	}
+	return ConfigNodeView(data, size, readWord(static_cast<uint32_t>(offset + 8 + idx * 8 + 4)));
+}
+
+ConfigNode ConfigNodeView::toConfigNode() const
+{
+	switch (getType()) {
+	case ConfigNodeType::Sequence:
+	{
+		ConfigNode::SequenceType result;
+		result.reserve(getSequenceSize());
+		for (const auto& e: *this) {
+			result.push_back(e.toConfigNode());
+		}
+		return ConfigNode(std::move(result));
+	}
+
+	case ConfigNodeType::Map:
+	{
+		const auto n = getMapSize();
+		ConfigNode::MapType result;
+		result.reserve(n);
+		for (size_t i = 0; i < n; ++i) {
+			result.emplace(String(getMapKey(i)), getMapValue(i).toConfigNode());
+		}
+		return ConfigNode(std::move(result));
+	}
+
+	case ConfigNodeType::Bytes:
+	{
+		const auto len = readWord(offset + 4);
+		if (uint64_t(offset) + 8 + len > size) {
+			throw Exception("Corrupt compiled ConfigNode.", HalleyExceptions::Resources);
+		}
+		Bytes result(len);
+		memcpy(result.data(), data + offset + 8, len);
+		return ConfigNode(std::move(result));
+	}
+
+	case ConfigNodeType::Undefined:
+	case ConfigNodeType::String:
+	case ConfigNodeType::Int:
+	case ConfigNodeType::Bool:
+	case ConfigNodeType::Float:
+	case ConfigNodeType::Int2:
+	case ConfigNodeType::Float2:
+	case ConfigNodeType::Int64:
+	case ConfigNodeType::EntityId:
+		return toScalar();
+
+	default:
+		throw Exception("Corrupt compiled ConfigNode.", HalleyExceptions::Resources);
+	}
+}
+
+uint32_t ConfigNodeView::readWord(uint32_t pos) const
+{
+	if (uint64_t(pos) + 4 > size) {
+		throw Exception("Corrupt compiled ConfigNode.", HalleyExceptions::Resources);
+	}
+	uint32_t result;
+	memcpy(&result, data + pos, 4);
+	return result;
+}
+
+uint32_t ConfigNodeView::getCount(ConfigNodeType expected) const
+{
+	const auto type = getType();
+	if (type != expected) {
+		throw Exception("Can't access compiled node of type " + toString(type) + " as " + toString(expected) + ".", HalleyExceptions::Resources);
+	}
+	return readWord(offset + 4);
+}
+
+std::string_view ConfigNodeView::readString(uint32_t nodeOffset) const
+{
+	const auto len = readWord(nodeOffset + 4);
+	if (uint64_t(nodeOffset) + 8 + len > size) {
+		throw Exception("Corrupt compiled ConfigNode.", HalleyExceptions::Resources);
+	}
+	return std::string_view(reinterpret_cast<const char*>(data + nodeOffset + 8), len);
+}
+
+ConfigNode ConfigNodeView::toScalar() const
+{
+	switch (getType()) {
+	case ConfigNodeType::Undefined:
+		return ConfigNode();
+	case ConfigNodeType::String:
+		return ConfigNode(readString(offset));
+	case ConfigNodeType::Int:
+		return ConfigNode(static_cast<int>(readWord(offset + 4)));
+	case ConfigNodeType::Bool:
+		return ConfigNode(readWord(offset + 4) != 0);
+	case ConfigNodeType::Float:
+		return ConfigNode(asFloat());
+	case ConfigNodeType::Int2:
+		return ConfigNode(Vector2i(static_cast<int>(readWord(offset + 4)), static_cast<int>(readWord(offset + 8))));
+	case ConfigNodeType::Float2:
+	{
+		uint32_t words[2] = { readWord(offset + 4), readWord(offset + 8) };
+		Vector2f result;
+		memcpy(&result.x, &words[0], 4);
+		memcpy(&result.y, &words[1], 4);
+		return ConfigNode(result);
+	}
+	case ConfigNodeType::Int64:
+	case ConfigNodeType::EntityId:
+	{
+		const auto value = static_cast<int64_t>(uint64_t(readWord(offset + 4)) | (uint64_t(readWord(offset + 8)) << 32));
+		return getType() == ConfigNodeType::EntityId ? ConfigNode(EntityId(value)) : ConfigNode(value);
+	}
+	case ConfigNodeType::Sequence:
+	case ConfigNodeType::Map:
+	case ConfigNodeType::Bytes:
+		return toConfigNode();
+	default:
+		throw Exception("Corrupt compiled ConfigNode.", HalleyExceptions::Resources);
+	}
+}
@@ -0,0 +1,37 @@
+#include "halley/diagnostics/ui_stats.h"
+#include "halley/graphics/text/font.h"
+#include "halley/resources/resources.h"
+#include "halley/ui/ui_root.h"
+#include "halley/text/string_converter.h"
+
+using namespace Halley;
+
+UIStatsView::UIStatsView(Resources& resources, const HalleyAPI& api)
+	: StatsView(resources, api)
+	, text(resources.get<Font>("Ubuntu Bold"), "", 16, Colour(1, 1, 1), 1.0f, Colour(0.1f, 0.1f, 0.1f))
+{
+}
+
+void UIStatsView::setUIRoot(const UIRoot* root)
+{
+	uiRoot = root;
+}
+
+void UIStatsView::paint(Painter& painter)
+{
+	if (!active || !uiRoot) {
+		return;
+	}
+
+	const auto& stats = uiRoot->getRenderStats();
+	const auto total = stats.widgetsDrawn + stats.widgetsReused;
+	const auto& layout = uiRoot->getLayoutStats();
+	String layoutSource = layout.invalidations > 0 ? " (first by \"" + layout.firstInvalidatedBy + "\")" : "";
+	text
+		.setText("UI: " + toString(total) + " widgets, " + toString(stats.widgetsReused) + " reused (" + toString(stats.getReuseRatio() * 100.0f, 1) + "%)\n"
+			+ toString(stats.subtreesReused) + " cached subtrees replayed, " + toString(stats.subtreesRecorded) + " recorded\n"
+			+ "Layout: " + toString(layout.widgetsMeasured) + " measured, " + toString(layout.widgetsArranged) + " arranged, " + toString(layout.widgetsSkipped) + " skipped\n"
+			+ toString(layout.invalidations) + " invalidations" + layoutSource)
+		.setPosition(Vector2f(20, 20))
+		.draw(painter);
+}
@@ -265,6 +265,10 @@ void Transform2DComponent::deserialize(const EntitySerializationContext& context
 
 void Transform2DComponent::markDirty()
 {
+	if (cachedValues == 0) {
+		// Nothing cached to invalidate, but the local values still changed
+		++revision;
+	}
 	markDirty(DirtyPropagationMode::Changed);
 }
 
@@ -50,6 +50,14 @@ bool DataInterpolatorSet::setInterpolatorEnabled(EntityId entityId, std::string_
 	return false;
 }
 
+bool DataInterpolatorSet::hasInterpolators(EntityId entity, std::string_view componentName) const
+{
+	return std::any_of(interpolators.begin(), interpolators.end(), [&] (const auto& entry)
+	{
+		return std::get<0>(entry.first) == entity && std::get<1>(entry.first) == componentName;
+	});
+}
+
 bool DataInterpolatorSet::isReady() const
 {
 	return ready;
@@ -65,11 +73,19 @@ void DataInterpolatorSet::update(Time time, World& world) const
 	for (auto& e: interpolators) {
 		const bool modified = e.second->update(time, world, std::get<0>(e.first));
 
-		// This hack is needed to make sure that transform 2D gets marked as dirty properly
-		if (modified && std::get<1>(e.first) == "Transform2D") {
+		if (modified) {
 			auto entity = world.getEntity(std::get<0>(e.first));
-			auto& transform = entity.getComponent<Transform2DComponent>();
-			transform.markDirty();
+			if (std::get<1>(e.first) == "Transform2D") {
+				// This hack is needed to make sure that transform 2D gets marked as dirty properly
+				auto& transform = entity.getComponent<Transform2DComponent>();
+				transform.markDirty();
+			} else {
+				// Interpolators write straight into the component, so let change tracking know about it
+				const auto& reflector = world.getReflection().getComponentReflector(String(std::get<1>(e.first)));
+				if (auto* component = reflector.tryGetComponent(entity)) {
+					reflector.markChanged(*component);
+				}
+			}
 		}
 	}
 }
@@ -114,6 +130,11 @@ IDataInterpolator* DataInterpolatorSetRetriever::tryGetInterpolator(EntityId ent
 	}
 }
 
+bool DataInterpolatorSetRetriever::hasInterpolators(EntityId entityId, std::string_view componentName) const
+{
+	return dataInterpolatorSet && entityId.isValid() && dataInterpolatorSet->hasInterpolators(entityId, componentName);
+}
+
 ConfigNode DataInterpolatorSetRetriever::createComponentDelta(const UUID& instanceUUID, const String& componentName, const ConfigNode& from, const ConfigNode& origTo) const
 {
 	const auto iter = uuids.find(instanceUUID);
@@ -321,6 +321,7 @@ void Entity::sortChildrenByInstanceUUIDs(const Vector<UUID>& uuids)
 	for (size_t i = 0; i < nChildren; ++i) {
 		children[i] = pairs[i].first;
 	}
+	propagateChildrenChange();
 }
 
 bool Entity::isEmpty() const
@@ -350,6 +351,40 @@ void Entity::setEnableRules(String rules)
 	} else {
 		enableRules = rules.isEmpty() ? std::unique_ptr<String>() : std::make_unique<String>(std::move(rules));
 	}
+	++componentRevision;
+}
+
+std::optional<uint64_t> Entity::getChangeRevision(const World& world) const
+{
+	// Each step is a bijection, so a change to any single revision always changes the result
+	// The narrow children and hierarchy revisions could wrap around between calls, so the parent and children are combined by id instead
+	uint64_t result = componentRevision;
+	auto combine = [&] (uint64_t value)
+	{
+		result = (result ^ value) * 0x100000001B3ull;
+	};
+	combine(parent ? uint64_t(parent->entityId.value) : ~uint64_t(0));
+
+	const auto& reflection = world.getReflection();
+	for (uint8_t i = 0; i < liveComponents; ++i) {
+		const auto [id, component] = components[i];
+		const auto revision = reflection.getComponentReflector(id).getChangeRevision(*component);
+		if (!revision) {
+			return std::nullopt;
+		}
+		combine((uint64_t(id) << 32) | *revision);
+	}
+
+	for (const auto* child: children) {
+		const auto childRevision = child->getChangeRevision(world);
+		if (!childRevision) {
+			return std::nullopt;
+		}
+		combine(uint64_t(child->entityId.value));
+		combine(*childRevision);
+	}
+
+	return result;
 }
 
 DataInterpolatorSet& Entity::setupNetwork(EntityRef& ref, uint8_t peerId)
@@ -14,9 +14,68 @@
 #include "halley/file_formats/yaml_convert.h"
 #include "halley/resources/resources.h"
 #include "halley/utils/algorithm.h"
+#include "halley/support/profiler.h"
+#include "halley/entity/prefab_blueprint.h"
+#include "halley/entity/components/transform_2d_component.h"
 
 using namespace Halley;
 
+namespace {
+	// Resolves entity references while stamping out one copy of a blueprint
+	class BlueprintInstanceContext final : public IEntityFactoryContext {
+	public:
+		BlueprintInstanceContext(World& world, const PrefabBlueprint& blueprint)
+			: world(world)
+			, nodes(blueprint.getNodes())
+		{
+			entities.reserve(nodes.size());
+		}
+
+		EntityId getEntityIdFromUUID(const UUID& uuid) const override
+		{
+			if (!uuid.isValid()) {
+				return EntityId();
+			}
+			for (size_t i = 0; i < entities.size(); ++i) {
+				if (nodes[i].prefabUUID == uuid || entities[i].getInstanceUUID() == uuid) {
+					return entities[i].getEntityId();
+				}
+			}
+			if (const auto entity = world.findEntity(uuid, true)) {
+				return entity->getEntityId();
+			}
+			Logger::logWarning("Couldn't find entity with UUID " + uuid.toString() + " while instantiating blueprint.");
+			return EntityId();
+		}
+
+		UUID getUUIDFromEntityId(EntityId id) const override
+		{
+			if (auto e = world.tryGetEntity(id); e.isValid()) {
+				return e.getInstanceUUID();
+			} else {
+				return {};
+			}
+		}
+
+		EntityId getCurrentEntityId() const override
+		{
+			return current;
+		}
+
+		bool isHeadless() const override
+		{
+			return world.isHeadless();
+		}
+
+		Vector<EntityRef> entities;
+		EntityId current;
+
+	private:
+		World& world;
+		const Vector<PrefabBlueprint::Node>& nodes;
+	};
+}
+
 EntityFactory::EntityFactory(World& world, Resources& resources)
 	: world(world)
 	, resources(resources)
@@ -34,6 +93,7 @@ World& EntityFactory::getWorld()
 
 EntityScene EntityFactory::createScene(const std::shared_ptr<const Prefab>& prefab, bool allowReload, WorldPartitionId worldPartition, String variant)
 {
+	ProfilerEvent event(ProfilerEventType::EntityInstantiate, prefab->getAssetId());
 	EntityScene curScene(allowReload, worldPartition, variant);
 	try {
 		Vector<EntityRef> entities;
@@ -81,8 +141,18 @@ EntityData EntityFactory::doSerializeEntity(EntityRef entity, const Serializatio
 	// Components
 	const auto serializeContext = std::make_shared<EntityFactoryContext>(world, resources, EntitySerialization::makeMask(options.type), false);
 	for (auto [componentId, component]: entity) {
+		if (options.skipComponent && options.skipComponent(entity, componentId)) {
+			continue;
+		}
 		const auto& reflector = world.getReflection().getComponentReflector(componentId);
-		result.getComponents().emplace_back(reflector.getName(), reflector.serialize(serializeContext->getEntitySerializationContext(), *component));
+		if (options.serializeComponent) {
+			result.getComponents().emplace_back(reflector.getName(), options.serializeComponent(entity, componentId, *component, [&] ()
+			{
+				return reflector.serialize(serializeContext->getEntitySerializationContext(), *component);
+			}));
+		} else {
+			result.getComponents().emplace_back(reflector.getName(), reflector.serialize(serializeContext->getEntitySerializationContext(), *component));
+		}
 	}
 
 	// Children
@@ -350,6 +420,7 @@ void EntityFactoryContext::notifyEntity(const EntityRef& entity) const
 
 EntityRef EntityFactory::createEntity(const String& prefabName, EntityRef parent, EntityScene* scene)
 {
+	ProfilerEvent event(ProfilerEventType::EntityInstantiate, prefabName);
 	EntityData data(UUID::generate());
 	data.setPrefab(prefabName);
 	const int mask = makeMask(EntitySerialization::Type::Prefab);
@@ -364,6 +435,103 @@ EntityRef EntityFactory::createEntity(const EntityData& data, int mask, EntityRe
 	return entity;
 }
 
+Vector<EntityRef> EntityFactory::instantiateBatch(const String& prefabName, size_t count, gsl::span<const BatchTransform> transforms, EntityRef parent)
+{
+	if (const auto prefab = getPrefab(prefabName)) {
+		return instantiateBatch(*prefab->getBlueprint(world.getReflection()), count, transforms, parent);
+	}
+	return {};
+}
+
+Vector<EntityRef> EntityFactory::instantiateBatch(const PrefabBlueprint& blueprint, size_t count, gsl::span<const BatchTransform> transforms, EntityRef parent)
+{
+	Expects(transforms.empty() || transforms.size() == count);
+	Expects(&blueprint.getReflection() == &world.getReflection());
+	ProfilerEvent event(ProfilerEventType::EntityInstantiate, blueprint.getPrefabId());
+
+	Vector<EntityRef> result;
+	result.reserve(count);
+
+	auto applyTransform = [&] (EntityRef& entity, size_t idx)
+	{
+		if (!transforms.empty()) {
+			if (auto* transform = entity.tryGetComponent<Transform2DComponent>()) {
+				transform->setLocalPosition(transforms[idx].position);
+				transform->setLocalRotation(transforms[idx].rotation);
+			}
+		}
+	};
+
+	if (!blueprint.isCompiled()) {
+		for (size_t i = 0; i < count; ++i) {
+			auto entity = createEntity(blueprint.getPrefabId(), parent);
+			applyTransform(entity, i);
+			result.push_back(entity);
+		}
+		return result;
+	}
+
+	const auto prefab = getPrefab(blueprint.getPrefabId());
+	const auto& nodes = blueprint.getNodes();
+
+	// Enable state only depends on the prefab (and world services), so evaluate it once for the whole batch
+	auto* enableRulesService = world.tryGetService<EnableRulesService>();
+	Vector<uint8_t> enabled;
+	enabled.reserve(nodes.size());
+	for (const auto& node: nodes) {
+		const bool disabled = (node.flags & static_cast<uint8_t>(EntityData::Flag::Disabled)) != 0;
+		const bool rulesPass = node.enableRules.isEmpty() || !enableRulesService || enableRulesService->evaluateEnableRules(node.enableRules);
+		enabled.push_back(!disabled && node.variant.isEmpty() && rulesPass ? 1 : 0);
+	}
+
+	BlueprintInstanceContext context(world, blueprint);
+	EntitySerializationContext serializationContext;
+	serializationContext.resources = &resources;
+	serializationContext.entityContext = &context;
+	serializationContext.entitySerializationTypeMask = makeMask(EntitySerialization::Type::Prefab);
+
+	for (size_t i = 0; i < count; ++i) {
+		const auto rootUUID = UUID::generate();
+
+		// Create the whole hierarchy first, so components can reference any entity in it
+		context.entities.clear();
+		for (const auto& node: nodes) {
+			const bool isRoot = node.parent == -1;
+			const auto uuid = isRoot ? rootUUID : UUID::generateFromUUIDs(node.prefabUUID, rootUUID);
+			const auto parentEntity = isRoot ? (parent.isValid() ? std::optional<EntityRef>(parent) : std::nullopt) : std::optional<EntityRef>(context.entities[node.parent]);
+			context.entities.push_back(world.createEntity(uuid, node.name, parentEntity));
+		}
+
+		for (size_t j = 0; j < nodes.size(); ++j) {
+			const auto& node = nodes[j];
+			auto& entity = context.entities[j];
+
+			entity.setSelectable((node.flags & static_cast<uint8_t>(EntityData::Flag::NotSelectable)) == 0);
+			entity.setSerializable((node.flags & static_cast<uint8_t>(EntityData::Flag::NotSerializable)) == 0);
+			entity.setEnabled(enabled[j] != 0);
+			entity.setEnableRules(node.enableRules);
+			if (networkFactory) {
+				entity.setFromNetwork(true);
+			}
+			if (node.prefabUUID.isValid()) {
+				entity.setPrefab(prefab, node.prefabUUID);
+			}
+
+			context.current = entity.getEntityId();
+			for (const auto& component: node.components) {
+				component.reflector->addComponent(serializationContext, entity, component.data);
+			}
+		}
+		context.current = EntityId();
+
+		auto& root = context.entities.front();
+		applyTransform(root, i);
+		result.push_back(root);
+	}
+
+	return result;
+}
+
 void EntityFactory::updateEntity(EntityRef& entity, const IEntityData& data, int serializationMask, EntityScene* scene, IDataInterpolatorSetRetriever* interpolators)
 {
 	Expects(entity.isValid());
@@ -7,6 +7,7 @@
 #include "halley/resources/resource_data.h"
 #include "halley/support/logger.h"
 #include "halley/concurrency/concurrent.h"
+#include "halley/entity/prefab_blueprint.h"
 
 using namespace Halley;
 
@@ -254,7 +255,9 @@ EntityData* Prefab::findEntityData(const UUID& uuid)
 std::shared_ptr<Prefab> Prefab::clone() const
 {
 	waitForLoad(true);
-	return std::make_shared<Prefab>(*this);
+	auto result = std::make_shared<Prefab>(*this);
+	result->blueprint.reset();
+	return result;
 }
 
 void Prefab::preloadDependencies(Resources& resources) const
@@ -278,6 +281,18 @@ void Prefab::generateUUIDs()
 	entityData.updateComponentUUIDs(changes);
 }
 
+std::shared_ptr<const PrefabBlueprint> Prefab::getBlueprint(const WorldReflection& reflection) const
+{
+	waitForLoad(true);
+
+	auto result = std::atomic_load(&blueprint);
+	if (!result || &result->getReflection() != &reflection) {
+		result = std::make_shared<PrefabBlueprint>(*this, reflection);
+		std::atomic_store(&blueprint, result);
+	}
+	return result;
+}
+
 void Prefab::doPreloadDependencies(const EntityData& data, Resources& resources) const
 {
 	if (!data.getPrefab().isEmpty()) {
@@ -370,7 +385,9 @@ String Scene::getPrefabName() const
 std::shared_ptr<Prefab> Scene::clone() const
 {
 	waitForLoad(true);
-	return std::make_shared<Scene>(*this);
+	auto result = std::make_shared<Scene>(*this);
+	result->blueprint.reset();
+	return result;
 }
 
 ConfigNode Scene::entityToConfigNode() const
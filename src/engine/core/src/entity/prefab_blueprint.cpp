@@ -0,0 +1,54 @@
+#include "halley/entity/prefab_blueprint.h"
+#include "halley/entity/prefab.h"
+#include "halley/entity/world_reflection.h"
+#include "halley/support/logger.h"
+
+using namespace Halley;
+
+PrefabBlueprint::PrefabBlueprint(const Prefab& prefab, const WorldReflection& reflection)
+	: reflection(&reflection)
+	, prefabId(prefab.getAssetId())
+{
+	if (prefab.isScene()) {
+		return;
+	}
+
+	compiled = addNode(prefab.getEntityData(), -1);
+	if (!compiled) {
+		nodes.clear();
+	}
+}
+
+bool PrefabBlueprint::addNode(const EntityData& data, int parent)
+{
+	if (parent != -1 && !data.getPrefab().isEmpty()) {
+		// Nested prefab instances need their own instancing context
+		return false;
+	}
+
+	const int idx = static_cast<int>(nodes.size());
+	auto& node = nodes.emplace_back();
+	node.name = data.getName();
+	node.prefabUUID = data.getPrefabUUID();
+	node.parent = parent;
+	node.flags = data.getFlags();
+	node.variant = data.getVariant();
+	node.enableRules = data.getEnableRules();
+
+	node.components.reserve(data.getNumComponents());
+	for (const auto& [componentName, componentData]: data.getComponents()) {
+		if (const auto* reflector = reflection->tryGetComponentReflector(componentName)) {
+			node.components.push_back(Component{ reflector, ConfigNode(componentData) });
+		} else {
+			Logger::logError("Unknown component \"" + componentName + "\" in prefab \"" + prefabId + "\"");
+		}
+	}
+
+	for (const auto& child: data.getChildren()) {
+		if (!addNode(child, idx)) {
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -88,18 +88,26 @@ std::unique_ptr<World> World::make(const HalleyAPI& api, Resources& resources, c
 
 std::unique_ptr<World> World::make(const HalleyAPI& api, Resources& resources, const String& sceneName, const std::optional<String>& systemTag, bool devMode)
 {
+	ProfilerEvent event(ProfilerEventType::WorldInit, "World::make");
 	auto world = std::make_unique<World>(api, resources, std::make_shared<WorldReflection>(*CreateEntityFunctions::getCodegenFunctions()));
-	const auto& sceneConfig = resources.get<ConfigFile>(sceneName)->getRoot();
-	world->loadSystems(sceneConfig, systemTag);
+	world->loadSystems(resources.get<ConfigFile>(sceneName)->getView(), systemTag);
 	return world;
 }
 
 void World::loadSystems(const ConfigNode& root, const std::optional<String>& systemTag)
 {
-	for (const auto& [timelineName, tlSystems]: root["timelines"].asMap()) {
-		const TimeLine timeline = fromString<TimeLine>(timelineName);
+	const auto bytes = ConfigNodeView::compile(root);
+	loadSystems(ConfigNodeView(gsl::as_bytes(gsl::span<const Byte>(bytes))), systemTag);
+}
+
+void World::loadSystems(const ConfigNodeView& root, const std::optional<String>& systemTag)
+{
+	ProfilerEvent event(ProfilerEventType::WorldInit, "World::loadSystems");
+	const auto timelines = root["timelines"];
+	for (size_t i = 0; i < timelines.getMapSize(); ++i) {
+		const TimeLine timeline = fromString<TimeLine>(String(timelines.getMapKey(i)));
 
-		for (auto& systemEntry: tlSystems) {
+		for (const auto& systemEntry: timelines.getMapValue(i)) {
 			String systemName;
 			Vector<String> systemTags;
 
@@ -107,7 +115,11 @@ void World::loadSystems(const ConfigNode& root, const std::optional<String>& sys
 				systemName = systemEntry.asString();
 			} else if (systemEntry.getType() == ConfigNodeType::Map) {
 				systemName = systemEntry["name"].asString();
-				systemTags = systemEntry["tags"].asVector<String>({});
+				if (const auto tags = systemEntry["tags"]; tags.getType() == ConfigNodeType::Sequence) {
+					for (const auto& tag: tags) {
+						systemTags.push_back(tag.asString());
+					}
+				}
 			}
 
 			if (systemTags.empty() || !systemTag || std_ex::contains(systemTags, *systemTag)) {
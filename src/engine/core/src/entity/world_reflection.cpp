@@ -72,3 +72,9 @@ ComponentReflector& WorldReflection::getComponentReflector(const String& name) c
 {
 	return *componentReflectors[componentMap.at(name)];
 }
+
+const ComponentReflector* WorldReflection::tryGetComponentReflector(const String& name) const
+{
+	const auto iter = componentMap.find(name);
+	return iter != componentMap.end() ? componentReflectors[iter->second].get() : nullptr;
+}
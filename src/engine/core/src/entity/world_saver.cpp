@@ -0,0 +1,186 @@
+#include "halley/entity/world_saver.h"
+
+#include "halley/api/save_data.h"
+#include "halley/bytes/byte_serializer.h"
+#include "halley/bytes/compression.h"
+#include "halley/concurrency/concurrent.h"
+#include "halley/entity/prefab.h"
+#include "halley/entity/world.h"
+#include "halley/time/stopwatch.h"
+#include "halley/utils/algorithm.h"
+using namespace Halley;
+
+String WorldSaver::Report::toString() const
+{
+	auto ms = [] (int64_t ns) { return Halley::toString(double(ns) / 1000000.0, 2) + " ms"; };
+	return "Saved " + Halley::toString(entitiesSerialized + entitiesReused) + " entities (" + Halley::toString(entitiesSerialized) + " changed, "
+		+ Halley::toString(componentsSerialized) + " components re-encoded, " + Halley::toString(componentsReused) + " reused), "
+		+ String::prettySize(rawSize) + " -> " + String::prettySize(compressedSize)
+		+ ", stall " + ms(stallTimeNs) + ", background " + ms(backgroundTimeNs);
+}
+
+std::shared_ptr<Scene> WorldSaver::Snapshot::toScene() const
+{
+	EntityData root;
+	root.setSceneRoot(true);
+	auto& children = root.getChildren();
+	children.reserve(entities.size());
+	for (const auto& entity: entities) {
+		children.push_back(*entity);
+	}
+
+	auto scene = std::make_shared<Scene>();
+	scene->getEntityData() = std::move(root);
+	return scene;
+}
+
+Bytes WorldSaver::Snapshot::serialize() const
+{
+	return Serializer::toBytes(*toScene(), SerializerOptions(SerializerOptions::maxVersion));
+}
+
+Bytes WorldSaver::Snapshot::encode() const
+{
+	return Compression::compress(serialize());
+}
+
+WorldSaver::WorldSaver(World& world, Resources& resources, EntityFactory::SerializationOptions options)
+	: world(world)
+	, factory(world, resources)
+	, options(std::move(options))
+{
+}
+
+std::shared_ptr<const WorldSaver::Snapshot> WorldSaver::capture()
+{
+	auto roots = world.getTopLevelEntities();
+	std_ex::erase_if(roots, [] (const EntityRef& e) { return !e.isSerializable(); });
+	return capture(roots);
+}
+
+std::shared_ptr<const WorldSaver::Snapshot> WorldSaver::capture(gsl::span<const EntityRef> roots)
+{
+	Stopwatch timer;
+
+	auto result = std::make_shared<Snapshot>();
+	result->entities.reserve(roots.size());
+	++captureCount;
+
+	auto captureOptions = options;
+	captureOptions.serializeComponent = [&] (EntityRef entity, int componentId, const Component& component, const std::function<ConfigNode()>& serialize)
+	{
+		if (options.serializeComponent) {
+			return serializeComponent(entity, componentId, component, [&] () { return options.serializeComponent(entity, componentId, component, serialize); }, result->report);
+		}
+		return serializeComponent(entity, componentId, component, serialize, result->report);
+	};
+
+	// Rebuilt every time, so entities that are gone don't linger
+	HashMap<UUID, CachedEntity> newCache;
+	newCache.reserve(roots.size());
+
+	for (const auto& entity: roots) {
+		const auto changeRevision = entity.getChangeRevision();
+		const auto iter = cache.find(entity.getInstanceUUID());
+
+		std::shared_ptr<const EntityData> data;
+		if (changeRevision && iter != cache.end() && iter->second.changeRevision == changeRevision) {
+			data = iter->second.data;
+			markComponentsUsed(entity);
+			++result->report.entitiesReused;
+		} else {
+			data = std::make_shared<EntityData>(factory.serializeEntity(entity, captureOptions));
+			++result->report.entitiesSerialized;
+		}
+
+		result->entities.push_back(data);
+		newCache[entity.getInstanceUUID()] = CachedEntity{ changeRevision, std::move(data) };
+	}
+	cache = std::move(newCache);
+	std_ex::erase_if_value(componentCache, [&] (const CachedComponents& c) { return c.lastCapture != captureCount; });
+
+	timer.pause();
+	result->report.stallTimeNs = timer.elapsedNanoseconds();
+	return result;
+}
+
+ConfigNode WorldSaver::serializeComponent(EntityRef entity, int componentId, const Component& component, const std::function<ConfigNode()>& serialize, Report& report)
+{
+	const auto changeRevision = world.getReflection().getComponentReflector(componentId).getChangeRevision(component);
+	if (!changeRevision) {
+		++report.componentsSerialized;
+		return serialize();
+	}
+
+	auto& cached = componentCache[entity.getInstanceUUID()];
+	if (cached.lastCapture != captureCount) {
+		cached.lastCapture = captureCount;
+		if (cached.entityComponentRevision != entity.getComponentRevision()) {
+			cached.entityComponentRevision = entity.getComponentRevision();
+			cached.components.clear();
+		}
+	}
+
+	const auto iter = std::find_if(cached.components.begin(), cached.components.end(), [&] (const CachedComponent& c) { return c.componentId == componentId; });
+	if (iter != cached.components.end() && iter->changeRevision == *changeRevision) {
+		++report.componentsReused;
+		return ConfigNode(iter->data);
+	}
+
+	++report.componentsSerialized;
+	auto data = serialize();
+	if (iter != cached.components.end()) {
+		iter->changeRevision = *changeRevision;
+		iter->data = ConfigNode(data);
+	} else {
+		cached.components.push_back(CachedComponent{ componentId, *changeRevision, ConfigNode(data) });
+	}
+	return data;
+}
+
+void WorldSaver::markComponentsUsed(EntityRef entity)
+{
+	if (const auto iter = componentCache.find(entity.getInstanceUUID()); iter != componentCache.end()) {
+		iter->second.lastCapture = captureCount;
+	}
+	for (const auto child: entity.getChildren()) {
+		markComponentsUsed(child);
+	}
+}
+
+void WorldSaver::reset()
+{
+	cache.clear();
+	componentCache.clear();
+}
+
+Future<WorldSaver::Report> WorldSaver::save(ISaveData& saveData, String path)
+{
+	return write(capture(), saveData, std::move(path));
+}
+
+Future<WorldSaver::Report> WorldSaver::write(std::shared_ptr<const Snapshot> snapshot, ISaveData& saveData, String path)
+{
+	return Concurrent::execute(Executors::getDiskIO(), [snapshot = std::move(snapshot), &saveData, path = std::move(path)] () -> Report
+	{
+		Stopwatch timer;
+		Report report = snapshot->getReport();
+
+		const auto raw = snapshot->serialize();
+		const auto bytes = Compression::compress(raw);
+		saveData.setData(path, bytes);
+
+		report.rawSize = raw.size();
+		report.compressedSize = bytes.size();
+		timer.pause();
+		report.backgroundTimeNs = timer.elapsedNanoseconds();
+		return report;
+	});
+}
+
+std::shared_ptr<Scene> WorldSaver::decode(const Bytes& data)
+{
+	auto scene = std::make_shared<Scene>();
+	Deserializer::fromBytes(*scene, Compression::decompress(data), SerializerOptions(SerializerOptions::maxVersion));
+	return scene;
+}
@@ -355,7 +355,7 @@ bool Path::operator==(gsl::span<const String> other) const
 #if defined(_WIN32) || defined(__APPLE__)
 		if (a.size() != b.size() || !a.asciiCompareNoCase(b.c_str())) {
 #else
-		if (a == b) {
+		if (a != b) {
 #endif
 			return false;
 		}
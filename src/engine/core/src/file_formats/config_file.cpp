@@ -3,7 +3,10 @@
 #include "halley/support/exception.h"
 #include "halley/resources/resource_collection.h"
 #include "halley/file_formats/yaml_convert.h"
+#include "halley/data_structures/config_node_arena.h"
+#include "halley/resources/resource_data.h"
 #include "config_file_serialization_state.h"
+#include <mutex>
 
 using namespace Halley;
 
@@ -12,9 +15,23 @@ public:
 	bool storeFilePosition = false;
 };
 
+struct ConfigFile::CompiledData {
+	std::unique_ptr<ResourceDataStatic> data; // Compiled asset data, if loaded from it
+	Bytes bytes; // Otherwise, root compiled on demand
+	ConfigNodeView view;
+	std::mutex mutex;
+	std::atomic<bool> hasView = false;
+	std::atomic<bool> materialized = false;
+};
+
+ConfigFile::ConfigFile()
+{
+	updateRoot();
+}
+
 ConfigFile::ConfigFile(const ConfigFile& other)
 {
-	root = ConfigNode(other.root);
+	root = ConfigNode(other.getRoot());
 	updateRoot();
 }
 
@@ -27,26 +44,61 @@ ConfigFile::ConfigFile(ConfigNode root)
 ConfigFile::ConfigFile(ConfigFile&& other) noexcept
 {
 	root = std::move(other.root);
+	arena = std::move(other.arena);
+	compiled = std::move(other.compiled);
 	updateRoot();
 }
 
+ConfigFile::~ConfigFile() = default;
+
 ConfigFile& ConfigFile::operator=(ConfigFile&& other) noexcept
 {
 	root = std::move(other.root);
+	arena = std::move(other.arena);
+	compiled = std::move(other.compiled);
 	updateRoot();
 	return *this;
 }
 
 ConfigNode& ConfigFile::getRoot()
 {
+	materializeRoot();
+
+	// Callers may mutate the tree, so it can't stay frozen, and the view has to be compiled again from it
+	root.thaw();
+	if (compiled && compiled->hasView) {
+		compiled->hasView = false;
+		compiled->view = ConfigNodeView();
+		compiled->bytes.clear();
+		compiled->data.reset();
+	}
 	return root;
 }
 
 const ConfigNode& ConfigFile::getRoot() const
 {
+	materializeRoot();
 	return root;
 }
 
+ConfigNodeView ConfigFile::getView() const
+{
+	if (!compiled) {
+		// Only a moved-from file has nothing to view
+		return {};
+	}
+
+	if (!compiled->hasView.load(std::memory_order_acquire)) {
+		std::unique_lock lock(compiled->mutex);
+		if (!compiled->hasView.load(std::memory_order_relaxed)) {
+			compiled->bytes = ConfigNodeView::compile(root);
+			compiled->view = ConfigNodeView(gsl::as_bytes(gsl::span<const Byte>(compiled->bytes)));
+			compiled->hasView.store(true, std::memory_order_release);
+		}
+	}
+	return compiled->view;
+}
+
 constexpr int curVersion = 3;
 
 void ConfigFile::serialize(Serializer& s) const
@@ -59,7 +111,7 @@ void ConfigFile::serialize(Serializer& s) const
 	state.storeFilePosition = storeFilePosition;
 	const auto oldState = s.setState(&state);
 	
-	s << root;
+	s << getRoot();
 
 	s.setState(oldState);
 }
@@ -89,7 +141,11 @@ void ConfigFile::deserialize(Deserializer& s)
 
 size_t ConfigFile::getSizeBytes() const
 {
-	return root.getSizeBytes();
+	size_t compiledSize = 0;
+	if (compiled) {
+		compiledSize = (compiled->data ? compiled->data->getSize() : 0) + compiled->bytes.size();
+	}
+	return root.getSizeBytes() + (arena ? arena->getSizeBytes() : 0) + compiledSize;
 }
 
 ResourceMemoryUsage ConfigFile::getMemoryUsage() const
@@ -107,8 +163,18 @@ std::unique_ptr<ConfigFile> ConfigFile::loadResource(ResourceLoader& loader)
 	}
 	
 	auto config = std::make_unique<ConfigFile>();
-	Deserializer s(data->getSpan(), SerializerOptions());
-	s >> *config;
+	if (ConfigNodeView::isCompiled(data->getSpan())) {
+		// Nodes are only built if something asks for the root, reads through getView() don't need them
+		config->compiled = std::make_unique<CompiledData>();
+		config->compiled->view = ConfigNodeView(data->getSpan());
+		config->compiled->data = std::move(data);
+		config->compiled->hasView = true;
+		config->storeFilePosition = false;
+	} else {
+		Deserializer s(data->getSpan(), SerializerOptions());
+		s >> *config;
+		config->freeze();
+	}
 
 	return config;
 }
@@ -122,6 +188,39 @@ void ConfigFile::reload(Resource&& resource)
 void ConfigFile::updateRoot()
 {
 	root.propagateParentingInformation(this);
+
+	if (!compiled) {
+		// The root is already built, getView() compiles it the first time it's called
+		compiled = std::make_unique<CompiledData>();
+		compiled->materialized = true;
+	}
+}
+
+void ConfigFile::materializeRoot() const
+{
+	if (!compiled || compiled->materialized.load(std::memory_order_acquire)) {
+		return;
+	}
+
+	std::unique_lock lock(compiled->mutex);
+	if (!compiled->materialized.load(std::memory_order_relaxed)) {
+		// Building the root on first access doesn't change the file's logical contents
+		auto& self = const_cast<ConfigFile&>(*this);
+		self.root = compiled->view.toConfigNode();
+		self.freeze();
+		self.updateRoot();
+		compiled->materialized.store(true, std::memory_order_release);
+	}
+}
+
+void ConfigFile::freeze()
+{
+#if !defined(STORE_CONFIG_NODE_PARENTING)
+	// Dev builds keep the regular tree, as frozen nodes can't point back to their file and line
+	if (auto newArena = ConfigNodeArena::freeze(root)) {
+		arena = std::move(newArena);
+	}
+#endif
 }
 
 ConfigObserver::ConfigObserver()
@@ -135,17 +234,24 @@ ConfigObserver::ConfigObserver(const ConfigNode& node)
 
 ConfigObserver::ConfigObserver(const ConfigFile& file)
 	: file(&file)
-	, node(&file.getRoot())
 {
-	assert(node->getType() != ConfigNodeType::Undefined);
+	// The file's root is only requested on update, so observing a compiled file doesn't build its nodes
 }
 
 const ConfigNode& ConfigObserver::getRoot() const
 {
+	if (file) {
+		return file->getRoot();
+	}
 	Expects(node);
 	return *node;
 }
 
+ConfigNodeView ConfigObserver::getView() const
+{
+	return file ? file->getView() : ConfigNodeView();
+}
+
 bool ConfigObserver::needsUpdate() const
 {
 	return file && assetVersion != file->getAssetVersion();
@@ -155,8 +261,6 @@ void ConfigObserver::update()
 {
 	if (file) {
 		assetVersion = file->getAssetVersion();
-		node = &file->getRoot();
-		assert(node->getType() == ConfigNodeType::Map);
 	}
 }
 
@@ -1,6 +1,7 @@
 #include "halley/file_formats/hlif_file.h"
 
 #include "halley/bytes/compression.h"
+#include "halley/concurrency/concurrent.h"
 
 using namespace Halley;
 
@@ -17,45 +18,133 @@ void HLIFFile::decode(Image& dst, gsl::span<const gsl::byte> bytes)
 	memcpy(&header, bytes.data(), sizeof(header));
 
 	const int bpp = header.numPalettes > 0 ? 1 : getBPP(header.format);
-	if (header.uncompressedSize != static_cast<uint32_t>(header.width * header.height * bpp + header.height + header.numPalettes * sizeof(Palette))) {
+	const size_t paletteSize = header.numPalettes * sizeof(Palette);
+	const size_t pixelSize = static_cast<size_t>(header.width) * header.height * bpp;
+	if (header.uncompressedSize != static_cast<uint32_t>(pixelSize + header.height + paletteSize)) {
 		throw Exception("Invalid HLIF file encoding.", HalleyExceptions::Utils);
 	}
+	if (bytes.size() < sizeof(header) + header.compressedSize) {
+		throw Exception("Invalid HLIF file.", HalleyExceptions::Utils);
+	}
+
+	const auto imgFormat = header.format == Format::RGBA ?
+		((header.flags & static_cast<uint8_t>(Flags::Premultiplied)) ? Image::Format::RGBAPremultiplied : Image::Format::RGBA) :
+		(header.format == Format::SingleChannel ? Image::Format::SingleChannel : Image::Format::Indexed);
+	const auto imgSize = Vector2i(header.width, header.height);
+	dst = Image(imgFormat, imgSize, false);
+
+	const auto data = bytes.subspan(sizeof(header), header.compressedSize);
+
+	if (memcmp(header.id, hlifIdV2, 8) == 0) {
+		// Paletted images are expanded band by band, otherwise bands are decoded straight into the image
+		Bytes metaData;
+		metaData.resize_no_init(paletteSize + header.height);
+		Bytes palettedData;
+		gsl::span<uint8_t> pixelData;
+		if (header.numPalettes > 0) {
+			palettedData.resize_no_init(pixelSize);
+			pixelData = palettedData;
+		} else {
+			pixelData = dst.getPixelBytes().subspan(0, pixelSize);
+		}
+
+		decodeBands(header, data, metaData, pixelData, bpp, header.numPalettes > 0 ? dst.getPixels4BPP() : gsl::span<int>());
+		return;
+	}
 
 	Bytes decompressedData;
 	decompressedData.resize_no_init(header.uncompressedSize);
-	const auto decompressedSize = Compression::lz4Decompress(bytes.subspan(sizeof(header), header.compressedSize), decompressedData.byte_span());
+	const auto decompressedSize = Compression::lz4Decompress(data, decompressedData.byte_span());
 	if (!decompressedSize) {
 		throw Exception("Error decoding HLIF file.", HalleyExceptions::Utils);
 	}
 	decompressedData.resize(*decompressedSize);
 
 	const auto dataSpan = gsl::span<Byte>(decompressedData);
-	const auto paletteData = dataSpan.subspan(0, header.numPalettes * sizeof(Palette));
+	const auto paletteData = dataSpan.subspan(0, paletteSize);
 	const auto lineData = dataSpan.subspan(paletteData.size(), header.height);
 	const auto pixelData = dataSpan.subspan(paletteData.size() + lineData.size());
-	const auto imgFormat = header.format == Format::RGBA ?
-		((header.flags & static_cast<uint8_t>(Flags::Premultiplied)) ? Image::Format::RGBAPremultiplied : Image::Format::RGBA) :
-		(header.format == Format::SingleChannel ? Image::Format::SingleChannel : Image::Format::Indexed);
-	const auto imgSize = Vector2i(header.width, header.height);
 
 	decodeLines(imgSize, lineData, pixelData, bpp);
 
-	dst = Image(imgFormat, imgSize, false);
 	if (header.numPalettes > 0) {
-		Vector<Palette> palettes(header.numPalettes);
-		memcpy(palettes.data(), paletteData.data(), paletteData.size());
-		deltaDecodePalettes(palettes);
-		applyPalettes(pixelData, palettes, dst.getPixels4BPP());
+		const auto palettes = readPalettes(paletteData);
+		const auto dstPixels = dst.getPixels4BPP();
+		constexpr size_t pixelsPerJob = 64 * 1024;
+		Concurrent::parallelFor((pixelData.size() + pixelsPerJob - 1) / pixelsPerJob, [&] (size_t job)
+		{
+			const size_t start = job * pixelsPerJob;
+			const size_t count = std::min(pixelsPerJob, pixelData.size() - start);
+			applyPalettes(pixelData.subspan(start, count), palettes, dstPixels.subspan(start, count), start);
+		});
 	} else {
 		memcpy(dst.getPixelBytes().data(), pixelData.data(), pixelData.size_bytes());
 	}
 }
 
+void HLIFFile::decodeBands(const Header& header, gsl::span<const gsl::byte> data, gsl::span<uint8_t> metaData, gsl::span<uint8_t> pixelData, int bpp, gsl::span<int> dst)
+{
+	BandTable table;
+	if (data.size() < sizeof(table)) {
+		throw Exception("Invalid HLIF file.", HalleyExceptions::Utils);
+	}
+	memcpy(&table, data.data(), sizeof(table));
+	if (table.rowsPerBand == 0 || table.numBands != (header.height + table.rowsPerBand - 1) / table.rowsPerBand) {
+		throw Exception("Invalid HLIF file encoding.", HalleyExceptions::Utils);
+	}
+
+	const size_t numChunks = static_cast<size_t>(table.numBands) + 1;
+	const size_t tableSize = sizeof(table) + numChunks * sizeof(uint32_t);
+	if (data.size() < tableSize) {
+		throw Exception("Invalid HLIF file.", HalleyExceptions::Utils);
+	}
+	Vector<uint32_t> chunkSizes(numChunks);
+	memcpy(chunkSizes.data(), data.data() + sizeof(table), numChunks * sizeof(uint32_t));
+	Vector<size_t> chunkOffsets(numChunks);
+	size_t pos = tableSize;
+	for (size_t i = 0; i < numChunks; ++i) {
+		chunkOffsets[i] = pos;
+		pos += chunkSizes[i];
+	}
+	if (pos > data.size()) {
+		throw Exception("Invalid HLIF file.", HalleyExceptions::Utils);
+	}
+
+	auto decompressChunk = [&] (size_t idx, gsl::span<uint8_t> out)
+	{
+		const auto result = Compression::lz4Decompress(data.subspan(chunkOffsets[idx], chunkSizes[idx]), gsl::as_writable_bytes(out));
+		if (!result || *result != out.size()) {
+			throw Exception("Error decoding HLIF file.", HalleyExceptions::Utils);
+		}
+	};
+
+	decompressChunk(0, metaData);
+	const auto paletteData = metaData.subspan(0, header.numPalettes * sizeof(Palette));
+	const auto lineData = metaData.subspan(paletteData.size());
+	const auto palettes = readPalettes(paletteData);
+
+	const size_t stride = static_cast<size_t>(header.width) * bpp;
+	Concurrent::parallelFor(table.numBands, [&] (size_t band)
+	{
+		const int y0 = static_cast<int>(band * table.rowsPerBand);
+		const int y1 = std::min(static_cast<int>(header.height), y0 + static_cast<int>(table.rowsPerBand));
+		const auto bandPixels = pixelData.subspan(y0 * stride, (y1 - y0) * stride);
+
+		decompressChunk(band + 1, bandPixels);
+		decodeLines(Vector2i(header.width, y1 - y0), lineData.subspan(y0, y1 - y0), bandPixels, bpp);
+
+		if (!palettes.empty()) {
+			const size_t firstPixel = static_cast<size_t>(y0) * header.width;
+			applyPalettes(bandPixels, palettes, dst.subspan(firstPixel, bandPixels.size()), firstPixel);
+		}
+	});
+}
+
 Bytes HLIFFile::encode(const Image& image, std::string_view name, bool lz4hc)
 {
 	// Fill header
 	Header header;
-	memcpy(header.id, hlifId, 8);
+	memcpy(header.id, hlifIdV2, 8);
 	switch (image.getFormat()) {
 	case Image::Format::RGBA:
 		header.format = Format::RGBA;
@@ -94,41 +183,75 @@ Bytes HLIFFile::encode(const Image& image, std::string_view name, bool lz4hc)
 	header.uncompressedSize = header.width * header.height * bpp + header.height + static_cast<uint32_t>(palettes.size() * sizeof(Palette));
 
 	// Prepare uncompressed data
-	Bytes uncompressed;
-	uncompressed.resize_no_init(header.uncompressedSize);
-	const auto dataSpan = gsl::span<Byte>(uncompressed);
-	const auto paletteSpan = dataSpan.subspan(0, palettes.size() * sizeof(Palette));
-	const auto lineSpan = dataSpan.subspan(paletteSpan.size(), header.height);
-	const auto pixelSpan = dataSpan.subspan(paletteSpan.size() + lineSpan.size());
+	Bytes metaData;
+	metaData.resize_no_init(palettes.size() * sizeof(Palette) + header.height);
+	const auto metaSpan = gsl::span<Byte>(metaData);
+	const auto lineSpan = metaSpan.subspan(palettes.size() * sizeof(Palette));
+	memcpy(metaSpan.data(), palettes.data(), palettes.size() * sizeof(Palette));
+	memset(lineSpan.data(), 0, lineSpan.size_bytes());
+
+	Bytes pixelData;
 	if (palettes.empty()) {
-		memcpy(pixelSpan.data(), image.getPixelBytes().data(), pixelSpan.size());
+		pixelData.resize_no_init(static_cast<size_t>(header.width) * header.height * bpp);
+		memcpy(pixelData.data(), image.getPixelBytes().data(), pixelData.size());
 	} else {
-		memcpy(paletteSpan.data(), palettes.data(), paletteSpan.size());
-		memcpy(pixelSpan.data(), palettedImage.data(), pixelSpan.size());
+		pixelData = std::move(palettedImage);
 	}
-	memset(lineSpan.data(), 0, lineSpan.size_bytes());
+	const auto pixelSpan = gsl::span<Byte>(pixelData);
 
-	// Try compressing with no filters first
 	Compression::LZ4Options options;
 	options.mode = lz4hc ? Compression::LZ4Mode::HC : Compression::LZ4Mode::Normal;
-	//options.level = 12;
-	auto compressedUnfiltered = Compression::lz4Compress(gsl::as_bytes(dataSpan), options);
 
-	// Filter and compress again
-	encodeLines(image.getSize(), lineSpan, pixelSpan, bpp);
-	auto compressedFiltered = Compression::lz4Compress(gsl::as_bytes(dataSpan), options);
-	uncompressed = {};
+	// Compress each band independently, both filtered and unfiltered, and keep the best of the two
+	BandTable table;
+	table.rowsPerBand = static_cast<uint32_t>(getRowsPerBand(header.width));
+	table.numBands = (header.height + table.rowsPerBand - 1) / table.rowsPerBand;
+	const size_t stride = static_cast<size_t>(header.width) * bpp;
 
-	// Take the best of the two
-	const auto compressed = compressedUnfiltered.size() < compressedFiltered.size() ? std::move(compressedUnfiltered) : std::move(compressedFiltered);
-	compressedFiltered = {};
-	compressedUnfiltered = {};
+	Vector<Bytes> chunks(static_cast<size_t>(table.numBands) + 1);
+	Concurrent::parallelFor(table.numBands, [&] (size_t band)
+	{
+		const int y0 = static_cast<int>(band * table.rowsPerBand);
+		const int y1 = std::min(static_cast<int>(header.height), y0 + static_cast<int>(table.rowsPerBand));
+		const auto bandPixels = pixelSpan.subspan(y0 * stride, (y1 - y0) * stride);
+		const auto bandLines = lineSpan.subspan(y0, y1 - y0);
+
+		auto compressedUnfiltered = Compression::lz4Compress(gsl::as_bytes(bandPixels), options);
+		encodeLines(Vector2i(header.width, y1 - y0), bandLines, bandPixels, bpp);
+		auto compressedFiltered = Compression::lz4Compress(gsl::as_bytes(bandPixels), options);
+
+		if (compressedUnfiltered.size() <= compressedFiltered.size()) {
+			memset(bandLines.data(), 0, bandLines.size_bytes());
+			chunks[band + 1] = std::move(compressedUnfiltered);
+		} else {
+			chunks[band + 1] = std::move(compressedFiltered);
+		}
+	});
+	chunks[0] = Compression::lz4Compress(gsl::as_bytes(metaSpan), options);
 
 	// Finish header and generate final bytes
-	header.compressedSize = static_cast<uint32_t>(compressed.size());
-	Bytes finalData(sizeof(header) + compressed.size());
-	memcpy(finalData.data(), &header, sizeof(header));
-	memcpy(finalData.data() + sizeof(header), compressed.data(), compressed.size());
+	size_t totalSize = sizeof(table) + chunks.size() * sizeof(uint32_t);
+	for (const auto& chunk: chunks) {
+		totalSize += chunk.size();
+	}
+	header.compressedSize = static_cast<uint32_t>(totalSize);
+
+	Bytes finalData(sizeof(header) + totalSize);
+	size_t pos = 0;
+	auto write = [&] (const void* src, size_t size)
+	{
+		memcpy(finalData.data() + pos, src, size);
+		pos += size;
+	};
+	write(&header, sizeof(header));
+	write(&table, sizeof(table));
+	for (const auto& chunk: chunks) {
+		const auto chunkSize = static_cast<uint32_t>(chunk.size());
+		write(&chunkSize, sizeof(chunkSize));
+	}
+	for (const auto& chunk: chunks) {
+		write(chunk.data(), chunk.size());
+	}
 	return finalData;
 }
 
@@ -152,7 +275,7 @@ HLIFFile::Info HLIFFile::getInfo(gsl::span<const gsl::byte> bytes)
 
 bool HLIFFile::isHLIF(gsl::span<const gsl::byte> bytes)
 {
-	return bytes.size() >= 8 && memcmp(bytes.data(), hlifId, 8) == 0;
+	return bytes.size() >= 8 && (memcmp(bytes.data(), hlifIdV2, 8) == 0 || memcmp(bytes.data(), hlifIdV1, 8) == 0);
 }
 
 void HLIFFile::decodeLines(Vector2i size, gsl::span<const uint8_t> lineData, gsl::span<uint8_t> pixelData, int bpp)
@@ -177,7 +300,7 @@ void HLIFFile::encodeLines(Vector2i size, gsl::span<uint8_t> lineData, gsl::span
 
 	Bytes blankLine(stride, 0);
 	
-	for (int y = size.y - 1; --y >= 0;) {
+	for (int y = size.y; --y >= 0;) {
 		const auto curLine = pixelData.subspan(y * stride, stride);
 		const auto prevLine = y > 0 ? pixelData.subspan((y - 1) * stride, stride) : gsl::span<const uint8_t>(blankLine);
 		const auto encoding = findBestLineEncoding(curLine, prevLine, bpp);
@@ -329,6 +452,20 @@ int HLIFFile::getBPP(Format format)
 	return format == Format::RGBA ? 4 : 1;
 }
 
+int HLIFFile::getRowsPerBand(int width)
+{
+	// Roughly 64k pixels per band, enough for LZ4 to find matches while giving plenty of parallelism on large atlases
+	return std::clamp(64 * 1024 / std::max(width, 1), 8, 1024);
+}
+
+Vector<HLIFFile::Palette> HLIFFile::readPalettes(gsl::span<const uint8_t> paletteData)
+{
+	Vector<Palette> palettes(paletteData.size() / sizeof(Palette));
+	memcpy(palettes.data(), paletteData.data(), palettes.size() * sizeof(Palette));
+	deltaDecodePalettes(palettes);
+	return palettes;
+}
+
 std::optional<std::pair<Vector<HLIFFile::Palette>, Bytes>> HLIFFile::makePalettes(gsl::span<const int> pixels, std::string_view name)
 {
 	HashMap<int, uint8_t> paletteEntries;
@@ -418,17 +555,22 @@ void HLIFFile::optimizePalettes(gsl::span<Palette> palettes, gsl::span<uint8_t>
 	}
 }
 
-void HLIFFile::applyPalettes(gsl::span<const uint8_t> palettedImage, gsl::span<const Palette> palettes, gsl::span<int> dst)
+void HLIFFile::applyPalettes(gsl::span<const uint8_t> palettedImage, gsl::span<const Palette> palettes, gsl::span<int> dst, size_t firstPixel)
 {
 	assert(palettedImage.size() == dst.size());
 
+	// palettedImage and dst start at firstPixel, while palette ranges are relative to the whole image
+	const size_t lastPixel = firstPixel + palettedImage.size();
 	size_t startPos = 0;
 	for (const auto& palette: palettes) {
-		const size_t endPos = palette.endPixel;
-		for (size_t i = startPos; i < endPos; ++i) {
-			dst[i] = palette.entries[palettedImage[i]];
+		const size_t endPos = std::min(static_cast<size_t>(palette.endPixel), lastPixel);
+		for (size_t i = std::max(startPos, firstPixel); i < endPos; ++i) {
+			dst[i - firstPixel] = palette.entries[palettedImage[i - firstPixel]];
+		}
+		startPos = palette.endPixel;
+		if (startPos >= lastPixel) {
+			break;
 		}
-		startPos = endPos;
 	}
 }
 
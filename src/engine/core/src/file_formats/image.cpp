@@ -20,6 +20,7 @@
 \*****************************************************************/
 
 #include <cassert>
+#include <algorithm>
 #include "halley/file_formats/image.h"
 #include "../../../../contrib/stb_image/stb_image.h"
 #include "../../../../contrib/lodepng/lodepng.h"
@@ -30,6 +31,8 @@
 #include "halley/bytes/compression.h"
 #include "halley/file_formats/hlif_file.h"
 #include "halley/support/logger.h"
+#include "halley/concurrency/concurrent.h"
+#include "halley/maths/simd.h"
 #include "qoi/qoi.h"
 
 namespace {
@@ -38,6 +41,63 @@ namespace {
 		uint16_t height;
 		Halley::Image::Format format;
 	};
+
+	// Images smaller than this aren't worth splitting across threads
+	constexpr size_t parallelPixelThreshold = 256 * 1024;
+	constexpr int rowsPerBand = 32;
+
+	template <typename F>
+	void forEachRowBand(int rows, size_t pixelsPerRow, F f)
+	{
+		if (rows <= 0) {
+			return;
+		}
+		if (size_t(rows) * pixelsPerRow < parallelPixelThreshold) {
+			f(0, rows);
+			return;
+		}
+
+		const int nBands = (rows + rowsPerBand - 1) / rowsPerBand;
+		Halley::Concurrent::parallelFor(size_t(nBands), [&] (size_t band)
+		{
+			const int y0 = int(band) * rowsPerBand;
+			f(y0, std::min(rows, y0 + rowsPerBand));
+		});
+	}
+
+	void preMultiplyPixels(unsigned int* data, size_t n)
+	{
+		size_t i = 0;
+
+#ifdef HAS_SSE
+		// Four pixels at a time, each channel widened to 16 bits so that c * (a + 1) can't overflow
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i one = _mm_set1_epi16(1);
+		const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+		for (; i + 4 <= n; i += 4) {
+			const __m128i src = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+			const __m128i lo = _mm_unpacklo_epi8(src, zero);
+			const __m128i hi = _mm_unpackhi_epi8(src, zero);
+			const __m128i alphaLo = _mm_add_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)), one);
+			const __m128i alphaHi = _mm_add_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)), one);
+			const __m128i mulLo = _mm_srli_epi16(_mm_mullo_epi16(lo, alphaLo), 8);
+			const __m128i mulHi = _mm_srli_epi16(_mm_mullo_epi16(hi, alphaHi), 8);
+			const __m128i result = _mm_or_si128(_mm_andnot_si128(alphaMask, _mm_packus_epi16(mulLo, mulHi)), _mm_and_si128(src, alphaMask));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), result);
+		}
+#endif
+
+		for (; i < n; i++) {
+			unsigned int cur = data[i];
+			unsigned int r, g, b, a;
+			Halley::Image::convertIntToRGBA(cur, r, g, b, a);
+			++a;
+			data[i] = ((r * a >> 8) & 0xFF)
+				| ((g * a) & 0xFF00)
+				| ((b * a << 8) & 0xFF0000)
+				| ((a-1) << 24);
+		}
+	}
 }
 
 using namespace Halley;
@@ -195,30 +255,43 @@ void Image::clear(int colour)
 
 void Image::blitFrom(Vector2i pos, gsl::span<const unsigned char> buffer, size_t width, size_t height, size_t pitch, size_t srcBpp)
 {
+	if (pos.x >= int(w) || pos.y >= int(h)) {
+		return;
+	}
+
 	const size_t xMin = std::max(0, -pos.x);
 	const size_t yMin = std::max(0, -pos.y);
 	const size_t xMax = std::min(size_t(w) - pos.x, width);
 	const size_t yMax = std::min(size_t(h) - pos.y, height);
+	if (xMin >= xMax || yMin >= yMax) {
+		return;
+	}
+	const int rows = int(yMax - yMin);
+	const size_t cols = xMax - xMin;
 
 	if (getBytesPerPixel() == 1) {
 		unsigned char* dst = px.get() + pos.x + pos.y * w;
 		if (srcBpp == 1) {
 			const unsigned char* src = reinterpret_cast<const unsigned char*>(buffer.data());
-			for (size_t y = yMin; y < yMax; y++) {
-				for (size_t x = xMin; x < xMax; x++) {
-					size_t pxPos = (x >> 3) + y * pitch;
-					int bit = 1 << (int(7 - x) & 7);
-					bool active = (src[pxPos] & bit) != 0;
-					dst[x + y * w] = active ? 0xFF : 0;
+			forEachRowBand(rows, cols, [&] (int y0, int y1)
+			{
+				for (size_t y = yMin + y0; y < yMin + y1; y++) {
+					for (size_t x = xMin; x < xMax; x++) {
+						size_t pxPos = (x >> 3) + y * pitch;
+						int bit = 1 << (int(7 - x) & 7);
+						bool active = (src[pxPos] & bit) != 0;
+						dst[x + y * w] = active ? 0xFF : 0;
+					}
 				}
-			}
+			});
 		} else if (srcBpp == 8) {
 			const unsigned char* src = reinterpret_cast<const unsigned char*>(buffer.data());
-			for (size_t y = yMin; y < yMax; y++) {
-				for (size_t x = xMin; x < xMax; x++) {
-					dst[x + y * w] = src[x + y * pitch];
+			forEachRowBand(rows, cols, [&] (int y0, int y1)
+			{
+				for (size_t y = yMin + y0; y < yMin + y1; y++) {
+					memcpy(dst + xMin + y * w, src + xMin + y * pitch, cols);
 				}
-			}
+			});
 		} else if (srcBpp == 32) {
 			throw Exception("Cannot blit from 32-bit to 8-bit.", HalleyExceptions::Utils);
 		} else {
@@ -228,34 +301,40 @@ void Image::blitFrom(Vector2i pos, gsl::span<const unsigned char> buffer, size_t
 		int* dst = reinterpret_cast<int*>(px.get());
 		if (srcBpp == 1) {
 			const unsigned char* src = reinterpret_cast<const unsigned char*>(buffer.data());
-			for (size_t y = yMin; y < yMax; y++) {
-				size_t dy = y + pos.y;
-				for (size_t x = xMin; x < xMax; x++) {
-					size_t dx = x + pos.x;
-					size_t pxPos = (x >> 3) + y * pitch;
-					int bit = 1 << (int(7 - x) & 7);
-					bool active = (src[pxPos] & bit) != 0;
-					dst[dx + dy * w] = convertRGBAToInt(255, 255, 255, active ? 255 : 0);
+			forEachRowBand(rows, cols, [&] (int y0, int y1)
+			{
+				for (size_t y = yMin + y0; y < yMin + y1; y++) {
+					size_t dy = y + pos.y;
+					for (size_t x = xMin; x < xMax; x++) {
+						size_t dx = x + pos.x;
+						size_t pxPos = (x >> 3) + y * pitch;
+						int bit = 1 << (int(7 - x) & 7);
+						bool active = (src[pxPos] & bit) != 0;
+						dst[dx + dy * w] = convertRGBAToInt(255, 255, 255, active ? 255 : 0);
+					}
 				}
-			}
+			});
 		} else if (srcBpp == 8) {
 			const unsigned char* src = reinterpret_cast<const unsigned char*>(buffer.data());
-			for (size_t y = yMin; y < yMax; y++) {
-				size_t dy = y + pos.y;
-				for (size_t x = xMin; x < xMax; x++) {
-					size_t dx = x + pos.x;
-					dst[dx + dy * w] = convertRGBAToInt(255, 255, 255, src[x + y * pitch]);
+			forEachRowBand(rows, cols, [&] (int y0, int y1)
+			{
+				for (size_t y = yMin + y0; y < yMin + y1; y++) {
+					size_t dy = y + pos.y;
+					for (size_t x = xMin; x < xMax; x++) {
+						size_t dx = x + pos.x;
+						dst[dx + dy * w] = convertRGBAToInt(255, 255, 255, src[x + y * pitch]);
+					}
 				}
-			}
+			});
 		} else if (srcBpp == 32) {
 			const int* src = reinterpret_cast<const int*>(buffer.data());
-			for (size_t y = yMin; y < yMax; y++) {
-				size_t dy = y + pos.y;
-				for (size_t x = xMin; x < xMax; x++) {
-					size_t dx = x + pos.x;
-					dst[dx + dy * w] = src[x + y * pitch];
+			forEachRowBand(rows, cols, [&] (int y0, int y1)
+			{
+				for (size_t y = yMin + y0; y < yMin + y1; y++) {
+					size_t dy = y + pos.y;
+					memcpy(dst + xMin + pos.x + dy * w, src + xMin + y * pitch, cols * sizeof(int));
 				}
-			}
+			});
 		} else {
 			throw Exception("Unknown amount of bits per pixel: " + toString(srcBpp), HalleyExceptions::Utils);
 		}
@@ -321,16 +400,26 @@ void Image::blitDownsampled(Image& srcImg, int scale)
 	const auto dstSize = getSize();
 	const auto rectW = std::min(dstSize.x, srcSize.x / scale);
 	const auto rectH = std::min(dstSize.y, srcSize.y / scale);
-	auto dst = getPixels4BPP();
-	auto src = srcImg.getPixels4BPP();
-	
-	for (int y = 0; y < rectH; ++y) {
-		auto dstRow = dst.subspan(y * dstSize.x, dstSize.x);
-		auto srcRow = src.subspan(y * scale * srcSize.x, srcSize.x);
-		for (int x = 0; x < rectW; ++x) {
-			dstRow[x] = srcRow[x * scale];
-		}
+	if (rectW <= 0 || rectH <= 0) {
+		return;
 	}
+	int* dst = getPixels4BPP().data();
+	const int* src = srcImg.getPixels4BPP().data();
+
+	forEachRowBand(rectH, size_t(rectW) * scale, [&] (int y0, int y1)
+	{
+		for (int y = y0; y < y1; ++y) {
+			int* dstRow = dst + size_t(y) * dstSize.x;
+			const int* srcRow = src + size_t(y) * scale * srcSize.x;
+			if (scale == 1) {
+				memcpy(dstRow, srcRow, size_t(rectW) * sizeof(int));
+			} else {
+				for (int x = 0; x < rectW; ++x) {
+					dstRow[x] = srcRow[x * scale];
+				}
+			}
+		}
+	});
 }
 
 namespace {
@@ -481,34 +570,28 @@ void Image::preMultiply()
 {
 	Expects(format == Format::RGBA);
 
-	size_t n = w * h;
 	unsigned int* data = reinterpret_cast<unsigned int*>(px.get());
-	for (size_t i = 0; i < n; i++) {
-		unsigned int cur = data[i];
-		unsigned int r, g, b, a;
-		convertIntToRGBA(cur, r, g, b, a);
-		++a;
-		data[i] = ((r * a >> 8) & 0xFF)
-			    | ((g * a) & 0xFF00)
-				| ((b * a << 8) & 0xFF0000)
-				| ((a-1) << 24);
-	}
+	forEachRowBand(int(h), w, [&] (int y0, int y1)
+	{
+		preMultiplyPixels(data + size_t(y0) * w, size_t(y1 - y0) * w);
+	});
 
 	format = Format::RGBAPremultiplied;
 }
 
 void Image::flipVertically()
 {
-	Vector<char> buffer;
-	buffer.resize(w * getBytesPerPixel());
+	const size_t rowSize = size_t(w) * getBytesPerPixel();
+	unsigned char* data = px.get();
 
-	for (int y = 0; y < static_cast<int>(h) / 2; ++y) {
-		auto a = getPixelBytesRow(0, static_cast<int>(w), y);
-		auto b = getPixelBytesRow(0, static_cast<int>(w), static_cast<int>(h) - y - 1);
-		memcpy(buffer.data(), a.data(), a.size());
-		memcpy(a.data(), b.data(), a.size());
-		memcpy(b.data(), buffer.data(), a.size());
-	}
+	forEachRowBand(static_cast<int>(h) / 2, w, [&] (int y0, int y1)
+	{
+		for (int y = y0; y < y1; ++y) {
+			auto* a = data + size_t(y) * rowSize;
+			auto* b = data + size_t(h - y - 1) * rowSize;
+			std::swap_ranges(a, a + rowSize, b);
+		}
+	});
 }
 
 ResourceMemoryUsage Image::getMemoryUsage() const
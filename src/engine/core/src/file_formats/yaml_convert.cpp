@@ -2,6 +2,9 @@
 #include "halley/file_formats/halley-yamlcpp.h"
 #include "halley/bytes/byte_serializer.h"
 #include "halley/text/encode.h"
+#include <yaml-cpp/eventhandler.h>
+#include <cmath>
+#include <streambuf>
 using namespace Halley;
 
 ConfigNode YAMLConvert::parseYAMLNode(const YAML::Node& node, const ParseOptions& options)
@@ -63,10 +66,179 @@ ConfigNode YAMLConvert::parseYAMLNode(const YAML::Node& node, const ParseOptions
 	return result;
 }
 
+namespace {
+	ConfigNode parseScalar(const std::string& tag, const std::string& value)
+	{
+		if (tag.find("binary") != std::string::npos) {
+			const auto b = YAML::DecodeBase64(value);
+			Bytes bs;
+			bs.resize(b.size());
+			memcpy(bs.data(), b.data(), b.size());
+			return ConfigNode(std::move(bs));
+		}
+
+		auto str = String(value);
+		if (str.isNumber()) {
+			if (str.isInteger()) {
+				return ConfigNode(str.toInteger());
+			} else {
+				return ConfigNode(str.toFloat());
+			}
+		} else if (str == "true") {
+			return ConfigNode(true);
+		} else if (str == "false") {
+			return ConfigNode(false);
+		} else {
+			return ConfigNode(std::move(str));
+		}
+	}
+
+	// Builds the ConfigNode tree straight from the parser's events, skipping the intermediate YAML::Node tree.
+	// Produces the same result as YAMLConvert::parseYAMLNode() on the loaded document.
+	class ConfigNodeEventBuilder final : public YAML::EventHandler {
+	public:
+		explicit ConfigNodeEventBuilder(const YAMLConvert::ParseOptions& options)
+			: options(options)
+		{}
+
+		ConfigNode& getResult()
+		{
+			return result;
+		}
+
+		void OnDocumentStart(const YAML::Mark& mark) override {}
+		void OnDocumentEnd() override {}
+
+		void OnNull(const YAML::Mark& mark, YAML::anchor_t anchor) override
+		{
+			addValue(ConfigNode(), mark, anchor, {});
+		}
+
+		void OnAlias(const YAML::Mark& mark, YAML::anchor_t anchor) override
+		{
+			if (anchor >= anchors.size()) {
+				throw Exception("Unknown YAML alias", HalleyExceptions::Resources);
+			}
+			addValue(ConfigNode(anchors[anchor]), mark, YAML::NullAnchor, {});
+		}
+
+		void OnScalar(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor, const std::string& value) override
+		{
+			addValue(parseScalar(tag, value), mark, anchor, value);
+		}
+
+		void OnSequenceStart(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor, YAML::EmitterStyle::value style) override
+		{
+			stack.push_back(Frame{ ConfigNode(ConfigNode::SequenceType()), mark, anchor, false, false, {} });
+		}
+
+		void OnSequenceEnd() override
+		{
+			endContainer();
+		}
+
+		void OnMapStart(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor, YAML::EmitterStyle::value style) override
+		{
+			if (options.parseMapsAsSequencesOfPairs) {
+				stack.push_back(Frame{ ConfigNode(ConfigNode::SequenceType()), mark, anchor, true, false, {} });
+			} else {
+				stack.push_back(Frame{ ConfigNode(ConfigNode::MapType()), mark, anchor, true, false, {} });
+			}
+		}
+
+		void OnMapEnd() override
+		{
+			endContainer();
+		}
+
+	private:
+		struct Frame {
+			ConfigNode node;
+			YAML::Mark mark;
+			YAML::anchor_t anchor;
+			bool isMap;
+			bool hasKey = false;
+			String key;
+		};
+
+		const YAMLConvert::ParseOptions& options;
+		ConfigNode result;
+		Vector<Frame> stack;
+		Vector<ConfigNode> anchors;
+
+		void endContainer()
+		{
+			auto frame = std::move(stack.back());
+			stack.pop_back();
+			addValue(std::move(frame.node), frame.mark, frame.anchor, {});
+		}
+
+		void addValue(ConfigNode node, const YAML::Mark& mark, YAML::anchor_t anchor, std::string_view rawScalar)
+		{
+			node.setOriginalPosition(mark.line, mark.column);
+			if (anchor != YAML::NullAnchor) {
+				if (anchor >= anchors.size()) {
+					anchors.resize(anchor + 1);
+				}
+				anchors[anchor] = ConfigNode(node);
+			}
+
+			if (stack.empty()) {
+				result = std::move(node);
+				return;
+			}
+
+			auto& top = stack.back();
+			if (!top.isMap) {
+				top.node.asSequence().push_back(std::move(node));
+			} else if (!top.hasKey) {
+				// Keys keep their original text, rather than going through the scalar conversion
+				if (rawScalar.data()) {
+					top.key = String(rawScalar);
+				} else if (node.getType() == ConfigNodeType::String || node.getType() == ConfigNodeType::Int || node.getType() == ConfigNodeType::Float || node.getType() == ConfigNodeType::Bool) {
+					top.key = node.asString();
+				} else {
+					throw Exception("YAML map keys must be scalars", HalleyExceptions::Resources);
+				}
+				top.hasKey = true;
+			} else {
+				if (options.parseMapsAsSequencesOfPairs) {
+					ConfigNode::MapType entry;
+					entry["key"] = std::move(top.key);
+					entry["value"] = std::move(node);
+					top.node.asSequence().push_back(ConfigNode(std::move(entry)));
+				} else {
+					top.node.asMap()[std::move(top.key)] = std::move(node);
+				}
+				top.key = String();
+				top.hasKey = false;
+			}
+		}
+	};
+
+	class MemoryStreamBuffer final : public std::streambuf {
+	public:
+		explicit MemoryStreamBuffer(gsl::span<const gsl::byte> data)
+		{
+			auto* start = const_cast<char*>(reinterpret_cast<const char*>(data.data()));
+			setg(start, start, start + data.size());
+		}
+	};
+
+	ConfigNode parseYAML(gsl::span<const gsl::byte> data, const YAMLConvert::ParseOptions& options)
+	{
+		MemoryStreamBuffer buffer(data);
+		std::istream stream(&buffer);
+		YAML::Parser parser(stream);
+		ConfigNodeEventBuilder builder(options);
+		parser.HandleNextDocument(builder);
+		return std::move(builder.getResult());
+	}
+}
+
 void YAMLConvert::parseConfig(ConfigFile& config, gsl::span<const gsl::byte> data, const ParseOptions& options)
 {
-	String strData(reinterpret_cast<const char*>(data.data()), data.size());
-	config.getRoot() = parseConfig(strData, options);
+	config.getRoot() = parseYAML(data, options);
 }
 
 ConfigFile YAMLConvert::parseConfig(gsl::span<const gsl::byte> data, const ParseOptions& options)
@@ -83,8 +255,7 @@ ConfigFile YAMLConvert::parseConfig(const Bytes& data, const ParseOptions& optio
 
 ConfigNode YAMLConvert::parseConfig(const String& str, const ParseOptions& options)
 {
-	YAML::Node root = YAML::Load(str.cppStr());
-	return parseYAMLNode(root, options);
+	return parseYAML(gsl::as_bytes(gsl::span<const char>(str.c_str(), str.size())), options);
 }
 
 ConfigFile YAMLConvert::parseConfig(const Path& path, const ParseOptions& options)
@@ -98,173 +269,523 @@ String YAMLConvert::generateYAML(const ConfigFile& config, const EmitOptions& op
 	return generateYAML(config.getRoot(), options);
 }
 
-String YAMLConvert::generateYAML(const ConfigNode& node, const EmitOptions& options)
-{
-	YAML::Emitter emitter;
-	emitNode(node, emitter, options);
+namespace {
+	bool isCompactNode(const ConfigNode& node, int depth, const YAMLConvert::EmitOptions& options)
+	{
+		bool ok = true;
+
+		switch (node.getType()) {
+		case ConfigNodeType::Map:
+			if (node.asMap().empty()) {
+				return true;
+			}
+			if (!options.compactMaps) {
+				return false;
+			}
+			if (depth >= 2) {
+				return false;
+			}
+			for (auto& [k, v]: node.asMap()) {
+				ok = ok && isCompactNode(v, depth + 1, options);
+			}
+			return ok;
 
-	if (!emitter.good()) {
-		throw Exception("Error generating YAML: " + emitter.GetLastError(), HalleyExceptions::Tools);
+		case ConfigNodeType::Int:
+		case ConfigNodeType::Bool:
+		case ConfigNodeType::Float:
+		case ConfigNodeType::String:
+			return true;
+
+		case ConfigNodeType::Int2:
+		case ConfigNodeType::Float2:
+			return depth <= 2;
+
+		case ConfigNodeType::Sequence:
+			if (depth >= 2) {
+				return false;
+			}
+			for (auto& n: node.asSequence()) {
+				ok = ok && isCompactNode(n, depth + 1, options);
+			}
+			return ok;
+
+		default:
+			return false;
+		}
 	}
-	return emitter.c_str();
-}
 
-void YAMLConvert::emitNode(const ConfigNode& node, YAML::Emitter& emitter, const EmitOptions& options)
-{
-	switch (node.getType()) {
-	case ConfigNodeType::Int:
-		emitter << node.asInt();
-		return;
+	// Writes YAML text directly, producing the same output as yaml-cpp's emitter (default settings) did for ConfigNode trees
+	class YAMLWriter {
+	public:
+		explicit YAMLWriter(const YAMLConvert::EmitOptions& options)
+			: options(options)
+		{}
 
-	case ConfigNodeType::Int64:
-		emitter << node.asInt64();
-		return;
+		String write(const ConfigNode& node)
+		{
+			if (isBlock(node)) {
+				writeBlock(node, 0, false);
+			} else {
+				writeInline(node, false, 1);
+			}
+			return String(std::move(out));
+		}
 
-	case ConfigNodeType::Bool:
-		emitter << node.asBool();
-		return;
+	private:
+		const YAMLConvert::EmitOptions& options;
+		std::string out;
 
-	case ConfigNodeType::Int2:
+		bool isBlock(const ConfigNode& node) const
 		{
-			const auto vec = node.asVector2i();
-			emitter << YAML::Flow << YAML::BeginSeq << vec.x << vec.y << YAML::EndSeq;
+			switch (node.getType()) {
+			case ConfigNodeType::Sequence:
+			case ConfigNodeType::DeltaSequence:
+			case ConfigNodeType::Map:
+			case ConfigNodeType::DeltaMap:
+				return !isCompactNode(node, 0, options);
+			default:
+				return false;
+			}
 		}
-		return;
 
-	case ConfigNodeType::Float:
-		emitter << node.asFloat();
-		return;
+		void newLine(int indent)
+		{
+			if (!out.empty()) {
+				out += '\n';
+			}
+			out.append(indent, ' ');
+		}
 
-	case ConfigNodeType::Float2:
+		// yaml-cpp pads flow collections up to the indentation of their nesting depth, which only shows when they start near the beginning of a line
+		void indentTo(int column)
 		{
-			const auto vec = node.asVector2f();
-			emitter << YAML::Flow << YAML::BeginSeq << vec.x << vec.y << YAML::EndSeq;
+			const auto lineStart = out.rfind('\n');
+			const auto curColumn = static_cast<int>(lineStart == std::string::npos ? out.size() : out.size() - lineStart - 1);
+			if (curColumn < column) {
+				out.append(column - curColumn, ' ');
+			}
 		}
-		return;
 
-	case ConfigNodeType::Sequence:
-	case ConfigNodeType::DeltaSequence:
-		emitSequence(node, emitter, options);
-		return;
+		void beginFlowElement(int depth, bool first, char open)
+		{
+			const int outerIndent = std::max(2 * (depth - 2), 0);
+			indentTo(outerIndent);
+			out += first ? open : ',';
+			if (!first) {
+				out += ' ';
+			}
+			indentTo(outerIndent);
+		}
 
-	case ConfigNodeType::Map:
-	case ConfigNodeType::DeltaMap:
-		emitMap(node, emitter, options);
-		return;
+		void endFlow(int depth, std::string_view close)
+		{
+			indentTo(2 * (depth - 1));
+			out += close;
+		}
 
-	case ConfigNodeType::String:
-		emitter << node.asString().cppStr();
-		return;
+		void writeBlock(const ConfigNode& node, int indent, bool continuesLine)
+		{
+			if (node.getType() == ConfigNodeType::Map || node.getType() == ConfigNodeType::DeltaMap) {
+				const auto keys = getSortedKeys(node);
+				if (keys.empty()) {
+					// Only undefined entries
+					if (!continuesLine) {
+						newLine(indent);
+					}
+					out += "{}";
+					return;
+				}
 
-	case ConfigNodeType::Bytes:
-		emitter << YAML::Binary(node.asBytes().data(), node.asBytes().size());
-		return;
+				bool first = true;
+				for (const auto* key: keys) {
+					if (!first || !continuesLine) {
+						newLine(indent);
+					}
+					first = false;
+
+					writeString(key->cppStr(), false);
+					out += ':';
+					const auto& value = node.asMap().at(*key);
+					if (isBlock(value)) {
+						writeBlock(value, indent + 2, false);
+					} else {
+						out += ' ';
+						writeInline(value, false, indent / 2 + 2);
+					}
+				}
+			} else {
+				if (node.asSequence().empty()) {
+					if (!continuesLine) {
+						newLine(indent);
+					}
+					out += "[]";
+					return;
+				}
 
-	case ConfigNodeType::Noop:
-		emitter << "<noop>";
-		return;
+				bool first = true;
+				for (const auto& value: node.asSequence()) {
+					if (!first || !continuesLine) {
+						newLine(indent);
+					}
+					first = false;
+
+					if (!isBlock(value)) {
+						out += "- ";
+						writeInline(value, false, indent / 2 + 2);
+					} else if (value.getType() == ConfigNodeType::Map || value.getType() == ConfigNodeType::DeltaMap) {
+						out += "- ";
+						writeBlock(value, indent + 2, true);
+					} else {
+						// Nested block sequences start on their own line
+						out += '-';
+						writeBlock(value, indent + 2, false);
+					}
+				}
+			}
+		}
 
-	case ConfigNodeType::Del:
-		emitter << "<del>";
-		return;
+		void writeInline(const ConfigNode& node, bool inFlow, int depth)
+		{
+			switch (node.getType()) {
+			case ConfigNodeType::Int:
+				out += std::to_string(node.asInt());
+				return;
+
+			case ConfigNodeType::Int64:
+				out += std::to_string(node.asInt64());
+				return;
+
+			case ConfigNodeType::Bool:
+				out += node.asBool() ? "true" : "false";
+				return;
+
+			case ConfigNodeType::Float:
+				writeFloat(node.asFloat());
+				return;
+
+			case ConfigNodeType::Int2:
+				{
+					const auto vec = node.asVector2i();
+					beginFlowElement(depth, true, '[');
+					out += std::to_string(vec.x);
+					beginFlowElement(depth, false, '[');
+					out += std::to_string(vec.y);
+					endFlow(depth, "]");
+				}
+				return;
+
+			case ConfigNodeType::Float2:
+				{
+					const auto vec = node.asVector2f();
+					beginFlowElement(depth, true, '[');
+					writeFloat(vec.x);
+					beginFlowElement(depth, false, '[');
+					writeFloat(vec.y);
+					endFlow(depth, "]");
+				}
+				return;
+
+			case ConfigNodeType::Sequence:
+			case ConfigNodeType::DeltaSequence:
+				{
+					const auto& seq = node.asSequence();
+					if (seq.empty()) {
+						endFlow(depth, "[]");
+						return;
+					}
+
+					bool first = true;
+					for (const auto& value: seq) {
+						beginFlowElement(depth, first, '[');
+						first = false;
+						writeInline(value, true, depth + 1);
+					}
+					endFlow(depth, "]");
+				}
+				return;
+
+			case ConfigNodeType::Map:
+			case ConfigNodeType::DeltaMap:
+				{
+					const auto keys = getSortedKeys(node);
+					if (keys.empty()) {
+						endFlow(depth, "{}");
+						return;
+					}
+
+					bool first = true;
+					for (const auto* key: keys) {
+						beginFlowElement(depth, first, '{');
+						first = false;
+						writeString(key->cppStr(), true);
+						indentTo(std::max(2 * (depth - 2), 0));
+						out += ": ";
+						indentTo(std::max(2 * (depth - 2), 0));
+						writeInline(node.asMap().at(*key), true, depth + 1);
+					}
+					endFlow(depth, "}");
+				}
+				return;
 
-	default:
-		emitter << YAML::Null;
-	}
-}
+			case ConfigNodeType::String:
+				writeString(node.asStringView(), inFlow);
+				return;
 
-void YAMLConvert::emitSequence(const ConfigNode& node, YAML::Emitter& emitter, const EmitOptions& options)
-{
-	if (isCompactSequence(node, 0, options)) {
-		emitter << YAML::Flow;
-	}
+			case ConfigNodeType::Bytes:
+				{
+					const auto& bytes = node.asBytes();
+					out += "!!binary ";
+					writeDoubleQuoted(YAML::EncodeBase64(bytes.data(), bytes.size()));
+				}
+				return;
 
-	emitter << YAML::BeginSeq;
-	for (auto& n: node.asSequence()) {
-		emitNode(n, emitter, options);
-	}
-	emitter << YAML::EndSeq;
-}
+			case ConfigNodeType::Noop:
+				writeString("<noop>", inFlow);
+				return;
 
-void YAMLConvert::emitMap(const ConfigNode& node, YAML::Emitter& emitter, const EmitOptions& options)
-{
-	const auto& map = node.asMap();
+			case ConfigNodeType::Del:
+				writeString("<del>", inFlow);
+				return;
 
-	// Sort entries by key, using options
-	Vector<String> keys;
-	keys.reserve(map.size());
-	for (auto& kv: map) {
-		if (kv.second.getType() != ConfigNodeType::Undefined) {
-			keys.push_back(kv.first);
+			default:
+				out += '~';
+			}
 		}
-	}
 
-	std::sort(keys.begin(), keys.end(), [&] (const String& a, const String& b)
-	{
-		const auto& mko = options.mapKeyOrder;
-		const auto idxA = std::find(mko.begin(), mko.end(), a);
-		const auto idxB = std::find(mko.begin(), mko.end(), b);
-		if (idxA != idxB) {
-			return idxA < idxB;
+		Vector<const String*> getSortedKeys(const ConfigNode& node) const
+		{
+			const auto& map = node.asMap();
+
+			Vector<const String*> result;
+			result.reserve(map.size());
+			for (auto& kv: map) {
+				if (kv.second.getType() != ConfigNodeType::Undefined) {
+					result.push_back(&kv.first);
+				}
+			}
+
+			const auto& mko = options.mapKeyOrder;
+			std::sort(result.begin(), result.end(), [&] (const String* a, const String* b)
+			{
+				const auto idxA = std::find(mko.begin(), mko.end(), *a);
+				const auto idxB = std::find(mko.begin(), mko.end(), *b);
+				if (idxA != idxB) {
+					return idxA < idxB;
+				}
+				return *a < *b;
+			});
+			return result;
 		}
-		return a < b;
-	});
 
-	if (isCompactSequence(node, 0, options)) {
-		emitter << YAML::Flow;
-	}
-	emitter << YAML::BeginMap;
-
-	// Emit keys in order
-	for (const auto& k: keys) {
-		const auto iter = map.find(k);
-		emitter << YAML::Key << k;
-		emitter << YAML::Value;
-		emitNode(iter->second, emitter, options);
-	}
-	
-	emitter << YAML::EndMap;
-}
+		void writeFloat(float value)
+		{
+			if (std::isnan(value)) {
+				out += ".nan";
+			} else if (std::isinf(value)) {
+				out += std::signbit(value) ? "-.inf" : ".inf";
+			} else {
+				char buffer[32];
+				snprintf(buffer, sizeof(buffer), "%.*g", std::numeric_limits<float>::max_digits10, double(value));
+				out += buffer;
+			}
+		}
 
-bool YAMLConvert::isCompactSequence(const ConfigNode& node, int depth, const EmitOptions& options)
-{
-	bool ok = true;
+		void writeString(std::string_view str, bool inFlow)
+		{
+			if (isPlain(str, inFlow)) {
+				out += str;
+			} else {
+				writeDoubleQuoted(str);
+			}
+		}
 
-	switch (node.getType()) {
-	case ConfigNodeType::Map:
-		if (node.asMap().empty()) {
-			return true;
+		static bool isBlankOrBreak(std::string_view str, size_t i)
+		{
+			if (i >= str.size()) {
+				return false;
+			}
+			const char c = str[i];
+			return c == ' ' || c == '\t' || c == '\n' || (c == '\r' && i + 1 < str.size() && str[i + 1] == '\n');
 		}
-		if (!options.compactMaps) {
-			return false;
+
+		static size_t blankOrBreakLength(std::string_view str, size_t i)
+		{
+			return str[i] == '\r' ? 2 : 1;
 		}
-		if (depth >= 2) {
+
+		static bool isNotPrintable(std::string_view str, size_t i)
+		{
+			const auto c = static_cast<unsigned char>(str[i]);
+			if (c <= 0x08 || c == 0x0B || c == 0x0C || c == 0x7F || (c >= 0x0E && c <= 0x1F)) {
+				return true;
+			}
+			if (c == 0xC2 && i + 1 < str.size()) {
+				const auto next = static_cast<unsigned char>(str[i + 1]);
+				return (next >= 0x80 && next <= 0x84) || (next >= 0x86 && next <= 0x9F);
+			}
 			return false;
 		}
-		for (auto& [k, v]: node.asMap()) {
-			ok = ok && isCompactSequence(v, depth + 1, options);
+
+		// Same rules as yaml-cpp's IsValidPlainScalar
+		static bool isPlain(std::string_view str, bool inFlow)
+		{
+			if (str.empty() || str == "~" || str == "null" || str == "Null" || str == "NULL") {
+				return false;
+			}
+
+			const char first = str[0];
+			if (isBlankOrBreak(str, 0)) {
+				return false;
+			}
+			if (inFlow) {
+				if (std::string_view("?,[]{}#&*!|>'\"%@`").find(first) != std::string_view::npos) {
+					return false;
+				}
+				if ((first == '-' || first == ':') && str.size() > 1 && (str[1] == ' ' || str[1] == '\t')) {
+					return false;
+				}
+			} else {
+				if (std::string_view(",[]{}#&*!|>'\"%@`").find(first) != std::string_view::npos) {
+					return false;
+				}
+				if ((first == '-' || first == '?' || first == ':') && (str.size() == 1 || isBlankOrBreak(str, 1))) {
+					return false;
+				}
+			}
+
+			if (str.back() == ' ') {
+				return false;
+			}
+
+			for (size_t i = 0; i < str.size(); ++i) {
+				const char c = str[i];
+				if (c == ':') {
+					const bool atEnd = i + 1 == str.size();
+					if (atEnd || isBlankOrBreak(str, i + 1)) {
+						return false;
+					}
+					if (inFlow && (str[i + 1] == ',' || str[i + 1] == ']' || str[i + 1] == '}')) {
+						return false;
+					}
+				}
+				if (inFlow && (c == ',' || c == '?' || c == '[' || c == ']' || c == '{' || c == '}')) {
+					return false;
+				}
+				if (isBlankOrBreak(str, i)) {
+					const auto next = i + blankOrBreakLength(str, i);
+					if (next < str.size() && str[next] == '#') {
+						return false;
+					}
+				}
+				if (c == '\t' || c == '\n' || (c == '\r' && i + 1 < str.size() && str[i + 1] == '\n')) {
+					return false;
+				}
+				if (isNotPrintable(str, i)) {
+					return false;
+				}
+				if (c == '\xEF' && str.substr(i, 3) == "\xEF\xBB\xBF") {
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		void writeCodePoint(int codePoint)
+		{
+			if (codePoint <= 0x7F) {
+				out += static_cast<char>(codePoint);
+			} else if (codePoint <= 0x7FF) {
+				out += static_cast<char>(0xC0 | (codePoint >> 6));
+				out += static_cast<char>(0x80 | (codePoint & 0x3F));
+			} else if (codePoint <= 0xFFFF) {
+				out += static_cast<char>(0xE0 | (codePoint >> 12));
+				out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+				out += static_cast<char>(0x80 | (codePoint & 0x3F));
+			} else {
+				out += static_cast<char>(0xF0 | (codePoint >> 18));
+				out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+				out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+				out += static_cast<char>(0x80 | (codePoint & 0x3F));
+			}
 		}
-		return ok;
 
-	case ConfigNodeType::Int:
-	case ConfigNodeType::Bool:
-	case ConfigNodeType::Float:
-	case ConfigNodeType::String:
-		return true;
+		static int nextCodePoint(std::string_view str, size_t& i)
+		{
+			constexpr int replacementCharacter = 0xFFFD;
 
-	case ConfigNodeType::Int2:
-	case ConfigNodeType::Float2:
-		return depth <= 2;
+			const auto lead = static_cast<unsigned char>(str[i]);
+			int nBytes = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 4) == 0xF ? 4 : -1;
+			if (nBytes < 1) {
+				++i;
+				return replacementCharacter;
+			}
+			if (nBytes == 1) {
+				++i;
+				return lead;
+			}
 
-	case ConfigNodeType::Sequence:
-		if (depth >= 2) {
-			return false;
+			int codePoint = lead & ~(0xFF << (7 - nBytes));
+			++i;
+			for (--nBytes; nBytes > 0; ++i, --nBytes) {
+				if (i >= str.size() || (static_cast<unsigned char>(str[i]) & 0xC0) != 0x80) {
+					codePoint = replacementCharacter;
+					break;
+				}
+				codePoint = (codePoint << 6) | (str[i] & 0x3F);
+			}
+
+			if (codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF) || (codePoint & 0xFFFE) == 0xFFFE || (codePoint >= 0xFDD0 && codePoint <= 0xFDEF)) {
+				return replacementCharacter;
+			}
+			return codePoint;
 		}
-		for (auto& n: node.asSequence()) {
-			ok = ok && isCompactSequence(n, depth + 1, options);
+
+		void writeDoubleQuoted(std::string_view str)
+		{
+			constexpr static const char* hexDigits = "0123456789abcdef";
+
+			out += '"';
+			for (size_t i = 0; i < str.size(); ) {
+				const int codePoint = nextCodePoint(str, i);
+				switch (codePoint) {
+				case '"':
+					out += "\\\"";
+					break;
+				case '\\':
+					out += "\\\\";
+					break;
+				case '\n':
+					out += "\\n";
+					break;
+				case '\t':
+					out += "\\t";
+					break;
+				case '\r':
+					out += "\\r";
+					break;
+				case '\b':
+					out += "\\b";
+					break;
+				default:
+					if (codePoint < 0x20 || (codePoint >= 0x80 && codePoint <= 0xA0) || codePoint == 0xFEFF) {
+						out += '\\';
+						int digits = codePoint < 0xFF ? 2 : codePoint < 0xFFFF ? 4 : 8;
+						out += digits == 2 ? 'x' : digits == 4 ? 'u' : 'U';
+						for (; digits > 0; --digits) {
+							out += hexDigits[(codePoint >> (4 * (digits - 1))) & 0xF];
+						}
+					} else {
+						writeCodePoint(codePoint);
+					}
+				}
+			}
+			out += '"';
 		}
-		return ok;
-	}
+	};
+}
 
-	return false;
+String YAMLConvert::generateYAML(const ConfigNode& node, const EmitOptions& options)
+{
+	return YAMLWriter(options).write(node);
 }
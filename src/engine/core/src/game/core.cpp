@@ -204,15 +204,24 @@ void Core::init()
 	initialized = true;
 	
 	// Initialize API
-	api->init();
-	api->systemInternal->setEnvironment(environment.get());
-	statics.resume(api->system, game->getMaxThreads());
+	{
+		ProfilerEvent event(ProfilerEventType::CoreStartup, "API::init");
+		api->init();
+		api->systemInternal->setEnvironment(environment.get());
+	}
+	{
+		ProfilerEvent event(ProfilerEventType::CoreStartup, "HalleyStatics::resume");
+		statics.resume(api->system, game->getMaxThreads());
+	}
 	if (api->system) {
 		api->system->setThreadName("main");
 	}
 
 	// Resources
-	initResources();
+	{
+		ProfilerEvent event(ProfilerEventType::CoreStartup, "Core::initResources");
+		initResources();
+	}
 
 	// Give game api and resources
 	game->api = api.get();
@@ -225,6 +234,7 @@ void Core::init()
 	}
 
 	// Start game
+	ProfilerEvent event(ProfilerEventType::CoreStartup, "Game::startGame");
 	setStage(game->startGame());
 }
 
@@ -390,6 +400,10 @@ void Core::onTick(Time delta)
 	if (record && capture.getFrameTime() >= getProfileCaptureThreshold()) {
 		onProfileData(std::make_shared<ProfilerData>(capture.getCapture()));
 	}
+
+	if (startupTracePath && (firstFrameRendered || !api->video)) {
+		endStartupTrace();
+	}
 }
 
 void Core::tickFrame(Time time)
@@ -580,6 +594,8 @@ void Core::render()
 			pendingSnapshots.erase(pendingSnapshots.begin());
 		}
 	}
+
+	firstFrameRendered = true;
 }
 
 void Core::waitForRenderEnd()
@@ -795,6 +811,25 @@ void Core::onProfileData(std::shared_ptr<ProfilerData> data)
 	}
 }
 
+void Core::setStartupTracePath(Path path)
+{
+	startupTracePath = std::move(path);
+}
+
+void Core::endStartupTrace()
+{
+	const auto data = ProfilerCapture::get().endBootTrace();
+	const auto path = std::move(*startupTracePath);
+	startupTracePath.reset();
+
+	const auto totalTime = std::chrono::duration<double>(data.getTotalElapsedTime()).count();
+	if (Path::writeFile(path, data.toChromeTrace())) {
+		Logger::logInfo("Startup took " + toString(totalTime, 3) + " seconds, trace with " + toString(data.getEvents().size()) + " events written to \"" + path.getString() + "\"");
+	} else {
+		Logger::logError("Unable to write startup trace to \"" + path.getString() + "\"");
+	}
+}
+
 Time Core::getProfileCaptureThreshold() const
 {
 	Time t = std::numeric_limits<Time>::infinity();
@@ -1,6 +1,7 @@
 #include "halley/game/halley_main.h"
 #include "halley/game/core.h"
 #include "halley/support/console.h"
+#include "halley/support/profiler.h"
 #include "halley/game/halley_main.h"
 
 #ifdef _WIN32
@@ -31,6 +32,7 @@ public:
 		try {
 			if (!coreInit) {
 				coreInit = true;
+				ProfilerEvent event(ProfilerEventType::CoreStartup, "Core::init");
 				core->init();
 			}
 
@@ -54,10 +56,22 @@ private:
 
 int HalleyMain::runMain(std::unique_ptr<GameLoader> loader, const Vector<std::string>& args)
 {
+	const auto startupTracePath = getStartupTracePath(args);
+	if (startupTracePath) {
+		ProfilerCapture::get().setThreadName("main");
+		ProfilerCapture::get().startBootTrace();
+	}
+
 	std::unique_ptr<Core> core;
 	try {
-		core = loader->createCore(args);
+		{
+			ProfilerEvent event(ProfilerEventType::CoreStartup, "createCore");
+			core = loader->createCore(args);
+		}
 		loader->setCore(*core);
+		if (startupTracePath) {
+			core->setStartupTracePath(*startupTracePath);
+		}
 		auto* system = core->getAPI().system;
 
 		if (system->mustOwnMainLoop()) {
@@ -65,7 +79,10 @@ int HalleyMain::runMain(std::unique_ptr<GameLoader> loader, const Vector<std::st
 			return 0;
 		} else {
 			system->runGame([&]() {
-				core->init();
+				{
+					ProfilerEvent event(ProfilerEventType::CoreStartup, "Core::init");
+					core->init();
+				}
 				MainLoop loop(*core, *loader);
 				loop.run();
 			});
@@ -104,6 +121,22 @@ Vector<std::string> HalleyMain::getWin32Args()
 	return args;
 }
 
+std::optional<Path> HalleyMain::getStartupTracePath(const Vector<std::string>& args)
+{
+	const std::string_view prefix = "--startup-trace=";
+	for (const auto& arg: args) {
+		if (arg.size() > prefix.size() && std::string_view(arg).substr(0, prefix.size()) == prefix) {
+			return Path(arg.substr(prefix.size()));
+		}
+	}
+
+	if (const char* env = std::getenv("HALLEY_STARTUP_TRACE"); env && env[0] != 0) {
+		return Path(env);
+	}
+
+	return std::nullopt;
+}
+
 Vector<std::string> HalleyMain::getArgs(int argc, char* argv[])
 {
 	Vector<std::string> args;
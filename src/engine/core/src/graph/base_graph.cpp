@@ -183,6 +183,7 @@ void BaseGraph::assignTypes(const GraphNodeTypeCollection& nodeTypeCollection, b
 		for (size_t i = 0; i < n; ++i) {
 			getNode(i).assignType(nodeTypeCollection);
 		}
+		onTypesAssigned();
 	}
 }
 
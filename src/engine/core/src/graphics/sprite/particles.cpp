@@ -6,13 +6,46 @@
 
 using namespace Halley;
 
+void Particles::setRandomSeed(uint64_t seed)
+{
+	randomSeed = seed;
+	rng.setSeed(seed);
+}
+
+size_t Particles::ParticleData::size() const
+{
+	return pos.size();
+}
+
+void Particles::ParticleData::resize(size_t size)
+{
+	pos.resize(size);
+	vel.resize(size);
+	time.resize(size);
+	ttl.resize(size, 1.0f);
+	scale.resize(size, 1.0f);
+	animTime.resize(size);
+	alive.resize(size);
+	firstFrame.resize(size);
+}
+
+void Particles::ParticleData::move(size_t from, size_t to)
+{
+	pos[to] = pos[from];
+	vel[to] = vel[from];
+	time[to] = time[from];
+	ttl[to] = ttl[from];
+	scale[to] = scale[from];
+	animTime[to] = animTime[from];
+	alive[to] = alive[from];
+	firstFrame[to] = firstFrame[from];
+}
+
 Particles::Particles()
-	: rng(&Random::getGlobal())
 {
 }
 
 Particles::Particles(const ConfigNode& node, Resources& resources, const EntitySerializationContext& context)
-	: rng(&Random::getGlobal())
 {
 	load(node, resources, context);
 }
@@ -91,6 +124,9 @@ void Particles::load(const ConfigNode& node, Resources& resources, const EntityS
 	randomiseAnimationTime = node["randomiseAnimationTime"].asBool(false);
 	onSpawn = ConfigNodeSerializer<EntityId>().deserialize(context, node["onSpawn"]);
 	onDeath = ConfigNodeSerializer<EntityId>().deserialize(context, node["onDeath"]);
+	offscreenUpdate = node["offscreenUpdate"].asEnum(ParticleOffscreenUpdate::Always);
+	offscreenUpdateInterval = node["offscreenUpdateInterval"].asFloat(0.25f);
+	overlapGridCellSize = node["overlapGridCellSize"].asOptional<float>();
 
 	maxBorder = {};
 }
@@ -124,6 +160,9 @@ ConfigNode Particles::toConfigNode(const EntitySerializationContext& context) co
 	result["randomiseAnimationTime"] = randomiseAnimationTime;
 	result["onSpawn"] = ConfigNodeSerializer<EntityId>().serialize(onSpawn, context);
 	result["onDeath"] = ConfigNodeSerializer<EntityId>().serialize(onDeath, context);
+	result["offscreenUpdate"] = offscreenUpdate;
+	result["offscreenUpdateInterval"] = offscreenUpdateInterval;
+	result["overlapGridCellSize"] = overlapGridCellSize;
 
 	return result;
 }
@@ -181,9 +220,10 @@ void Particles::setPosition(Vector3f pos)
 		const auto delta = pos - position;
 		if (delta.squaredLength() > 0.000001f) {
 			if (relativePosition) {
-				for (auto& particle: particles) {
-					particle.pos += delta;
+				for (size_t i = 0; i < nParticlesAlive; ++i) {
+					particles.pos[i] += delta;
 				}
+				markOverlapGridDirty();
 			}
 
 			position = pos;
@@ -306,6 +346,9 @@ void Particles::setSpawnPositionOffset(Vector2f offset)
 
 void Particles::start()
 {
+	// Each emitter has its own generator, so the simulation doesn't depend on which thread updates it
+	rng.setSeed(randomSeed ? *randomSeed : Random::getGlobal().getInt(uint64_t(0), std::numeric_limits<uint64_t>::max()));
+
 	if (burst) {
 		spawn(burst.value(), 0);
 	}
@@ -318,6 +361,20 @@ void Particles::update(Time t)
 		firstUpdate = false;
 		start();
 	}
+
+	if (offscreenUpdate != ParticleOffscreenUpdate::Always) {
+		if (!visible) {
+			offscreenTime += static_cast<float>(t);
+			const float interval = offscreenUpdate == ParticleOffscreenUpdate::Reduced ? offscreenUpdateInterval : std::max(ttl.end, offscreenUpdateInterval);
+			if (offscreenTime >= interval) {
+				catchUp(std::exchange(offscreenTime, 0.0f));
+			}
+			return;
+		}
+		if (offscreenTime > 0) {
+			catchUp(std::exchange(offscreenTime, 0.0f));
+		}
+	}
 	
 	pendingSpawn += static_cast<float>(t * spawnRate * (enabled && !burst ? spawnRateMultiplier : 0));
 	const int toSpawn = static_cast<int>(floor(pendingSpawn));
@@ -338,6 +395,57 @@ void Particles::update(Time t)
 	}
 }
 
+void Particles::catchUp(float t)
+{
+	// Advances the existing particles in one step, then spawns the ones that would still be alive by now, at the age they'd have
+	// Spawning in the same step as the regular update would age all of them by the whole time, killing them right away
+	updateParticles(t);
+
+	const float spawnTime = std::min(t, ttl.end);
+	pendingSpawn += spawnTime * spawnRate * (enabled && !burst ? spawnRateMultiplier : 0);
+	const int toSpawn = static_cast<int>(floor(pendingSpawn));
+	pendingSpawn -= static_cast<float>(toSpawn);
+	if (toSpawn > 0) {
+		spawn(static_cast<size_t>(toSpawn), spawnTime);
+	}
+
+	nParticlesVisible = nParticlesAlive;
+	if (nParticlesVisible > 0 && !sprites[0].hasMaterial()) {
+		nParticlesVisible = 0;
+	}
+}
+
+void Particles::setVisible(bool v)
+{
+	visible = v;
+}
+
+bool Particles::isVisible() const
+{
+	return visible;
+}
+
+void Particles::setOffscreenUpdate(ParticleOffscreenUpdate mode)
+{
+	offscreenUpdate = mode;
+}
+
+ParticleOffscreenUpdate Particles::getOffscreenUpdate() const
+{
+	return offscreenUpdate;
+}
+
+void Particles::setOverlapGridCellSize(std::optional<float> cellSize)
+{
+	overlapGridCellSize = cellSize;
+	markOverlapGridDirty();
+}
+
+std::optional<float> Particles::getOverlapGridCellSize() const
+{
+	return overlapGridCellSize;
+}
+
 void Particles::setSprites(Vector<Sprite> sprites)
 {
 	baseSprites = std::move(sprites);
@@ -381,37 +489,126 @@ void Particles::setSecondarySpawner(IParticleSpawner* spawner)
 void Particles::spawnAt(Vector3f pos)
 {
 	spawn(1, 0.0f);
-	particles[nParticlesAlive - 1].pos = pos;
+	particles.pos[nParticlesAlive - 1] = pos;
 }
 
-void Particles::destroyOverlapping(const Polygon& polygon)
+void Particles::markOverlapGridDirty()
 {
-	for (size_t i = 0; i < nParticlesAlive; ++i) {
-		auto& particle = particles[i];
-		if (polygon.isPointInside(particle.pos.xy())) {
-			particle.alive = false;
+	overlapGrid.dirty = true;
+	overlapGrid.queriesWhileDirty = 0;
+}
+
+void Particles::updateOverlapGrid()
+{
+	if (!overlapGrid.dirty) {
+		return;
+	}
+	overlapGrid.dirty = false;
+
+	auto& grid = overlapGrid;
+	const size_t n = nParticlesAlive;
+
+	Vector2f minPos = particles.pos[0].xy();
+	Vector2f maxPos = minPos;
+	for (size_t i = 1; i < n; ++i) {
+		minPos = Vector2f::min(minPos, particles.pos[i].xy());
+		maxPos = Vector2f::max(maxPos, particles.pos[i].xy());
+	}
+
+	// Cells get bigger if the particles are spread too far apart for the grid to stay small
+	constexpr int maxCells = 64 * 64;
+	grid.cellSize = std::max(*overlapGridCellSize, 0.001f);
+	const auto extents = maxPos - minPos;
+	while (true) {
+		grid.size = Vector2i(static_cast<int>(extents.x / grid.cellSize) + 1, static_cast<int>(extents.y / grid.cellSize) + 1);
+		if (grid.size.x * grid.size.y <= maxCells) {
+			break;
 		}
+		grid.cellSize *= 2;
+	}
+	grid.origin = minPos;
+
+	// Counting sort of particles by cell
+	const size_t nCells = static_cast<size_t>(grid.size.x * grid.size.y);
+	grid.cellStart.clear();
+	grid.cellStart.resize(nCells + 1, 0);
+	grid.particleCell.resize(n);
+	grid.particles.resize(n);
+	const float invCellSize = 1.0f / grid.cellSize;
+	for (size_t i = 0; i < n; ++i) {
+		const auto cellPos = Vector2i((particles.pos[i].xy() - grid.origin) * invCellSize);
+		const auto cell = static_cast<uint32_t>(clamp(cellPos.x, 0, grid.size.x - 1) + clamp(cellPos.y, 0, grid.size.y - 1) * grid.size.x);
+		grid.particleCell[i] = cell;
+		++grid.cellStart[cell + 1];
+	}
+	for (size_t i = 0; i < nCells; ++i) {
+		grid.cellStart[i + 1] += grid.cellStart[i];
 	}
+	for (size_t i = 0; i < n; ++i) {
+		grid.particles[grid.cellStart[grid.particleCell[i]]++] = static_cast<uint32_t>(i);
+	}
+	for (size_t i = nCells; i > 0; --i) {
+		grid.cellStart[i] = grid.cellStart[i - 1];
+	}
+	grid.cellStart[0] = 0;
 }
 
-void Particles::destroyOverlapping(const Ellipse& ellipse)
+template <typename F>
+void Particles::destroyMatching(Rect4f aabb, F contains)
 {
-	for (size_t i = 0; i < nParticlesAlive; ++i) {
-		auto& particle = particles[i];
-		if (ellipse.contains(particle.pos.xy())) {
-			particle.alive = false;
+	// Below this, testing every particle is as fast as building the grid
+	constexpr size_t minParticlesForGrid = 64;
+	// Every particle moves on each update, so the grid is rebuilt from scratch, which costs a few linear scans.
+	// Queries after an update scan until they've spent about that much, and only then build it, so a frame with few queries never pays for it.
+	constexpr int scansBeforeGrid = 4;
+
+	const bool useGrid = overlapGridCellSize && nParticlesAlive >= minParticlesForGrid && (!overlapGrid.dirty || overlapGrid.queriesWhileDirty++ >= scansBeforeGrid);
+	if (!useGrid) {
+		for (size_t i = 0; i < nParticlesAlive; ++i) {
+			if (contains(particles.pos[i].xy())) {
+				particles.alive[i] = 0;
+			}
 		}
+		return;
 	}
+
+	updateOverlapGrid();
+
+	const auto& grid = overlapGrid;
+	const float invCellSize = 1.0f / grid.cellSize;
+	const auto p0 = Vector2i(((aabb.getTopLeft() - grid.origin) * invCellSize).floor());
+	const auto p1 = Vector2i(((aabb.getBottomRight() - grid.origin) * invCellSize).floor());
+	const int x0 = std::max(p0.x, 0);
+	const int y0 = std::max(p0.y, 0);
+	const int x1 = std::min(p1.x, grid.size.x - 1);
+	const int y1 = std::min(p1.y, grid.size.y - 1);
+
+	for (int y = y0; y <= y1; ++y) {
+		for (int x = x0; x <= x1; ++x) {
+			const auto cell = static_cast<size_t>(x + y * grid.size.x);
+			for (uint32_t j = grid.cellStart[cell]; j < grid.cellStart[cell + 1]; ++j) {
+				const auto i = grid.particles[j];
+				if (contains(particles.pos[i].xy())) {
+					particles.alive[i] = 0;
+				}
+			}
+		}
+	}
+}
+
+void Particles::destroyOverlapping(const Polygon& polygon)
+{
+	destroyMatching(polygon.getAABB(), [&] (Vector2f pos) { return polygon.isPointInside(pos); });
+}
+
+void Particles::destroyOverlapping(const Ellipse& ellipse)
+{
+	destroyMatching(ellipse.getAABB(), [&] (Vector2f pos) { return ellipse.contains(pos); });
 }
 
 void Particles::destroyOverlapping(const Circle& circle)
 {
-	for (size_t i = 0; i < nParticlesAlive; ++i) {
-		auto& particle = particles[i];
-		if (circle.contains(particle.pos.xy())) {
-			particle.alive = false;
-		}
-	}
+	destroyMatching(circle.getAABB(), [&] (Vector2f pos) { return circle.contains(pos); });
 }
 
 void Particles::spawn(size_t n, float time)
@@ -422,8 +619,10 @@ void Particles::spawn(size_t n, float time)
 
 	const size_t start = nParticlesAlive;
 	nParticlesAlive += n;
+	markOverlapGridDirty();
 	const size_t size = std::max(size_t(8), nextPowerOf2(nParticlesAlive));
 	if (particles.size() < size) {
+		// Capacity only ever grows, so an emitter in steady state doesn't allocate
 		particles.resize(size);
 		sprites.resize(size);
 	}
@@ -439,122 +638,142 @@ void Particles::spawn(size_t n, float time)
 
 void Particles::initializeParticle(size_t index, float time, float totalTime)
 {
-	const auto startAzimuth = Angle1f::fromDegrees(rng->getFloat(azimuth));
-	const auto startElevation = Angle1f::fromDegrees(rng->getFloat(altitude));
-	
-	auto& particle = particles[index];
-	particle.firstFrame = true;
-	particle.alive = true;
-	particle.time = time;
-	particle.ttl = rng->getFloat(ttl);
-	//particle.angle = rotateTowardsMovement ? startAzimuth : Angle1f();
-	particle.scale = rng->getFloat(initialScale);
-
-	particle.vel = Vector3f(rng->getFloat(speed) * speedMultiplier, startAzimuth, startElevation);
-	const bool stopped = stopTime > 0.00001f && particle.time + stopTime >= particle.ttl;
+	const auto startAzimuth = Angle1f::fromDegrees(rng.getFloat(azimuth));
+	const auto startElevation = Angle1f::fromDegrees(rng.getFloat(altitude));
+
+	// Random values are drawn in the same order as they always were, so that seeded simulations stay reproducible
+	const float particleTtl = rng.getFloat(ttl);
+	const float particleScale = rng.getFloat(initialScale);
+	const auto vel = Vector3f(rng.getFloat(speed) * speedMultiplier, startAzimuth, startElevation);
+	const bool stopped = stopTime > 0.00001f && time + stopTime >= particleTtl;
 	const auto a = stopped ? Vector3f() : acceleration;
 	const auto spawnPosSmear = totalTime > 0.00001f ? lerp(position - lastPosition, Vector3f(), time / totalTime) : Vector3f();
-	particle.pos = getSpawnPosition() + spawnPosSmear + (particle.vel * time + a * (0.5f * time * time)) * velScale;
+
+	particles.firstFrame[index] = 1;
+	particles.alive[index] = 1;
+	particles.time[index] = time;
+	particles.animTime[index] = time;
+	particles.ttl[index] = particleTtl;
+	particles.scale[index] = particleScale;
+	particles.vel[index] = vel;
+	particles.pos[index] = getSpawnPosition() + spawnPosSmear + (vel * time + a * (0.5f * time * time)) * velScale;
 
 	auto& sprite = sprites[index];
 	if (isAnimated()) {
 		auto& anim = animationPlayers[index];
 		anim.update(0, sprite);
 		if (randomiseAnimationTime) {
-			anim.update(Random::getGlobal().getFloat({0.0f, 42.0f}), sprite);
+			anim.update(rng.getFloat({0.0f, 42.0f}), sprite);
 		}
 	} else if (!baseSprites.empty()) {
 		// Optimization: if there's only one baseSprite, and this sprite has a material, then we don't need to update it at all here
 		if (!sprite.hasMaterial() || baseSprites.size() >= 2) {
-			sprite.copyFrom(rng->getRandomElement(baseSprites), false);
+			sprite.copyFrom(rng.getRandomElement(baseSprites), false);
 		}
 	}
 
 	if (onSpawn) {
-		onSecondarySpawn(particle, onSpawn);
+		onSecondarySpawn(particles.pos[index], onSpawn);
 	}
 }
 
 void Particles::updateParticles(float time)
 {
-	const bool hasAnim = isAnimated();
-
-	for (size_t i = 0; i < nParticlesAlive; ++i) {
-		if (hasAnim) {
-			animationPlayers[i].update(time, sprites[i]);
-		}
-
-		auto& particle = particles[i];
+	const size_t n = nParticlesAlive;
+	auto* pos = particles.pos.data();
+	auto* vel = particles.vel.data();
+	auto* particleTime = particles.time.data();
+	const auto* particleTtl = particles.ttl.data();
+	auto* alive = particles.alive.data();
+	auto* firstFrame = particles.firstFrame.data();
+
+	const bool hasStopTime = stopTime > 0.00001f;
+	const Vector3f accelPos = acceleration * (0.5f * time * time);
+	const Vector3f accelVel = acceleration * time;
+	const float stoppedDamp = std::exp(-10.0f * time);
+	const float velDamp = speedDamp > 0.0001f ? std::exp(-speedDamp * time) : 1.0f;
+
+	// No early-outs in here, so it can be vectorized; dead particles just don't move
+	for (size_t i = 0; i < n; ++i) {
+		particleTime[i] += time;
+		const bool living = particleTime[i] < particleTtl[i];
+		const bool stopped = hasStopTime && particleTime[i] + stopTime >= particleTtl[i];
+		const float move = living && !firstFrame[i] ? 1.0f : 0.0f;
+		const float accel = stopped ? 0.0f : move;
+
+		pos[i] += (vel[i] * (time * move) + accelPos * accel) * velScale;
+		vel[i] += accelVel * accel;
+		vel[i] *= living ? (stopped ? stoppedDamp : 1.0f) * velDamp : 1.0f;
+		alive[i] = alive[i] && living ? 1 : 0;
+		firstFrame[i] = 0;
+	}
 
-		particle.time += time;
-		if (particle.time >= particle.ttl) {
-			particle.alive = false;
+	if (minHeight) {
+		const float minZ = *minHeight;
+		for (size_t i = 0; i < n; ++i) {
+			alive[i] = alive[i] && !(pos[i].z < minZ) ? 1 : 0;
 		}
-		else {
-			const bool stopped = stopTime > 0.00001f && particle.time + stopTime >= particle.ttl;
-			const auto a = stopped ? Vector3f() : acceleration;
-			if (particle.firstFrame) {
-				particle.firstFrame = false;
-			}
-			else {
-				particle.pos += (particle.vel * time + a * (0.5f * time * time)) * velScale;
-				particle.vel += a * time;
-			}
-
-			if (minHeight && particle.pos.z < minHeight) {
-				particle.alive = false;
-			}
-
-			if (stopped) {
-				particle.vel = damp(particle.vel, Vector3f(), 10.0f, time);
-			}
-
-			if (speedDamp > 0.0001f) {
-				particle.vel = damp(particle.vel, Vector3f(), speedDamp, time);
-			}
+	}
 
-			if (directionScatter > 0.00001f) {
-				particle.vel = Vector3f(particle.vel.xy().rotate(Angle1f::fromDegrees(rng->getFloat(-directionScatter * time, directionScatter * time))), particle.vel.z);
+	if (directionScatter > 0.00001f) {
+		for (size_t i = 0; i < n; ++i) {
+			if (particleTime[i] < particleTtl[i]) {
+				vel[i] = Vector3f(vel[i].xy().rotate(Angle1f::fromDegrees(rng.getFloat(-directionScatter * time, directionScatter * time))), vel[i].z);
 			}
 		}
 	}
 
 	removeDeadParticles();
+	markOverlapGridDirty();
 }
 
 void Particles::updateSprites(Time t)
 {
+	const bool hasAnim = isAnimated();
+
 	for (size_t i = 0; i < nParticlesAlive; ++i) {
-		const auto& particle = particles[i];
+		const auto pos = particles.pos[i];
+		const auto vel = particles.vel[i];
+		const float time = particles.time[i];
+
+		if (hasAnim) {
+			// Animations only advance while they're visible, catching up with the particle's age when they come back
+			animationPlayers[i].update(time - particles.animTime[i], sprites[i]);
+			particles.animTime[i] = time;
+		}
 
 		Angle1f angle;
-		if (rotateTowardsMovement && particle.vel.squaredLength() > 0.001f) {
-			angle = (particle.vel.xy() + Vector2f(0, particle.vel.z)).angle();
+		if (rotateTowardsMovement && vel.squaredLength() > 0.001f) {
+			angle = (vel.xy() + Vector2f(0, vel.z)).angle();
 		}
 
-		const float t = particle.time / particle.ttl;
+		const float t = time / particles.ttl[i];
 
 		sprites[i]
-			.setPosition(particle.pos.xy() + Vector2f(0, -particle.pos.z))
+			.setPosition(pos.xy() + Vector2f(0, -pos.z))
 			.setRotation(angle)
-			.setScale(scaleCurve.evaluate(t) * particle.scale)
+			.setScale(scaleCurve.evaluate(t) * particles.scale[i])
 			.setColour(colourGradient.evaluatePrecomputed(t))
-			.setCustom1(Vector4f(particle.pos.xy(), 0, 0));
+			.setCustom1(Vector4f(pos.xy(), 0, 0));
 	}
 }
 
 void Particles::removeDeadParticles()
 {
+	const bool swapSprites = needsSpriteSwap();
+
 	for (size_t i = 0; i < nParticlesAlive; ) {
-		if (!particles[i].alive) {
+		if (!particles.alive[i]) {
 			if (onDeath) {
-				onSecondarySpawn(particles[i], onDeath);
+				onSecondarySpawn(particles.pos[i], onDeath);
 			}
 
 			if (i != nParticlesAlive - 1) {
-				// Swap with last particle that's alive
-				std::swap(particles[i], particles[nParticlesAlive - 1]);
-				std::swap(sprites[i], sprites[nParticlesAlive - 1]);
+				// Replace with last particle that's alive
+				particles.move(nParticlesAlive - 1, i);
+				if (swapSprites) {
+					std::swap(sprites[i], sprites[nParticlesAlive - 1]);
+				}
 				if (isAnimated()) {
 					std::swap(animationPlayers[i], animationPlayers[nParticlesAlive - 1]);
 				}
@@ -567,23 +786,29 @@ void Particles::removeDeadParticles()
 	}
 }
 
+bool Particles::needsSpriteSwap() const
+{
+	// With a single base sprite, all sprites only differ by what updateSprites sets on every frame
+	return isAnimated() || baseSprites.size() >= 2;
+}
+
 Vector3f Particles::getSpawnPosition() const
 {
 	Vector2f pos;
 	if (spawnAreaShape == ParticleSpawnAreaShape::Rectangle) {
-		pos = Vector2f(rng->getFloat(-1, 1), rng->getFloat(-1, 1)) * spawnArea * 0.5f;
+		pos = Vector2f(rng.getFloat(-1, 1), rng.getFloat(-1, 1)) * spawnArea * 0.5f;
 	} else if (spawnAreaShape == ParticleSpawnAreaShape::Ellipse) {
-		const float radius = std::sqrt(rng->getFloat(0, 1));
-		const float angle = rng->getFloat(0.0f, 2.0f * pif());
+		const float radius = std::sqrt(rng.getFloat(0, 1));
+		const float angle = rng.getFloat(0.0f, 2.0f * pif());
 		pos = Vector2f(radius, 0).rotate(Angle1f::fromRadians(angle)) * spawnArea * 0.5f;
 	}
 	return position + Vector3f(pos + spawnPositionOffset, startHeight);
 }
 
-void Particles::onSecondarySpawn(const Particle& particle, EntityId target)
+void Particles::onSecondarySpawn(Vector3f pos, EntityId target)
 {
 	if (secondarySpawner && target) {
-		secondarySpawner->spawn(particle.pos, target);
+		secondarySpawner->spawn(pos, target);
 	}
 }
 
@@ -593,11 +818,11 @@ std::optional<Rect4f> Particles::getAABB() const
 		return {};
 	}
 
-	Vector2f minPos = particles[0].pos.xy() + Vector2f(0, -particles[0].pos.z);
+	Vector2f minPos = particles.pos[0].xy() + Vector2f(0, -particles.pos[0].z);
 	Vector2f maxPos = minPos;
 
 	for (size_t i = 1; i < nParticlesAlive; ++i) {
-		const auto p = particles[i].pos.xy() + Vector2f(0, -particles[i].pos.z);
+		const auto p = particles.pos[i].xy() + Vector2f(0, -particles.pos[i].z);
 		minPos = Vector2f::min(minPos, p);
 		maxPos = Vector2f::max(maxPos, p);
 	}
@@ -0,0 +1,284 @@
+#include "halley/graphics/text/dynamic_font_atlas.h"
+#include "halley/api/halley_api.h"
+#include "halley/concurrency/concurrent.h"
+#include "halley/file_formats/image.h"
+#include "halley/graphics/material/material.h"
+#include "halley/graphics/texture_descriptor.h"
+#include "halley/support/logger.h"
+#include "halley/utils/algorithm.h"
+
+using namespace Halley;
+
+float DynamicFontAtlasStats::getHitRate() const
+{
+	const auto total = hits + misses;
+	return total > 0 ? static_cast<float>(hits) / static_cast<float>(total) : 1.0f;
+}
+
+DynamicFontAtlas::DynamicFontAtlas(VideoAPI& video, std::shared_ptr<const MaterialDefinition> material, std::shared_ptr<IGlyphRasterizer> rasterizer, DynamicFontAtlasConfig config)
+	: video(video)
+	, materialDefinition(std::move(material))
+	, rasterizer(std::move(rasterizer))
+	, config(config)
+	, results(std::make_shared<Results>())
+{
+	metrics = this->rasterizer->getFontMetrics();
+
+	// One pixel gap between slots, so filtering doesn't bleed neighbours in
+	slotSize = this->rasterizer->getMaxGlyphSize() + Vector2i(1, 1);
+	if (slotSize.x > config.pageSize.x || slotSize.y > config.pageSize.y || config.maxPages == 0) {
+		throw Exception("Dynamic font atlas pages are too small for the glyphs of \"" + metrics.name + "\"", HalleyExceptions::Graphics);
+	}
+
+	placeholderGlyph.charcode = -1;
+
+	// The first page always exists, so the font has a material even before any glyph is drawn
+	addPage();
+}
+
+const IGlyphRasterizer::FontMetrics& DynamicFontAtlas::getFontMetrics() const
+{
+	return metrics;
+}
+
+Vector2i DynamicFontAtlas::getPageSize() const
+{
+	return config.pageSize;
+}
+
+bool DynamicFontAtlas::canRasterize(int charcode) const
+{
+	return rasterizer->hasGlyph(charcode);
+}
+
+std::pair<const Font::Glyph&, const Font&> DynamicFontAtlas::getGlyph(int charcode, const Font& placeholderFont)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	if (const auto iter = entries.find(charcode); iter != entries.end()) {
+		++stats.hits;
+		const auto& entry = iter->second;
+		if (entry.slot) {
+			lru.splice(lru.begin(), lru, entry.lruPos);
+		}
+		const auto& font = *pages[entry.page].font;
+		return { font.getGlyphHere(charcode), font };
+	}
+
+	++stats.misses;
+	if (!failed.contains(charcode)) {
+		request(charcode);
+	}
+	return { placeholderGlyph, placeholderFont };
+}
+
+void DynamicFontAtlas::prewarm(gsl::span<const int> characters)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	for (const int c: characters) {
+		if (!entries.contains(c) && !failed.contains(c) && rasterizer->hasGlyph(c)) {
+			request(c);
+		}
+	}
+}
+
+void DynamicFontAtlas::prewarm(const I18N& i18n, const std::optional<I18NLanguage>& language)
+{
+	prewarm(i18n.getCharacters(language));
+}
+
+void DynamicFontAtlas::request(int charcode)
+{
+	if (!pending.insert(charcode).second) {
+		return;
+	}
+
+	if (config.useWorkerThreads && Executors::hasInstance()) {
+		tasks.push_back(Concurrent::execute(Executors::getCPU(), [rasterizer = rasterizer, results = results, charcode] ()
+		{
+			auto glyph = rasterizer->rasterize(charcode);
+			std::unique_lock<std::mutex> lock(results->mutex);
+			results->glyphs.emplace_back(charcode, std::move(glyph));
+		}));
+	} else {
+		queued.push_back(charcode);
+	}
+}
+
+bool DynamicFontAtlas::update()
+{
+	Vector<int> toRasterize;
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		toRasterize = std::move(queued);
+		queued.clear();
+		std_ex::erase_if(tasks, [] (const Future<void>& f) { return f.isReady(); });
+	}
+
+	Vector<std::pair<int, std::optional<IGlyphRasterizer::Glyph>>> done;
+	for (const int c: toRasterize) {
+		done.emplace_back(c, rasterizer->rasterize(c));
+	}
+	{
+		std::unique_lock<std::mutex> lock(results->mutex);
+		for (auto& r: results->glyphs) {
+			done.push_back(std::move(r));
+		}
+		results->glyphs.clear();
+	}
+
+	if (done.empty()) {
+		return false;
+	}
+
+	std::unique_lock<std::mutex> lock(mutex);
+	for (auto& [charcode, glyph]: done) {
+		pending.erase(charcode);
+		addGlyph(charcode, std::move(glyph));
+	}
+	for (auto& page: pages) {
+		if (page.dirty) {
+			uploadPage(page);
+		}
+	}
+	return true;
+}
+
+void DynamicFontAtlas::waitForPending()
+{
+	Vector<Future<void>> toWait;
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		toWait = std::move(tasks);
+		tasks.clear();
+	}
+	for (auto& t: toWait) {
+		t.wait();
+	}
+}
+
+const std::shared_ptr<Material>& DynamicFontAtlas::getMaterial() const
+{
+	return pages.front().font->getMaterial();
+}
+
+DynamicFontAtlasStats DynamicFontAtlas::getStats() const
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	auto result = stats;
+	result.glyphs = entries.size();
+	result.pages = pages.size();
+	result.pending = pending.size();
+	return result;
+}
+
+void DynamicFontAtlas::resetStats()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	stats = {};
+}
+
+void DynamicFontAtlas::addGlyph(int charcode, std::optional<IGlyphRasterizer::Glyph> glyph)
+{
+	if (!glyph) {
+		Logger::logWarning("Unable to rasterize character " + toString(charcode) + " of font \"" + metrics.name + "\"");
+		failed.insert(charcode);
+		return;
+	}
+
+	Entry entry;
+	Rect4f area;
+	Vector2f size;
+	if (glyph->image) {
+		const auto imageSize = glyph->image->getSize();
+		if (imageSize.x >= slotSize.x || imageSize.y >= slotSize.y) {
+			Logger::logWarning("Character " + toString(charcode) + " of font \"" + metrics.name + "\" doesn't fit the atlas slots");
+			failed.insert(charcode);
+			return;
+		}
+
+		const auto slot = allocateSlot();
+		auto& page = pages[slot->page];
+		page.image->blitFrom(slot->pos, *glyph->image);
+		page.dirty = true;
+
+		area = Rect4f(Vector2f(slot->pos), Vector2f(slot->pos + imageSize)) / Vector2f(config.pageSize);
+		size = Vector2f(imageSize);
+		entry.page = slot->page;
+		entry.slot = slot;
+		lru.push_front(charcode);
+		entry.lruPos = lru.begin();
+	}
+
+	pages[entry.page].font->addGlyph(Font::Glyph(charcode, area, size, glyph->horizontalBearing, glyph->verticalBearing, glyph->advance, {}));
+	entries[charcode] = entry;
+}
+
+std::optional<DynamicFontAtlas::Slot> DynamicFontAtlas::allocateSlot()
+{
+	if (freeSlots.empty() && pages.size() < config.maxPages) {
+		addPage();
+	}
+
+	if (freeSlots.empty()) {
+		// Evict the least recently used glyph and take its slot
+		const int victim = lru.back();
+		lru.pop_back();
+		const auto iter = entries.find(victim);
+		const auto slot = iter->second.slot;
+		entries.erase(iter);
+
+		auto& page = pages[slot->page];
+		page.font->removeGlyph(victim);
+		page.image->blitFrom(slot->pos, Image(Image::Format::RGBA, slotSize));
+		++stats.evictions;
+		return slot;
+	}
+
+	const auto slot = freeSlots.back();
+	freeSlots.pop_back();
+	return slot;
+}
+
+void DynamicFontAtlas::addPage()
+{
+	const auto pageIdx = pages.size();
+	auto& page = pages.emplace_back();
+
+	page.image = std::make_unique<Image>(Image::Format::RGBA, config.pageSize);
+	page.texture = std::shared_ptr<Texture>(video.createTexture(config.pageSize));
+	page.texture->setAssetId("dynamicFont/" + metrics.name + "/" + toString(pageIdx));
+	page.texture->startLoading();
+	uploadPage(page);
+
+	const auto name = metrics.name + "/page" + toString(pageIdx);
+	if (metrics.smoothRadius > 0) {
+		page.font = std::make_shared<Font>(name, "", metrics.ascender, metrics.height, metrics.sizePt, 1.0f, config.pageSize, metrics.smoothRadius, Vector<String>(), metrics.floorGlyphPosition);
+	} else {
+		page.font = std::make_shared<Font>(name, "", metrics.ascender, metrics.height, metrics.sizePt, 1.0f, config.pageSize);
+	}
+	auto material = std::make_shared<Material>(materialDefinition);
+	material->set(0, page.texture);
+	page.font->setMaterial(std::move(material));
+
+	// Slots are handed out from the back, so reverse them to fill the page in reading order
+	const auto slotsPerRow = config.pageSize.x / slotSize.x;
+	const auto slotsPerColumn = config.pageSize.y / slotSize.y;
+	for (int y = slotsPerColumn; --y >= 0; ) {
+		for (int x = slotsPerRow; --x >= 0; ) {
+			freeSlots.push_back(Slot{ pageIdx, Vector2i(x * slotSize.x, y * slotSize.y) });
+		}
+	}
+}
+
+void DynamicFontAtlas::uploadPage(Page& page)
+{
+	// The texture gets its own copy, since the video backend may still be reading it while the next glyphs are added
+	TextureDescriptor desc(config.pageSize, TextureFormat::RGBA);
+	desc.pixelData = page.image->clone();
+	desc.useFiltering = true;
+	desc.canBeUpdated = true;
+	page.texture->load(std::move(desc));
+	page.dirty = false;
+}
@@ -1,4 +1,5 @@
 #include "halley/graphics/text/font.h"
+#include "halley/graphics/text/dynamic_font_atlas.h"
 #include "halley/graphics/material/material.h"
 #include "halley/graphics/material/material_definition.h"
 #include "halley/graphics/material/material_parameter.h"
@@ -6,10 +7,16 @@
 #include "halley/bytes/byte_serializer.h"
 #include "halley/resources/resources.h"
 #include "halley/text/string_converter.h"
+#include "halley/utils/algorithm.h"
 #include <iostream>
 
 using namespace Halley;
 
+namespace {
+	// Charcodes below this are looked up by direct indexing (Latin, Greek, Cyrillic, Hebrew, Arabic, punctuation, etc), anything else by binary search
+	constexpr int glyphTableLimit = 0x3000;
+}
+
 Font::Glyph::Glyph() {}
 
 Font::Glyph::Glyph(int charcode, Rect4f area, Vector2f size, Vector2f horizontalBearing, Vector2f verticalBearing, Vector2f advance, HashMap<int32_t, Vector2f> kerning)
@@ -23,15 +30,6 @@ Font::Glyph::Glyph(int charcode, Rect4f area, Vector2f size, Vector2f horizontal
 {
 }
 
-Vector2f Font::Glyph::getKerning(int32_t charcode) const
-{
-	const auto iter = kerning.find(charcode);
-	if (iter != kerning.end()) {
-		return iter->second;
-	}
-	return Vector2f();
-}
-
 void Font::Glyph::serialize(Serializer& s) const
 {
 	s << area;
@@ -81,6 +79,21 @@ Font::Font(String name, String imageName, float ascender, float height, float si
 {
 }
 
+Font::Font(std::shared_ptr<DynamicFontAtlas> atlas)
+	: dynamicAtlas(std::move(atlas))
+{
+	const auto& metrics = dynamicAtlas->getFontMetrics();
+	name = metrics.name;
+	ascender = metrics.ascender;
+	height = metrics.height;
+	sizePt = metrics.sizePt;
+	smoothRadius = metrics.smoothRadius;
+	imageSize = dynamicAtlas->getPageSize();
+	distanceField = metrics.smoothRadius > 0;
+	floorGlyphPosition = metrics.floorGlyphPosition;
+	material = dynamicAtlas->getMaterial();
+}
+
 std::unique_ptr<Font> Font::loadResource(ResourceLoader& loader)
 {
 	auto data = loader.getStatic(false);
@@ -100,6 +113,11 @@ std::unique_ptr<Font> Font::loadResource(ResourceLoader& loader)
 	return font;
 }
 
+bool Font::KerningPair::operator<(const KerningPair& other) const
+{
+	return left != other.left ? left < other.left : right < other.right;
+}
+
 void Font::reload(Resource&& resource)
 {
 	*this = std::move(dynamic_cast<Font&>(resource));
@@ -114,34 +132,85 @@ void Font::onLoaded(Resources& resources)
 
 std::pair<const Font::Glyph&, const Font&> Font::getGlyph(int code) const
 {
-	const auto& font = getFontForGlyph(code);
-	return { font.getGlyphHere(code), font };
+	if (const auto* glyph = tryGetGlyphHere(code)) {
+		return { *glyph, *this };
+	}
+	if (dynamicAtlas && dynamicAtlas->canRasterize(code)) {
+		return dynamicAtlas->getGlyph(code, *this);
+	}
+	for (const auto& font: fallbackFont) {
+		if (const auto* glyph = font->tryGetGlyphHere(code)) {
+			return { *glyph, *font };
+		}
+	}
+	if (dynamicAtlas) {
+		return dynamicAtlas->getGlyph(0, *this);
+	}
+	return { getGlyphHere(code), *this };
 }
 
 const Font::Glyph& Font::getGlyphHere(int code) const
 {
-	auto iter = glyphs.find(code);
-	if (iter == glyphs.end()) {
-		iter = glyphs.find(0);
-		if (iter == glyphs.end()) {
-			throw Exception("Unable to load fallback character, needed for character " + toString(code), HalleyExceptions::Graphics);
-		}
-		return iter->second;
+	if (const auto* glyph = tryGetGlyphHere(code)) {
+		return *glyph;
 	}
-	return iter->second;
+	if (const auto* glyph = tryGetGlyphHere(0)) {
+		return *glyph;
+	}
+	throw Exception("Unable to load fallback character, needed for character " + toString(code), HalleyExceptions::Graphics);
+}
+
+const Font::Glyph* Font::tryGetGlyphHere(int code) const
+{
+	if (code >= 0 && code < static_cast<int>(glyphTable.size())) {
+		const auto idx = glyphTable[code];
+		return idx != 0 ? &glyphs[idx - 1] : nullptr;
+	}
+	if (code < glyphTableLimit) {
+		return nullptr;
+	}
+
+	const auto iter = std::lower_bound(glyphs.begin(), glyphs.end(), code, [] (const Glyph& g, int c) { return g.charcode < c; });
+	return iter != glyphs.end() && iter->charcode == code ? &*iter : nullptr;
 }
 
 const Font& Font::getFontForGlyph(int code) const
 {
-	const auto iter = glyphs.find(code);
-	if (iter == glyphs.end()) {
-		for (const auto& font: fallbackFont) {
-			if (font->glyphs.find(code) != font->glyphs.end()) {
-				return *font;
-			}
+	return getGlyph(code).second;
+}
+
+bool Font::hasGlyph(int code) const
+{
+	return tryGetGlyphHere(code) || (dynamicAtlas && dynamicAtlas->canRasterize(code)) || std::any_of(fallbackFont.begin(), fallbackFont.end(), [&] (const auto& font) { return font->tryGetGlyphHere(code) != nullptr; });
+}
+
+float Font::getCoverage(gsl::span<const int> characters) const
+{
+	if (characters.empty()) {
+		return 1.0f;
+	}
+	const auto found = std::count_if(characters.begin(), characters.end(), [&] (int c) { return hasGlyph(c); });
+	return static_cast<float>(found) / static_cast<float>(characters.size());
+}
+
+Vector<int> Font::getMissingCharacters(gsl::span<const int> characters) const
+{
+	Vector<int> result;
+	for (const int c: characters) {
+		if (!hasGlyph(c)) {
+			result.push_back(c);
 		}
 	}
-	return *this;
+	return result;
+}
+
+Vector2f Font::getKerning(int left, int right) const
+{
+	const auto iter = std::lower_bound(kerning.begin(), kerning.end(), KerningPair{ left, right, {} });
+	if (iter != kerning.end() && iter->left == left && iter->right == right) {
+		return iter->kerning;
+	}
+	return Vector2f();
 }
 
 float Font::getLineHeightAtSize(float size) const
@@ -196,14 +265,83 @@ bool Font::shouldFloorGlyphPosition() const
 
 void Font::addGlyph(const Glyph& glyph)
 {
-	glyphs[glyph.charcode] = glyph;
+	const auto iter = std::lower_bound(glyphs.begin(), glyphs.end(), glyph.charcode, [] (const Glyph& g, int c) { return g.charcode < c; });
+	const bool append = iter == glyphs.end();
+	if (!append && iter->charcode == glyph.charcode) {
+		*iter = glyph;
+		std_ex::erase_if(kerning, [&] (const KerningPair& p) { return p.left == glyph.charcode; });
+		takeKerning(*iter);
+	} else {
+		takeKerning(*glyphs.insert(iter, glyph));
+	}
+
+	// Fonts are usually built in charcode order, in which case the table only needs to grow
+	if (append && glyph.charcode < glyphTableLimit) {
+		glyphTable.resize(glyph.charcode + 1, 0);
+		glyphTable[glyph.charcode] = static_cast<uint32_t>(glyphs.size());
+	} else if (!append) {
+		updateGlyphTable();
+	}
+}
+
+void Font::removeGlyph(int code)
+{
+	const auto iter = std::lower_bound(glyphs.begin(), glyphs.end(), code, [] (const Glyph& g, int c) { return g.charcode < c; });
+	if (iter != glyphs.end() && iter->charcode == code) {
+		glyphs.erase(iter);
+		std_ex::erase_if(kerning, [&] (const KerningPair& p) { return p.left == code || p.right == code; });
+		updateGlyphTable();
+	}
+}
+
+DynamicFontAtlas* Font::getDynamicAtlas() const
+{
+	return dynamicAtlas.get();
+}
+
+bool Font::updateDynamicGlyphs()
+{
+	if (dynamicAtlas && dynamicAtlas->update()) {
+		increaseAssetVersion();
+		return true;
+	}
+	return false;
+}
+
+void Font::takeKerning(Glyph& glyph)
+{
+	const auto start = kerning.size();
+	for (const auto& [right, value]: glyph.kerning) {
+		kerning.push_back(KerningPair{ glyph.charcode, right, value });
+	}
+	glyph.kerning.clear();
+
+	std::sort(kerning.begin() + start, kerning.end());
+	std::inplace_merge(kerning.begin(), kerning.begin() + start, kerning.end());
+}
+
+void Font::updateGlyphTable()
+{
+	glyphTable.clear();
+	for (size_t i = 0; i < glyphs.size() && glyphs[i].charcode < glyphTableLimit; ++i) {
+		const auto code = glyphs[i].charcode;
+		if (code >= 0) {
+			glyphTable.resize(code + 1, 0);
+			glyphTable[code] = static_cast<uint32_t>(i + 1);
+		}
+	}
 }
 
-std::shared_ptr<Material> Font::getMaterial() const
+const std::shared_ptr<Material>& Font::getMaterial() const
 {
 	return material;
 }
 
+void Font::setMaterial(std::shared_ptr<Material> m)
+{
+	material = std::move(m);
+}
+
 void Font::serialize(Serializer& s) const
 {
 	s << name;
@@ -215,7 +353,17 @@ void Font::serialize(Serializer& s) const
 	s << smoothRadius;
 	s << imageSize;
 	s << replacementScale;
-	s << glyphs;
+
+	// Serialized in the original map format, with each glyph carrying its own kerning
+	HashMap<int, Glyph> glyphMap;
+	for (const auto& g: glyphs) {
+		glyphMap[g.charcode] = g;
+	}
+	for (const auto& p: kerning) {
+		glyphMap[p.left].kerning[p.right] = p.kerning;
+	}
+	s << glyphMap;
+
 	s << fallback;
 	s << floorGlyphPosition;
 }
@@ -231,13 +379,29 @@ void Font::deserialize(Deserializer& s)
 	s >> smoothRadius;
 	s >> imageSize;
 	s >> replacementScale;
-	s >> glyphs;
-	s >> fallback;
-	s >> floorGlyphPosition;
 
+	HashMap<int, Glyph> glyphMap;
+	s >> glyphMap;
+	glyphs.clear();
+	glyphs.reserve(glyphMap.size());
+	for (auto& [code, g]: glyphMap) {
+		g.charcode = code;
+		glyphs.push_back(std::move(g));
+	}
+	std::sort(glyphs.begin(), glyphs.end(), [] (const Glyph& a, const Glyph& b) { return a.charcode < b.charcode; });
+
+	kerning.clear();
 	for (auto& g: glyphs) {
-		g.second.charcode = g.first;
+		for (const auto& [right, value]: g.kerning) {
+			kerning.push_back(KerningPair{ g.charcode, right, value });
+		}
+		g.kerning.clear();
 	}
+	std::sort(kerning.begin(), kerning.end());
+	updateGlyphTable();
+
+	s >> fallback;
+	s >> floorGlyphPosition;
 
 	//printGlyphs();
 }
@@ -247,7 +411,7 @@ void Font::printGlyphs() const
 	std::optional<Range<int>> curRange;
 	Vector<Range<int>> ranges;
 	for (auto& g: glyphs) {
-		int c = g.first;
+		int c = g.charcode;
 		if (curRange && curRange->end == c - 1) {
 			curRange->end = c;
 		} else {
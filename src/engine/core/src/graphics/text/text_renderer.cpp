@@ -3,12 +3,27 @@
 #include "halley/graphics/painter.h"
 #include "halley/graphics/material/material.h"
 #include "halley/graphics/material/material_parameter.h"
+#include "halley/concurrency/concurrent.h"
 #include <gsl/assert>
 
 #include "halley/text/i18n.h"
 
 using namespace Halley;
 
+namespace {
+	bool isSameText(const String& utf8, const StringUTF32& utf32)
+	{
+		size_t i = 0;
+		for (const char32_t c: utf8.getCodePoints()) {
+			if (i >= utf32.size() || utf32[i] != c) {
+				return false;
+			}
+			++i;
+		}
+		return i == utf32.size();
+	}
+}
+
 TextRenderer::TextRenderer()
 {
 }
@@ -36,7 +51,7 @@ TextRenderer& TextRenderer::setFont(std::shared_ptr<const Font> v)
 {
 	if (font != v) {
 		font = std::move(v);
-		markLayoutDirty();
+		markShapeDirty();
 
 		if (font->isDistanceField()) {
 			materialDirty = true;
@@ -48,10 +63,10 @@ TextRenderer& TextRenderer::setFont(std::shared_ptr<const Font> v)
 
 TextRenderer& TextRenderer::setText(const String& v)
 {
-	const auto newText = v.getUTF32();
-	if (newText != text) {
-		text = newText;
-		markLayoutDirty();
+	// Compared in place, as this tends to be called every frame with the same text
+	if (!isSameText(v, text)) {
+		text = v.getUTF32();
+		markShapeDirty();
 	}
 	return *this;
 }
@@ -60,26 +75,21 @@ TextRenderer& TextRenderer::setText(const StringUTF32& v)
 {
 	if (v != text) {
 		text = v;
-		markLayoutDirty();
+		markShapeDirty();
 	}
 	return *this;
 }
 
 TextRenderer& TextRenderer::setText(const LocalisedString& v)
 {
-	const auto newText = v.getString().getUTF32();
-	if (newText != text) {
-		text = newText;
-		markLayoutDirty();
-	}
-	return *this;
+	return setText(v.getString());
 }
 
 TextRenderer& TextRenderer::setSize(float v)
 {
 	if (size != v) {
 		size = v;
-		markLayoutDirty();
+		markShapeDirty();
 	}
 	return *this;
 }
@@ -198,7 +208,7 @@ TextRenderer& TextRenderer::setFontOverride(Vector<FontOverride> fontOverride)
 {
 	if (fontOverrides != fontOverride) {
 		fontOverrides = std::move(fontOverride);
-		markLayoutDirty();
+		markShapeDirty();
 	}
 	return *this;
 }
@@ -207,7 +217,7 @@ TextRenderer& TextRenderer::setFontSizeOverride(Vector<FontSizeOverride> fontSiz
 {
 	if (fontSizeOverrides != fontSizeOverride) {
 		fontSizeOverrides = std::move(fontSizeOverride);
-		markLayoutDirty();
+		markShapeDirty();
 	}
 	return *this;
 }
@@ -216,7 +226,7 @@ TextRenderer& TextRenderer::setLineSpacing(float spacing)
 {
 	if (lineSpacing != spacing) {
 		lineSpacing = spacing;
-		markLayoutDirty();
+		markShapeDirty();
 	}
 	return *this;
 }
@@ -242,7 +252,7 @@ TextRenderer& TextRenderer::setScale(float scale)
 {
 	if (this->scale != scale) {
 		this->scale = scale;
-		markLayoutDirty();
+		markShapeDirty();
 	}
 	return *this;
 }
@@ -258,7 +268,7 @@ TextRenderer& TextRenderer::setAngle(Angle1f angle)
 
 void TextRenderer::refresh()
 {
-	markLayoutDirty();
+	markShapeDirty();
 	materialDirty = true;
 	positionDirty = true;
 }
@@ -277,14 +287,25 @@ TextRenderer TextRenderer::clone() const
 	return *this;
 }
 
+void TextRenderer::shapeIfNeeded() const
+{
+	if (shapeDirty || shapedFontVersion != font->getAssetVersion()) {
+		shape(text.begin(), text.size(), fontOverrides, fontSizeOverrides, shapeCache);
+		shapedFontVersion = font->getAssetVersion();
+		shapeDirty = false;
+		layoutDirty = true;
+	}
+}
+
 void TextRenderer::generateLayoutIfNeeded() const
 {
 	if (!font) {
 		return;
 	}
 
+	shapeIfNeeded();
 	if (layoutDirty || positionDirty) {
-		generateLayout(text, &layoutCache, extents);
+		generateLayout(shapeCache, &layoutCache, extents);
 		hasExtents = true;
 		positionDirty = false;
 		layoutDirty = false;
@@ -316,7 +337,92 @@ void TextRenderer::generateSprites() const
 	generateGlyphsIfNeeded();
 }
 
-void TextRenderer::generateLayout(const StringUTF32& text, Vector<GlyphLayout>* layouts, Vector2f& extents) const
+gsl::span<const Sprite> TextRenderer::getSprites() const
+{
+	generateSprites();
+	return spritesCache;
+}
+
+namespace {
+	template <typename F>
+	void forEachChunk(size_t count, F f)
+	{
+		if (count < TextRenderer::minParallelBatchSize || !Executors::hasInstance() || Executors::getCPU().threadCount() < 2) {
+			for (size_t i = 0; i < count; ++i) {
+				f(i);
+			}
+			return;
+		}
+
+		// Most strings are short, so they're handed out in chunks to keep the scheduling cost below the work itself
+		constexpr size_t chunkSize = 16;
+		const size_t nChunks = (count + chunkSize - 1) / chunkSize;
+		Concurrent::parallelFor(nChunks, [&] (size_t chunk)
+		{
+			const size_t end = std::min(count, (chunk + 1) * chunkSize);
+			for (size_t i = chunk * chunkSize; i < end; ++i) {
+				f(i);
+			}
+		});
+	}
+}
+
+void TextRenderer::generateSprites(gsl::span<const TextRenderer> renderers)
+{
+	forEachChunk(renderers.size(), [&] (size_t i)
+	{
+		renderers[i].generateSprites();
+	});
+}
+
+void TextRenderer::generateSprites(gsl::span<const TextRenderer* const> renderers)
+{
+	forEachChunk(renderers.size(), [&] (size_t i)
+	{
+		if (renderers[i]) {
+			renderers[i]->generateSprites();
+		}
+	});
+}
+
+template <typename Iter>
+void TextRenderer::shape(Iter begin, size_t n, const Vector<FontOverride>& fontOverrides, const Vector<FontSizeOverride>& fontSizeOverrides, Vector<ShapedGlyph>& result) const
+{
+	result.resize(n);
+
+	const Font::Glyph* lastGlyph = nullptr;
+	const Font* lastFont = nullptr;
+
+	auto curFont = TextOverrideCursor(font, fontOverrides);
+	auto curFontSize = TextOverrideCursor(size, fontSizeOverrides);
+
+	auto iter = begin;
+	for (size_t i = 0; i < n; ++i, ++iter) {
+		const char32_t c = *iter;
+		curFont.setPos(i);
+		curFontSize.setPos(i);
+
+		const auto& [glyph, fontForGlyph] = curFont->getGlyph(c);
+		const float curScale = getScale(fontForGlyph, *curFontSize);
+		const Vector2f kerning = lastGlyph && lastFont == &fontForGlyph ? fontForGlyph.getKerning(lastGlyph->charcode, c) : Vector2f();
+
+		auto& shaped = result[i];
+		shaped.font = &fontForGlyph;
+		shaped.area = glyph.area;
+		shaped.size = glyph.size;
+		shaped.offset = (kerning + glyph.horizontalBearing.flipVertical()) * curScale;
+		shaped.advance = (glyph.advance.x + kerning.x) * curScale;
+		shaped.scale = curScale;
+		shaped.lineHeight = getLineHeight(fontForGlyph, *curFontSize);
+		shaped.ascender = fontForGlyph.getAscenderDistance() * curScale;
+		shaped.c = c;
+
+		lastGlyph = &glyph;
+		lastFont = &fontForGlyph;
+	}
+}
+
+void TextRenderer::generateLayout(const Vector<ShapedGlyph>& glyphs, Vector<GlyphLayout>* layouts, Vector2f& extents) const
 {
 	const bool floorEnabled = font->shouldFloorGlyphPosition();
 	const auto floorAlign = [floorEnabled] (Vector2f a) { return floorEnabled ? a.floor() : a; };
@@ -328,35 +434,24 @@ void TextRenderer::generateLayout(const StringUTF32& text, Vector<GlyphLayout>*
 	float curLineHeight = 0;
 	float curAscender = 0;
 
+	const size_t n = glyphs.size();
 	if (layouts) {
-		layouts->resize(text.size());
+		layouts->resize(n);
 	}
 
-	const Font::Glyph* lastGlyph = nullptr;
-	const Font* lastFont = nullptr;
-
-	auto curFont = TextOverrideCursor(font, fontOverrides);
-	auto curFontSize = TextOverrideCursor(size, fontSizeOverrides);
-
 	float minX = std::numeric_limits<float>::infinity();
 	float maxX = -std::numeric_limits<float>::infinity();
 	float height = 0;
 	bool gotExtents = false;
 
 	// Go through every character
-	const size_t n = text.size();
-	for (size_t i = 0; i < n; i++) {
-		const char32_t c = text[i];
-		curFont.setPos(i);
-		curFontSize.setPos(i);
-		
-		const auto& [glyph, fontForGlyph] = curFont->getGlyph(c);
-		const float curScale = getScale(fontForGlyph, *curFontSize);
+	for (size_t i = 0; i < n; ++i) {
+		const auto& glyph = glyphs[i];
+		const char32_t c = glyph.c;
 
-		const Vector2f kerning = lastGlyph && lastFont == &fontForGlyph ? lastGlyph->getKerning(c) : Vector2f();
 		const Vector2f cursorPos = lineStartPos + curLineOffset + pixelOffset;
-		const Vector2f glyphPos = cursorPos + (kerning + glyph.horizontalBearing.flipVertical()) * curScale;
-		const float advance = (glyph.advance.x + kerning.x) * curScale;
+		const Vector2f glyphPos = cursorPos + glyph.offset;
+		const float advance = glyph.advance;
 
 		if (layouts) {
 			auto& layout = (*layouts)[i];
@@ -367,8 +462,8 @@ void TextRenderer::generateLayout(const StringUTF32& text, Vector<GlyphLayout>*
 		}
 
 		curLineOffset.x += advance;
-		curLineHeight = std::max(curLineHeight, getLineHeight(fontForGlyph, *curFontSize));
-		curAscender = std::max(curAscender, fontForGlyph.getAscenderDistance() * curScale);
+		curLineHeight = std::max(curLineHeight, glyph.lineHeight);
+		curAscender = std::max(curAscender, glyph.ascender);
 
 		if (c != ' ' && c != '\n') {
 			minX = std::min(minX, glyphPos.x);
@@ -376,9 +471,6 @@ void TextRenderer::generateLayout(const StringUTF32& text, Vector<GlyphLayout>*
 			gotExtents = true;
 		}
 
-		lastGlyph = &glyph;
-		lastFont = &fontForGlyph;
-
 		auto lineBreak = [&] {
 			// Line break, update previous characters!
 			if (layouts) {
@@ -430,29 +522,28 @@ void TextRenderer::generateSprites(Vector<Sprite>& sprites, const Vector<GlyphLa
 	sprites.resize(getGlyphCount(text));
 
 	auto curCol = TextOverrideCursor(colour, colourOverrides);
-	auto curFont = TextOverrideCursor(font, fontOverrides);
-	auto curFontSize = TextOverrideCursor(size, fontSizeOverrides);
 
 	const size_t n = text.size();
 	for (size_t i = 0; i < n; i++) {
 		const char32_t c = text[i];
 		curCol.setPos(i);
-		curFont.setPos(i);
-		curFontSize.setPos(i);
 		
 		if (c != '\n') {
-			const auto& [glyph, fontForGlyph] = curFont->getGlyph(c);
-			const float curScale = getScale(fontForGlyph, *curFontSize);
-
+			const auto& glyph = shapeCache[i];
 			const Vector2f glyphPos = layouts[i].pos;
 			const Vector2f renderPos = (glyphPos - position).rotate(angle) + position;
 
-			sprites.at(spritesInserted++) = Sprite()
-				.setMaterial(hasMaterialOverride ? getMaterial(fontForGlyph) : fontForGlyph.getMaterial())
+			// Sprites are only replaced when the material changes, as its reference count is shared by every renderer using the font
+			auto& sprite = sprites.at(spritesInserted++);
+			const auto& material = hasMaterialOverride ? getMaterial(*glyph.font) : glyph.font->getMaterial();
+			if (spriteFilter || sprite.getMaterialPtr() != material) {
+				sprite = Sprite().setMaterial(material);
+			}
+			sprite
 				.setSize(glyph.size)
 				.setTexRect(glyph.area)
 				.setPos(renderPos)
-				.setScale(curScale)
+				.setScale(glyph.scale)
 				.setColour(curCol.getCurValue())
 				.setRotation(angle);
 		}
@@ -492,7 +583,8 @@ void TextRenderer::setSpriteFilter(SpriteFilter f)
 
 Vector2f TextRenderer::getExtents() const
 {
-	if (hasExtents) {
+	// Fonts with a dynamic atlas change version as glyphs arrive, which changes the extents too
+	if (hasExtents && (!font || shapedFontVersion == font->getAssetVersion())) {
 		return extents;
 	}
 
@@ -502,8 +594,8 @@ Vector2f TextRenderer::getExtents() const
 		return {};
 	}
 
-	extents = getExtents(text);
-	hasExtents = true;
+	// Extents come out of the layout, which will be needed to draw anyway
+	generateLayoutIfNeeded();
 	return extents;
 }
 
@@ -512,9 +604,27 @@ Vector2f TextRenderer::getExtents(const StringUTF32& str) const
 	if (!font) {
 		return {};
 	}
+	if (str == text) {
+		return getExtents();
+	}
 
+	Vector<ShapedGlyph> glyphs;
+	shape(str.begin(), str.size(), fontOverrides, fontSizeOverrides, glyphs);
 	Vector2f result;
-	generateLayout(str, nullptr, result);
+	generateLayout(glyphs, nullptr, result);
+	return result;
+}
+
+Vector2f TextRenderer::getExtents(const String& str) const
+{
+	if (!font) {
+		return {};
+	}
+
+	Vector<ShapedGlyph> glyphs;
+	shape(str.getCodePoints().begin(), str.getUTF32Len(), fontOverrides, fontSizeOverrides, glyphs);
+	Vector2f result;
+	generateLayout(glyphs, nullptr, result);
 	return result;
 }
 
@@ -577,50 +687,61 @@ size_t TextRenderer::getCharacterAt(const Vector2f& targetPos) const
 
 StringUTF32 TextRenderer::split(float maxWidth) const
 {
-	return split(text, maxWidth, {}, fontOverrides, fontSizeOverrides);
+	if (!font) {
+		return text;
+	}
+
+	shapeIfNeeded();
+	return doSplit(text.begin(), text.end(), shapeCache, maxWidth, {});
 }
 
 StringUTF32 TextRenderer::split(const String& str, float maxWidth) const
 {
-	return split(str.getUTF32(), maxWidth, {}, fontOverrides, fontSizeOverrides);
+	const auto codePoints = str.getCodePoints();
+	Vector<ShapedGlyph> glyphs;
+	shape(codePoints.begin(), str.getUTF32Len(), fontOverrides, fontSizeOverrides, glyphs);
+	return doSplit(codePoints.begin(), codePoints.end(), glyphs, maxWidth, {});
 }
 
 StringUTF32 TextRenderer::split(const StringUTF32& str, float maxWidth, std::function<bool(int32_t)> filter, const Vector<FontOverride>& fontOverrides, const Vector<FontSizeOverride>& fontSizeOverrides) const
 {
-	StringUTF32 result;
+	if (font && str == text && fontOverrides == this->fontOverrides && fontSizeOverrides == this->fontSizeOverrides) {
+		shapeIfNeeded();
+		return doSplit(str.begin(), str.end(), shapeCache, maxWidth, filter);
+	}
 
-	gsl::span<const char32_t> src = str;
-	const Font::Glyph* lastGlyph = nullptr;
-	const Font* lastFont = nullptr;
+	Vector<ShapedGlyph> glyphs;
+	shape(str.begin(), str.size(), fontOverrides, fontSizeOverrides, glyphs);
+	return doSplit(str.begin(), str.end(), glyphs, maxWidth, filter);
+}
 
-	auto curFont = TextOverrideCursor(font, fontOverrides);
-	auto curFontSize = TextOverrideCursor(size, fontSizeOverrides);
+template <typename Iter>
+StringUTF32 TextRenderer::doSplit(Iter begin, Iter end, const Vector<ShapedGlyph>& glyphs, float maxWidth, const std::function<bool(int32_t)>& filter) const
+{
+	StringUTF32 result;
+	result.reserve(glyphs.size()); // Line breaks mostly replace whitespace, so this tends to be enough
+
+	Iter src = begin;
+	size_t srcIdx = 0;
 
 	// Keep doing this while src is not exhausted
-	while (!src.empty()) {
+	while (src != end) {
 		float curWidth = 0.0f;
-		std::optional<gsl::span<const char32_t>> lastValid;
+		std::optional<Iter> lastValid; // One past the end of the line
 
-		for (size_t i = 0; i < src.size(); ++i) {
-			const int32_t c = src[i];
-			curFont.setPos(i);
-			curFontSize.setPos(i);
+		size_t i = 0;
+		for (Iter iter = src; iter != end; ++iter, ++i) {
+			const int32_t c = *iter;
+			const Iter next = std::next(iter);
 
 			const bool accepted = filter ? filter(c) : true;
 
-			const bool isLastChar = i == src.size() - 1;
+			const bool isLastChar = next == end;
 			if (isLastChar || (accepted && (c == '\n' || c == ' ' || c == '\t'))) {
-				lastValid = src.subspan(0, i + 1);
+				lastValid = next;
 			}
 
-			const auto& [glyph, f] = curFont->getGlyph(c);
-			const float scale = getScale(f, *curFontSize);
-			const auto kerning = lastFont == &f && lastGlyph ? lastGlyph->getKerning(c) : Vector2f();
-			const float w = accepted ? (glyph.advance.x + kerning.x) * scale : 0.0f;
-			curWidth += w;
-
-			lastFont = &f;
-			lastGlyph = &glyph;
+			curWidth += accepted ? glyphs[srcIdx + i].advance : 0.0f;
 
 			const bool firstCharInRun = i == 0; // It MUST fit at least the first character, or we'll infinite loop
 			if (c == '\n' || (!firstCharInRun && curWidth > maxWidth) || isLastChar) {
@@ -628,20 +749,23 @@ StringUTF32 TextRenderer::split(const StringUTF32& str, float maxWidth, std::fun
 				if (!lastValid) {
 					// lastValid won't be set if there were no suitable breaking spaces
 					if (isLastChar) {
-						lastValid = src.subspan(0, i + 1);
+						lastValid = next;
 					} else {
-						lastValid = src.subspan(0, i);
+						lastValid = iter;
 					}
 					advanceAdjust = 0;
 				}
-				const int advance = int(lastValid->size());
+				const int advance = int(std::distance(src, *lastValid));
 
 				if (!result.empty()) {
 					result.push_back('\n');
 				}
 				const int totalAdvance = std::max(advance + advanceAdjust, 0);
-				result += StringUTF32(lastValid->data(), totalAdvance);
-				src = src.subspan(advance);
+				for (int j = 0; j < totalAdvance; ++j, ++src) {
+					result.push_back(*src);
+				}
+				src = *lastValid;
+				srcIdx += advance;
 				break;
 			}
 		}
@@ -741,6 +865,12 @@ float TextRenderer::getScale(const Font& f, float size) const
 	return size / f.getSizePoints() * (usingReplacement ? font->getReplacementScale() : 1.0f) * scale;
 }
 
+void TextRenderer::markShapeDirty() const
+{
+	shapeDirty = true;
+	markLayoutDirty();
+}
+
 void TextRenderer::markLayoutDirty() const
 {
 	layoutDirty = true;
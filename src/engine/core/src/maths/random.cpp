@@ -56,11 +56,34 @@ Random::Random(gsl::span<const gsl::byte> data, bool threadSafe)
 
 Random::~Random() = default;
 
+Random::Random(const Random& other)
+{
+	*this = other;
+}
+
 Random::Random(Random&& other) noexcept
 {
 	*this = std::move(other);
 }
 
+Random& Random::operator=(const Random& other)
+{
+	if (this == &other) {
+		return *this;
+	}
+
+	auto lock = std::unique_lock<std::mutex>(other.mutex, std::defer_lock_t());
+	if (other.threadSafe) {
+		lock.lock();
+	}
+
+	generator = std::make_unique<MT199937AR>(*other.generator);
+	canSeed = other.canSeed;
+	threadSafe = other.threadSafe;
+
+	return *this;
+}
+
 Random& Random::operator=(Random&& other) noexcept
 {
 	auto lock = std::unique_lock<std::mutex>(other.mutex, std::defer_lock_t());
@@ -38,7 +38,7 @@ size_t NetworkPacketBase::getSize() const
 
 gsl::span<const gsl::byte> NetworkPacketBase::getBytes() const
 {
-	return gsl::span<const gsl::byte>(data).subspan(dataStart, getSize());
+	return gsl::as_bytes(gsl::span<const Byte>(data)).subspan(dataStart, getSize());
 }
 
 OutboundNetworkPacket::OutboundNetworkPacket(const OutboundNetworkPacket& other)
@@ -50,19 +50,31 @@ OutboundNetworkPacket::OutboundNetworkPacket(const OutboundNetworkPacket& other)
 
 OutboundNetworkPacket::OutboundNetworkPacket(OutboundNetworkPacket&& other) noexcept
 {
-	data = other.data;
+	data = std::move(other.data);
 	dataStart = other.dataStart;
 	other.dataStart = 0;
 }
 
 OutboundNetworkPacket::OutboundNetworkPacket(gsl::span<const gsl::byte> data)
-	: NetworkPacketBase(data, 128)
+	: NetworkPacketBase(data, headerSpace)
 {
 }
 
 OutboundNetworkPacket::OutboundNetworkPacket(const Bytes& data)
-	: NetworkPacketBase(gsl::as_bytes(gsl::span<const Byte>(data)), 128)
+	: NetworkPacketBase(gsl::as_bytes(gsl::span<const Byte>(data)), headerSpace)
+{
+}
+
+OutboundNetworkPacket::OutboundNetworkPacket(Bytes bytes, size_t dataStart)
 {
+	Expects(dataStart <= bytes.size());
+	data = std::move(bytes);
+	this->dataStart = dataStart;
+}
+
+OutboundNetworkPacket::~OutboundNetworkPacket()
+{
+	SerializerBufferPool::release(std::move(data));
 }
 
 void OutboundNetworkPacket::addHeader(gsl::span<const gsl::byte> src)
@@ -107,7 +119,7 @@ void InboundNetworkPacket::extractHeader(gsl::span<gsl::byte> dst)
 
 InboundNetworkPacket& InboundNetworkPacket::operator=(InboundNetworkPacket&& other) noexcept
 {
-	data = other.data;
+	data = std::move(other.data);
 	dataStart = other.dataStart;
 	other.dataStart = 0;
 	return *this;
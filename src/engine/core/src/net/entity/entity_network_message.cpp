@@ -22,12 +22,14 @@ void EntityNetworkMessageUpdate::serialize(Serializer& s) const
 {
 	s << entityId;
 	s << bytes;
+	s << componentDeltas;
 }
 
 void EntityNetworkMessageUpdate::deserialize(Deserializer& s)
 {
 	s >> entityId;
 	s >> bytes;
+	s >> componentDeltas;
 }
 
 void EntityNetworkMessageDestroy::serialize(Serializer& s) const
@@ -172,6 +172,7 @@ void EntityNetworkRemotePeer::sendCreateEntity(EntityRef entity)
 
 	result.networkId = assignId();
 	result.data = parent->getFactory().serializeEntity(entity, parent->getEntitySerializationOptions());
+	result.changeRevision = entity.getChangeRevision();
 
 	auto deltaData = parent->getFactory().entityDataToPrefabDelta(result.data, entity.getPrefab(), parent->getEntityDeltaOptions());
 	auto bytes = Serializer::toBytes(deltaData, parent->getByteSerializationOptions());
@@ -179,6 +180,7 @@ void EntityNetworkRemotePeer::sendCreateEntity(EntityRef entity)
 	Logger::logDev("Send Create: " + entity.getName() + " (" + entity.getInstanceUUID() + ") to peer " + toString(static_cast<int>(peerId)) + " (" + toString(bytes.size()) + " B)");
 
 	send(EntityNetworkMessageCreate(result.networkId, std::move(bytes)));
+	startComponentDeltas(result, entity);
 	
 	outboundEntities[entity.getEntityId()] = std::move(result);
 }
@@ -190,25 +192,102 @@ void EntityNetworkRemotePeer::sendUpdateEntity(Time t, OutboundEntity& remote, E
 		return;
 	}
 
+	// If every component tracks its changes, an entity that hasn't changed since it was last sent can be skipped without serializing it.
+	// One untracked component anywhere in the hierarchy means it's serialized and diffed in full, as reusing just the unchanged tracked
+	// components saves nothing: copying their last sent data costs as much as serializing them (see EntityChangeRevisionBenchmark).
+	const auto changeRevision = entity.getChangeRevision();
+	if (changeRevision && changeRevision == remote.changeRevision) {
+		return;
+	}
+
+	// Components that have binary deltas skip the EntityData path entirely
+	const auto& reflection = parent->getWorld().getReflection();
+	for (auto iter = remote.deltaSnapshots.begin(); iter != remote.deltaSnapshots.end();) {
+		auto& reflector = reflection.getComponentReflector(iter->first);
+		if (!reflector.tryGetComponent(entity)) {
+			// Removed, put it back in the last sent data so the EntityDataDelta removes it remotely
+			remote.data.getComponents().emplace_back(reflector.getName(), ConfigNode::MapType());
+			iter = remote.deltaSnapshots.erase(iter);
+		} else {
+			++iter;
+		}
+	}
+	auto serializationOptions = parent->getEntitySerializationOptions();
+	serializationOptions.skipComponent = [&] (EntityRef e, int componentId)
+	{
+		return e == entity && remote.deltaSnapshots.contains(componentId);
+	};
+
 	// Encode delta using interpolators
-	auto newData = parent->getFactory().serializeEntity(entity, parent->getEntitySerializationOptions());
+	auto newData = parent->getFactory().serializeEntity(entity, serializationOptions);
 	auto retriever = DataInterpolatorSetRetriever(entity, true);
 	auto options = parent->getEntityDeltaOptions();
 	options.interpolatorSet = &retriever;
 	auto deltaData = EntityDataDelta(remote.data, newData, options);
+	auto componentDeltas = serializeComponentDeltas(remote, entity);
 	
-	if (deltaData.hasChange()) {
-		remote.data = std::move(newData);
+	if (deltaData.hasChange() || !componentDeltas.empty()) {
+		Bytes bytes;
+		if (deltaData.hasChange()) {
+			// Only recorded here, as a delta without changes might just mean that the interpolators are holding back small ones
+			remote.changeRevision = changeRevision;
+			remote.data = std::move(newData);
+			bytes = Serializer::toBytes(deltaData, parent->getByteSerializationOptions());
+			startComponentDeltas(remote, entity);
+		}
 		remote.timeSinceSend = 0;
 
-		auto bytes = Serializer::toBytes(deltaData, parent->getByteSerializationOptions());
 		//Logger::logDev("Send Update " + entity.getName() + " to peer " + toString(static_cast<int>(peerId)) + " (" + toString(bytes.size()) + " B):\n" + deltaData.toYAML() + "\n");
-		//Logger::logDev("Send Update " + entity.getName() + " to peer " + toString(static_cast<int>(peerId)) + " (" + toString(bytes.size()) + " B)");
+		//Logger::logDev("Send Update " + entity.getName() + " to peer " + toString(static_cast<int>(peerId)) + " (" + toString(bytes.size() + componentDeltas.size()) + " B)");
 		
-		send(EntityNetworkMessageUpdate(remote.networkId, std::move(bytes)));
+		send(EntityNetworkMessageUpdate(remote.networkId, std::move(bytes), std::move(componentDeltas)));
+	}
+}
+
+void EntityNetworkRemotePeer::startComponentDeltas(OutboundEntity& remote, EntityRef entity)
+{
+	// Components added since the last time have just been sent in full, so from now on they can be sent as binary deltas
+	// Components with interpolators stay on the EntityData path, as binary deltas are applied directly and would bypass them
+	const auto& reflection = parent->getWorld().getReflection();
+	const auto retriever = DataInterpolatorSetRetriever(entity, false);
+	for (auto [componentId, component]: entity) {
+		const auto& reflector = reflection.getComponentReflector(componentId);
+		if (reflector.hasNetworkDelta() && !remote.deltaSnapshots.contains(componentId) && !retriever.hasInterpolators(entity.getEntityId(), reflector.getName())) {
+			remote.deltaSnapshots[componentId] = reflector.makeNetworkDeltaSnapshot(*component);
+			std_ex::erase_if(remote.data.getComponents(), [&] (const auto& c) { return c.first == reflector.getName(); });
+		}
 	}
 }
 
+Bytes EntityNetworkRemotePeer::serializeComponentDeltas(OutboundEntity& remote, EntityRef entity)
+{
+	if (remote.deltaSnapshots.empty()) {
+		return {};
+	}
+
+	const auto& reflection = parent->getWorld().getReflection();
+	Vector<std::tuple<int, Component*, uint64_t>> changed;
+	for (auto [componentId, component]: entity) {
+		if (const auto iter = remote.deltaSnapshots.find(componentId); iter != remote.deltaSnapshots.end()) {
+			if (const auto mask = reflection.getComponentReflector(componentId).getNetworkDeltaMask(*component, *iter->second); mask != 0) {
+				changed.emplace_back(componentId, component, mask);
+			}
+		}
+	}
+	if (changed.empty()) {
+		return {};
+	}
+
+	return Serializer::toBytes([&] (Serializer& s)
+	{
+		s << static_cast<uint32_t>(changed.size());
+		for (const auto& [componentId, component, mask]: changed) {
+			s << componentId;
+			reflection.getComponentReflector(componentId).serializeNetworkDelta(s, *component, *remote.deltaSnapshots.at(componentId), mask);
+		}
+	}, parent->getByteSerializationOptions());
+}
+
 void EntityNetworkRemotePeer::sendDestroyEntity(OutboundEntity& remote)
 {
 	allocatedOutboundIds.erase(remote.networkId);
@@ -299,8 +378,17 @@ void EntityNetworkRemotePeer::receiveUpdateEntity(const EntityNetworkMessageUpda
 	auto entity = parent->getWorld().tryGetEntity(remote.worldId);
 	if (!entity.isValid()) {
 		Logger::logWarning("Entity with network id (" + toString(static_cast<int>(msg.entityId)) + ") and EntityId (" + toString(remote.worldId) + ") not alive in the world from peer " + toString(static_cast<int>(peerId)));
-		const auto delta = Deserializer::fromBytes<EntityDataDelta>(msg.bytes, parent->getByteSerializationOptions());
-		Logger::logWarning("Caused by trying to update entity:\n" + delta.toYAML());
+		if (!msg.bytes.empty()) {
+			const auto delta = Deserializer::fromBytes<EntityDataDelta>(msg.bytes, parent->getByteSerializationOptions());
+			Logger::logWarning("Caused by trying to update entity:\n" + delta.toYAML());
+		}
+		return;
+	}
+
+	if (!msg.componentDeltas.empty()) {
+		applyComponentDeltas(entity, msg.componentDeltas);
+	}
+	if (msg.bytes.empty()) {
 		return;
 	}
 	
@@ -320,6 +408,27 @@ void EntityNetworkRemotePeer::receiveUpdateEntity(const EntityNetworkMessageUpda
 	remote.data.applyDelta(delta);
 }
 
+void EntityNetworkRemotePeer::applyComponentDeltas(EntityRef entity, const Bytes& bytes)
+{
+	const auto& reflection = parent->getWorld().getReflection();
+	auto s = Deserializer(bytes, parent->getByteSerializationOptions());
+
+	uint32_t count = 0;
+	s >> count;
+	for (uint32_t i = 0; i < count; ++i) {
+		int componentId = -1;
+		s >> componentId;
+		const auto& reflector = reflection.getComponentReflector(componentId);
+		auto* component = reflector.tryGetComponent(entity);
+		if (!component) {
+			// Can't skip over the rest of the data without the component
+			Logger::logError("Component " + String(reflector.getName()) + " not found in network entity \"" + entity.getName() + "\" when applying delta");
+			return;
+		}
+		reflector.applyNetworkDelta(s, *component);
+	}
+}
+
 void EntityNetworkRemotePeer::receiveDestroyEntity(const EntityNetworkMessageDestroy& msg)
 {
 	const auto iter = inboundEntities.find(msg.entityId);
@@ -130,13 +130,15 @@ void EntityNetworkSession::sendMessages()
 {
 	auto tryCompress = [&](size_t startIdx, size_t count, const Vector<EntityNetworkMessage>& msgs) -> std::optional<Bytes>
 	{
-		auto data = Serializer::toBytes(msgs.span().subspan(startIdx, count), byteSerializationOptions);
+		auto data = Serializer::toPooledBytes(msgs.span().subspan(startIdx, count), byteSerializationOptions);
         if (data.size() > 32 * 1024) {
             // EntityNetworkSession::receiveUpdates() uses a fixed sized buffer to decompress into.
             // Let's just check the size right here, and split if needed.
+            SerializerBufferPool::release(std::move(data));
             return std::nullopt;
         }
 		auto compressed = Compression::lz4Compress(gsl::as_bytes(gsl::span<const Byte>(data)));
+		SerializerBufferPool::release(std::move(data));
 		if (compressed.size() <= 16000) {
 			return std::move(compressed);
 		} else {
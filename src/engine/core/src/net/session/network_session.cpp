@@ -49,8 +49,8 @@ void NetworkSession::join(const String& address)
 	ControlMsgJoin msg;
 	msg.networkVersion = networkVersion;
 	msg.userName = userName;
-	Bytes bytes = Serializer::toBytes(msg);
-	doSendToPeer(peers.back(), doMakeControlPacket(NetworkSessionControlMessageType::Join, OutboundNetworkPacket(bytes)));
+	msg.engineNetworkVersion = engineNetworkVersion;
+	doSendToPeer(peers.back(), doMakeControlPacket(NetworkSessionControlMessageType::Join, OutboundNetworkPacket::fromSerialized(msg)));
 	
 	for (auto* listener : listeners) {
 		listener->onPeerConnected(0);
@@ -478,18 +478,17 @@ void NetworkSession::onControlMessage(PeerId peerId, const ControlMsgJoin& msg)
 		return;
 	}
 
-	if (msg.networkVersion != networkVersion) {
+	if (msg.networkVersion != networkVersion || msg.engineNetworkVersion != engineNetworkVersion) {
 		closeConnection(peerId, "Incompatible network version.");
 		return;
 	}
 
 	ControlMsgSetPeerId outMsg;
 	outMsg.peerId = peerId;
-	Bytes bytes = Serializer::toBytes(outMsg);
 	sharedData[outMsg.peerId] = makePeerSharedData();
 
 	const auto& peer = getPeer(peerId);
-	doSendToPeer(peer, doMakeControlPacket(NetworkSessionControlMessageType::SetPeerId, OutboundNetworkPacket(bytes)));
+	doSendToPeer(peer, doMakeControlPacket(NetworkSessionControlMessageType::SetPeerId, OutboundNetworkPacket::fromSerialized(outMsg)));
 	doSendToPeer(peer, makeUpdateSharedDataPacket({}));
 	for (auto& i : sharedData) {
 		doSendToPeer(peer, makeUpdateSharedDataPacket(i.first));
@@ -548,9 +547,7 @@ void NetworkSession::onControlMessage(PeerId peerId, const ControlMsgSetServerSi
 	ControlMsgSetServerSideDataReply reply;
 	reply.requestId = msg.requestId;
 	reply.ok = ok;
-	Bytes bytes = Serializer::toBytes(reply);
-
-	doSendToPeer(getPeer(peerId), doMakeControlPacket(NetworkSessionControlMessageType::SetServerSideDataReply, OutboundNetworkPacket(bytes)));
+	doSendToPeer(getPeer(peerId), doMakeControlPacket(NetworkSessionControlMessageType::SetServerSideDataReply, OutboundNetworkPacket::fromSerialized(reply)));
 }
 
 void NetworkSession::onControlMessage(PeerId peerId, const ControlMsgSetServerSideDataReply& msg)
@@ -576,9 +573,7 @@ void NetworkSession::onControlMessage(PeerId peerId, const ControlMsgGetServerSi
 	ControlMsgGetServerSideDataReply reply;
 	reply.requestId = msg.requestId;
 	reply.data = std::move(result);
-	Bytes bytes = Serializer::toBytes(reply);
-
-	doSendToPeer(getPeer(peerId), doMakeControlPacket(NetworkSessionControlMessageType::GetServerSideDataReply, OutboundNetworkPacket(bytes)));
+	doSendToPeer(getPeer(peerId), doMakeControlPacket(NetworkSessionControlMessageType::GetServerSideDataReply, OutboundNetworkPacket::fromSerialized(reply)));
 }
 
 void NetworkSession::onControlMessage(PeerId peerId, const ControlMsgGetServerSideDataReply& msg)
@@ -678,14 +673,12 @@ OutboundNetworkPacket NetworkSession::makeUpdateSharedDataPacket(std::optional<P
 	if (!ownerId) {
 		ControlMsgSetSessionState state;
 		state.state = Serializer::toBytes(data);
-		Bytes bytes = Serializer::toBytes(state);
-		return doMakeControlPacket(NetworkSessionControlMessageType::SetSessionState, OutboundNetworkPacket(bytes));
+		return doMakeControlPacket(NetworkSessionControlMessageType::SetSessionState, OutboundNetworkPacket::fromSerialized(state));
 	} else {
 		ControlMsgSetPeerState state;
 		state.peerId = ownerId.value();
 		state.state = Serializer::toBytes(data);
-		Bytes bytes = Serializer::toBytes(state);
-		return doMakeControlPacket(NetworkSessionControlMessageType::SetPeerState, OutboundNetworkPacket(bytes));
+		return doMakeControlPacket(NetworkSessionControlMessageType::SetPeerState, OutboundNetworkPacket::fromSerialized(state));
 	}
 }
 
@@ -774,9 +767,7 @@ Future<bool> NetworkSession::setServerSideData(String uniqueKey, ConfigNode data
 		msg.key = std::move(uniqueKey);
 		msg.data = std::move(data);
 		msg.requestId = id;
-		Bytes bytes = Serializer::toBytes(msg);
-
-		doSendToPeer(peers.back(), doMakeControlPacket(NetworkSessionControlMessageType::SetServerSideData, OutboundNetworkPacket(bytes)));
+		doSendToPeer(peers.back(), doMakeControlPacket(NetworkSessionControlMessageType::SetServerSideData, OutboundNetworkPacket::fromSerialized(msg)));
 
 		auto future = result.getFuture();
 		setServerSideDataPending[id] = std::move(result);
@@ -796,9 +787,7 @@ Future<ConfigNode> NetworkSession::retrieveServerSideData(String uniqueKey)
 		ControlMsgGetServerSideData msg;
 		msg.key = std::move(uniqueKey);
 		msg.requestId = id;
-		Bytes bytes = Serializer::toBytes(msg);
-
-		doSendToPeer(peers.back(), doMakeControlPacket(NetworkSessionControlMessageType::GetServerSideData, OutboundNetworkPacket(bytes)));
+		doSendToPeer(peers.back(), doMakeControlPacket(NetworkSessionControlMessageType::GetServerSideData, OutboundNetworkPacket::fromSerialized(msg)));
 
 		auto future = result.getFuture();
 		getServerSideDataPending[id] = std::move(result);
@@ -5,12 +5,16 @@ void ControlMsgJoin::serialize(Serializer& s) const
 {
 	s << networkVersion;
 	s << userName;
+	s << engineNetworkVersion;
 }
 
 void ControlMsgJoin::deserialize(Deserializer& s)
 {
 	s >> networkVersion;
 	s >> userName;
+	if (s.getBytesLeft() > 0) {
+		s >> engineNetworkVersion;
+	}
 }
 
 void ControlMsgSetPeerId::serialize(Serializer& s) const
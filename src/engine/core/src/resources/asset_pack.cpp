@@ -1,5 +1,6 @@
 #include "halley/resources/asset_pack.h"
 #include "halley/resources/asset_database.h"
+#include "halley/resources/asset_pack_index.h"
 #include "halley/resources/resource_data.h"
 #include "halley/bytes/byte_serializer.h"
 #include "halley/bytes/compression.h"
@@ -8,14 +9,20 @@
 
 using namespace Halley;
 
-void AssetPackHeader::init(size_t assetDbSize)
+void AssetPackHeader::init(size_t assetDbSize, size_t indexSize)
 {
-	memcpy(identifier.data(), "HALLEYPK", 8);
-	assetDbStartPos = sizeof(AssetPackHeader);
+	// Packs with an index store it uncompressed right after the header, followed by the asset database
+	memcpy(identifier.data(), indexSize > 0 ? "HALLEYPX" : "HALLEYPK", 8);
+	assetDbStartPos = sizeof(AssetPackHeader) + indexSize;
 	dataStartPos = assetDbStartPos + assetDbSize;
 	memset(iv.data(), 0, iv.size());
 }
 
+bool AssetPackHeader::hasIndex() const
+{
+	return memcmp(identifier.data(), "HALLEYPX", 8) == 0;
+}
+
 AssetPack::AssetPack()
 	: assetDb(std::make_unique<AssetDatabase>())
 	, hasReader(false)
@@ -42,14 +49,26 @@ AssetPack::AssetPack(std::unique_ptr<ResourceDataReader> _reader, std::optional<
 	if (nRead != int(sizeof(header))) {
 		throw Exception("Unable to read header", HalleyExceptions::Resources);
 	}
-	if (memcmp(header.identifier.data(), "HALLEYPK", 8) != 0) {
+	if (memcmp(header.identifier.data(), "HALLEYPK", 8) != 0 && !header.hasIndex()) {
 		throw Exception("Asset pack is invalid (invalid identifier)", HalleyExceptions::Resources);
 	}
 	iv = header.iv;
 	dataOffset = size_t(header.dataStartPos);
 
-	// Read asset database
-	{
+	if (header.hasIndex()) {
+		// Read index, the asset database is only deserialized if someone asks for it
+		const size_t indexSize = size_t(header.assetDbStartPos - sizeof(AssetPackHeader));
+		auto indexBytes = Bytes(indexSize);
+		nRead = reader->read(gsl::as_writable_bytes(gsl::span<Byte>(indexBytes)));
+		if (nRead != int(indexBytes.size())) {
+			throw Exception("Unable to read asset pack index", HalleyExceptions::Resources);
+		}
+		index = std::make_unique<AssetPackIndex>(std::move(indexBytes));
+		if (!index->isValid()) {
+			throw Exception("Asset pack is invalid (invalid index)", HalleyExceptions::Resources);
+		}
+	} else {
+		// Read asset database
 		const size_t assetDbSize = size_t(header.dataStartPos - header.assetDbStartPos);
 		auto assetDbBytes = Bytes(assetDbSize);
 		nRead = reader->read(gsl::as_writable_bytes(gsl::span<Byte>(assetDbBytes)));
@@ -85,6 +104,8 @@ AssetPack& AssetPack::operator=(AssetPack&& other) noexcept
 	std::unique_lock<std::mutex> lock(other.readerMutex);
 
 	assetDb = std::move(other.assetDb);
+	index = std::move(other.index);
+	indexMetadata = std::move(other.indexMetadata);
 	dataOffset = other.dataOffset;
 	reader = std::move(other.reader);
 	data = std::move(other.data);
@@ -98,11 +119,15 @@ AssetPack& AssetPack::operator=(AssetPack&& other) noexcept
 
 AssetDatabase& AssetPack::getAssetDatabase()
 {
-	return *assetDb;
+	return const_cast<AssetDatabase&>(static_cast<const AssetPack&>(*this).getAssetDatabase());
 }
 
 const AssetDatabase& AssetPack::getAssetDatabase() const
 {
+	std::unique_lock<std::mutex> lock(assetDbMutex);
+	if (!assetDb) {
+		assetDb = index ? index->makeAssetDatabase() : std::make_unique<AssetDatabase>();
+	}
 	return *assetDb;
 }
 
@@ -118,13 +143,16 @@ const Bytes& AssetPack::getData() const
 
 Bytes AssetPack::writeOut() const
 {
-	auto assetDbBytes = Compression::compress(Serializer::toBytes(*assetDb));
+	const auto& db = getAssetDatabase();
+	const auto indexBytes = AssetPackIndex::build(db);
+	auto assetDbBytes = Compression::compress(Serializer::toBytes(db));
 	AssetPackHeader header;
-	header.init(assetDbBytes.size());
+	header.init(assetDbBytes.size(), indexBytes.size());
 	header.iv = iv;
 
 	auto result = Bytes(size_t(header.dataStartPos + data.size()));
 	memcpy(result.data(), &header, sizeof(AssetPackHeader));
+	memcpy(result.data() + sizeof(AssetPackHeader), indexBytes.data(), indexBytes.size());
 	memcpy(result.data() + header.assetDbStartPos, assetDbBytes.data(), assetDbBytes.size());
 	memcpy(result.data() + header.dataStartPos, data.data(), data.size());
 	return result;
@@ -133,13 +161,24 @@ Bytes AssetPack::writeOut() const
 std::unique_ptr<ResourceData> AssetPack::getData(const String& asset, AssetType type, bool stream)
 {
 	auto path = asset;
-	const auto* assetInfo = assetDb->getDatabase(type).tryGet(asset);
-	if (!assetInfo) {
-		return {};
+	size_t pos;
+	size_t size;
+	if (index) {
+		const auto* entry = index->find(type, asset);
+		if (!entry) {
+			return {};
+		}
+		pos = size_t(entry->dataPos);
+		size = size_t(entry->dataSize);
+	} else {
+		const auto* assetInfo = getAssetDatabase().getDatabase(type).tryGet(asset);
+		if (!assetInfo) {
+			return {};
+		}
+		auto ps = assetInfo->path.split(':');
+		pos = size_t(ps.at(0).toInteger64());
+		size = size_t(ps.at(1).toInteger64());
 	}
-	auto ps = assetInfo->path.split(':');
-	size_t pos = size_t(ps.at(0).toInteger());
-	size_t size = size_t(ps.at(1).toInteger());
 
 	if (stream) {
 		return std::make_unique<ResourceDataStream>(path, [=] () -> std::unique_ptr<ResourceDataReader> {
@@ -166,6 +205,37 @@ std::unique_ptr<ResourceData> AssetPack::getData(const String& asset, AssetType
 	}
 }
 
+const AssetPackIndex* AssetPack::getIndex() const
+{
+	return index.get();
+}
+
+const Metadata* AssetPack::getMetadata(const String& asset, AssetType type) const
+{
+	if (index) {
+		const auto* entry = index->find(type, asset);
+		if (!entry) {
+			return nullptr;
+		}
+
+		// Metadata is deserialized on first access and kept for the lifetime of the pack
+		std::unique_lock<std::mutex> lock(indexMetadataMutex);
+		if (indexMetadata.empty()) {
+			indexMetadata.resize(index->size());
+		}
+		auto& meta = indexMetadata[index->getEntryIndex(*entry)];
+		if (!meta) {
+			meta = std::make_unique<Metadata>();
+			auto s = Deserializer(index->getMetadataBytes(*entry));
+			s >> *meta;
+		}
+		return meta.get();
+	} else {
+		const auto* assetInfo = getAssetDatabase().getDatabase(type).tryGet(asset);
+		return assetInfo ? &assetInfo->meta : nullptr;
+	}
+}
+
 void AssetPack::readToMemory()
 {
 	std::unique_lock<std::mutex> lock(readerMutex);
@@ -223,7 +293,8 @@ std::shared_ptr<bool> AssetPack::getAliveToken() const
 
 size_t AssetPack::getMemoryUsage() const
 {
-	return sizeof(*this) + data.size() + assetDb->getMemoryUsage();
+	std::unique_lock<std::mutex> lock(assetDbMutex);
+	return sizeof(*this) + data.size() + (assetDb ? assetDb->getMemoryUsage() : 0) + (index ? index->getMemoryUsage() : 0);
 }
 
 PackDataReader::PackDataReader(AssetPack& pack, size_t startPos, size_t fileSize)
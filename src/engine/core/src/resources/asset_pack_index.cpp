@@ -0,0 +1,293 @@
+#include "halley/resources/asset_pack_index.h"
+#include "halley/resources/asset_database.h"
+#include "halley/resources/resource.h"
+#include "halley/bytes/byte_serializer.h"
+#include "halley/support/exception.h"
+#include "halley/utils/hash.h"
+#include <algorithm>
+
+using namespace Halley;
+
+namespace {
+	constexpr uint32_t directSlotFlag = 0x80000000u;
+	constexpr uint32_t maxDisplacement = 0x7FFFFFFFu;
+	constexpr size_t keysPerBucket = 4;
+}
+
+AssetPackIndex::AssetPackIndex(Bytes bytes)
+	: data(std::move(bytes))
+{
+	if (data.size() < sizeof(Header)) {
+		return;
+	}
+
+	const auto* h = reinterpret_cast<const Header*>(data.data());
+	if (memcmp(h->identifier.data(), "HPIX", 4) != 0 || h->version != currentVersion || h->totalSize > data.size()) {
+		return;
+	}
+	if (h->bucketsOffset + size_t(h->numBuckets) * sizeof(uint32_t) > h->totalSize
+		|| h->entriesOffset + size_t(h->numEntries) * sizeof(Entry) > h->totalSize
+		|| h->blobOffset > h->totalSize) {
+		return;
+	}
+
+	// From here on the image claims to be a valid index, so anything pointing outside of it is corruption
+	const auto* hEntries = reinterpret_cast<const Entry*>(data.data() + h->entriesOffset);
+	const size_t blobSize = h->totalSize - h->blobOffset;
+	if (h->numEntries > 0 && h->numBuckets == 0) {
+		throw Exception("Corrupt asset pack index: no buckets.", HalleyExceptions::Resources);
+	}
+	for (uint32_t i = 0; i < h->numEntries; ++i) {
+		const auto& entry = hEntries[i];
+		if (size_t(entry.nameOffset) + entry.nameLength > blobSize || size_t(entry.metadataOffset) + entry.metadataSize > blobSize) {
+			throw Exception("Corrupt asset pack index: entry " + toString(i) + " points outside of the blob.", HalleyExceptions::Resources);
+		}
+	}
+
+	header = h;
+	buckets = reinterpret_cast<const uint32_t*>(data.data() + h->bucketsOffset);
+	entries = reinterpret_cast<const Entry*>(data.data() + h->entriesOffset);
+	blob = reinterpret_cast<const char*>(data.data() + h->blobOffset);
+}
+
+Bytes AssetPackIndex::build(const AssetDatabase& db)
+{
+	struct Key {
+		uint64_t hash;
+		AssetType type;
+		const String* name;
+		const AssetDatabase::Entry* entry;
+	};
+
+	// Collect keys
+	Vector<Key> keys;
+	for (const auto type: db.getTypes()) {
+		const auto& assets = db.getDatabase(type).getAssets();
+		keys.reserve(keys.size() + assets.size());
+		for (const auto& [name, entry]: assets) {
+			keys.push_back(Key{ hashKey(type, name), type, &name, &entry });
+		}
+	}
+
+	const auto numKeys = static_cast<uint32_t>(keys.size());
+	const auto numBuckets = static_cast<uint32_t>(std::max(size_t(1), (keys.size() + keysPerBucket - 1) / keysPerBucket));
+
+	// Distribute keys into buckets, and place the largest buckets first
+	Vector<Vector<uint32_t>> bucketKeys(numBuckets);
+	for (uint32_t i = 0; i < numKeys; ++i) {
+		bucketKeys[(keys[i].hash >> 32) % numBuckets].push_back(i);
+	}
+	Vector<uint32_t> bucketOrder(numBuckets);
+	for (uint32_t i = 0; i < numBuckets; ++i) {
+		bucketOrder[i] = i;
+	}
+	std::stable_sort(bucketOrder.begin(), bucketOrder.end(), [&] (uint32_t a, uint32_t b)
+	{
+		return bucketKeys[a].size() > bucketKeys[b].size();
+	});
+
+	Vector<uint32_t> displacements(numBuckets, 0);
+	Vector<uint32_t> keyToSlot(numKeys, 0);
+	Vector<uint8_t> taken(numKeys, 0);
+	Vector<uint32_t> candidate;
+
+	size_t orderIdx = 0;
+	for (; orderIdx < bucketOrder.size(); ++orderIdx) {
+		const auto bucketIdx = bucketOrder[orderIdx];
+		const auto& bucket = bucketKeys[bucketIdx];
+		if (bucket.size() <= 1) {
+			break;
+		}
+
+		bool found = false;
+		for (uint32_t d = 0; d < maxDisplacement && !found; ++d) {
+			candidate.clear();
+			found = true;
+			for (const auto keyIdx: bucket) {
+				const auto slot = getSlot(keys[keyIdx].hash, d, numKeys);
+				if (taken[slot] || std::find(candidate.begin(), candidate.end(), slot) != candidate.end()) {
+					found = false;
+					break;
+				}
+				candidate.push_back(slot);
+			}
+
+			if (found) {
+				displacements[bucketIdx] = d;
+				for (size_t i = 0; i < bucket.size(); ++i) {
+					taken[candidate[i]] = 1;
+					keyToSlot[bucket[i]] = candidate[i];
+				}
+			}
+		}
+
+		if (!found) {
+			throw Exception("Unable to build perfect hash for asset pack index.", HalleyExceptions::Resources);
+		}
+	}
+
+	// Buckets with a single key get assigned one of the remaining slots directly
+	uint32_t nextFree = 0;
+	for (; orderIdx < bucketOrder.size(); ++orderIdx) {
+		const auto bucketIdx = bucketOrder[orderIdx];
+		const auto& bucket = bucketKeys[bucketIdx];
+		if (bucket.empty()) {
+			break;
+		}
+		while (taken[nextFree]) {
+			++nextFree;
+		}
+		taken[nextFree] = 1;
+		keyToSlot[bucket[0]] = nextFree;
+		displacements[bucketIdx] = directSlotFlag | nextFree;
+	}
+
+	// Write string and metadata blob
+	Bytes blobData;
+	auto appendBlob = [&] (gsl::span<const gsl::byte> bytes) -> uint32_t
+	{
+		const auto pos = blobData.size();
+		blobData.resize(pos + bytes.size());
+		memcpy(blobData.data() + pos, bytes.data(), bytes.size());
+		return static_cast<uint32_t>(pos);
+	};
+
+	Vector<Entry> entryData(numKeys);
+	for (uint32_t i = 0; i < numKeys; ++i) {
+		const auto& key = keys[i];
+		const auto location = key.entry->path.split(':');
+		if (location.size() != 2) {
+			throw Exception("Asset \"" + *key.name + "\" has invalid pack location \"" + key.entry->path + "\"", HalleyExceptions::Resources);
+		}
+		const auto metaBytes = Serializer::toBytes(key.entry->meta);
+
+		auto& entry = entryData[keyToSlot[i]];
+		entry.hash = key.hash;
+		entry.dataPos = static_cast<uint64_t>(location[0].toInteger64());
+		entry.dataSize = static_cast<uint64_t>(location[1].toInteger64());
+		entry.nameLength = static_cast<uint32_t>(key.name->size());
+		entry.nameOffset = appendBlob(gsl::as_bytes(gsl::span<const char>(key.name->c_str(), key.name->size())));
+		entry.metadataSize = static_cast<uint32_t>(metaBytes.size());
+		entry.metadataOffset = appendBlob(gsl::as_bytes(gsl::span<const Byte>(metaBytes)));
+		entry.type = static_cast<int32_t>(key.type);
+		entry.padding = 0;
+	}
+
+	// Assemble image
+	Header h;
+	memcpy(h.identifier.data(), "HPIX", 4);
+	h.version = currentVersion;
+	h.numEntries = numKeys;
+	h.numBuckets = numBuckets;
+	h.bucketsOffset = static_cast<uint32_t>(alignUp(sizeof(Header), size_t(8)));
+	h.entriesOffset = static_cast<uint32_t>(alignUp(h.bucketsOffset + numBuckets * sizeof(uint32_t), size_t(8)));
+	h.blobOffset = static_cast<uint32_t>(h.entriesOffset + numKeys * sizeof(Entry));
+	h.totalSize = static_cast<uint32_t>(alignUp(h.blobOffset + blobData.size(), size_t(8)));
+
+	Bytes result(h.totalSize, 0);
+	memcpy(result.data(), &h, sizeof(Header));
+	memcpy(result.data() + h.bucketsOffset, displacements.data(), displacements.size() * sizeof(uint32_t));
+	memcpy(result.data() + h.entriesOffset, entryData.data(), entryData.size() * sizeof(Entry));
+	memcpy(result.data() + h.blobOffset, blobData.data(), blobData.size());
+	return result;
+}
+
+bool AssetPackIndex::isValid() const
+{
+	return header != nullptr;
+}
+
+size_t AssetPackIndex::size() const
+{
+	return header ? header->numEntries : 0;
+}
+
+const AssetPackIndex::Entry* AssetPackIndex::find(AssetType type, std::string_view name) const
+{
+	if (!header || header->numEntries == 0) {
+		return nullptr;
+	}
+
+	const auto hash = hashKey(type, name);
+	const auto displacement = buckets[(hash >> 32) % header->numBuckets];
+	const auto slot = (displacement & directSlotFlag) != 0 ? (displacement & ~directSlotFlag) : getSlot(hash, displacement, header->numEntries);
+	if (slot >= header->numEntries) {
+		return nullptr;
+	}
+
+	const auto& entry = entries[slot];
+	if (entry.hash != hash || entry.type != static_cast<int32_t>(type) || getName(entry) != name) {
+		return nullptr;
+	}
+	return &entry;
+}
+
+const AssetPackIndex::Entry& AssetPackIndex::getEntry(size_t idx) const
+{
+	return entries[idx];
+}
+
+AssetType AssetPackIndex::getType(const Entry& entry) const
+{
+	return static_cast<AssetType>(entry.type);
+}
+
+std::string_view AssetPackIndex::getName(const Entry& entry) const
+{
+	return std::string_view(blob + entry.nameOffset, entry.nameLength);
+}
+
+gsl::span<const gsl::byte> AssetPackIndex::getMetadataBytes(const Entry& entry) const
+{
+	return gsl::as_bytes(gsl::span<const char>(blob + entry.metadataOffset, entry.metadataSize));
+}
+
+size_t AssetPackIndex::getEntryIndex(const Entry& entry) const
+{
+	return static_cast<size_t>(&entry - entries);
+}
+
+Vector<String> AssetPackIndex::enumerate(AssetType type) const
+{
+	Vector<String> result;
+	for (size_t i = 0; i < size(); ++i) {
+		if (entries[i].type == static_cast<int32_t>(type)) {
+			result.push_back(String(getName(entries[i])));
+		}
+	}
+	return result;
+}
+
+std::unique_ptr<AssetDatabase> AssetPackIndex::makeAssetDatabase() const
+{
+	auto db = std::make_unique<AssetDatabase>();
+	for (size_t i = 0; i < size(); ++i) {
+		const auto& entry = entries[i];
+		Metadata meta;
+		auto s = Deserializer(getMetadataBytes(entry));
+		s >> meta;
+		db->addAsset(String(getName(entry)), getType(entry), AssetDatabase::Entry(toString(entry.dataPos) + ":" + toString(entry.dataSize), meta));
+	}
+	return db;
+}
+
+size_t AssetPackIndex::getMemoryUsage() const
+{
+	return sizeof(*this) + data.size();
+}
+
+uint64_t AssetPackIndex::hashKey(AssetType type, std::string_view name)
+{
+	const auto nameHash = Hash::hash(gsl::as_bytes(gsl::span<const char>(name.data(), name.size())));
+	return nameHash ^ ((static_cast<uint64_t>(type) + 1) * 0xC2B2AE3D27D4EB4FULL);
+}
+
+uint32_t AssetPackIndex::getSlot(uint64_t hash, uint32_t displacement, uint32_t numSlots)
+{
+	// splitmix64 finalizer
+	uint64_t z = hash + (static_cast<uint64_t>(displacement) + 1) * 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	z = z ^ (z >> 31);
+	return static_cast<uint32_t>(z % numSlots);
+}
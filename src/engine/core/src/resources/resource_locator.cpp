@@ -7,9 +7,23 @@
 #include "halley/text/string_converter.h"
 #include "halley/resources/resource.h"
 #include "halley/utils/algorithm.h"
+#include "halley/resources/asset_database.h"
+#include "halley/resources/asset_pack_index.h"
+#include "halley/support/profiler.h"
 
 using namespace Halley;
 
+const Metadata* IResourceLocatorProvider::getMetaData(const String& asset, AssetType type)
+{
+	const auto* entry = getAssetDatabase().getDatabase(type).tryGet(asset);
+	return entry ? &entry->meta : nullptr;
+}
+
+Vector<String> IResourceLocatorProvider::enumerate(AssetType type)
+{
+	return getAssetDatabase().enumerate(type);
+}
+
 ResourceLocator::ResourceLocator(SystemAPI& system)
 	: system(system)
 {
@@ -24,6 +38,16 @@ void ResourceLocator::add(std::unique_ptr<IResourceLocatorProvider> locator, con
 
 void ResourceLocator::loadLocatorData(IResourceLocatorProvider& locator)
 {
+	if (locator.getAssetIndex()) {
+		// Indexed locators are queried directly, highest priority first (ties go to whichever was added first, even if it's re-inserted after a purge)
+		const auto iter = std::find_if(indexedLocators.begin(), indexedLocators.end(), [&] (const IResourceLocatorProvider* l)
+		{
+			return l->getPriority() < locator.getPriority() || (l->getPriority() == locator.getPriority() && isAddedBefore(locator, *l));
+		});
+		indexedLocators.insert(iter, &locator);
+		return;
+	}
+
 	auto& db = locator.getAssetDatabase();
 	for (auto& asset: db.getAssets()) {
 		auto result = assetToLocator.find(asset);
@@ -33,12 +57,48 @@ void ResourceLocator::loadLocatorData(IResourceLocatorProvider& locator)
 	}
 }
 
+IResourceLocatorProvider* ResourceLocator::findLocator(const String& asset, AssetType type) const
+{
+	IResourceLocatorProvider* result = nullptr;
+	if (!assetToLocator.empty()) {
+		const auto iter = assetToLocator.find(toString(type) + ":" + asset);
+		if (iter != assetToLocator.end()) {
+			result = iter->second;
+		}
+	}
+
+	// Same precedence as assetToLocator: highest priority wins, ties go to whichever locator was added first
+	for (auto* locator: indexedLocators) {
+		if (result && (locator->getPriority() < result->getPriority() || (locator->getPriority() == result->getPriority() && !isAddedBefore(*locator, *result)))) {
+			break;
+		}
+		const auto* index = locator->getAssetIndex();
+		if (index && index->find(type, asset)) {
+			return locator;
+		}
+	}
+
+	return result;
+}
+
+bool ResourceLocator::isAddedBefore(const IResourceLocatorProvider& a, const IResourceLocatorProvider& b) const
+{
+	for (const auto& locator: locators) {
+		if (locator.get() == &a) {
+			return true;
+		}
+		if (locator.get() == &b) {
+			return false;
+		}
+	}
+	return false;
+}
+
 void ResourceLocator::purge(const String& asset, AssetType type)
 {
-	auto result = assetToLocator.find(toString(type) + ":" + asset);
-	if (result != assetToLocator.end()) {
+	if (auto* locator = findLocator(asset, type)) {
 		// Found the locator for this file, purge it
-		result->second->purgeAll(system);
+		locator->purgeAll(system);
 	} else {
 		// Couldn't find a locator (new file?), purge everything
 		purgeAll();
@@ -48,6 +108,7 @@ void ResourceLocator::purge(const String& asset, AssetType type)
 void ResourceLocator::purgeAll()
 {
 	assetToLocator.clear();
+	indexedLocators.clear();
 	for (auto& locator: locators) {
 		locator->purgeAll(system);
 		loadLocatorData(*locator);
@@ -60,6 +121,7 @@ void ResourceLocator::purgePacks(gsl::span<const String> assetIds, gsl::span<con
 		const bool affected = locator->purgeIfAffected(system, assetIds, packs);
 		if (affected) {
 			std_ex::erase_if_value(assetToLocator, [&] (IResourceLocatorProvider* v) { return v == locator.get(); });
+			std_ex::erase(indexedLocators, locator.get());
 			loadLocatorData(*locator);
 		}
 	}
@@ -67,9 +129,8 @@ void ResourceLocator::purgePacks(gsl::span<const String> assetIds, gsl::span<con
 
 std::unique_ptr<ResourceData> ResourceLocator::getResource(const String& asset, AssetType type, bool stream, bool throwOnFail) const
 {
-	auto result = assetToLocator.find(toString(type) + ":" + asset);
-	if (result != assetToLocator.end()) {
-		auto data = result->second->getData(asset, type, stream);
+	if (auto* locator = findLocator(asset, type)) {
+		auto data = locator->getData(asset, type, stream);
 		if (data) {
 			return data;
 		} else if (throwOnFail) {
@@ -119,7 +180,7 @@ Vector<String> ResourceLocator::enumerate(const AssetType type)
 {
 	Vector<String> result;
 	for (auto& l: locators) {
-		for (auto& r: l->getAssetDatabase().enumerate(type)) {
+		for (auto& r: l->enumerate(type)) {
 			result.push_back(std::move(r));
 		}
 	}
@@ -133,6 +194,7 @@ void ResourceLocator::addFileSystem(const Path& path, IFileSystemCache* cache)
 
 void ResourceLocator::addPack(const Path& path, std::optional<Encrypt::AESKey> encryptionKey, bool preLoad, bool allowFailure, std::optional<int> priority)
 {
+	ProfilerEvent event(ProfilerEventType::ResourcesOpenPack, path.getString());
 	auto dataReader = system.getDataReader(path.string());
 	if (dataReader) {
 		auto resourceLocator = std::make_unique<PackResourceLocator>(std::move(dataReader), path, encryptionKey, preLoad, priority);
@@ -149,25 +211,14 @@ void ResourceLocator::addPack(const Path& path, std::optional<Encrypt::AESKey> e
 void ResourceLocator::removePack(const Path& path)
 {
 	auto* locatorToRemove = locatorPaths.find(path.getString())->second;
-	auto& dbToRemove = locatorToRemove->getAssetDatabase();
-	for (auto& asset : dbToRemove.getAssets()) {
-		auto result = assetToLocator.find(asset);
-		if (result != assetToLocator.end()) {
-			assetToLocator.erase(asset);
-		}
-	}
+	locatorPaths.erase(path.getString());
 	auto locaterIter = std::find_if(locators.begin(), locators.end(), [&](std::unique_ptr<IResourceLocatorProvider>& locator) { return locator.get() == locatorToRemove; });
 	locators.erase(locaterIter);
-	
-	for (const auto& locator : locators)
-	{
-		auto& db = locator->getAssetDatabase();
-		for (auto& asset : db.getAssets()) {
-			auto result = assetToLocator.find(asset);
-			if (result == assetToLocator.end() || result->second->getPriority() < locator->getPriority()) {
-				assetToLocator[asset] = locator.get();
-			}
-		}
+
+	assetToLocator.clear();
+	indexedLocators.clear();
+	for (const auto& locator : locators) {
+		loadLocatorData(*locator);
 	}
 }
 
@@ -186,9 +237,11 @@ Vector<String> ResourceLocator::getAssetsFromPack(const Path& path, std::optiona
 
 const Metadata* ResourceLocator::getMetaData(const String& asset, AssetType type) const
 {
-	auto result = assetToLocator.find(toString(type) + ":" + asset);
-	if (result != assetToLocator.end()) {
-		return &result->second->getAssetDatabase().getDatabase(type).get(asset).meta;
+	if (auto* locator = findLocator(asset, type)) {
+		if (const auto* meta = locator->getMetaData(asset, type)) {
+			return meta;
+		}
+		throw Exception("Asset not found: " + toString(type) + ":" + asset, HalleyExceptions::Resources);
 	} else {
 		return &dummyMetadata;
 	}
@@ -196,12 +249,30 @@ const Metadata* ResourceLocator::getMetaData(const String& asset, AssetType type
 
 bool ResourceLocator::exists(const String& asset, AssetType type)
 {
-	return assetToLocator.find(toString(type) + ":" + asset) != assetToLocator.end();
+	return findLocator(asset, type) != nullptr;
 }
 
 size_t ResourceLocator::getLocatorCount() const
 {
-	return assetToLocator.size();
+	// Assets present in more than one locator only count once
+	size_t count = assetToLocator.size();
+	for (auto iter = indexedLocators.begin(); iter != indexedLocators.end(); ++iter) {
+		const auto* index = (*iter)->getAssetIndex();
+		for (size_t i = 0; index && i < index->size(); ++i) {
+			const auto& entry = index->getEntry(i);
+			const auto type = index->getType(entry);
+			const auto name = index->getName(entry);
+			const bool inPrevious = std::any_of(indexedLocators.begin(), iter, [&] (IResourceLocatorProvider* l)
+			{
+				const auto* other = l->getAssetIndex();
+				return other && other->find(type, name);
+			});
+			if (!inPrevious && (assetToLocator.empty() || !assetToLocator.contains(toString(type) + ":" + String(name)))) {
+				++count;
+			}
+		}
+	}
+	return count;
 }
 
 void ResourceLocator::generateMemoryReport() const
@@ -1,6 +1,7 @@
 #include "resource_pack.h"
 #include <utility>
 #include "halley/resources/asset_pack.h"
+#include "halley/resources/asset_pack_index.h"
 #include "halley/api/system_api.h"
 #include "halley/utils/algorithm.h"
 using namespace Halley;
@@ -34,6 +35,33 @@ const AssetDatabase& PackResourceLocator::getAssetDatabase()
 	return assetPack->getAssetDatabase();
 }
 
+const AssetPackIndex* PackResourceLocator::getAssetIndex()
+{
+	if (!assetPack) {
+		loadAfterPurge();
+	}
+	return assetPack->getIndex();
+}
+
+const Metadata* PackResourceLocator::getMetaData(const String& asset, AssetType type)
+{
+	if (!assetPack) {
+		loadAfterPurge();
+	}
+	return assetPack->getMetadata(asset, type);
+}
+
+Vector<String> PackResourceLocator::enumerate(AssetType type)
+{
+	if (!assetPack) {
+		loadAfterPurge();
+	}
+	if (const auto* index = assetPack->getIndex()) {
+		return index->enumerate(type);
+	}
+	return assetPack->getAssetDatabase().enumerate(type);
+}
+
 void PackResourceLocator::purgeAll(SystemAPI& sys)
 {
 	assetPack.reset();
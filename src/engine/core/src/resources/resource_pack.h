@@ -16,6 +16,9 @@ namespace Halley {
 	protected:
 		std::unique_ptr<ResourceData> getData(const String& asset, AssetType type, bool stream) override;
 		const AssetDatabase& getAssetDatabase() override;
+		const AssetPackIndex* getAssetIndex() override;
+		const Metadata* getMetaData(const String& asset, AssetType type) override;
+		Vector<String> enumerate(AssetType type) override;
 		void purgeAll(SystemAPI& system) override;
 		bool purgeIfAffected(SystemAPI& system, gsl::span<const String> assetIds, gsl::span<const String> packIds) override;
 		int getPriority() const override;
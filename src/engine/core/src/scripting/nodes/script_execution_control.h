@@ -8,6 +8,7 @@ namespace Halley {
 		String getName() const override { return "Start"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/start.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Terminator; }
+		bool isEntityLocal(const ScriptGraphNode& node) const override { return true; }
 		bool canAdd() const override { return false; }
 		bool canDelete() const override { return false; }
 
@@ -10,6 +10,7 @@ namespace Halley {
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/logic_gate_and.png"; }
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool isEntityLocal(const ScriptGraphNode& node) const override { return true; }
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
@@ -23,6 +24,7 @@ namespace Halley {
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/logic_gate_or.png"; }
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool isEntityLocal(const ScriptGraphNode& node) const override { return true; }
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
@@ -36,6 +38,7 @@ namespace Halley {
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/logic_gate_xor.png"; }
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool isEntityLocal(const ScriptGraphNode& node) const override { return true; }
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
@@ -49,6 +52,7 @@ namespace Halley {
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/logic_gate_not.png"; }
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool isEntityLocal(const ScriptGraphNode& node) const override { return true; }
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
@@ -17,6 +17,7 @@ namespace Halley {
 		String getName() const override { return "For Loop"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/loop.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::FlowControl; }
+		bool isEntityLocal(const ScriptGraphNode& node) const override { return true; }
 
 		String getLabel(const BaseGraphNode& node) const override;
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
@@ -39,6 +40,7 @@ namespace Halley {
 		String getName() const override { return "While Loop"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/loop.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::FlowControl; }
+		bool isEntityLocal(const ScriptGraphNode& node) const override { return true; }
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 		String getPinDescription(const BaseGraphNode& node, PinType elementType, GraphPinId elementIdx) const override;
@@ -129,6 +131,7 @@ namespace Halley {
 		String getName() const override { return "Every Frame"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/every_frame.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::FlowControl; }
+		bool isEntityLocal(const ScriptGraphNode& node) const override { return true; }
 		bool canKeepData() const override;
 
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
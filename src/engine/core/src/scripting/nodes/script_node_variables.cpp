@@ -46,16 +46,31 @@ std::pair<String, Vector<ColourOverride>> ScriptVariable::getNodeDescription(con
 	return str.moveResults();
 }
 
+void ScriptVariable::compile(const ScriptGraphNode& node, ScriptGraphNode::Compiled& compiled) const
+{
+	compiled.variable = Atom(node.getSettings()["variable"].asStringView(""));
+	compiled.mode = static_cast<int>(fromString<ScriptVariableScope>(node.getSettings()["scope"].asString("local")));
+}
+
+bool ScriptVariable::lower(const ScriptGraphNode& node, GraphPinId outputPin, ScriptProgram::Builder& builder) const
+{
+	if (outputPin != 1) {
+		return false;
+	}
+	builder.emitVariable(node.getCompiled().variable, getScope(node));
+	return true;
+}
+
 ConfigNode ScriptVariable::doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const
 {
 	const auto& vars = environment.getVariables(getScope(node));
-	return ConfigNode(vars.getVariable(node.getSettings()["variable"].asString("")));
+	return ConfigNode(vars.getVariable(node.getCompiled().variable));
 }
 
 EntityId ScriptVariable::doGetEntityId(ScriptEnvironment& environment, const ScriptGraphNode& node, GraphPinId pinN) const
 {
 	const auto& vars = environment.getVariables(getScope(node));
-	const auto& data = vars.getVariable(node.getSettings()["variable"].asString(""));
+	const auto& data = vars.getVariable(node.getCompiled().variable);
 	if (data.getType() == ConfigNodeType::EntityId || data.getType() == ConfigNodeType::Int || data.getType() == ConfigNodeType::Float) {
 		return data.asEntityId();
 	} else {
@@ -66,10 +81,10 @@ EntityId ScriptVariable::doGetEntityId(ScriptEnvironment& environment, const Scr
 void ScriptVariable::doSetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, ConfigNode data) const
 {
 	const auto scope = getScope(node);
-	const auto variable = node.getSettings()["variable"].asString("");
+	const auto& variable = node.getCompiled().variable;
 
 	if (scope != ScriptVariableScope::Local && !environment.hasNetworkAuthorityOver(environment.getCurrentEntityId())) {
-		Logger::logError(environment.getCurrentGraph()->getAssetId() + ": Cannot write to Script/Entity Variable \"" + variable + "\", not owned by this client");
+		Logger::logError(environment.getCurrentGraph()->getAssetId() + ": Cannot write to Script/Entity Variable \"" + variable.getString() + "\", not owned by this client");
 		return;
 	}
 
@@ -84,7 +99,7 @@ ConfigNode ScriptVariable::doGetDevConData(ScriptEnvironment& environment, const
 
 ScriptVariableScope ScriptVariable::getScope(const ScriptGraphNode& node) const
 {
-	return fromString<ScriptVariableScope>(node.getSettings()["scope"].asString("local"));
+	return static_cast<ScriptVariableScope>(node.getCompiled().mode);
 }
 
 
@@ -129,16 +144,21 @@ std::pair<String, Vector<ColourOverride>> ScriptEntityVariable::getNodeDescripti
 	return str.moveResults();
 }
 
+void ScriptEntityVariable::compile(const ScriptGraphNode& node, ScriptGraphNode::Compiled& compiled) const
+{
+	compiled.variable = Atom(node.getSettings()["variable"].asStringView(""));
+}
+
 ConfigNode ScriptEntityVariable::doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const
 {
 	const auto& vars = environment.getEntityVariables(readEntityId(environment, node, 0));
-	return ConfigNode(vars.getVariable(node.getSettings()["variable"].asString("")));
+	return ConfigNode(vars.getVariable(node.getCompiled().variable));
 }
 
 EntityId ScriptEntityVariable::doGetEntityId(ScriptEnvironment& environment, const ScriptGraphNode& node, GraphPinId pinN) const
 {
 	const auto& vars = environment.getEntityVariables(readEntityId(environment, node, 0));
-	return vars.getVariable(node.getSettings()["variable"].asString("")).asEntityId({});
+	return vars.getVariable(node.getCompiled().variable).asEntityId({});
 }
 
 ConfigNode ScriptEntityVariable::doGetDevConData(ScriptEnvironment& environment, const ScriptGraphNode& node) const
@@ -152,10 +172,10 @@ void ScriptEntityVariable::doSetData(ScriptEnvironment& environment, const Scrip
 	auto e = environment.tryGetEntity(readEntityId(environment, node, 0));
 	if (e.isValid()) {
 		if (!environment.hasNetworkAuthorityOver(e)) {
-			Logger::logError(environment.getCurrentGraph()->getAssetId() + ": Cannot write to Entity Variable \"" + node.getSettings()["variable"].asString("") + "\", not owned by this client");
+			Logger::logError(environment.getCurrentGraph()->getAssetId() + ": Cannot write to Entity Variable \"" + node.getCompiled().variable.getString() + "\", not owned by this client");
 			return;
 		}
-		environment.setEntityVariable(e.getEntityId(), node.getSettings()["variable"].asString(""), std::move(data));
+		environment.setEntityVariable(e.getEntityId(), node.getCompiled().variable, std::move(data));
 	}
 }
 
@@ -219,9 +239,20 @@ std::pair<String, Vector<ColourOverride>> ScriptLiteral::getNodeDescription(cons
 	return str.moveResults();
 }
 
+void ScriptLiteral::compile(const ScriptGraphNode& node, ScriptGraphNode::Compiled& compiled) const
+{
+	compiled.constant = getConfigNode(node);
+}
+
+bool ScriptLiteral::lower(const ScriptGraphNode& node, GraphPinId outputPin, ScriptProgram::Builder& builder) const
+{
+	builder.emitConstant(ConfigNode(node.getCompiled().constant));
+	return true;
+}
+
 ConfigNode ScriptLiteral::doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const
 {
-	return getConfigNode(node);
+	return ConfigNode(node.getCompiled().constant);
 }
 
 ConfigNode ScriptLiteral::getConfigNode(const BaseGraphNode& node) const
@@ -431,9 +462,20 @@ std::pair<String, Vector<ColourOverride>> ScriptColourLiteral::getNodeDescriptio
 	return str.moveResults();
 }
 
+void ScriptColourLiteral::compile(const ScriptGraphNode& node, ScriptGraphNode::Compiled& compiled) const
+{
+	compiled.constant = ConfigNode(node.getSettings()["value"].asString("#FFFFFF"));
+}
+
+bool ScriptColourLiteral::lower(const ScriptGraphNode& node, GraphPinId outputPin, ScriptProgram::Builder& builder) const
+{
+	builder.emitConstant(ConfigNode(node.getCompiled().constant));
+	return true;
+}
+
 ConfigNode ScriptColourLiteral::doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const
 {
-	return ConfigNode(node.getSettings()["value"].asString("#FFFFFF"));
+	return ConfigNode(node.getCompiled().constant);
 }
 
 
@@ -476,11 +518,24 @@ std::pair<String, Vector<ColourOverride>> ScriptComparison::getNodeDescription(c
 	return str.moveResults();
 }
 
+void ScriptComparison::compile(const ScriptGraphNode& node, ScriptGraphNode::Compiled& compiled) const
+{
+	compiled.mode = static_cast<int>(fromString<MathRelOp>(node.getSettings()["operator"].asString("==")));
+}
+
+bool ScriptComparison::lower(const ScriptGraphNode& node, GraphPinId outputPin, ScriptProgram::Builder& builder) const
+{
+	builder.emitInput(node, 0);
+	builder.emitInput(node, 1);
+	builder.emitComparison(static_cast<MathRelOp>(node.getCompiled().mode));
+	return true;
+}
+
 ConfigNode ScriptComparison::doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const
 {
 	const auto a = readDataPin(environment, node, 0);
 	const auto b = readDataPin(environment, node, 1);
-	const auto op = fromString<MathRelOp>(node.getSettings()["operator"].asString("=="));
+	const auto op = static_cast<MathRelOp>(node.getCompiled().mode);
 	return ConfigNode(a.compareTo(op, b));
 }
 
@@ -530,12 +585,28 @@ std::pair<String, Vector<ColourOverride>> ScriptArithmetic::getNodeDescription(c
 	return str.moveResults();
 }
 
+void ScriptArithmetic::compile(const ScriptGraphNode& node, ScriptGraphNode::Compiled& compiled) const
+{
+	compiled.mode = static_cast<int>(fromString<MathOp>(node.getSettings()["operator"].asString("+")));
+}
+
+bool ScriptArithmetic::lower(const ScriptGraphNode& node, GraphPinId outputPin, ScriptProgram::Builder& builder) const
+{
+	builder.emitInput(node, 0);
+	builder.emitInput(node, 1);
+	builder.emitArithmetic(static_cast<MathOp>(node.getCompiled().mode));
+	return true;
+}
+
 ConfigNode ScriptArithmetic::doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pin_n) const
 {
 	const auto a = readDataPin(environment, node, 0);
 	const auto b = readDataPin(environment, node, 1);
-	const auto op = fromString<MathOp>(node.getSettings()["operator"].asString("+"));
+	return apply(a, b, static_cast<MathOp>(node.getCompiled().mode));
+}
 
+ConfigNode ScriptArithmetic::apply(const ConfigNode& a, const ConfigNode& b, MathOp op)
+{
 	const auto type = ConfigNode::getPromotedType(std::array<ConfigNodeType, 2>{ a.getType(), b.getType() }, true);
 
 	if (type == ConfigNodeType::String) {
@@ -8,6 +8,7 @@ namespace Halley {
 		String getName() const override { return "Variable"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/variable.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Variable; }
+		bool isEntityLocal(const ScriptGraphNode& node) const override { return true; }
 
 		String getLargeLabel(const BaseGraphNode& node) const override;
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
@@ -15,6 +16,8 @@ namespace Halley {
 		Vector<SettingType> getSettingTypes() const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
+		void compile(const ScriptGraphNode& node, ScriptGraphNode::Compiled& compiled) const override;
+		bool lower(const ScriptGraphNode& node, GraphPinId outputPin, ScriptProgram::Builder& builder) const override;
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
 		EntityId doGetEntityId(ScriptEnvironment& environment, const ScriptGraphNode& node, GraphPinId pinN) const override;
 		void doSetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, ConfigNode data) const override;
@@ -37,6 +40,7 @@ namespace Halley {
 		Vector<SettingType> getSettingTypes() const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
+		void compile(const ScriptGraphNode& node, ScriptGraphNode::Compiled& compiled) const override;
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
 		EntityId doGetEntityId(ScriptEnvironment& environment, const ScriptGraphNode& node, GraphPinId pinN) const override;
 		ConfigNode doGetDevConData(ScriptEnvironment& environment, const ScriptGraphNode& node) const override;
@@ -53,8 +57,11 @@ namespace Halley {
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		Vector<SettingType> getSettingTypes() const override;
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Variable; }
+		bool isEntityLocal(const ScriptGraphNode& node) const override { return true; }
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
+		void compile(const ScriptGraphNode& node, ScriptGraphNode::Compiled& compiled) const override;
+		bool lower(const ScriptGraphNode& node, GraphPinId outputPin, ScriptProgram::Builder& builder) const override;
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
 
 	private:
@@ -106,8 +113,11 @@ namespace Halley {
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		Vector<SettingType> getSettingTypes() const override;
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Variable; }
+		bool isEntityLocal(const ScriptGraphNode& node) const override { return true; }
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
+		void compile(const ScriptGraphNode& node, ScriptGraphNode::Compiled& compiled) const override;
+		bool lower(const ScriptGraphNode& node, GraphPinId outputPin, ScriptProgram::Builder& builder) const override;
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
 	};
 
@@ -117,6 +127,7 @@ namespace Halley {
 		String getName() const override { return "Comparison"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/comparison.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool isEntityLocal(const ScriptGraphNode& node) const override { return true; }
 		
 		String getLargeLabel(const BaseGraphNode& node) const override;
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
@@ -124,6 +135,8 @@ namespace Halley {
 		Vector<SettingType> getSettingTypes() const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
+		void compile(const ScriptGraphNode& node, ScriptGraphNode::Compiled& compiled) const override;
+		bool lower(const ScriptGraphNode& node, GraphPinId outputPin, ScriptProgram::Builder& builder) const override;
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
 	};
 	
@@ -133,6 +146,7 @@ namespace Halley {
 		String getName() const override { return "Arithmetic"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/arithmetic.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool isEntityLocal(const ScriptGraphNode& node) const override { return true; }
 
 		String getLargeLabel(const BaseGraphNode& node) const override;
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
@@ -140,7 +154,11 @@ namespace Halley {
 		Vector<SettingType> getSettingTypes() const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
+		void compile(const ScriptGraphNode& node, ScriptGraphNode::Compiled& compiled) const override;
+		bool lower(const ScriptGraphNode& node, GraphPinId outputPin, ScriptProgram::Builder& builder) const override;
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
+
+		static ConfigNode apply(const ConfigNode& a, const ConfigNode& b, MathOp op);
 	};
 	
 	class ScriptValueOr final : public ScriptNodeTypeBase<void> {
@@ -149,6 +167,7 @@ namespace Halley {
 		String getName() const override { return "Value Or"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/value_or.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool isEntityLocal(const ScriptGraphNode& node) const override { return true; }
 
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
@@ -163,6 +182,7 @@ namespace Halley {
 		String getName() const override { return "Conditional Operator"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/value_or.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool isEntityLocal(const ScriptGraphNode& node) const override { return true; }
 
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
@@ -177,6 +197,7 @@ namespace Halley {
 		String getName() const override { return "Lerp"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/lerp.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool isEntityLocal(const ScriptGraphNode& node) const override { return true; }
 
 		Vector<SettingType> getSettingTypes() const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
@@ -209,6 +230,7 @@ namespace Halley {
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/set_variable.png"; }
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Action; }
+		bool isEntityLocal(const ScriptGraphNode& node) const override { return true; }
 		Vector<SettingType> getSettingTypes() const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
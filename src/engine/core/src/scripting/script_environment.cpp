@@ -43,7 +43,11 @@ void ScriptEnvironment::update(Time time, ScriptState& graphState, EntityId curE
 		throw Exception("Unable to update script state, script not set.", HalleyExceptions::Entity);
 	}
 
-	ProfilerEvent event(ProfilerEventType::ScriptUpdate, currentGraph->getAssetId());
+	// The profiler capture isn't thread-safe, so workers are profiled as a whole by whoever runs them
+	std::optional<ProfilerEvent> event;
+	if (!isWorker) {
+		event.emplace(ProfilerEventType::ScriptUpdate, currentGraph->getAssetId());
+	}
 
 	currentState = &graphState;
 	currentEntityVariables = &entityVariables;
@@ -113,6 +117,32 @@ void ScriptEnvironment::update(Time time, ScriptState& graphState, EntityId curE
 	currentEntity = EntityId();
 }
 
+std::unique_ptr<ScriptEnvironment> ScriptEnvironment::makeWorker() const
+{
+	return std::make_unique<ScriptEnvironment>(api, world, resources, nodeTypeCollection, isHost);
+}
+
+void ScriptEnvironment::prepareWorker(ScriptEnvironment& worker) const
+{
+	worker.isWorker = true;
+	worker.isHost = isHost;
+	worker.inputEnabled = inputEnabled;
+	worker.compiledExpressionsEnabled = compiledExpressionsEnabled;
+	worker.scriptTargetRetriever = scriptTargetRetriever;
+	worker.variableTable = variableTable;
+}
+
+void ScriptEnvironment::mergeWorker(ScriptEnvironment& worker)
+{
+	auto append = [] (auto& dst, auto src)
+	{
+		dst.insert(dst.end(), std::make_move_iterator(src.begin()), std::make_move_iterator(src.end()));
+	};
+	append(scriptOutbox, worker.getOutboundScriptMessages());
+	append(entityOutbox, worker.getOutboundEntityMessages());
+	append(scriptExecutionRequestOutbox, worker.getScriptExecutionRequests());
+}
+
 bool ScriptEnvironment::updateThread(ScriptState& graphState, ScriptStateThread& thread, Vector<ScriptStateThread>& pendingThreads)
 {
 	currentThread = &thread;
@@ -830,6 +860,11 @@ void ScriptEnvironment::assignTypes(const ScriptGraph& graph)
 	graph.assignTypes(*nodeTypeCollection);
 }
 
+void ScriptEnvironment::setCompiledExpressionsEnabled(bool enabled)
+{
+	compiledExpressionsEnabled = enabled;
+}
+
 ConfigNode ScriptEnvironment::readInputDataPin(const ScriptGraphNode& node, GraphPinId pinN)
 {
 	const auto& pins = node.getPins();
@@ -844,6 +879,13 @@ ConfigNode ScriptEnvironment::readInputDataPin(const ScriptGraphNode& node, Grap
 	assert(pin.connections.size() == 1);
 
 	const auto& dst = pin.connections[0];
+	if (compiledExpressionsEnabled) {
+		const auto& program = currentGraph->getProgram();
+		if (const auto expression = program.getExpression(dst.dstNode.value(), dst.dstPin); expression >= 0) {
+			return program.evaluate(expression, *this);
+		}
+	}
+
 	const auto& nodes = currentGraph->getNodes();
 	const auto& dstNode = nodes[dst.dstNode.value()];
 	return dstNode.getNodeType().getData(*this, dstNode, dst.dstPin, getNodeData(dst.dstNode.value()));
@@ -851,6 +893,13 @@ ConfigNode ScriptEnvironment::readInputDataPin(const ScriptGraphNode& node, Grap
 
 ConfigNode ScriptEnvironment::readOutputDataPin(const ScriptGraphNode& node, GraphPinId pinN)
 {
+	if (compiledExpressionsEnabled) {
+		const auto& program = currentGraph->getProgram();
+		if (const auto expression = program.getExpression(node.getId(), pinN); expression >= 0) {
+			return program.evaluate(expression, *this);
+		}
+	}
+
 	return node.getNodeType().getData(*this, node, pinN, getNodeData(node.getId()));
 }
 
@@ -934,7 +983,7 @@ const ScriptVariables& ScriptEnvironment::getEntityVariables(EntityId entityId)
 	return dummy;
 }
 
-void ScriptEnvironment::setEntityVariable(EntityId entityId, const String& name, ConfigNode value) const
+void ScriptEnvironment::setEntityVariable(EntityId entityId, const Atom& name, ConfigNode value) const
 {
 	auto entity = tryGetEntity(entityId);
 	if (entity.isValid()) {
@@ -135,11 +135,23 @@ void ScriptGraphNode::assignType(const GraphNodeTypeCollection& nodeTypeCollecti
 {
 	nodeType = dynamic_cast<const IScriptNodeType*>(nodeTypeCollection.tryGetGraphNodeType(type));
 	Ensures(nodeType != nullptr);
+
+	compiled = Compiled();
+	const auto& pinConfig = nodeType->getPinConfiguration(*this);
+	for (size_t i = 0; i < pinConfig.size() && compiled.nFlowOutputs < compiled.flowOutputPins.size(); ++i) {
+		if (pinConfig[i].type == GraphElementType(ScriptNodeElementType::FlowPin) && pinConfig[i].direction == GraphNodePinDirection::Output) {
+			compiled.flowOutputPins[compiled.nFlowOutputs++] = static_cast<GraphPinId>(i);
+		}
+	}
+	nodeType->compile(*this, compiled);
+	compiled.entityLocal = nodeType->isEntityLocal(*this);
+	compiled.valid = true;
 }
 
 void ScriptGraphNode::clearType() const
 {
 	nodeType = nullptr;
+	compiled = Compiled();
 }
 
 const IGraphNodeType& ScriptGraphNode::getGraphNodeType() const
@@ -506,6 +518,26 @@ const ScriptGraph* ScriptGraph::getPreviousVersion(uint64_t hash) const
 	return previousVersion.get();
 }
 
+bool ScriptGraph::isEntityLocal(const ScriptNodeTypeCollection& nodeTypeCollection) const
+{
+	if (entityLocalHash != hash) {
+		assignTypes(nodeTypeCollection);
+		entityLocal = std::all_of(nodes.begin(), nodes.end(), [] (const ScriptGraphNode& node) { return node.getCompiled().entityLocal; });
+		entityLocalHash = hash;
+	}
+	return entityLocal;
+}
+
+const ScriptProgram& ScriptGraph::getProgram() const
+{
+	return program;
+}
+
+void ScriptGraph::onTypesAssigned() const
+{
+	program.compile(*this);
+}
+
 ConfigNode& ScriptGraph::getProperties()
 {
 	return properties;
@@ -151,6 +151,22 @@ std::array<IScriptNodeType::OutputNode, 8> IScriptNodeType::getOutputNodes(const
 {
 	std::array<OutputNode, 8> result;
 	result.fill({});
+
+	const auto& compiled = node.getCompiled();
+	if (compiled.valid) {
+		size_t nOutputsFound = 0;
+		for (size_t i = 0; i < compiled.nFlowOutputs; ++i) {
+			if ((outputActiveMask & (1 << i)) != 0) {
+				const auto pinIdx = compiled.flowOutputPins[i];
+				for (auto& conn: node.getPin(pinIdx).connections) {
+					if (conn.dstNode) {
+						result[nOutputsFound++] = OutputNode{ conn.dstNode, pinIdx, conn.dstPin };
+					}
+				}
+			}
+		}
+		return result;
+	}
 	
 	const auto& pinConfig = getPinConfiguration(node);
 
@@ -177,6 +193,11 @@ std::array<IScriptNodeType::OutputNode, 8> IScriptNodeType::getOutputNodes(const
 
 GraphPinId IScriptNodeType::getNthOutputPinIdx(const ScriptGraphNode& node, size_t n) const
 {
+	const auto& compiled = node.getCompiled();
+	if (compiled.valid && n < compiled.nFlowOutputs) {
+		return compiled.flowOutputPins[n];
+	}
+
 	const auto& pinConfig = getPinConfiguration(node);
 	size_t curOutputPin = 0;
 	for (size_t i = 0; i < pinConfig.size(); ++i) {
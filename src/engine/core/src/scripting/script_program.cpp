@@ -0,0 +1,300 @@
+#include "halley/scripting/script_program.h"
+
+#include "halley/scripting/script_environment.h"
+#include "halley/scripting/script_graph.h"
+#include "halley/scripting/script_node_type.h"
+#include "nodes/script_node_variables.h"
+using namespace Halley;
+
+namespace {
+	constexpr size_t maxInputDepth = 32;
+
+	bool canFoldArithmetic(const ConfigNode& a, const ConfigNode& b, MathOp op)
+	{
+		// Only fold what can't fail, so any errors are still reported at runtime, where they used to be
+		switch (ConfigNode::getPromotedType(std::array<ConfigNodeType, 2>{ a.getType(), b.getType() }, true)) {
+		case ConfigNodeType::Float:
+		case ConfigNodeType::Float2:
+			return true;
+		case ConfigNodeType::Int:
+		case ConfigNodeType::Int64:
+			return op != MathOp::Divide || b.asInt64(0) != 0;
+		case ConfigNodeType::Int2:
+			return op != MathOp::Divide || (b.asVector2i({}).x != 0 && b.asVector2i({}).y != 0);
+		default:
+			return false;
+		}
+	}
+}
+
+ScriptProgram::Builder::Builder(const ScriptGraph& graph, ScriptProgram& program)
+	: graph(graph)
+	, program(program)
+{
+}
+
+bool ScriptProgram::Builder::lowerOutput(const ScriptGraphNode& node, GraphPinId outputPin)
+{
+	const auto checkpoint = makeCheckpoint();
+	firstSlot = program.slots.size();
+	stackSize = 0;
+	depth = 0;
+	failed = false;
+
+	if (!node.getNodeType().lower(node, outputPin, *this) || failed) {
+		restore(checkpoint);
+		return false;
+	}
+	assert(stackSize == 1);
+	return true;
+}
+
+void ScriptProgram::Builder::emitInput(const ScriptGraphNode& node, GraphPinId inputPin)
+{
+	const auto& pins = node.getPins();
+	if (inputPin >= pins.size() || pins[inputPin].connections.empty() || !pins[inputPin].connections[0].dstNode) {
+		emitConstant(ConfigNode());
+		return;
+	}
+
+	const auto& dst = pins[inputPin].connections[0];
+	const auto dstNodeId = dst.dstNode.value();
+	const auto& dstNode = graph.getNodes()[dstNodeId];
+
+	if (depth < maxInputDepth) {
+		const auto checkpoint = makeCheckpoint();
+		const bool wasFailed = failed;
+		++depth;
+		const bool lowered = dstNode.getNodeType().lower(dstNode, dst.dstPin, *this) && !failed;
+		--depth;
+		if (lowered) {
+			return;
+		}
+		restore(checkpoint);
+		failed = wasFailed;
+	}
+
+	emitReadPin(dstNodeId, dst.dstPin);
+}
+
+void ScriptProgram::Builder::emitConstant(ConfigNode value)
+{
+	push(Instruction{ OpCode::PushConstant, 0, 0, static_cast<uint32_t>(program.constants.size()) }, 1);
+	program.constants.push_back(std::move(value));
+}
+
+void ScriptProgram::Builder::emitVariable(Atom name, ScriptVariableScope scope)
+{
+	size_t slot = firstSlot;
+	while (slot < program.slots.size() && (program.slots[slot].name != name || program.slots[slot].scope != scope)) {
+		++slot;
+	}
+	if (slot == program.slots.size()) {
+		if (slot - firstSlot >= maxSlots) {
+			failed = true;
+			return;
+		}
+		program.slots.push_back(VariableSlot{ name, scope });
+	}
+
+	push(Instruction{ OpCode::LoadVariable, 0, 0, static_cast<uint32_t>(slot - firstSlot) }, 1);
+}
+
+void ScriptProgram::Builder::emitArithmetic(MathOp op)
+{
+	if (lastInstructionsAreConstants(2)) {
+		const auto& a = program.constants[program.constants.size() - 2];
+		const auto& b = program.constants[program.constants.size() - 1];
+		if (canFoldArithmetic(a, b, op)) {
+			auto result = ScriptArithmetic::apply(a, b, op);
+			popConstant();
+			popConstant();
+			emitConstant(std::move(result));
+			return;
+		}
+	}
+
+	push(Instruction{ OpCode::Arithmetic, static_cast<uint8_t>(op) }, -1);
+}
+
+void ScriptProgram::Builder::emitComparison(MathRelOp op)
+{
+	if (lastInstructionsAreConstants(2)) {
+		const auto& a = program.constants[program.constants.size() - 2];
+		const auto& b = program.constants[program.constants.size() - 1];
+		auto result = ConfigNode(a.compareTo(op, b));
+		popConstant();
+		popConstant();
+		emitConstant(std::move(result));
+		return;
+	}
+
+	push(Instruction{ OpCode::Compare, static_cast<uint8_t>(op) }, -1);
+}
+
+ScriptProgram::Builder::Checkpoint ScriptProgram::Builder::makeCheckpoint() const
+{
+	return Checkpoint{ program.instructions.size(), program.constants.size(), program.slots.size(), stackSize };
+}
+
+void ScriptProgram::Builder::restore(const Checkpoint& checkpoint)
+{
+	program.instructions.resize(checkpoint.nInstructions);
+	program.constants.resize(checkpoint.nConstants);
+	program.slots.resize(checkpoint.nSlots);
+	stackSize = checkpoint.stackSize;
+}
+
+void ScriptProgram::Builder::emitReadPin(GraphNodeId nodeId, GraphPinId outputPin)
+{
+	push(Instruction{ OpCode::ReadPin, 0, outputPin, nodeId }, 1);
+}
+
+void ScriptProgram::Builder::push(Instruction instruction, int stackDelta)
+{
+	program.instructions.push_back(instruction);
+	stackSize = static_cast<size_t>(static_cast<int>(stackSize) + stackDelta);
+	if (stackSize > maxStackSize) {
+		failed = true;
+	}
+}
+
+bool ScriptProgram::Builder::lastInstructionsAreConstants(size_t n) const
+{
+	// Each operand leaves exactly one value on the stack, so if the last n instructions are constants, they are the last n operands
+	const auto& instrs = program.instructions;
+	if (instrs.size() < n) {
+		return false;
+	}
+	return std::all_of(instrs.end() - n, instrs.end(), [] (const Instruction& i) { return i.op == OpCode::PushConstant; });
+}
+
+ConfigNode ScriptProgram::Builder::popConstant()
+{
+	// Constants are appended in the same order as the instructions pushing them, so the last one is always at the back
+	assert(program.instructions.back().op == OpCode::PushConstant && program.instructions.back().arg == program.constants.size() - 1);
+	program.instructions.pop_back();
+	auto value = std::move(program.constants.back());
+	program.constants.pop_back();
+	--stackSize;
+	return value;
+}
+
+
+void ScriptProgram::compile(const ScriptGraph& graph)
+{
+	clear();
+
+	const auto& nodes = graph.getNodes();
+	nodeExpressions.resize(nodes.size(), -1);
+
+	Builder builder(graph, *this);
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		const auto& node = nodes[i];
+		const auto& pinConfig = node.getNodeType().getPinConfiguration(node);
+		for (size_t j = 0; j < pinConfig.size(); ++j) {
+			if (pinConfig[j].type != GraphElementType(ScriptNodeElementType::ReadDataPin) || pinConfig[j].direction != GraphNodePinDirection::Output) {
+				continue;
+			}
+
+			const auto start = instructions.size();
+			const auto firstSlot = slots.size();
+			if (builder.lowerOutput(node, static_cast<GraphPinId>(j))) {
+				if (nodeExpressions[i] == -1) {
+					nodeExpressions[i] = static_cast<int>(expressions.size());
+				}
+				expressions.push_back(Expression{ static_cast<GraphNodeId>(i), static_cast<GraphPinId>(j),
+					static_cast<uint32_t>(start), static_cast<uint32_t>(instructions.size() - start),
+					static_cast<uint32_t>(firstSlot), static_cast<uint32_t>(slots.size() - firstSlot) });
+			}
+		}
+	}
+}
+
+void ScriptProgram::clear()
+{
+	instructions.clear();
+	constants.clear();
+	slots.clear();
+	expressions.clear();
+	nodeExpressions.clear();
+}
+
+int ScriptProgram::getExpression(GraphNodeId nodeId, GraphPinId outputPin) const
+{
+	if (nodeId >= nodeExpressions.size()) {
+		return -1;
+	}
+	for (int i = nodeExpressions[nodeId]; i >= 0 && i < static_cast<int>(expressions.size()) && expressions[i].node == nodeId; ++i) {
+		if (expressions[i].outputPin == outputPin) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+ConfigNode ScriptProgram::evaluate(int expression, ScriptEnvironment& environment) const
+{
+	const auto& expr = expressions[expression];
+	const auto* exprSlots = slots.data() + expr.firstSlot;
+
+	// Slots are bound to the variables they name on first use, and stay bound for the rest of this evaluation
+	std::array<const ConfigNode*, maxSlots> boundSlots = {};
+	std::array<ConfigNode, maxStackSize> stack;
+	size_t top = 0;
+
+	for (const auto& instruction: getInstructions(expression)) {
+		switch (instruction.op) {
+		case OpCode::PushConstant:
+			stack[top++] = constants[instruction.arg];
+			break;
+
+		case OpCode::LoadVariable:
+			{
+				auto& bound = boundSlots[instruction.arg];
+				if (!bound) {
+					const auto& slot = exprSlots[instruction.arg];
+					bound = &environment.getVariables(slot.scope).getVariable(slot.name);
+				}
+				stack[top++] = *bound;
+			}
+			break;
+
+		case OpCode::ReadPin:
+			{
+				const auto nodeId = static_cast<GraphNodeId>(instruction.arg);
+				const auto& node = environment.getCurrentGraph()->getNodes()[nodeId];
+				stack[top++] = node.getNodeType().getData(environment, node, instruction.pin, environment.getNodeData(nodeId));
+
+				// The node might have written to a variable, so bindings might no longer be valid
+				boundSlots = {};
+			}
+			break;
+
+		case OpCode::Arithmetic:
+			--top;
+			stack[top - 1] = ScriptArithmetic::apply(stack[top - 1], stack[top], static_cast<MathOp>(instruction.mode));
+			break;
+
+		case OpCode::Compare:
+			--top;
+			stack[top - 1] = ConfigNode(stack[top - 1].compareTo(static_cast<MathRelOp>(instruction.mode), stack[top]));
+			break;
+		}
+	}
+
+	assert(top == 1);
+	return std::move(stack[0]);
+}
+
+gsl::span<const ScriptProgram::Instruction> ScriptProgram::getInstructions(int expression) const
+{
+	const auto& expr = expressions[expression];
+	return gsl::span<const Instruction>(instructions).subspan(expr.start, expr.length);
+}
+
+gsl::span<const ScriptProgram::VariableSlot> ScriptProgram::getVariableSlots(int expression) const
+{
+	const auto& expr = expressions[expression];
+	return gsl::span<const VariableSlot>(slots).subspan(expr.firstSlot, expr.nSlots);
+}
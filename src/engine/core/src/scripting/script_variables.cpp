@@ -12,33 +12,33 @@ ScriptVariables::ScriptVariables(const ConfigNode& node, const EntitySerializati
 void ScriptVariables::load(const ConfigNode& node, const EntitySerializationContext& context)
 {
 	if (node.getType() == ConfigNodeType::Map) {
-		variables.clear();
+		clear();
 		for (const auto& [k, v]: node.asMap()) {
 			if (k.startsWith("entity!")) {
 				context.debugCurrentContext = "ScriptVariables:" + k;
 				const auto entityId = ConfigNodeSerializer<EntityId>().deserialize(context, v);
 				context.debugCurrentContext = {};
-				variables[k.mid(7)] = entityId;
+				getOrAddVariable(std::string_view(k).substr(7)) = entityId;
 			} else {
-				variables[k] = v;
+				getOrAddVariable(k) = v;
 			}
 		}
 	} else if (node.getType() != ConfigNodeType::Undefined) {
 		for (const auto& [k, v]: node.asMap()) {
 			if (k.startsWith("entity!")) {
 				if (v.getType() == ConfigNodeType::Del) {
-					variables.erase(k.mid(7));
+					eraseVariable(std::string_view(k).substr(7));
 				} else {
 					context.debugCurrentContext = "ScriptVariables:" + k;
 					const auto entityId = ConfigNodeSerializer<EntityId>().deserialize(context, v);
 					context.debugCurrentContext = {};
-					variables[k.mid(7)] = entityId;
+					getOrAddVariable(std::string_view(k).substr(7)) = entityId;
 				}
 			} else {
 				if (v.getType() == ConfigNodeType::Del) {
-					variables.erase(k);
+					eraseVariable(k);
 				} else {
-					variables[k].applyDelta(v);
+					getOrAddVariable(k).applyDelta(v);
 				}
 			}
 		}
@@ -48,43 +48,104 @@ void ScriptVariables::load(const ConfigNode& node, const EntitySerializationCont
 ConfigNode ScriptVariables::toConfigNode(const EntitySerializationContext& context) const
 {
 	ConfigNode::MapType result;
-	for (const auto& [k, v]: variables) {
+	auto add = [&] (const String& k, const ConfigNode& v)
+	{
 		if (v.getType() == ConfigNodeType::EntityId) {
 			result["entity!" + k] = ConfigNodeSerializer<EntityId>().serialize(v.asEntityId(), context);
 		} else {
 			result[k] = v;
 		}
+	};
+	for (const auto& [k, v]: variables) {
+		add(k.getString(), v);
+	}
+	for (const auto& [k, v]: uninternedVariables) {
+		add(k, v);
 	}
 	return result;
 }
 
-const ConfigNode& ScriptVariables::getVariable(const String& name) const
+const ConfigNode& ScriptVariables::getVariable(std::string_view name) const
+{
+	const auto* value = tryGetVariable(name);
+	return value ? *value : dummy;
+}
+
+const ConfigNode& ScriptVariables::getVariable(const Atom& name) const
 {
 	const auto iter = variables.find(name);
 	if (iter != variables.end()) {
 		return iter->second;
 	}
-	return dummy;
+	return uninternedVariables.empty() ? dummy : getVariable(name.getView());
+}
+
+void ScriptVariables::setVariable(std::string_view name, ConfigNode value)
+{
+	getOrAddVariable(name) = std::move(value);
+}
+
+void ScriptVariables::setVariable(const Atom& name, ConfigNode value)
+{
+	if (uninternedVariables.empty()) {
+		variables[name] = std::move(value);
+	} else {
+		getOrAddVariable(name.getView()) = std::move(value);
+	}
 }
 
-void ScriptVariables::setVariable(const String& name, ConfigNode value)
+bool ScriptVariables::hasVariable(std::string_view name) const
 {
-	variables[name] = std::move(value);
+	return tryGetVariable(name) != nullptr;
 }
 
-bool ScriptVariables::hasVariable(const String& name) const
+void ScriptVariables::eraseVariable(std::string_view name)
 {
-	return variables.find(name) != variables.end();
+	// A name that was never interned can't be an atom key, and mustn't be interned just to find that out
+	if (const auto atom = Atom::tryFind(name)) {
+		variables.erase(*atom);
+	}
+	const auto iter = uninternedVariables.find(name);
+	if (iter != uninternedVariables.end()) {
+		uninternedVariables.erase(iter);
+	}
 }
 
 bool ScriptVariables::empty() const
 {
-	return variables.empty();
+	return variables.empty() && uninternedVariables.empty();
 }
 
 void ScriptVariables::clear()
 {
 	variables.clear();
+	uninternedVariables.clear();
+}
+
+const ConfigNode* ScriptVariables::tryGetVariable(std::string_view name) const
+{
+	if (const auto iter = variables.find(name); iter != variables.end()) {
+		return &iter->second;
+	}
+	if (const auto iter = uninternedVariables.find(name); iter != uninternedVariables.end()) {
+		return &iter->second;
+	}
+	return nullptr;
+}
+
+ConfigNode& ScriptVariables::getOrAddVariable(std::string_view name)
+{
+	// Each name lives in only one of the maps, so check both before adding
+	if (const auto iter = variables.find(name); iter != variables.end()) {
+		return iter->second;
+	}
+	if (const auto iter = uninternedVariables.find(name); iter != uninternedVariables.end()) {
+		return iter->second;
+	}
+	if (const auto atom = Atom::tryFind(name)) {
+		return variables[*atom];
+	}
+	return uninternedVariables[String(name)];
 }
 
 ConfigNode ConfigNodeSerializer<ScriptVariables>::serialize(const ScriptVariables& variables, const EntitySerializationContext& context)
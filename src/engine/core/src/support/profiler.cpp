@@ -1,9 +1,65 @@
 #include "halley/support/profiler.h"
 
 #include "halley/utils/algorithm.h"
+#include "halley/text/string_converter.h"
 
 using namespace Halley;
 
+namespace {
+	constexpr const char* eventTypeNames[] = {
+		"CorePumpEvents",
+		"CoreDevConClient",
+		"CorePumpAudio",
+		"CoreFixedUpdate",
+		"CoreVariableUpdate",
+		"CoreUpdateSystem",
+		"CoreUpdatePlatform",
+		"CoreUpdate",
+		"CoreStartRender",
+		"CoreRender",
+		"CoreVSync",
+		"PainterDrawCall",
+		"PainterEndRender",
+		"PainterUpdateProjection",
+		"WorldVariableUpdate",
+		"WorldFixedUpdate",
+		"WorldRender",
+		"WorldSystemUpdate",
+		"WorldSystemRender",
+		"WorldSystemMessages",
+		"ScriptUpdate",
+		"AudioGenerateBuffer",
+		"GPU",
+		"DiskIO",
+		"StatsView",
+		"Game",
+		"ExternalCode",
+		"UserDefined",
+		"CoreStartup",
+		"WorldInit",
+		"EntityInstantiate",
+		"ResourcesOpenPack",
+		"ExecutorTask"
+	};
+	static_assert(std::size(eventTypeNames) == static_cast<size_t>(ProfilerEventType::ExecutorTask) + 1);
+
+	void appendJSONString(String& dst, std::string_view str)
+	{
+		dst += '"';
+		for (const char c: str) {
+			if (c == '"' || c == '\\') {
+				dst += '\\';
+				dst += c;
+			} else if (static_cast<unsigned char>(c) < 0x20) {
+				dst += "\\u00" + toString(static_cast<int>(c), 16, 2);
+			} else {
+				dst += c;
+			}
+		}
+		dst += '"';
+	}
+}
+
 
 bool ProfilerData::ThreadInfo::operator<(const ThreadInfo& other) const
 {
@@ -13,10 +69,11 @@ bool ProfilerData::ThreadInfo::operator<(const ThreadInfo& other) const
 	return totalTime > other.totalTime;
 }
 
-ProfilerData::ProfilerData(TimePoint frameStartTime, TimePoint frameEndTime, Vector<Event> events)
+ProfilerData::ProfilerData(TimePoint frameStartTime, TimePoint frameEndTime, Vector<Event> events, HashMap<std::thread::id, String> threadNames)
 	: frameStartTime(frameStartTime)
 	, frameEndTime(frameEndTime)
 	, events(std::move(events))
+	, threadNames(std::move(threadNames))
 {
 	processEvents();
 }
@@ -70,6 +127,48 @@ gsl::span<const ProfilerData::ThreadInfo> ProfilerData::getThreads() const
 	return threads;
 }
 
+String ProfilerData::toChromeTrace() const
+{
+	String result;
+	result.cppStr().reserve(events.size() * 128);
+	result += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	auto toMicroseconds = [] (Duration d)
+	{
+		return toString(static_cast<double>(d.count()) / 1000.0, 3);
+	};
+
+	HashMap<std::thread::id, int> threadIds;
+	bool first = true;
+	for (const auto& thread: threads) {
+		const int tid = static_cast<int>(threadIds.size()) + 1;
+		threadIds[thread.id] = tid;
+
+		const String name = thread.id == std::thread::id() ? String("GPU") : (thread.name.isEmpty() ? "Thread " + toString(tid) : thread.name);
+		result += first ? "\n" : ",\n";
+		first = false;
+		result += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + toString(tid) + ",\"args\":{\"name\":";
+		appendJSONString(result, name);
+		result += "}}";
+	}
+
+	for (const auto& e: events) {
+		const auto* typeName = eventTypeNames[static_cast<size_t>(e.type)];
+		result += first ? "\n" : ",\n";
+		first = false;
+		result += "{\"name\":";
+		appendJSONString(result, e.name.isEmpty() ? std::string_view(typeName) : std::string_view(e.name));
+		result += ",\"cat\":";
+		appendJSONString(result, typeName);
+		result += ",\"ph\":\"X\",\"ts\":" + toMicroseconds(e.startTime - frameStartTime);
+		result += ",\"dur\":" + toMicroseconds(std::max(e.endTime, e.startTime) - e.startTime);
+		result += ",\"pid\":1,\"tid\":" + toString(threadIds[e.threadId]) + "}";
+	}
+
+	result += "\n]}\n";
+	return result;
+}
+
 void ProfilerData::processEvents()
 {
 	struct ThreadCurInfo {
@@ -131,7 +230,8 @@ void ProfilerData::processEvents()
 
 	// Generate the thread list
 	for (const auto& [k, v]: threadInfo) {
-		const String name; // TODO
+		const auto nameIter = threadNames.find(k);
+		const String name = nameIter != threadNames.end() ? nameIter->second : String();
 		threads.emplace_back(ThreadInfo{ k, static_cast<int>(v.maxDepth), name, v.start, v.end, v.totalTime, v.type });
 	}
 	std::sort(threads.begin(), threads.end());
@@ -140,6 +240,7 @@ void ProfilerData::processEvents()
 ProfilerCapture::ProfilerCapture(size_t maxEvents)
 	: recording(false)
 	, curId(0)
+	, bootTracing(false)
 {
 	events.resize(maxEvents);
 }
@@ -163,25 +264,43 @@ void ProfilerCapture::recordEventEnd(EventId id)
 
 ProfilerCapture::EventId ProfilerCapture::recordEventStart(ProfilerEventType type, std::string_view name, std::chrono::steady_clock::time_point time)
 {
+	EventId result;
+	const auto threadId = type == ProfilerEventType::GPU ? std::thread::id() : std::this_thread::get_id();
+
+	if (bootTracing) {
+		std::unique_lock<std::mutex> lock(bootMutex);
+		if (bootTracing) {
+			result.bootId = bootEvents.size() + 1;
+			bootEvents.push_back(ProfilerData::Event{ name, threadId, type, 0, result.bootId, time, {} });
+		}
+	}
+
 	if (recording) {
 		const auto id = curId++; // I think this is thread-safe?
 		if (id < endId) {
 			const auto pos = id % events.size();
-			const auto threadId = type == ProfilerEventType::GPU ? std::thread::id() : std::this_thread::get_id();
 			events[pos] = ProfilerData::Event{ name, threadId, type, 0, id, time, {} };
-			return id;
+			result.frameId = id;
 		} else {
 			--curId;
 		}
 	}
-	return 0;
+	return result;
 }
 
 void ProfilerCapture::recordEventEnd(EventId id, std::chrono::steady_clock::time_point time)
 {
-	if (recording && id != 0) {
-		const auto pos = id % events.size();
-		if (events[pos].id == id) { // Dodgy, potential race condition here
+	if (id.bootId != 0) {
+		std::unique_lock<std::mutex> lock(bootMutex);
+		const auto idx = id.bootId - 1;
+		if (idx < bootEvents.size()) {
+			bootEvents[idx].endTime = time;
+		}
+	}
+
+	if (recording && id.frameId != 0) {
+		const auto pos = id.frameId % events.size();
+		if (events[pos].id == id.frameId) { // Dodgy, potential race condition here
 			events[pos].endTime = time;
 		}
 	}
@@ -233,7 +352,7 @@ ProfilerData ProfilerCapture::getCapture()
 		eventsCopy.insert(eventsCopy.end(), events.begin(), events.begin() + endIdx);
 	}
 	
-	return ProfilerData(frameStartTime, frameEndTime, std::move(eventsCopy));
+	return ProfilerData(frameStartTime, frameEndTime, std::move(eventsCopy), getThreadNames());
 }
 
 Time ProfilerCapture::getFrameTime() const
@@ -243,6 +362,53 @@ Time ProfilerCapture::getFrameTime() const
 	return std::chrono::duration<Time>(frameEndTime - frameStartTime).count();
 }
 
+void ProfilerCapture::startBootTrace()
+{
+	std::unique_lock<std::mutex> lock(bootMutex);
+	bootStartTime = std::chrono::steady_clock::now();
+	bootEvents.clear();
+	bootEvents.reserve(4096);
+	bootTracing = true;
+}
+
+ProfilerData ProfilerCapture::endBootTrace()
+{
+	Vector<ProfilerData::Event> eventsCopy;
+	const auto endTime = std::chrono::steady_clock::now();
+	{
+		std::unique_lock<std::mutex> lock(bootMutex);
+		bootTracing = false;
+		eventsCopy = std::move(bootEvents);
+		bootEvents = {};
+	}
+
+	// Events still open when the trace ends (e.g. the frame that ended it) are closed at the end of the trace
+	for (auto& e: eventsCopy) {
+		if (e.endTime < e.startTime) {
+			e.endTime = std::max(e.startTime, endTime);
+		}
+	}
+
+	return ProfilerData(bootStartTime, endTime, std::move(eventsCopy), getThreadNames());
+}
+
+bool ProfilerCapture::isBootTracing() const
+{
+	return bootTracing;
+}
+
+void ProfilerCapture::setThreadName(String name)
+{
+	std::unique_lock<std::mutex> lock(threadNamesMutex);
+	threadNames[std::this_thread::get_id()] = std::move(name);
+}
+
+HashMap<std::thread::id, String> ProfilerCapture::getThreadNames() const
+{
+	std::unique_lock<std::mutex> lock(threadNamesMutex);
+	return threadNames;
+}
+
 constexpr static bool isDevMode()
 {
 #ifdef DEV_BUILD
@@ -268,14 +434,15 @@ constexpr static bool alwaysLogType(ProfilerEventType type)
 
 ProfilerEvent::ProfilerEvent(ProfilerEventType type, std::string_view name)
 {
-	if (isDevMode() || alwaysLogType(type)) {
-		id = ProfilerCapture::get().recordEventStart(type, name);
+	auto& capture = ProfilerCapture::get();
+	if (isDevMode() || alwaysLogType(type) || capture.isBootTracing()) {
+		id = capture.recordEventStart(type, name);
 	}
 }
 
 ProfilerEvent::~ProfilerEvent() noexcept
 {
-	if (id != 0) {
+	if (id.isValid()) {
 		ProfilerCapture::get().recordEventEnd(id);
 	}
 }
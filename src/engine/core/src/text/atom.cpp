@@ -0,0 +1,79 @@
+#include "halley/text/atom.h"
+#include <atomic>
+using namespace Halley;
+
+namespace {
+	// Fixed number of buckets, each a linked list that only ever grows at the head, so insertion is a single CAS
+	// Zero-initialized before any dynamic initialization runs, so atoms can be created from static initializers
+	constexpr size_t numBuckets = 16384;
+	std::atomic<const void*> buckets[numBuckets];
+	std::atomic<size_t> internedCount;
+}
+
+Atom::Atom(std::string_view str)
+{
+	if (str.empty()) {
+		return;
+	}
+
+	const size_t hash = std::hash<std::string_view>()(str);
+	auto& bucket = buckets[hash % numBuckets];
+
+	const Entry* head = static_cast<const Entry*>(bucket.load(std::memory_order_acquire));
+	const Entry* searchedUntil = nullptr;
+	Entry* created = nullptr;
+
+	while (true) {
+		// Only the entries added since the last pass need to be checked
+		if (const auto* e = find(hash, str, head, searchedUntil)) {
+			delete created;
+			entry = e;
+			return;
+		}
+
+		if (!created) {
+			created = new Entry{ hash, {}, String(str), nullptr };
+			created->view = created->str;
+		}
+		created->next = head;
+		const void* expected = head;
+		if (bucket.compare_exchange_weak(expected, created, std::memory_order_release, std::memory_order_acquire)) {
+			internedCount.fetch_add(1, std::memory_order_relaxed);
+			entry = created;
+			return;
+		}
+		searchedUntil = head;
+		head = static_cast<const Entry*>(expected);
+	}
+}
+
+std::optional<Atom> Atom::tryFind(std::string_view str)
+{
+	if (str.empty()) {
+		return Atom();
+	}
+
+	const size_t hash = std::hash<std::string_view>()(str);
+	const auto* head = static_cast<const Entry*>(buckets[hash % numBuckets].load(std::memory_order_acquire));
+	if (const auto* e = find(hash, str, head, nullptr)) {
+		Atom result;
+		result.entry = e;
+		return result;
+	}
+	return std::nullopt;
+}
+
+const Atom::Entry* Atom::find(size_t hash, std::string_view str, const Entry* from, const Entry* until)
+{
+	for (const Entry* e = from; e != until; e = e->next) {
+		if (e->hash == hash && e->view == str) {
+			return e;
+		}
+	}
+	return nullptr;
+}
+
+size_t Atom::getInternedCount()
+{
+	return internedCount.load(std::memory_order_relaxed);
+}
@@ -1,6 +1,7 @@
 #include <utility>
 #include "halley/text/i18n.h"
 #include "halley/file_formats/config_file.h"
+#include "halley/utils/algorithm.h"
 
 using namespace Halley;
 
@@ -19,7 +20,7 @@ void I18N::update()
 	for (auto& o: observers) {
 		if (o.second.needsUpdate()) {
 			o.second.update();
-			loadLocalisation(o.second.getRoot());
+			loadLocalisation(o.second.getView());
 		}
 	}
 }
@@ -47,19 +48,20 @@ void I18N::setFallbackLanguage(const I18NLanguage& code)
 
 void I18N::loadLocalisationFile(const ConfigFile& config)
 {
-	loadLocalisation(config.getRoot());
+	loadLocalisation(config.getView());
 #ifdef DEV_BUILD
 	observers[config.getAssetId()] = ConfigObserver(config);
 #endif
 }
 
-void I18N::loadLocalisation(const ConfigNode& root)
+void I18N::loadLocalisation(const ConfigNodeView& root)
 {
-	for (auto& language: root.asMap()) {
-		auto langCode = I18NLanguage(language.first);
+	for (size_t i = 0; i < root.getMapSize(); ++i) {
+		auto langCode = I18NLanguage(String(root.getMapKey(i)));
 		auto& lang = strings[langCode];
-		for (auto& e: language.second.asMap()) {
-			lang[e.first] = e.second.asString();
+		const auto entries = root.getMapValue(i);
+		for (size_t j = 0; j < entries.getMapSize(); ++j) {
+			lang[String(entries.getMapKey(j))] = entries.getMapValue(j).asString();
 		}
 	}
 	++version;
@@ -151,6 +153,49 @@ char I18N::getDecimalSeparator() const
 	return '.';
 }
 
+namespace {
+	void addCharacters(Vector<int>& dst, const String& str)
+	{
+		for (const auto c: str.getUTF32()) {
+			dst.push_back(static_cast<int>(c));
+		}
+	}
+
+	void sortCharacters(Vector<int>& chars)
+	{
+		std::sort(chars.begin(), chars.end());
+		chars.erase(std::unique(chars.begin(), chars.end()), chars.end());
+	}
+}
+
+Vector<int> I18N::getCharacters(const std::optional<I18NLanguage>& language) const
+{
+	Vector<int> result;
+	for (const auto& [lang, entries]: strings) {
+		if (!language || lang == *language) {
+			for (const auto& e: entries) {
+				addCharacters(result, e.second);
+			}
+		}
+	}
+	sortCharacters(result);
+	return result;
+}
+
+Vector<int> I18N::getCharacters(const ConfigNode& stringTable, const Vector<I18NLanguage>& languages)
+{
+	Vector<int> result;
+	for (const auto& [langCode, entries]: stringTable.asMap()) {
+		if (languages.empty() || std_ex::contains(languages, I18NLanguage(langCode))) {
+			for (const auto& e: entries.asMap()) {
+				addCharacters(result, e.second.asString());
+			}
+		}
+	}
+	sortCharacters(result);
+	return result;
+}
+
 LocalisedString::LocalisedString()
 {
 }
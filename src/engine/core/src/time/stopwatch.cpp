@@ -54,25 +54,31 @@ void Stopwatch::pause()
 void Stopwatch::reset()
 {
 	measuredTime = 0;
+	if (running) {
+		startTime = high_resolution_clock::now();
+	}
 }
 
 Time Stopwatch::elapsedSeconds() const
 {
-	return measuredTime / 1'000'000'000.0;
+	return elapsedNanoseconds() / 1'000'000'000.0;
 }
 
 int64_t Stopwatch::elapsedMilliseconds() const
 {
-	return (measuredTime + 500000) / 1000000;
+	return (elapsedNanoseconds() + 500000) / 1000000;
 }
 
 int64_t Stopwatch::elapsedMicroseconds() const
 {
-	return (measuredTime + 500) / 1000;
+	return (elapsedNanoseconds() + 500) / 1000;
 }
 
 int64_t Stopwatch::elapsedNanoseconds() const
 {
+	if (running) {
+		return measuredTime + duration_cast<nanoseconds>(high_resolution_clock::now() - startTime).count();
+	}
 	return measuredTime;
 }
 
@@ -29,19 +29,27 @@ UIColourScheme::UIColourScheme()
 {}
 
 UIColourScheme::UIColourScheme(const ConfigNode& node, Resources& resources)
+{
+	const auto bytes = ConfigNodeView::compile(node);
+	*this = UIColourScheme(ConfigNodeView(gsl::as_bytes(gsl::span<const Byte>(bytes))), resources);
+}
+
+UIColourScheme::UIColourScheme(const ConfigNodeView& node, Resources& resources)
 {
 	if (node.hasKey("base")) {
 		const auto& base = resources.get<ConfigFile>(node["base"].asString());
-		*this = UIColourScheme(base->getRoot(), resources);
+		*this = UIColourScheme(base->getView(), resources);
 	}
-	
-	for (const auto& [k, v]: node["colours"].asMap()) {
-		colours[k] = Colour4f::fromString(v.asString());
+
+	const auto colourNodes = node["colours"];
+	for (size_t i = 0; i < colourNodes.getMapSize(); ++i) {
+		colours[String(colourNodes.getMapKey(i))] = Colour4f::fromString(colourNodes.getMapValue(i).asString());
 	}
 
 	if (node.hasKey("sprites")) {
-		for (const auto& [k, v]: node["sprites"].asMap()) {
-			sprites[k] = getSpriteFromConfigNode(v, resources);
+		const auto spriteNodes = node["sprites"];
+		for (size_t i = 0; i < spriteNodes.getMapSize(); ++i) {
+			sprites[String(spriteNodes.getMapKey(i))] = getSpriteFromConfigNode(spriteNodes.getMapValue(i).toConfigNode(), resources);
 		}
 	}
 	
@@ -62,10 +70,10 @@ UIColourScheme::UIColourScheme(const ConfigNode& node, Resources& resources)
 	}
 	if (node.hasKey("backgroundParticles")) {
 		EntitySerializationContext context;
-		backgroundParticles = Particles(node["backgroundParticles"]["particles"], resources, context);
+		backgroundParticles = Particles(node["backgroundParticles"]["particles"].toConfigNode(), resources, context);
 		Vector<Sprite> particleSprites;
-		for (const auto& spriteNode: node["backgroundParticles"]["sprites"].asSequence()) {
-			particleSprites.push_back(getSpriteFromConfigNode(spriteNode, resources));
+		for (const auto& spriteNode: node["backgroundParticles"]["sprites"]) {
+			particleSprites.push_back(getSpriteFromConfigNode(spriteNode.toConfigNode(), resources));
 		}
 		backgroundParticles.setSprites(std::move(particleSprites));
 	}
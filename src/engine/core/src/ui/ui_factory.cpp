@@ -28,6 +28,7 @@
 #include "halley/ui/widgets/ui_spin_list.h"
 #include "halley/ui/widgets/ui_option_list_morpher.h"
 #include "halley/ui/widgets/ui_tree_list.h"
+#include "halley/ui/widgets/ui_virtual_list.h"
 #include "halley/ui/behaviours/ui_reload_ui_behaviour.h"
 #include "halley/ui/widgets/ui_custom_paint.h"
 #include "halley/ui/widgets/ui_debug_console.h"
@@ -91,6 +92,7 @@ UIFactory::UIFactory(const HalleyAPI& api, Resources& resources, const I18N& i18
 	addFactory("spinList", [=](const ConfigNode& node) { return makeSpinList(node); }, getSpinListProperties());
 	addFactory("optionListMorpher", [=](const ConfigNode& node) { return makeOptionListMorpher(node); }, getOptionListMorpherProperties());
 	addFactory("treeList", [=](const ConfigNode& node) { return makeTreeList(node); }, getTreeListProperties());
+	addFactory("virtualList", [=](const ConfigNode& node) { return makeVirtualList(node); }, getVirtualListProperties());
 	addFactory("debugConsole", [=](const ConfigNode& node) { return makeDebugConsole(node); }, getDebugConsoleProperties());
 	addFactory("renderSurface", [=](const ConfigNode& node) { return makeRenderSurface(node); }, getRenderSurfaceProperties());
 	addFactory("customPaint", [=](const ConfigNode& node) { return makeCustomPaint(node); }, getCustomPaintProperties());
@@ -1613,6 +1615,42 @@ std::shared_ptr<UIWidget> UIFactory::makeTreeList(const ConfigNode& entryNode)
 	return widget;
 }
 
+std::shared_ptr<UIWidget> UIFactory::makeVirtualList(const ConfigNode& entryNode)
+{
+	const auto& node = entryNode["widget"];
+	auto id = node["id"].asString();
+	auto style = UIStyle(node["style"].asString("list"), styleSheet);
+
+	// Rows come from an IUIVirtualListSource, which the owner sets in code
+	auto widget = std::make_shared<UIVirtualList>(id, style);
+	applyInputButtons(*widget, node["inputButtons"].asString("list"));
+	widget->setDragEnabled(node["canDrag"].asBool(false));
+	widget->setSingleClickAccept(node["singleClickAccept"].asBool(true));
+	widget->setMultiSelect(node["multiSelect"].asBool(false));
+	widget->setAcceptKeyboardInput(node["acceptKeyboardInput"].asBool(true));
+	widget->setRequiresSelection(node["requiresSelection"].asBool(true));
+
+	return widget;
+}
+
+UIFactoryWidgetProperties UIFactory::getVirtualListProperties() const
+{
+	UIFactoryWidgetProperties result;
+	result.name = "Virtual List";
+	result.iconName = "widget_icons/list.png";
+	result.canHaveChildren = false;
+
+	result.entries.emplace_back("Can Drag", "canDrag", "bool", "false");
+	result.entries.emplace_back("Multi-select", "multiSelect", "bool", "false");
+	result.entries.emplace_back("Single Click Accept", "singleClickAccept", "bool", "true");
+	result.entries.emplace_back("Accept Keyboard Input", "acceptKeyboardInput", "bool", "true");
+	result.entries.emplace_back("Requires Selection", "requiresSelection", "bool", "true");
+	result.entries.emplace_back("Input Buttons", "inputButtons", "Halley::String", "list");
+	result.entries.emplace_back("Style", "style", "Halley::UIStyle<list>", "list");
+
+	return result;
+}
+
 void UIFactory::applyListProperties(UIList& list, const ConfigNode& node, const String& inputConfigName)
 {
 	applyInputButtons(list, node["inputButtons"].asString(inputConfigName));
@@ -1819,13 +1857,13 @@ void UIFactory::loadDefaultColourScheme()
 {
 	const String defaultColourScheme = "colour_schemes/flat_halley_dark";
 	if (resources.exists<ConfigFile>(defaultColourScheme)) {
-		colourScheme = std::make_shared<UIColourScheme>(resources.get<ConfigFile>(defaultColourScheme)->getRoot(), resources);
+		colourScheme = std::make_shared<UIColourScheme>(resources.get<ConfigFile>(defaultColourScheme)->getView(), resources);
 	}
 }
 
 void UIFactory::setColourScheme(const String& assetId)
 {
 	if (resources.exists<ConfigFile>(assetId)) {
-		colourScheme = std::make_shared<UIColourScheme>(resources.get<ConfigFile>(assetId)->getRoot(), resources);
+		colourScheme = std::make_shared<UIColourScheme>(resources.get<ConfigFile>(assetId)->getView(), resources);
 	}
 }
@@ -2,8 +2,15 @@
 #include "halley/graphics/sprite/sprite_painter.h"
 #include "halley/graphics/sprite/sprite.h"
 #include "halley/graphics/text/text_renderer.h"
+#include "halley/ui/ui_render_cache.h"
 using namespace Halley;
 
+float UIRenderStats::getReuseRatio() const
+{
+	const auto total = widgetsDrawn + widgetsReused;
+	return total > 0 ? float(widgetsReused) / float(total) : 0.0f;
+}
+
 UIPainter::UIPainter(SpritePainter& painter, int mask, int layer)
 	: painter(&painter)
 	, mask(mask)
@@ -18,6 +25,8 @@ UIPainter UIPainter::clone() const
 	result.clip = clip;
 	result.currentPriority = currentPriority;
 	result.colourMultiplier = colourMultiplier;
+	result.recorder = recorder;
+	result.stats = stats;
 	return result;
 }
 
@@ -91,11 +100,20 @@ float UIPainter::getCurrentPriorityAndIncrement() const
 void UIPainter::draw(const Sprite& sprite, bool forceCopy)
 {
 	if (colourMultiplier) {
-		painter->add(applyColour(sprite), mask, layer, getCurrentPriorityAndIncrement(), clip);
-	} else if (forceCopy) {
-		painter->addCopy(sprite, mask, layer, getCurrentPriorityAndIncrement(), clip);
+		auto coloured = applyColour(sprite);
+		if (recorder) {
+			record(coloured);
+		}
+		painter->add(std::move(coloured), mask, layer, getCurrentPriorityAndIncrement(), clip);
 	} else {
-		painter->add(sprite, mask, layer, getCurrentPriorityAndIncrement(), clip);
+		if (recorder) {
+			record(sprite);
+		}
+		if (forceCopy) {
+			painter->addCopy(sprite, mask, layer, getCurrentPriorityAndIncrement(), clip);
+		} else {
+			painter->add(sprite, mask, layer, getCurrentPriorityAndIncrement(), clip);
+		}
 	}
 }
 
@@ -103,35 +121,133 @@ void UIPainter::draw(const TextRenderer& text, bool forceCopy)
 {
 	text.generateSprites();
 	if (colourMultiplier) {
-		painter->add(applyColour(text), mask, layer, getCurrentPriorityAndIncrement(), clip);
-	} else if (forceCopy) {
-		painter->addCopy(text, mask, layer, getCurrentPriorityAndIncrement(), clip);
+		auto coloured = applyColour(text);
+		if (recorder) {
+			record(coloured);
+		}
+		painter->add(std::move(coloured), mask, layer, getCurrentPriorityAndIncrement(), clip);
 	} else {
-		painter->add(text, mask, layer, getCurrentPriorityAndIncrement(), clip);
+		if (recorder) {
+			record(text);
+		}
+		if (forceCopy) {
+			painter->addCopy(text, mask, layer, getCurrentPriorityAndIncrement(), clip);
+		} else {
+			painter->add(text, mask, layer, getCurrentPriorityAndIncrement(), clip);
+		}
 	}
 }
 
 void UIPainter::draw(Sprite&& sprite)
 {
-	painter->add(applyColour(std::move(sprite)), mask, layer, getCurrentPriorityAndIncrement(), clip);
+	auto coloured = applyColour(std::move(sprite));
+	if (recorder) {
+		record(coloured);
+	}
+	painter->add(std::move(coloured), mask, layer, getCurrentPriorityAndIncrement(), clip);
 }
 
 void UIPainter::draw(TextRenderer&& text)
 {
-	painter->add(applyColour(std::move(text)), mask, layer, getCurrentPriorityAndIncrement(), clip);
+	auto coloured = applyColour(std::move(text));
+	if (recorder) {
+		record(coloured);
+	}
+	painter->add(std::move(coloured), mask, layer, getCurrentPriorityAndIncrement(), clip);
 }
 
 void UIPainter::draw(std::function<void(Painter&)> f)
 {
+	if (recorder) {
+		record(f);
+	}
 	painter->add(std::move(f), mask, layer, getCurrentPriorityAndIncrement(), clip);
 }
 
 void UIPainter::addBounds(Rect4f bounds)
 {
 	if (clip && clip->overlaps(bounds)) {
-		painter->add(clip->intersection(bounds));
-	} else {
-		painter->add(bounds);
+		bounds = clip->intersection(bounds);
+	}
+	if (recorder) {
+		recordBounds(bounds);
+	}
+	painter->add(bounds);
+}
+
+void UIPainter::setStats(UIRenderStats* s)
+{
+	stats = s;
+}
+
+void UIPainter::notifyWidgetDrawn(bool hasRender)
+{
+	if (stats) {
+		++stats->widgetsDrawn;
+	}
+	if (recorder) {
+		++recorder->widgetCount;
+		if (hasRender) {
+			// Widgets with their own render pass do work on draw that can't be replayed
+			recorder->replayable = false;
+		}
+	}
+}
+
+UIPainter UIPainter::startRecording(UIRenderCache& cache) const
+{
+	cache.clear();
+	cache.baseClip = clip;
+	cache.baseColour = colourMultiplier;
+	cache.baseMask = mask;
+	cache.baseLayer = layer;
+
+	auto result = clone();
+	result.recorder = &cache;
+	return result;
+}
+
+void UIPainter::endRecording(UIRenderCache& cache)
+{
+	cache.valid = true;
+	if (stats) {
+		++stats->subtreesRecorded;
+	}
+	if (recorder) {
+		recorder->append(cache);
+	}
+}
+
+bool UIPainter::canReplay(const UIRenderCache& cache) const
+{
+	return cache.isValid() && cache.baseClip == clip && cache.baseColour == colourMultiplier && cache.baseMask == mask && cache.baseLayer == layer;
+}
+
+void UIPainter::replay(const UIRenderCache& cache)
+{
+	for (const auto& entry: cache.entries) {
+		switch (entry.type) {
+		case UIRenderCache::EntryType::Sprite:
+			painter->add(cache.sprites[entry.idx], entry.mask, entry.layer, getCurrentPriorityAndIncrement(), entry.clip);
+			break;
+		case UIRenderCache::EntryType::Text:
+			painter->add(cache.texts[entry.idx], entry.mask, entry.layer, getCurrentPriorityAndIncrement(), entry.clip);
+			break;
+		case UIRenderCache::EntryType::Callback:
+			painter->add(cache.callbacks[entry.idx], entry.mask, entry.layer, getCurrentPriorityAndIncrement(), entry.clip);
+			break;
+		case UIRenderCache::EntryType::Bounds:
+			painter->add(cache.bounds[entry.idx]);
+			break;
+		}
+	}
+
+	if (stats) {
+		stats->widgetsReused += cache.widgetCount;
+		++stats->subtreesReused;
+	}
+	if (recorder) {
+		recorder->append(cache);
 	}
 }
 
@@ -156,3 +272,27 @@ Sprite UIPainter::applyColour(Sprite sprite) const
 	}
 	return sprite;
 }
+
+void UIPainter::record(const Sprite& sprite) const
+{
+	recorder->entries.push_back({ UIRenderCache::EntryType::Sprite, static_cast<uint32_t>(recorder->sprites.size()), mask, layer, clip });
+	recorder->sprites.push_back(sprite);
+}
+
+void UIPainter::record(const TextRenderer& text) const
+{
+	recorder->entries.push_back({ UIRenderCache::EntryType::Text, static_cast<uint32_t>(recorder->texts.size()), mask, layer, clip });
+	recorder->texts.push_back(text);
+}
+
+void UIPainter::record(const std::function<void(Painter&)>& f) const
+{
+	recorder->entries.push_back({ UIRenderCache::EntryType::Callback, static_cast<uint32_t>(recorder->callbacks.size()), mask, layer, clip });
+	recorder->callbacks.push_back(f);
+}
+
+void UIPainter::recordBounds(Rect4f bounds) const
+{
+	recorder->entries.push_back({ UIRenderCache::EntryType::Bounds, static_cast<uint32_t>(recorder->bounds.size()), mask, layer, clip });
+	recorder->bounds.push_back(bounds);
+}
@@ -106,6 +106,11 @@ bool UIParent::isWaitingToSpawnChildren() const
 
 void UIParent::markAsNeedingLayout() {}
 
+void UIParent::markAsNeedingLayout(const UIWidget& source)
+{
+	markAsNeedingLayout();
+}
+
 Vector<std::shared_ptr<UIWidget>>& UIParent::getChildren()
 {
 	/*
@@ -0,0 +1,51 @@
+#include "halley/ui/ui_render_cache.h"
+using namespace Halley;
+
+void UIRenderCache::clear()
+{
+	entries.clear();
+	sprites.clear();
+	texts.clear();
+	callbacks.clear();
+	bounds.clear();
+	widgetCount = 0;
+	valid = false;
+	replayable = true;
+}
+
+bool UIRenderCache::isValid() const
+{
+	return valid && replayable;
+}
+
+size_t UIRenderCache::getWidgetCount() const
+{
+	return widgetCount;
+}
+
+void UIRenderCache::append(const UIRenderCache& other)
+{
+	for (const auto& e: other.entries) {
+		auto& entry = entries.emplace_back(e);
+		switch (e.type) {
+		case EntryType::Sprite:
+			entry.idx = static_cast<uint32_t>(sprites.size());
+			sprites.push_back(other.sprites[e.idx]);
+			break;
+		case EntryType::Text:
+			entry.idx = static_cast<uint32_t>(texts.size());
+			texts.push_back(other.texts[e.idx]);
+			break;
+		case EntryType::Callback:
+			entry.idx = static_cast<uint32_t>(callbacks.size());
+			callbacks.push_back(other.callbacks[e.idx]);
+			break;
+		case EntryType::Bounds:
+			entry.idx = static_cast<uint32_t>(bounds.size());
+			bounds.push_back(other.bounds[e.idx]);
+			break;
+		}
+	}
+	widgetCount += other.widgetCount;
+	replayable = replayable && other.replayable;
+}
@@ -70,6 +70,28 @@ void UIRoot::runLayout()
 	}
 }
 
+void UIRoot::setIncrementalLayout(bool enabled)
+{
+	incrementalLayout = enabled;
+}
+
+bool UIRoot::isIncrementalLayout() const
+{
+	return incrementalLayout;
+}
+
+const UILayoutStats& UIRoot::getLayoutStats() const
+{
+	return lastLayoutStats;
+}
+
+void UIRoot::markAsNeedingLayout(const UIWidget& source)
+{
+	if (layoutStats.invalidations++ == 0) {
+		layoutStats.firstInvalidatedBy = source.getId();
+	}
+}
+
 void UIRoot::updateWidgets(UIWidgetUpdateType type, Time t, UIInputType activeInputType, JoystickType joystickType)
 {
 	widgetsCache.clear();
@@ -142,6 +164,9 @@ void UIRoot::update(Time t, UIInputType activeInputType, spInputDevice mouse, sp
 		t = 0;
 	} while (isWaitingToSpawnChildren());
 
+	lastLayoutStats = std::move(layoutStats);
+	layoutStats = {};
+
 	prepareRender();
 }
 
@@ -738,6 +763,8 @@ void UIRoot::collectWidgets(const std::shared_ptr<UIWidget>& start, Vector<std::
 void UIRoot::draw(SpritePainter& painter, int mask, int layer)
 {
 	UIPainter p(painter, mask, layer);
+	renderStats = {};
+	p.setStats(&renderStats);
 
 	for (auto& c: getChildren()) {
 		c->doDraw(p);
@@ -778,6 +805,11 @@ void UIRoot::render(RenderContext& origRC)
 	}
 }
 
+const UIRenderStats& UIRoot::getRenderStats() const
+{
+	return renderStats;
+}
+
 std::optional<AudioHandle> UIRoot::playSound(const String& eventName)
 {
 	if (audioAPI && !eventName.isEmpty()) {
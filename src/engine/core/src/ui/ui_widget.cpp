@@ -7,6 +7,7 @@
 #include "halley/ui/ui_anchor.h"
 #include "halley/ui/ui_behaviour.h"
 #include "halley/ui/ui_event_handler.h"
+#include "halley/ui/ui_render_cache.h"
 #include "halley/input/input_keyboard.h"
 
 using namespace Halley;
@@ -44,6 +45,23 @@ void UIWidget::doDraw(UIPainter& painter) const
 		}
 	}
 
+	if (renderCache) {
+		if (!redrawNeeded && painter.canReplay(*renderCache)) {
+			painter.replay(*renderCache);
+		} else {
+			auto recording = painter.startRecording(*renderCache);
+			doDrawWidget(recording);
+			painter.endRecording(*renderCache);
+		}
+	} else {
+		doDrawWidget(painter);
+	}
+	redrawNeeded = false;
+}
+
+void UIWidget::doDrawWidget(UIPainter& painter) const
+{
+	painter.notifyWidgetDrawn(hasRender());
 	draw(painter);
 
 	if (childLayerAdjustment == 0) {
@@ -123,12 +141,22 @@ void UIWidget::collectWidgetsForUpdating(Vector<std::shared_ptr<UIWidget>>& dst)
 void UIWidget::collectWidgetsForRendering(size_t curRootIdx, Vector<std::pair<std::shared_ptr<UIWidget>, size_t>>& dst, Vector<std::shared_ptr<UIWidget>>& dstRoots)
 {
 	if (isActive()) {
+		// A cached subtree that hasn't changed since it was last found to have nothing to render can be skipped outright
+		if (renderCache && !renderListNeeded && renderListEmpty) {
+			return;
+		}
+
+		const auto prevSize = dst.size();
+		const auto prevRoots = dstRoots.size();
 		for (auto& c: getChildren()) {
 			c->collectWidgetsForRendering(curRootIdx, dst, dstRoots);
 		}
 		if (hasRender()) {
 			dst.emplace_back(shared_from_this(), curRootIdx);
 		}
+
+		renderListEmpty = dst.size() == prevSize && dstRoots.size() == prevRoots;
+		renderListNeeded = false;
 	}
 }
 
@@ -142,6 +170,9 @@ Vector2f UIWidget::getLayoutMinimumSize(bool force) const
 	if (sizer) {
 		if (layoutNeeded > 0) {
 			--layoutNeeded;
+			if (root) {
+				++root->layoutStats.widgetsMeasured;
+			}
 			auto border = getInnerBorder();
 			layoutSize = sizer->getLayoutMinimumSize(false);
 			if (layoutSize.x > 0.1f || layoutSize.y > 0.1f) {
@@ -155,11 +186,25 @@ Vector2f UIWidget::getLayoutMinimumSize(bool force) const
 
 void UIWidget::setRect(Rect4f rect, IUIElementListener* listener)
 {
+	const bool canSkip = !arrangeNeeded && !listener && root && root->incrementalLayout && rect.getTopLeft() == position && rect.getSize() == size;
+	if (canSkip && getLayoutOriginPosition() == arrangedOrigin && getLayoutSize(size) == arrangedSize) {
+		// Nothing in this subtree asked for layout and it's being given the same space, so children are already where they should be
+		++root->layoutStats.widgetsSkipped;
+		return;
+	}
+
 	setWidgetRect(rect);
+	arrangeNeeded = false;
+	arrangedOrigin = getLayoutOriginPosition();
+	arrangedSize = getLayoutSize(rect.getSize());
+	if (root) {
+		++root->layoutStats.widgetsArranged;
+	}
+
 	if (sizer) {
 		const auto border = getInnerBorder();
-		const auto p0 = getLayoutOriginPosition();
-		const auto size = getLayoutSize(rect.getSize());
+		const auto p0 = arrangedOrigin;
+		const auto size = arrangedSize;
 		if (listener) {
 			onPreNotifySetRect(*listener);
 		}
@@ -385,6 +430,7 @@ void UIWidget::setPositionOffset(Vector2f offset)
 	if (positionOffset != offset) {
 		positionOffset = offset;
 		positionUpdated = true;
+		markAsNeedingRedraw();
 	}
 }
 
@@ -417,10 +463,25 @@ void UIWidget::setPosition(Vector2f pos)
 {
 	Expects(pos.isValid());
 	
+	if (position != pos) {
+		// A leaf placed by its parent's sizer doesn't change anyone's size, so the sizer only has to place it again
+		// Anchors and tooltips call this every frame, and shouldn't make the whole path to the root measure again
+		if (!getChildren().empty() || !isPlacedBySizer()) {
+			markAsNeedingLayout();
+		} else {
+			dynamic_cast<UIWidget&>(*parent).markAsNeedingArrange();
+		}
+	}
 	position = pos;
 	positionUpdated = true;
 }
 
+bool UIWidget::isPlacedBySizer() const
+{
+	const auto* parentWidget = dynamic_cast<const UIWidget*>(parent);
+	return parentWidget && parentWidget->sizer;
+}
+
 void UIWidget::setBorder(Vector4f border)
 {
 	if (auto* parentWidget = dynamic_cast<UIWidget*>(parent)) {
@@ -628,6 +689,7 @@ void UIWidget::forceLayout()
 {
 	Expects (lastInputType != UIInputType::Undefined);
 	forceAddChildren(lastInputType, true);
+	arrangeNeeded = true;
 	layout();
 }
 
@@ -680,6 +742,11 @@ void UIWidget::setMouseClip(std::optional<Rect4f> clip, bool force)
 	}
 }
 
+const std::optional<Rect4f>& UIWidget::getMouseClip() const
+{
+	return mouseClip;
+}
+
 void UIWidget::onManualControlCycleValue(int delta)
 {
 }
@@ -983,6 +1050,11 @@ void UIWidget::update(Time t, bool moved)
 
 void UIWidget::updateBehaviours(Time t)
 {
+	if (!behaviours.empty()) {
+		// Behaviours are free to change anything about the widget
+		markAsNeedingRedraw();
+	}
+
 	for (auto& behaviour: behaviours) {
 		behaviour->update(t);
 	}
@@ -1056,16 +1128,32 @@ bool UIWidget::needsLayout() const
 }
 
 void UIWidget::markAsNeedingLayout()
+{
+	markAsNeedingLayout(*this);
+}
+
+void UIWidget::markAsNeedingLayout(const UIWidget& source)
 {
 	layoutNeeded = 1;
+	arrangeNeeded = true;
+	redrawNeeded = true;
+	renderListNeeded = true;
 	if (parent) {
-		parent->markAsNeedingLayout();
+		parent->markAsNeedingLayout(source);
 	}
 	if (sizer) {
 		sizer->updateEnabled();
 	}
 }
 
+void UIWidget::markAsNeedingArrange()
+{
+	for (auto* widget = this; widget; widget = dynamic_cast<UIWidget*>(widget->parent)) {
+		widget->arrangeNeeded = true;
+	}
+	markAsNeedingRedraw();
+}
+
 bool UIWidget::canReceiveFocus() const
 {
 	return false;
@@ -1137,10 +1225,12 @@ void UIWidget::setWidgetRect(Rect4f rect)
 	if (position != rect.getTopLeft()) {
 		position = rect.getTopLeft();
 		positionUpdated = true;
+		markAsNeedingRedraw();
 	}
 	if (size != rect.getSize()) {
 		size = rect.getSize();
 		positionUpdated = true;
+		markAsNeedingRedraw();
 	}
 }
 
@@ -1303,7 +1393,10 @@ UIGamepadInput::Priority UIWidget::getInputPriority() const
 
 void UIWidget::setChildLayerAdjustment(int delta)
 {
-	childLayerAdjustment = delta;
+	if (childLayerAdjustment != delta) {
+		childLayerAdjustment = delta;
+		markAsNeedingRedraw();
+	}
 }
 
 int UIWidget::getChildLayerAdjustment() const
@@ -1313,7 +1406,34 @@ int UIWidget::getChildLayerAdjustment() const
 
 void UIWidget::setNoClipChildren(bool noClip)
 {
-	dontClipChildren = noClip;
+	if (dontClipChildren != noClip) {
+		dontClipChildren = noClip;
+		markAsNeedingRedraw();
+	}
+}
+
+void UIWidget::setRenderCached(bool enabled)
+{
+	if (enabled && !renderCache) {
+		renderCache = std::make_unique<UIRenderCache>();
+	} else if (!enabled) {
+		renderCache.reset();
+	}
+	markAsNeedingRedraw();
+}
+
+bool UIWidget::isRenderCached() const
+{
+	return !!renderCache;
+}
+
+void UIWidget::markAsNeedingRedraw()
+{
+	redrawNeeded = true;
+	renderListNeeded = true;
+	if (parent) {
+		parent->markAsNeedingRedraw();
+	}
 }
 
 bool UIWidget::getNoClipChildren() const
@@ -132,6 +132,7 @@ bool UIClickable::setState(State state)
 	if (state != curState || forceUpdate) {
 		curState = state;
 		doSetState(state);
+		markAsNeedingRedraw();
 		return true;
 	}
 	return false;
@@ -109,7 +109,7 @@ void UIDropdown::updateOptionLabels()
 	float maxExtents = label.getExtents().x;
 	for (auto& o: options) {
 		const float iconSize = o.icon.hasMaterial() ? o.icon.getScaledSize().x + iconGap : 0;
-		const float strSize = label.getExtents(o.label.getString().getUTF32()).x;
+		const float strSize = label.getExtents(o.label.getString()).x;
 		maxExtents = std::max(maxExtents, iconSize + strSize);
 	}
 
@@ -72,6 +72,7 @@ void UIImage::setSprite(Sprite s)
 		setMinSize(spriteSize);
 	}
 	dirty = true;
+	markAsNeedingRedraw();
 }
 
 Sprite& UIImage::getSprite()
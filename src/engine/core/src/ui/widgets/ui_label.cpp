@@ -51,6 +51,7 @@ void UILabel::update(Time t, bool moved)
 	}
 	if (marqueeSpeed) {
 		updateMarquee(t);
+		markAsNeedingRedraw();
 	}
 	if (text.checkForUpdates()) {
 		updateText();
@@ -118,6 +119,7 @@ void UILabel::updateMinSize()
 void UILabel::updateText() {
 	renderer.setText(text);
 	updateMinSize();
+	markAsNeedingRedraw();
 }
 
 void UILabel::updateMarquee(Time t)
@@ -204,6 +206,7 @@ const LocalisedString& UILabel::getText() const
 void UILabel::setColourOverride(Vector<ColourOverride> overrides)
 {
 	renderer.setColourOverride(std::move(overrides));
+	markAsNeedingRedraw();
 }
 
 void UILabel::setMaxWidth(std::optional<float> m)
@@ -262,6 +265,7 @@ void UILabel::setFlowLayout(bool flow)
 void UILabel::setAlignment(float alignment)
 {
 	renderer.setAlignment(alignment);
+	markAsNeedingRedraw();
 }
 
 TextRenderer& UILabel::getTextRenderer()
@@ -284,11 +288,13 @@ void UILabel::setTextRenderer(TextRenderer r)
 	r.setText(text).setPosition(renderer.getPosition());
 	renderer = std::move(r);
 	updateMinSize();
+	markAsNeedingRedraw();
 }
 
 void UILabel::setColour(Colour4f colour)
 {
 	renderer.setColour(colour);
+	markAsNeedingRedraw();
 }
 
 void UILabel::setSelectable(TextRenderer normalRenderer, TextRenderer selectedRenderer, bool preserveAlpha)
@@ -1062,6 +1062,7 @@ bool UIListItem::isSelected() const
 void UIListItem::refreshSelectionState()
 {
 	doSetState(getCurState());
+	markAsNeedingRedraw();
 	sendEventDown(UIEvent(UIEventType::SetSelected, getId(), isSelected() && parent.canShowSelection()));
 }
 
@@ -1069,6 +1070,7 @@ void UIListItem::setStyle(UIStyle style)
 {
 	this->style = style;
 	doSetState(getCurState());
+	markAsNeedingRedraw();
 }
 
 void UIListItem::onEnabledChanged()
@@ -75,6 +75,8 @@ void UIScrollPane::scrollTo(Vector2f position)
 	}
 
 	if (scrollPos != old) {
+		// Children are placed relative to the scroll position
+		markAsNeedingArrange();
 		sendEventDown(UIEvent(UIEventType::ScrollPositionChanged, getId(), Vector2f(scrollPos)));
 	}
 }
@@ -169,6 +171,7 @@ bool UIScrollPane::isScrollWheelEnabled() const
 
 void UIScrollPane::refresh(bool force)
 {
+	const auto oldScrollPos = scrollPos;
 	if (!scrollHorizontal) {
 		clipSize.x = getSize().x;
 		scrollPos.x = 0;
@@ -177,6 +180,9 @@ void UIScrollPane::refresh(bool force)
 		clipSize.y = getSize().y;
 		scrollPos.y = 0;
 	}
+	if (scrollPos != oldScrollPos) {
+		markAsNeedingArrange();
+	}
 	contentsSize = UIWidget::getLayoutMinimumSize(false);
 
 	setMouseClip(getRect(), force);
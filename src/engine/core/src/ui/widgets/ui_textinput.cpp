@@ -57,6 +57,7 @@ UITextInput& UITextInput::setText(StringUTF32 t)
 	if (t != text.getText()) {
 		text.setText(std::move(t));
 		onMaybeTextModified();
+		markAsNeedingRedraw();
 	}
 	return *this;
 }
@@ -340,6 +341,9 @@ void UITextInput::update(Time t, bool moved)
 
 	// Caret
 	if (isFocused()) {
+		// Caret blinks and typing don't go through any setter
+		markAsNeedingRedraw();
+
 		caretTime += float(t);
 		if (caretTime > 0.4f) {
 			caretTime -= 0.4f;
@@ -352,6 +356,9 @@ void UITextInput::update(Time t, bool moved)
 			onMaybeTextModified();
 		}
 	} else {
+		if (caretShowing) {
+			markAsNeedingRedraw();
+		}
 		caretTime = 0;
 		caretShowing = false;
 	}
@@ -0,0 +1,771 @@
+#include "halley/ui/widgets/ui_virtual_list.h"
+#include "halley/ui/ui_style.h"
+#include "halley/input/input_keyboard.h"
+#include "halley/ui/widgets/ui_label.h"
+#include "halley/ui/widgets/ui_image.h"
+
+using namespace Halley;
+
+UIVirtualList::UIVirtualList(String id, UIStyle style, std::shared_ptr<IUIVirtualListSource> source)
+	: UIClickable(std::move(id), {}, {}, style.getBorder("innerBorder"))
+	, style(style)
+	, itemStyle(style.getSubStyle("item"))
+{
+	styles.emplace_back(style);
+	sprite = style.getSprite("background");
+	gap = style.getFloat("gap");
+
+	if (style.hasFloat("rowHeight")) {
+		rowHeight = style.getFloat("rowHeight");
+	} else {
+		const auto itemBorder = itemStyle.getBorder("innerBorder");
+		rowHeight = std::max(itemStyle.getVector2f("minSize", Vector2f()).y, std::ceil(style.getTextRenderer("label").getLineHeight()) + itemBorder.y + itemBorder.w);
+	}
+
+	setSource(std::move(source));
+}
+
+void UIVirtualList::setSource(std::shared_ptr<IUIVirtualListSource> s)
+{
+	source = std::move(s);
+	selectedIds.clear();
+	curOption = -1;
+	curOptionId = "";
+	curHover = -1;
+	refresh();
+}
+
+const std::shared_ptr<IUIVirtualListSource>& UIVirtualList::getSource() const
+{
+	return source;
+}
+
+void UIVirtualList::refresh()
+{
+	const auto prevCount = count;
+	count = source ? source->getCount() : 0;
+	++revision;
+
+	// Indices might have shifted, so resolve the current option from its id
+	if (curOption >= 0 && !(curOption < int(count) && source->getId(curOption) == curOptionId)) {
+		curOption = -1;
+		if (!curOptionId.isEmpty()) {
+			for (size_t i = 0; i < count; ++i) {
+				if (source->getId(i) == curOptionId) {
+					curOption = int(i);
+					break;
+				}
+			}
+		}
+	}
+
+	// Drop anything that was removed from the source
+	if (!selectedIds.empty()) {
+		HashSet<String> stillPresent;
+		for (size_t i = 0; i < count && stillPresent.size() < selectedIds.size(); ++i) {
+			auto id = source->getId(i);
+			if (selectedIds.find(id) != selectedIds.end()) {
+				stillPresent.insert(std::move(id));
+			}
+		}
+		selectedIds = std::move(stillPresent);
+	}
+
+	// If the current option was removed, move it to whatever is left of the selection
+	if (curOption < 0 && !selectedIds.empty()) {
+		curOption = getSelectedOptions().front();
+		curOptionId = source->getId(curOption);
+	}
+
+	if (curHover >= int(count)) {
+		curHover = -1;
+	}
+
+	if (curOption < 0 && count > 0 && requiresSelection) {
+		setSelectedOption(0);
+	}
+
+	if (count != prevCount) {
+		markAsNeedingLayout();
+	}
+}
+
+size_t UIVirtualList::getCount() const
+{
+	return count;
+}
+
+float UIVirtualList::getRowHeight() const
+{
+	return rowHeight;
+}
+
+size_t UIVirtualList::getNumberOfRowWidgets() const
+{
+	return rows.size();
+}
+
+bool UIVirtualList::setSelectedOption(int option, SelectionMode mode)
+{
+	if (option < 0 || option >= int(count)) {
+		return false;
+	}
+	return changeSelection(option, mode);
+}
+
+bool UIVirtualList::setSelectedOptionId(const String& id, SelectionMode mode)
+{
+	if (curOption >= 0 && curOptionId == id) {
+		return changeSelection(curOption, mode);
+	}
+	for (size_t i = 0; i < count; ++i) {
+		if (source->getId(i) == id) {
+			return changeSelection(int(i), mode);
+		}
+	}
+	return false;
+}
+
+int UIVirtualList::getSelectedOption() const
+{
+	return curOption;
+}
+
+String UIVirtualList::getSelectedOptionId() const
+{
+	return curOption >= 0 ? curOptionId : String();
+}
+
+Vector<int> UIVirtualList::getSelectedOptions() const
+{
+	Vector<int> result;
+	if (selectedIds.size() == 1 && curOption >= 0 && selectedIds.find(curOptionId) != selectedIds.end()) {
+		result.push_back(curOption);
+		return result;
+	}
+
+	result.reserve(selectedIds.size());
+	for (size_t i = 0; i < count && result.size() < selectedIds.size(); ++i) {
+		if (selectedIds.find(source->getId(i)) != selectedIds.end()) {
+			result.push_back(int(i));
+		}
+	}
+	return result;
+}
+
+Vector<String> UIVirtualList::getSelectedOptionIds() const
+{
+	Vector<String> result;
+	for (const auto idx: getSelectedOptions()) {
+		result.push_back(source->getId(idx));
+	}
+	return result;
+}
+
+bool UIVirtualList::isSelected(int option) const
+{
+	return option >= 0 && option < int(count) && selectedIds.find(source->getId(option)) != selectedIds.end();
+}
+
+std::optional<int> UIVirtualList::getHoveredOption() const
+{
+	if (curHover >= 0) {
+		return curHover;
+	}
+	return std::nullopt;
+}
+
+Rect4f UIVirtualList::getOptionRect(int option) const
+{
+	if (count == 0) {
+		return Rect4f();
+	}
+	const auto border = getInnerBorder();
+	const auto pos = Vector2f(border.x, border.y + clamp(option, 0, int(count) - 1) * getStride());
+	const auto rect = Rect4f(pos, getSize().x - border.x - border.z, rowHeight);
+	return rect.grow(style.getBorder("scrollBorder", Vector4f()));
+}
+
+void UIVirtualList::showCurSelection(bool centre)
+{
+	sendEvent(UIEvent(centre ? UIEventType::MakeAreaVisibleCentered : UIEventType::MakeAreaVisible, getId(), getOptionRect(curOption)));
+}
+
+bool UIVirtualList::isMultiSelect() const
+{
+	return multiSelect;
+}
+
+void UIVirtualList::setMultiSelect(bool enabled)
+{
+	multiSelect = enabled;
+}
+
+bool UIVirtualList::isDragEnabled() const
+{
+	return dragEnabled;
+}
+
+void UIVirtualList::setDragEnabled(bool drag)
+{
+	dragEnabled = drag;
+}
+
+void UIVirtualList::setSingleClickAccept(bool enabled)
+{
+	singleClickAccept = enabled;
+}
+
+void UIVirtualList::setScrollToSelection(bool value)
+{
+	scrollToSelection = value;
+}
+
+void UIVirtualList::setRequiresSelection(bool requireSelection)
+{
+	requiresSelection = requireSelection;
+}
+
+void UIVirtualList::setAcceptKeyboardInput(bool value)
+{
+	acceptKeyboardInput = value;
+}
+
+bool UIVirtualList::canReceiveFocus() const
+{
+	return true;
+}
+
+Vector2f UIVirtualList::getLayoutMinimumSize(bool force) const
+{
+	if (!isActive() && !force) {
+		return {};
+	}
+	const auto border = getInnerBorder();
+	const float height = count > 0 ? count * getStride() - gap : 0.0f;
+	return Vector2f::max(getMinimumSize(), Vector2f(border.x + border.z, height + border.y + border.w));
+}
+
+void UIVirtualList::draw(UIPainter& painter) const
+{
+	if (sprite.hasMaterial()) {
+		painter.draw(sprite);
+	}
+}
+
+void UIVirtualList::update(Time t, bool moved)
+{
+	UIClickable::update(t, moved);
+
+	if (moved) {
+		if (sprite.hasMaterial()) {
+			sprite.scaleTo(getSize()).setPos(getPosition());
+		}
+	}
+
+	if (firstUpdate && count > 0) {
+		if (scrollToSelection && curOption >= 0) {
+			sendEvent(UIEvent(UIEventType::MakeAreaVisibleCentered, getId(), getOptionRect(curOption)));
+		}
+		firstUpdate = false;
+	}
+
+	updateRows();
+}
+
+void UIVirtualList::doSetState(State state)
+{
+}
+
+float UIVirtualList::getStride() const
+{
+	return rowHeight + gap;
+}
+
+std::optional<int> UIVirtualList::getOptionAt(Vector2f mousePos) const
+{
+	const float y = mousePos.y - getPosition().y - getInnerBorder().y;
+	if (y < 0 || getStride() <= 0) {
+		return std::nullopt;
+	}
+	const int option = int(y / getStride());
+	if (option >= int(count) || y - option * getStride() > rowHeight) {
+		return std::nullopt;
+	}
+	return option;
+}
+
+Range<int> UIVirtualList::getVisibleRange() const
+{
+	if (count == 0 || getStride() <= 0) {
+		return {};
+	}
+
+	// Without a clip area (i.e. not inside a scroll pane), every row is visible
+	const auto rect = getRect();
+	const auto& clip = getMouseClip();
+	const auto visible = clip ? rect.intersection(clip.value()) : rect;
+	if (visible.getHeight() <= 0) {
+		return {};
+	}
+
+	const float top = rect.getTop() + getInnerBorder().y;
+	const int start = clamp(int(std::floor((visible.getTop() - top) / getStride())), 0, int(count));
+	const int end = clamp(int(std::ceil((visible.getBottom() - top) / getStride())), start, int(count));
+	return Range<int>(start, end);
+}
+
+void UIVirtualList::updateRows()
+{
+	const auto range = getVisibleRange();
+	const int n = range.end - range.start;
+
+	while (int(rows.size()) < n) {
+		auto row = std::make_shared<UIVirtualListRow>(*this, itemStyle);
+		add(row);
+		rows.push_back(std::move(row));
+	}
+
+	// Each index always maps to the same row widget, so scrolling by one row only rebinds one widget
+	const auto border = getInnerBorder();
+	const auto origin = getPosition() + Vector2f(border.x, border.y);
+	const float width = getSize().x - border.x - border.z;
+	for (int i = range.start; i < range.end; ++i) {
+		auto& row = *rows[i % rows.size()];
+		row.setData(i, revision);
+		row.setState(selectedIds.find(row.getId()) != selectedIds.end(), i == curHover);
+		row.setActive(true);
+		row.setRect(Rect4f(origin + Vector2f(0, i * getStride()), width, rowHeight), nullptr);
+	}
+
+	for (auto& row: rows) {
+		if (row->getIndex() < range.start || row->getIndex() >= range.end) {
+			row->setActive(false);
+		}
+	}
+
+	firstVisible = range.start;
+	lastVisible = range.end;
+}
+
+bool UIVirtualList::changeSelection(int option, SelectionMode mode)
+{
+	if (!source->isEnabled(option)) {
+		return false;
+	}
+	if (!multiSelect) {
+		mode = SelectionMode::Normal;
+	}
+
+	auto id = source->getId(option);
+	bool changed = false;
+	bool moveCursor = true;
+
+	switch (mode) {
+	case SelectionMode::Normal:
+		changed = selectedIds.size() != 1 || selectedIds.find(id) == selectedIds.end();
+		selectedIds.clear();
+		selectedIds.insert(id);
+		break;
+
+	case SelectionMode::AddToSelect:
+		changed = selectedIds.insert(id).second;
+		break;
+
+	case SelectionMode::CtrlSelect:
+		if (selectedIds.erase(id) > 0) {
+			moveCursor = false;
+			if (selectedIds.empty() && requiresSelection) {
+				selectedIds.insert(id);
+			} else if (curOption == option) {
+				const auto sels = getSelectedOptions();
+				if (!sels.empty()) {
+					curOption = sels.front();
+					curOptionId = source->getId(curOption);
+				}
+			}
+		} else {
+			selectedIds.insert(id);
+		}
+		changed = true;
+		break;
+
+	case SelectionMode::ShiftSelect:
+		{
+			// The current option is the anchor, so it stays put
+			const int anchor = curOption >= 0 ? curOption : option;
+			selectedIds.clear();
+			for (int i = std::min(anchor, option); i <= std::max(anchor, option); ++i) {
+				if (source->isEnabled(i)) {
+					selectedIds.insert(source->getId(i));
+				}
+			}
+			moveCursor = curOption < 0;
+			changed = true;
+		}
+		break;
+	}
+
+	if (moveCursor && curOption != option) {
+		curOption = option;
+		curOptionId = std::move(id);
+		changed = true;
+	}
+
+	if (changed) {
+		notifyNewItemSelected();
+	}
+	return changed;
+}
+
+void UIVirtualList::moveSelection(int delta, KeyMods mods)
+{
+	if (count == 0 || delta == 0) {
+		return;
+	}
+
+	const bool shift = (static_cast<int>(mods) & static_cast<int>(KeyMods::Shift)) != 0;
+	const int target = clamp(curOption + delta, 0, int(count) - 1);
+	if (shift && multiSelect) {
+		// Keep the anchor, only the far end of the range moves
+		const auto sels = getSelectedOptions();
+		const int anchor = curOption;
+		const int far = sels.empty() ? curOption : (sels.front() == anchor ? sels.back() : sels.front());
+		const int newFar = clamp(far + delta, 0, int(count) - 1);
+		changeSelection(newFar, SelectionMode::ShiftSelect);
+		sendEvent(UIEvent(UIEventType::MakeAreaVisible, getId(), getOptionRect(newFar)));
+	} else {
+		setSelectedOption(target);
+	}
+}
+
+void UIVirtualList::notifyNewItemSelected()
+{
+	playStyleSound("selectionChangedSound");
+
+	const auto& itemId = getSelectedOptionId();
+	sendEvent(UIEvent(UIEventType::ListSelectionChanged, getId(), itemId, curOption));
+	if (scrollToSelection) {
+		sendEvent(UIEvent(UIEventType::MakeAreaVisible, getId(), getOptionRect(curOption)));
+	}
+
+	if (getDataBindFormat() == UIDataBind::Format::String) {
+		notifyDataBind(itemId);
+	} else {
+		notifyDataBind(curOption);
+	}
+}
+
+void UIVirtualList::setHovered(int option)
+{
+	if (option != curHover) {
+		curHover = option;
+		if (option >= 0) {
+			sendEvent(UIEvent(UIEventType::ListHoveredChanged, getId(), source->getId(option), option));
+			playStyleSound("hoverSound");
+		} else {
+			sendEvent(UIEvent(UIEventType::ListHoveredChanged, getId(), String(), -1));
+		}
+	}
+}
+
+void UIVirtualList::dragTo(int option)
+{
+	while (heldOption != option) {
+		const int next = heldOption + (option > heldOption ? 1 : -1);
+		if (!source->swapItems(heldOption, next)) {
+			break;
+		}
+
+		if (curOption == heldOption) {
+			curOption = next;
+		} else if (curOption == next) {
+			curOption = heldOption;
+		}
+		sendEvent(UIEvent(UIEventType::ListItemsSwapped, getId(), heldOption, next));
+		heldOption = next;
+		++revision;
+	}
+
+	sendEvent(UIEvent(UIEventType::MakeAreaVisibleContinuous, getId(), getOptionRect(heldOption)));
+}
+
+void UIVirtualList::onAccept()
+{
+	playStyleSound("acceptSound");
+	sendEvent(UIEvent(UIEventType::ListAccept, getId(), getSelectedOptionId(), curOption));
+}
+
+void UIVirtualList::onCancel()
+{
+	playStyleSound("cancelSound");
+	sendEvent(UIEvent(UIEventType::ListCancel, getId(), getSelectedOptionId(), curOption));
+}
+
+UIVirtualList::SelectionMode UIVirtualList::getMode(KeyMods mods) const
+{
+	const bool shiftHeld = (static_cast<int>(mods) & static_cast<int>(KeyMods::Shift)) != 0;
+	const bool ctrlHeld = (static_cast<int>(mods) & static_cast<int>(KeyMods::Ctrl)) != 0;
+	return shiftHeld ? SelectionMode::ShiftSelect : (ctrlHeld ? SelectionMode::CtrlSelect : SelectionMode::Normal);
+}
+
+void UIVirtualList::pressMouse(Vector2f mousePos, int button, KeyMods keyMods)
+{
+	UIClickable::pressMouse(mousePos, button, keyMods);
+
+	heldOption = -1;
+	deferredSelect = false;
+	dragging = false;
+
+	const auto option = getOptionAt(mousePos);
+	if (!option) {
+		if (button == 0) {
+			sendEvent(UIEvent(UIEventType::ListBackgroundLeftClicked, getId()));
+		} else if (button == 1) {
+			sendEvent(UIEvent(UIEventType::ListBackgroundMiddleClicked, getId()));
+		} else if (button == 2) {
+			sendEvent(UIEvent(UIEventType::ListBackgroundRightClicked, getId()));
+		}
+		return;
+	}
+	if (!isEnabled()) {
+		return;
+	}
+	const auto id = source->getId(option.value());
+
+	if (button == 0 || !singleClickAccept) {
+		const auto mode = button == 0 ? getMode(keyMods) : SelectionMode::Normal;
+
+		// If you click an item that's already selected, that doesn't cause any changes until release. This is important for dragging.
+		if (mode != SelectionMode::Normal || !isSelected(option.value())) {
+			setSelectedOption(option.value(), mode);
+		} else {
+			deferredSelect = true;
+		}
+	}
+
+	if (button == 0) {
+		heldOption = option.value();
+		heldMods = keyMods;
+		mouseStartPos = mousePos;
+		sendEvent(UIEvent(UIEventType::ListItemLeftClicked, getId(), id, curOption));
+		if (singleClickAccept) {
+			onAccept();
+		}
+	} else if (button == 1) {
+		sendEvent(UIEvent(UIEventType::ListItemMiddleClicked, getId(), id, curOption));
+	} else if (button == 2) {
+		sendEvent(UIEvent(UIEventType::ListItemRightClicked, getId(), id, curOption));
+	}
+	focus();
+}
+
+void UIVirtualList::releaseMouse(Vector2f mousePos, int button)
+{
+	UIClickable::releaseMouse(mousePos, button);
+
+	if (button == 0) {
+		if (deferredSelect && !dragging && heldOption >= 0) {
+			setSelectedOption(heldOption, SelectionMode::Normal);
+		}
+		heldOption = -1;
+		deferredSelect = false;
+		dragging = false;
+	}
+}
+
+void UIVirtualList::onMouseOver(Vector2f mousePos)
+{
+	const auto option = getOptionAt(mousePos);
+	setHovered(option.value_or(-1));
+
+	if (dragEnabled && heldOption >= 0 && heldMods == KeyMods::None) {
+		if (!dragging && (mousePos - mouseStartPos).length() > 3.0f) {
+			dragging = true;
+		}
+		if (dragging && count > 0) {
+			const float y = mousePos.y - getPosition().y - getInnerBorder().y;
+			dragTo(clamp(int(std::floor(y / getStride())), 0, int(count) - 1));
+		}
+	}
+}
+
+void UIVirtualList::onMouseLeft(Vector2f mousePos)
+{
+	setHovered(-1);
+}
+
+void UIVirtualList::onDoubleClicked(Vector2f mousePos, KeyMods keyMods)
+{
+	const auto option = getOptionAt(mousePos);
+	if (option && keyMods == KeyMods::None) {
+		setSelectedOption(option.value());
+		onAccept();
+	}
+}
+
+void UIVirtualList::onGamepadInput(const UIInputResults& input, Time time)
+{
+	if (count == 0) {
+		return;
+	}
+
+	if (input.isButtonPressed(UIGamepadInput::Button::Next)) {
+		setSelectedOption(modulo(curOption + 1, int(count)));
+	}
+	if (input.isButtonPressed(UIGamepadInput::Button::Prev)) {
+		setSelectedOption(modulo(curOption - 1, int(count)));
+	}
+	moveSelection(input.getAxisRepeat(UIGamepadInput::Axis::Y), KeyMods::None);
+
+	if (input.isButtonPressed(UIGamepadInput::Button::Accept)) {
+		onAccept();
+	}
+	if (input.isButtonPressed(UIGamepadInput::Button::Cancel)) {
+		onCancel();
+	}
+}
+
+bool UIVirtualList::onKeyPress(KeyboardKeyPress key)
+{
+	if (!acceptKeyboardInput) {
+		return false;
+	}
+
+	const int pageSize = std::max(1, lastVisible - firstVisible - 1);
+	const auto mods = static_cast<KeyMods>(static_cast<int>(key.mod) & static_cast<int>(KeyMods::Shift));
+
+	if (key.is(KeyCode::Up, mods)) {
+		moveSelection(-1, mods);
+		return true;
+	}
+	if (key.is(KeyCode::Down, mods)) {
+		moveSelection(1, mods);
+		return true;
+	}
+	if (key.is(KeyCode::PageUp, mods)) {
+		moveSelection(-pageSize, mods);
+		return true;
+	}
+	if (key.is(KeyCode::PageDown, mods)) {
+		moveSelection(pageSize, mods);
+		return true;
+	}
+	if (key.is(KeyCode::Home, mods)) {
+		moveSelection(-int(count), mods);
+		return true;
+	}
+	if (key.is(KeyCode::End, mods)) {
+		moveSelection(int(count), mods);
+		return true;
+	}
+	if (key.is(KeyCode::Enter)) {
+		onAccept();
+		return true;
+	}
+
+	return false;
+}
+
+
+UIVirtualListRow::UIVirtualListRow(UIVirtualList& parent, UIStyle style)
+	: UIWidget("", {}, UISizer(UISizerType::Horizontal, parent.style.getFloat("iconGap", 4)), style.getBorder("innerBorder"))
+	, parent(parent)
+	, style(style)
+	, baseBorder(style.getBorder("innerBorder"))
+{
+	const auto& listStyle = parent.style;
+
+	icon = std::make_shared<UIImage>(Sprite());
+	icon->setActive(false);
+	add(icon, 0, {}, UISizerAlignFlags::Centre);
+
+	label = std::make_shared<UILabel>("", listStyle, LocalisedString());
+	if (listStyle.hasTextRenderer("selectedLabel")) {
+		label->setSelectable(listStyle.getTextRenderer("label"), listStyle.getTextRenderer("selectedLabel"));
+	}
+	if (listStyle.hasTextRenderer("hoveredLabel")) {
+		label->setHoverable(listStyle.getTextRenderer("label"), listStyle.getTextRenderer("hoveredLabel"));
+	}
+	if (listStyle.hasTextRenderer("disabledLabel")) {
+		label->setDisablable(listStyle.getTextRenderer("label"), listStyle.getTextRenderer("disabledLabel"));
+	}
+	add(label, 1, {}, UISizerAlignFlags::CentreVertical);
+
+	sprite = style.getSprite("normal");
+}
+
+void UIVirtualListRow::setData(int idx, uint32_t rev)
+{
+	if (idx == index && rev == revision) {
+		return;
+	}
+	index = idx;
+	revision = rev;
+
+	const auto& source = *parent.source;
+	setId(source.getId(idx));
+	label->setText(source.getLabel(idx));
+
+	auto iconSprite = source.getIcon(idx);
+	icon->setActive(iconSprite.hasMaterial());
+	icon->setSprite(std::move(iconSprite));
+
+	const float indent = float(source.getDepth(idx)) * parent.style.getFloat("indentSize", 16);
+	setInnerBorder(baseBorder + Vector4f(indent, 0, 0, 0));
+
+	if (enabled != source.isEnabled(idx)) {
+		enabled = !enabled;
+		label->setEnabled(enabled);
+	}
+	updateSprite();
+}
+
+void UIVirtualListRow::setState(bool s, bool h)
+{
+	if (s != selected) {
+		selected = s;
+		sendEventDown(UIEvent(UIEventType::SetSelected, getId(), selected));
+		updateSprite();
+	}
+	if (h != hovered) {
+		hovered = h;
+		sendEventDown(UIEvent(UIEventType::SetHovered, getId(), hovered, selected));
+		updateSprite();
+	}
+}
+
+int UIVirtualListRow::getIndex() const
+{
+	return index;
+}
+
+void UIVirtualListRow::draw(UIPainter& painter) const
+{
+	if (sprite.hasMaterial()) {
+		painter.draw(sprite);
+	}
+}
+
+void UIVirtualListRow::update(Time t, bool moved)
+{
+	if (moved && sprite.hasMaterial()) {
+		sprite.scaleTo(getSize()).setPos(getPosition());
+	}
+}
+
+void UIVirtualListRow::updateSprite()
+{
+	if (selected && style.hasSprite("selected")) {
+		sprite = style.getSprite("selected");
+	} else if (!enabled && style.hasSprite("disabled")) {
+		sprite = style.getSprite("disabled");
+	} else if (hovered) {
+		sprite = style.getSprite("hover");
+	} else {
+		sprite = style.getSprite("normal");
+	}
+	if (sprite.hasMaterial()) {
+		sprite.scaleTo(getSize()).setPos(getPosition());
+	}
+}
@@ -40,7 +40,12 @@ public:
 		if (getSessionService().isMultiplayer() && isHost()) {
 			// Check for stale locks (e.g. from disconnects)
 			for (const auto& e: networkFamily) {
-				std_ex::erase_if_value(e.network.locks, [&](uint8_t peerId) { return !isPeerPresent(peerId); });
+				const auto isStale = [&](uint8_t peerId) { return !isPeerPresent(peerId); };
+				if (std_ex::contains_if(e.network.getLocks(), [&](const auto& lock) { return isStale(lock.second); })) {
+					auto locks = e.network.getLocks();
+					std_ex::erase_if_value(locks, isStale);
+					e.network.setLocks(std::move(locks));
+				}
 			}
 		}
 	}
@@ -48,8 +53,9 @@ public:
 	LockStatus getLockStatus(EntityId targetId) const override
 	{
 		if (const NetworkFamily* e = getRootEntity(targetId)) {
-			const auto iter = std_ex::find_if(e->network.locks, [&](const auto& e) { return e.first == targetId; });
-			if (iter != e->network.locks.end()) {
+			const auto& locks = e->network.getLocks();
+			const auto iter = std_ex::find_if(locks, [&](const auto& e) { return e.first == targetId; });
+			if (iter != locks.end()) {
 				return iter->second == getMyPeerId() ? LockStatus::AcquiredByMe : LockStatus::AcquiredByOther;
 			}
 		} else {
@@ -62,8 +68,9 @@ public:
 	bool isLockedByOrAvailableTo(EntityId playerId, EntityId targetId) const override
 	{
 		if (const NetworkFamily* e = getRootEntity(targetId)) {
-			const auto iter = std_ex::find_if(e->network.locks, [&](const auto& e) { return e.first == targetId; });
-			if (iter != e->network.locks.end()) {
+			const auto& locks = e->network.getLocks();
+			const auto iter = std_ex::find_if(locks, [&](const auto& e) { return e.first == targetId; });
+			if (iter != locks.end()) {
 				if (const NetworkFamily* playerEntity = getRootEntity(playerId)) {
 					const auto playerPeer = playerEntity->network.ownerId.value_or(0);
 					return iter->second == playerPeer;
@@ -198,14 +205,15 @@ private:
 
             //Logger::logDev("Peer " + toString(int(peerId)) + " attempts to " + (lock ? "lock" : "unlock") + " entity " + getWorld().getEntity(targetId).getName() + (withAuthority ? ", with authority" : ""));
 
-			auto& locks = e->network.locks;
-			const auto iter = std_ex::find_if(e->network.locks, [&](const auto& e) { return e.first == targetId; });
+			auto locks = e->network.getLocks();
+			const auto iter = std_ex::find_if(locks, [&](const auto& e) { return e.first == targetId; });
 
 			if (iter == locks.end()) {
 				// Unlocked
 				if (lock) {
 					//Logger::logDev("Entity " + getWorld().getEntity(targetId).getName() + " locked by " + toString(int(peerId)));
 					locks.emplace_back(targetId, peerId);
+					e->network.setLocks(std::move(locks));
                     if (withAuthority) {
                         changeAuthority(e->network, peerId);
                     }
@@ -217,6 +225,7 @@ private:
 					// Release lock
 					//Logger::logDev("Entity " + getWorld().getEntity(targetId).getName() + " unlocked by " + toString(int(peerId)));
 					locks.erase(iter);
+					e->network.setLocks(std::move(locks));
                     if (withAuthority) {
                         changeAuthority(e->network, {});
                     }
@@ -23,11 +23,9 @@ public:
 			const auto peerId = maybePeerId.value();
 
 			// Enable only network components which aren't nested in another
+			// Set directly to the final value, as flipping it back and forth would mark the component as changed every frame
 			for (auto& e: networkFamily) {
-				e.network.sendUpdates = true;
-			}
-			for (auto& e: networkFamily) {
-				disableSendUpdateForChildren(getWorld().getEntity(e.entityId));
+				e.network.setSendUpdates(!hasNetworkAncestor(getWorld().getEntity(e.entityId)));
 			}
 
 			entities.clear();
@@ -39,7 +37,7 @@ public:
 					e.network.ownerId = peerId;
 				}
 
-				if (e.network.sendUpdates && (e.network.ownerId == peerId || mpSession.isHost())) {
+				if (e.network.getSendUpdates() && (e.network.ownerId == peerId || mpSession.isHost())) {
 					entities.emplace_back(EntityNetworkUpdateInfo{ e.entityId, e.network.ownerId.value() });
 				}
 
@@ -56,15 +54,14 @@ public:
 private:
 	Vector<EntityNetworkUpdateInfo> entities;
 
-	void disableSendUpdateForChildren(EntityRef entity)
+	bool hasNetworkAncestor(EntityRef entity)
 	{
-		for (auto c: entity.getChildren()) {
-			if (auto* network = c.tryGetComponent<NetworkComponent>()) {
-				network->sendUpdates = false;
+		for (auto parent = entity.tryGetParent(); parent; parent = parent->tryGetParent()) {
+			if (parent->tryGetComponent<NetworkComponent>()) {
+				return true;
 			}
-
-			disableSendUpdateForChildren(c);
 		}
+		return false;
 	}
 };
 
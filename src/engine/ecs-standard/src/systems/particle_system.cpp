@@ -20,14 +20,33 @@ public:
 
 	void update(Time t)
 	{
+		// Transforms and the other emitters aren't safe to touch from workers, so only the simulation itself runs in parallel
+		emitters.clear();
 		for (auto& e: particleFamily) {
 			auto& particles = e.particles.particles;
 			particles.setPosition(Vector3f(e.transform2D.getGlobalPosition(), e.transform2D.getGlobalHeight()));
 			particles.setSecondarySpawner(this);
+			emitters.push_back({ &e, {} });
+		}
+
+		Concurrent::parallelFor(emitters.size(), [&] (size_t i)
+		{
+			auto& emitter = emitters[i];
+			auto& particles = emitter.entity->particles.particles;
 			particles.update(t);
+			emitter.aabb = particles.getAABB();
+		});
+
+		flushPendingSpawns();
 
-			if (const auto aabb = particles.getAABB(); aabb && getScreenService().isVisible(*aabb)) {
-				particles.updateSprites(t);
+		visibleEmitters.clear();
+		for (auto& emitter: emitters) {
+			auto& e = *emitter.entity;
+			auto& particles = e.particles.particles;
+			const bool visible = isVisible(e, emitter.aabb);
+			particles.setVisible(visible);
+			if (visible) {
+				visibleEmitters.push_back(&particles);
 			}
 
 			if (!particles.isAlive() && !particles.isEnabled() && !getWorld().isEditor()) {
@@ -35,6 +54,11 @@ public:
 			}
 		}
 
+		Concurrent::parallelFor(visibleEmitters.size(), [&] (size_t i)
+		{
+			visibleEmitters[i]->updateSprites(t);
+		});
+
 		editorDebugDraw();
 	}
 
@@ -44,14 +68,52 @@ public:
 	}
 
 	void spawn(Vector3f pos, EntityId target) override
+	{
+		// Called from the workers, spawned once they're done
+		std::unique_lock<std::mutex> lock(pendingSpawnsMutex);
+		pendingSpawns.emplace_back(pos, target);
+	}
+
+private:
+	struct Emitter {
+		ParticleFamily* entity;
+		std::optional<Rect4f> aabb;
+	};
+
+	Vector<Emitter> emitters;
+	Vector<Particles*> visibleEmitters;
+	Vector<std::pair<Vector3f, EntityId>> pendingSpawns;
+	std::mutex pendingSpawnsMutex;
+
+	bool isVisible(const ParticleFamily& e, const std::optional<Rect4f>& aabb)
+	{
+		if (aabb && getScreenService().isVisible(*aabb)) {
+			return true;
+		}
+
+		// Emitters that aren't simulated off screen have stale particles, so also check whether new ones would show up
+		const auto& particles = e.particles.particles;
+		if (particles.getOffscreenUpdate() != ParticleOffscreenUpdate::Always) {
+			const auto pos = e.transform2D.getGlobalPosition();
+			const auto halfArea = particles.getSpawnArea() * 0.5f;
+			return getScreenService().isVisible(Rect4f(pos - halfArea, pos + halfArea));
+		}
+		return false;
+	}
+
+	void flushPendingSpawns()
 	{
 		// TODO: this could be a perf bottleneck
-		if (auto* particles = particleFamily.tryFind(target)) {
-			particles->particles.particles.spawnAt(pos);
+		// Indexed, as spawning can queue up more spawns
+		for (size_t i = 0; i < pendingSpawns.size(); ++i) {
+			const auto [pos, target] = pendingSpawns[i];
+			if (auto* particles = particleFamily.tryFind(target)) {
+				particles->particles.particles.spawnAt(pos);
+			}
 		}
+		pendingSpawns.clear();
 	}
 
-private:
 	void refreshParticles(ParticleFamily& e)
 	{
 		auto& particles = e.particles.particles;
@@ -214,7 +214,12 @@ public:
 	}
 
 private:
+	constexpr static size_t maxWorkers = 8;
+	constexpr static size_t minEntitiesPerWorker = 16;
+
 	Vector<std::pair<EntityId, ScriptMessage>> pendingMessages;
+	Vector<std::unique_ptr<ScriptEnvironment>> workers;
+	Vector<ScriptableFamily*> entityLocalEntities;
 
 	void initializeEnvironment()
 	{
@@ -281,7 +286,11 @@ private:
 		auto& env = getScriptingService().getEnvironment();
 		for (auto& e : scriptableFamily) {
 			e.scriptable.activeStates.terminateMarkedDead(env, e.entityId, e.scriptable.variables);
+		}
+
+		updateEntityLocalScripts(t);
 
+		for (auto& e : scriptableFamily) {
 			for (auto& state: e.scriptable.activeStates) {
 				if (!state->getFrameFlag()) {
 					env.update(t, *state, e.entityId, e.scriptable.variables);
@@ -297,6 +306,82 @@ private:
 		}
 	}
 
+	bool canUpdateOnWorker(const ScriptState& state) const
+	{
+		// Starting a state, or restarting it because its graph changed, can run nodes from outside the current graph, so that's left to the main thread
+		const auto* graph = state.getScriptGraphPtr();
+		return state.hasStarted() && state.getGraphHash() == graph->getHash() && graph->isEntityLocal(getScriptingService().getEnvironment().getNodeTypeCollection());
+	}
+
+	template <typename F>
+	void forEachWorkerState(ScriptableFamily& e, F f) const
+	{
+		// Only the pending states before the first one that can't go on a worker, so each entity's states still update in order
+		for (auto& state: e.scriptable.activeStates) {
+			if (state->getFrameFlag()) {
+				continue;
+			}
+			if (!canUpdateOnWorker(*state)) {
+				return;
+			}
+			f(*state);
+		}
+	}
+
+	void updateEntityLocalScripts(Time t)
+	{
+		// Entity-local scripts can't see anything outside of their own entity, so each worker takes a contiguous run of entities.
+		// Everything else is left for the serial update that follows.
+		auto& env = getScriptingService().getEnvironment();
+
+		entityLocalEntities.clear();
+		for (auto& e: scriptableFamily) {
+			// Checks the same states the workers will, so their graphs get their types assigned here, before the workers read them
+			bool any = false;
+			forEachWorkerState(e, [&] (ScriptState&) { any = true; });
+			if (any) {
+				entityLocalEntities.push_back(&e);
+			}
+		}
+
+		const size_t nWorkers = std::min(maxWorkers, entityLocalEntities.size() / minEntitiesPerWorker);
+		if (nWorkers < 2) {
+			return;
+		}
+
+		while (workers.size() < nWorkers) {
+			auto worker = env.makeWorker();
+			if (!worker) {
+				// This environment can't run on workers, update everything serially
+				return;
+			}
+			workers.push_back(std::move(worker));
+		}
+		for (size_t i = 0; i < nWorkers; ++i) {
+			env.prepareWorker(*workers[i]);
+		}
+
+		ProfilerEvent event(ProfilerEventType::ScriptUpdate, "entity-local scripts");
+		Concurrent::parallelFor(nWorkers, [&] (size_t workerIdx)
+		{
+			auto& worker = *workers[workerIdx];
+			const size_t start = entityLocalEntities.size() * workerIdx / nWorkers;
+			const size_t end = entityLocalEntities.size() * (workerIdx + 1) / nWorkers;
+			for (size_t i = start; i < end; ++i) {
+				auto& e = *entityLocalEntities[i];
+				forEachWorkerState(e, [&] (ScriptState& state)
+				{
+					worker.update(t, state, e.entityId, e.scriptable.variables);
+					state.setFrameFlag(true);
+				});
+			}
+		});
+
+		for (size_t i = 0; i < nWorkers; ++i) {
+			env.mergeWorker(*workers[i]);
+		}
+	}
+
 	void eraseDeadScripts(ScriptableFamily& e)
 	{
 		e.scriptable.activeStates.removeDeadLocalStates(getWorld(), e.entityId);
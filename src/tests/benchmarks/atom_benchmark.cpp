@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include <iostream>
+using namespace Halley;
+
+TEST(AtomBenchmark, HashMapLookup)
+{
+	constexpr int nKeys = 256;
+	constexpr int nLookups = 1000000;
+
+	Vector<String> keys;
+	Vector<Atom> atoms;
+	HashMap<String, int> stringMap;
+	HashMap<Atom, int> atomMap;
+	for (int i = 0; i < nKeys; ++i) {
+		keys.push_back("script_variable_name_" + toString(i));
+		atoms.emplace_back(keys.back());
+		stringMap[keys.back()] = i;
+		atomMap[atoms.back()] = i;
+	}
+
+	// Best of a few runs, as single runs of this size are noisy
+	auto run = [&] (auto&& map, auto&& lookupKeys)
+	{
+		int64_t best = std::numeric_limits<int64_t>::max();
+		for (int attempt = 0; attempt < 5; ++attempt) {
+			int64_t total = 0;
+			Stopwatch timer;
+			for (int i = 0; i < nLookups; ++i) {
+				total += map.find(lookupKeys[i % nKeys])->second;
+			}
+			timer.pause();
+			best = std::min(best, timer.elapsedNanoseconds());
+			EXPECT_EQ(total, int64_t(nLookups / nKeys) * (nKeys * (nKeys - 1) / 2) + int64_t(nLookups % nKeys) * (nLookups % nKeys - 1) / 2);
+		}
+		return double(best) / nLookups;
+	};
+
+	const auto stringTime = run(stringMap, keys);
+	const auto viewTime = run(atomMap, keys);
+	const auto atomTime = run(atomMap, atoms);
+
+	std::cout << "HashMap lookup: String " << toString(stringTime, 2) << " ns, Atom by String " << toString(viewTime, 2) << " ns, Atom " << toString(atomTime, 2) << " ns" << std::endl;
+}
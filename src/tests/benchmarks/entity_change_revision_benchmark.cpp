@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include <iostream>
+#include "test_world.h"
+using namespace Halley;
+using namespace Halley::Test;
+
+TEST(EntityChangeRevisionBenchmark, IdleEntities1K)
+{
+	constexpr int entityCount = 1000;
+	constexpr int frames = 100;
+
+	TestWorld testWorld;
+	auto& world = testWorld.getWorld();
+	EntityFactory factory(world, testWorld.getResources());
+
+	Vector<EntityId> ids;
+	for (int i = 0; i < entityCount; ++i) {
+		const auto id = world.createEntity("entity_" + toString(i))
+			.addComponent(Transform2DComponent(Vector2f(float(i), 0)))
+			.getEntityId();
+		world.createEntity("child", id)
+			.addComponent(Transform2DComponent(Vector2f(0, 1)));
+		ids.push_back(id);
+	}
+	world.spawnPending();
+
+	Vector<EntityRef> entities;
+	for (const auto id: ids) {
+		entities.push_back(world.getEntity(id));
+	}
+
+	EntityFactory::SerializationOptions options;
+	options.type = EntitySerialization::Type::Network;
+
+	// Baseline: what updates did for entities that haven't changed, serializing them and finding an empty delta
+	int64_t serializeTime = 0;
+	{
+		Vector<EntityData> lastSent;
+		for (auto& entity: entities) {
+			lastSent.push_back(factory.serializeEntity(entity, options));
+		}
+		bool changed = false;
+		Stopwatch timer;
+		for (int frame = 0; frame < frames; ++frame) {
+			for (int i = 0; i < entityCount; ++i) {
+				changed = EntityDataDelta(lastSent[i], factory.serializeEntity(entities[i], options)).hasChange() || changed;
+			}
+		}
+		serializeTime = timer.elapsedNanoseconds();
+		EXPECT_FALSE(changed);
+	}
+
+	int64_t revisionTime = 0;
+	{
+		Vector<std::optional<uint64_t>> lastSent;
+		for (auto& entity: entities) {
+			lastSent.push_back(entity.getChangeRevision());
+			ASSERT_TRUE(lastSent.back().has_value());
+		}
+		bool changed = false;
+		Stopwatch timer;
+		for (int frame = 0; frame < frames; ++frame) {
+			for (int i = 0; i < entityCount; ++i) {
+				changed = entities[i].getChangeRevision() != lastSent[i] || changed;
+			}
+		}
+		revisionTime = timer.elapsedNanoseconds();
+		EXPECT_FALSE(changed);
+	}
+
+	auto ms = [] (int64_t ns) { return toString(double(ns) / 1000000.0, 2) + " ms"; };
+	std::cout << entityCount << " idle entities (with one child each) x" << frames << " frames" << std::endl;
+	std::cout << "serialize + EntityDataDelta: " << ms(serializeTime) << ", change revision: " << ms(revisionTime) << std::endl;
+}
+
+TEST(EntityChangeRevisionBenchmark, PartlyTrackedEntities1K)
+{
+	constexpr int entityCount = 1000;
+	constexpr int frames = 100;
+
+	TestWorld testWorld;
+	auto& world = testWorld.getWorld();
+	EntityFactory factory(world, testWorld.getResources());
+
+	// Velocity doesn't track its changes, so these entities never have a change revision as a whole
+	Vector<EntityId> ids;
+	for (int i = 0; i < entityCount; ++i) {
+		const auto id = world.createEntity("entity_" + toString(i))
+			.addComponent(Transform2DComponent(Vector2f(float(i), 0)))
+			.addComponent(VelocityComponent(Vector2f(1, 0)))
+			.getEntityId();
+		world.createEntity("child", id)
+			.addComponent(Transform2DComponent(Vector2f(0, 1)));
+		ids.push_back(id);
+	}
+	world.spawnPending();
+
+	Vector<EntityRef> entities;
+	for (const auto id: ids) {
+		entities.push_back(world.getEntity(id));
+	}
+
+	EntityFactory::SerializationOptions options;
+	options.type = EntitySerialization::Type::Network;
+
+	int64_t serializeTime = 0;
+	{
+		Vector<EntityData> lastSent;
+		for (auto& entity: entities) {
+			lastSent.push_back(factory.serializeEntity(entity, options));
+		}
+		bool changed = false;
+		Stopwatch timer;
+		for (int frame = 0; frame < frames; ++frame) {
+			for (int i = 0; i < entityCount; ++i) {
+				changed = EntityDataDelta(lastSent[i], factory.serializeEntity(entities[i], options)).hasChange() || changed;
+			}
+		}
+		serializeTime = timer.elapsedNanoseconds();
+		EXPECT_FALSE(changed);
+	}
+
+	// What per-component tracking could save on these: unchanged tracked components copied from the last sent data instead of serialized
+	int64_t reuseTime = 0;
+	{
+		HashMap<std::pair<EntityId, int>, std::pair<uint32_t, ConfigNode>> sentComponents;
+		auto reuseOptions = options;
+		reuseOptions.serializeComponent = [&] (EntityRef entity, int componentId, const Component& component, const std::function<ConfigNode()>& serialize)
+		{
+			const auto revision = world.getReflection().getComponentReflector(componentId).getChangeRevision(component);
+			if (!revision) {
+				return serialize();
+			}
+			auto& sent = sentComponents[{ entity.getEntityId(), componentId }];
+			if (sent.first != *revision || sent.second.getType() == ConfigNodeType::Undefined) {
+				sent = { *revision, serialize() };
+			}
+			return ConfigNode(sent.second);
+		};
+
+		Vector<EntityData> lastSent;
+		for (auto& entity: entities) {
+			lastSent.push_back(factory.serializeEntity(entity, reuseOptions));
+		}
+		bool changed = false;
+		Stopwatch timer;
+		for (int frame = 0; frame < frames; ++frame) {
+			for (int i = 0; i < entityCount; ++i) {
+				changed = EntityDataDelta(lastSent[i], factory.serializeEntity(entities[i], reuseOptions)).hasChange() || changed;
+			}
+		}
+		reuseTime = timer.elapsedNanoseconds();
+		EXPECT_FALSE(changed);
+	}
+
+	auto ms = [] (int64_t ns) { return toString(double(ns) / 1000000.0, 2) + " ms"; };
+	std::cout << entityCount << " idle entities with an untracked component (with one child each) x" << frames << " frames" << std::endl;
+	std::cout << "serialize + EntityDataDelta: " << ms(serializeTime) << ", reusing tracked components: " << ms(reuseTime) << std::endl;
+}
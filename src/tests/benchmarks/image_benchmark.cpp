@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include <iostream>
+#include "test_threads.h"
+#include "test_images.h"
+using namespace Halley;
+using namespace Halley::Test;
+
+TEST(ImageBenchmark, Atlas4K)
+{
+	setupThreads();
+
+	const auto atlas = makeAtlas(Vector2i(4096, 4096), 200);
+	auto measure = [] (auto&& f)
+	{
+		Stopwatch timer;
+		f();
+		return timer.elapsedNanoseconds();
+	};
+
+	Bytes bytes;
+	const auto encodeTime = measure([&] { bytes = atlas->saveHLIFToBytes("atlas", false); });
+
+	Image decoded;
+	const auto decodeTime = measure([&] { decoded = Image(bytes.byte_span(), Image::Format::RGBA); });
+	expectSamePixels(*atlas, decoded);
+
+	const auto preMultiplyTime = measure([&] { decoded.preMultiply(); });
+	const auto flipTime = measure([&] { decoded.flipVertically(); });
+
+	Image dst(Image::Format::RGBA, Vector2i(4096, 4096));
+	const auto blitTime = measure([&] { dst.blitFrom(Vector2i(), decoded); });
+
+	Image half(Image::Format::RGBA, Vector2i(2048, 2048));
+	const auto downsampleTime = measure([&] { half.blitDownsampled(dst, 2); });
+
+	auto ms = [] (int64_t ns) { return toString(double(ns) / 1000000.0, 2) + " ms"; };
+	std::cout << "4K atlas (" << String::prettySize(bytes.size()) << " HLIF): encode " << ms(encodeTime) << ", decode " << ms(decodeTime)
+		<< ", premultiply " << ms(preMultiplyTime) << ", flip " << ms(flipTime) << ", blit " << ms(blitTime) << ", downsample " << ms(downsampleTime) << std::endl;
+}
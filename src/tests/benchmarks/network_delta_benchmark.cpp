@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include <iostream>
+#include "halley/entity/ecs_reflection_impl.h"
+#include "components/velocity_component.h"
+using namespace Halley;
+
+TEST(NetworkDeltaBenchmark, Velocity1K)
+{
+	constexpr int entityCount = 1000;
+	constexpr int frames = 100;
+
+	SerializerOptions options;
+	options.version = SerializerOptions::maxVersion;
+	EntitySerializationContext context;
+	context.entitySerializationTypeMask = EntitySerialization::makeMask(EntitySerialization::Type::Network);
+	const ComponentReflectorImpl<VelocityComponent> reflector;
+
+	Vector<UUID> uuids;
+	Vector<VelocityComponent> velocities(entityCount);
+	for (int i = 0; i < entityCount; ++i) {
+		uuids.push_back(UUID::generate());
+		velocities[i].velocity = Vector2f(float(i), float(-i));
+	}
+	auto step = [&] (int frame)
+	{
+		for (int i = 0; i < entityCount; ++i) {
+			velocities[i].velocity += Vector2f(0.25f, float(frame % 3));
+		}
+	};
+	auto makeData = [&] (int i)
+	{
+		EntityData data(uuids[i]);
+		data.setComponents({ { VelocityComponent::componentName, velocities[i].serialize(context) } });
+		return data;
+	};
+
+	// Baseline: what entity updates did before, serializing to EntityData and sending an EntityDataDelta of it
+	size_t configBytes = 0;
+	int64_t configTime = 0;
+	{
+		Vector<EntityData> lastSent;
+		for (int i = 0; i < entityCount; ++i) {
+			lastSent.push_back(makeData(i));
+		}
+		for (int frame = 0; frame < frames; ++frame) {
+			step(frame);
+			Stopwatch timer;
+			for (int i = 0; i < entityCount; ++i) {
+				auto newData = makeData(i);
+				configBytes += Serializer::toBytes(EntityDataDelta(lastSent[i], newData), options).size();
+				lastSent[i] = std::move(newData);
+			}
+			configTime += timer.elapsedNanoseconds();
+		}
+	}
+
+	size_t binaryBytes = 0;
+	int64_t binaryTime = 0;
+	{
+		Vector<std::shared_ptr<Component>> snapshots;
+		for (int i = 0; i < entityCount; ++i) {
+			snapshots.push_back(reflector.makeNetworkDeltaSnapshot(velocities[i]));
+		}
+		for (int frame = 0; frame < frames; ++frame) {
+			step(frame);
+			Stopwatch timer;
+			for (int i = 0; i < entityCount; ++i) {
+				if (const auto mask = reflector.getNetworkDeltaMask(velocities[i], *snapshots[i]); mask != 0) {
+					binaryBytes += Serializer::toBytes([&] (Serializer& s)
+					{
+						s << uint32_t(1);
+						s << VelocityComponent::componentIndex;
+						reflector.serializeNetworkDelta(s, velocities[i], *snapshots[i], mask);
+					}, options).size();
+				}
+			}
+			binaryTime += timer.elapsedNanoseconds();
+		}
+	}
+
+	EXPECT_LT(binaryBytes, configBytes);
+
+	auto ms = [] (int64_t ns) { return toString(double(ns) / 1000000.0, 2) + " ms"; };
+	std::cout << entityCount << " Velocity updates x" << frames << " frames" << std::endl;
+	std::cout << "EntityDataDelta: " << String::prettySize(configBytes) << ", " << ms(configTime) << std::endl;
+	std::cout << "binary delta: " << String::prettySize(binaryBytes) << ", " << ms(binaryTime) << std::endl;
+}
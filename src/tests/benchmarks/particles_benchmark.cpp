@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include <iostream>
+#include "test_world.h"
+using namespace Halley;
+using namespace Halley::Test;
+
+namespace {
+	Particles makeParticles(float spawnRate, std::optional<float> gridCellSize)
+	{
+		static TestWorld world;
+		ConfigNode node = ConfigNode::MapType();
+		node["spawnRate"] = spawnRate;
+		node["ttl"] = 1.0f;
+		node["speed"] = ConfigNode(Vector<float>{ 10.0f, 30.0f });
+		node["azimuth"] = ConfigNode(Vector<float>{ 0.0f, 360.0f });
+		node["spawnArea"] = Vector2f(400, 400);
+
+		Particles particles(node, world.getResources(), EntitySerializationContext());
+		Sprite base;
+		base.setMaterial(std::make_shared<Material>(std::make_shared<MaterialDefinition>())).setSize(Vector2f(4, 4));
+		particles.setSprites({ base });
+		particles.setOverlapGridCellSize(gridCellSize);
+		particles.setRandomSeed(1);
+		return particles;
+	}
+}
+
+TEST(ParticlesBenchmark, DestroyOverlapping)
+{
+	constexpr Time frameTime = 1.0 / 60.0;
+	constexpr int nFrames = 200;
+
+	for (const float spawnRate: { 500.0f, 2000.0f, 8000.0f }) {
+		for (const int queries: { 1, 4, 16 }) {
+			auto runFrames = [&] (std::optional<float> gridCellSize)
+			{
+				auto particles = makeParticles(spawnRate, gridCellSize);
+				for (int i = 0; i < 60; ++i) {
+					particles.update(frameTime);
+				}
+
+				Random rng(uint64_t(2));
+				int64_t queryTime = 0;
+				for (int frame = 0; frame < nFrames; ++frame) {
+					particles.update(frameTime);
+
+					// Small shapes, like bullets hitting smoke, so the particle count stays about the same
+					Stopwatch timer(false);
+					timer.start();
+					for (int i = 0; i < queries; ++i) {
+						particles.destroyOverlapping(Circle(Vector2f(rng.getFloat(-200, 200), rng.getFloat(-200, 200)), 4));
+					}
+					timer.pause();
+					queryTime += timer.elapsedNanoseconds();
+				}
+				return queryTime / nFrames;
+			};
+
+			const auto linearTime = runFrames(std::nullopt);
+			const auto gridTime = runFrames(8.0f);
+
+			auto us = [] (int64_t ns) { return toString(double(ns) / 1000.0, 1) + " us"; };
+			std::cout << int(spawnRate) << " particles, " << queries << " queries per frame: linear " << us(linearTime) << "/frame, grid " << us(gridTime) << "/frame" << std::endl;
+		}
+	}
+}
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include <iostream>
+using namespace Halley;
+
+TEST(SerializerBenchmark, EntityData10K)
+{
+	Vector<EntityData> entities;
+	entities.reserve(10000);
+	for (int i = 0; i < 10000; ++i) {
+		auto& entity = entities.emplace_back(UUID::generate());
+		entity.setName("entity_" + toString(i));
+
+		ConfigNode::MapType transform;
+		transform["position"] = Vector2f(float(i), float(i * 2));
+		transform["rotation"] = float(i) * 0.1f;
+		ConfigNode::MapType sprite;
+		sprite["image"] = "sprites/image_" + toString(i % 100) + ".png";
+		sprite["layer"] = i % 8;
+		entity.setComponents({ { "Transform2D", ConfigNode(std::move(transform)) }, { "SpriteComponent", ConfigNode(std::move(sprite)) } });
+	}
+
+	constexpr int iterations = 10;
+	auto measure = [&] (auto&& f)
+	{
+		Stopwatch timer;
+		for (int i = 0; i < iterations; ++i) {
+			f();
+		}
+		return timer.elapsedNanoseconds() / iterations;
+	};
+
+	// Baseline: dry run to measure, then serialize into an exact-size buffer
+	size_t size = 0;
+	const auto twoPassTime = measure([&]
+	{
+		Bytes twoPass(Serializer::getSize(entities));
+		auto s = Serializer(twoPass.byte_span(), SerializerOptions());
+		s << entities;
+		size = twoPass.size();
+	});
+
+	const auto singlePassTime = measure([&]
+	{
+		const auto bytes = Serializer::toBytes(entities);
+		EXPECT_EQ(size, bytes.size());
+	});
+
+	const auto pooledTime = measure([&]
+	{
+		SerializerBufferPool::release(Serializer::toPooledBytes(entities, {}, OutboundNetworkPacket::headerSpace));
+	});
+
+	auto ms = [] (int64_t ns) { return toString(double(ns) / 1000000.0, 2) + " ms"; };
+	std::cout << "10k EntityData (" << String::prettySize(size) << "): two-pass " << ms(twoPassTime) << ", single-pass " << ms(singlePassTime) << ", pooled " << ms(pooledTime) << std::endl;
+}
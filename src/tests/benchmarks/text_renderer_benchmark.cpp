@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include <iostream>
+#include "test_threads.h"
+#include "test_text.h"
+using namespace Halley;
+using namespace Halley::Test;
+
+TEST(TextRendererBenchmark, BatchedSprites)
+{
+	setupThreads();
+	const auto font = makeTextFont();
+
+	for (const size_t n: { 16, 64, 256, 1024, 4096 }) {
+		auto serial = makeTextRenderers(font, n);
+		auto batched = makeTextRenderers(font, n);
+
+		// Every renderer changes every frame, so both paths do the same amount of work
+		const int nFrames = int(std::max(size_t(20), 40000 / n));
+		auto runFrames = [&] (Vector<TextRenderer>& texts, bool batch)
+		{
+			Stopwatch timer(false);
+			timer.start();
+			for (int frame = 0; frame < nFrames; ++frame) {
+				for (size_t i = 0; i < texts.size(); ++i) {
+					texts[i].setText(toString(frame * 1000 + int(i)));
+				}
+				if (batch) {
+					TextRenderer::generateSprites(texts);
+				} else {
+					for (const auto& text: texts) {
+						text.generateSprites();
+					}
+				}
+			}
+			timer.pause();
+			return timer.elapsedNanoseconds() / nFrames;
+		};
+
+		const auto serialTime = runFrames(serial, false);
+		const auto batchedTime = runFrames(batched, true);
+
+		auto us = [] (int64_t ns) { return toString(double(ns) / 1000.0, 1) + " us"; };
+		std::cout << n << " text renderers (" << Executors::getCPU().threadCount() << " CPU threads, parallel above " << TextRenderer::minParallelBatchSize << "): serial "
+			<< us(serialTime) << "/frame, batched " << us(batchedTime) << "/frame" << std::endl;
+	}
+}
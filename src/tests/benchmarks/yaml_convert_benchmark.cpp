@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include <filesystem>
+#include <iostream>
+#include "test_yaml.h"
+using namespace Halley;
+using namespace Halley::Test;
+
+TEST(YAMLConvertBenchmark, SharedAssets)
+{
+	Vector<String> files;
+	size_t totalSize = 0;
+	for (const auto& entry: std::filesystem::recursive_directory_iterator(HALLEY_TESTS_SHARED_ASSETS_DIR)) {
+		const auto ext = entry.path().extension();
+		if (entry.is_regular_file() && (ext == ".yaml" || ext == ".prefab" || ext == ".scene")) {
+			const auto bytes = Path::readFile(Path(entry.path().string()));
+			files.push_back(String(reinterpret_cast<const char*>(bytes.data()), bytes.size()));
+			totalSize += bytes.size();
+		}
+	}
+	ASSERT_FALSE(files.empty());
+
+	constexpr int iterations = 20;
+	auto measure = [&] (auto&& f)
+	{
+		Stopwatch timer;
+		for (int i = 0; i < iterations; ++i) {
+			for (size_t j = 0; j < files.size(); ++j) {
+				f(j);
+			}
+		}
+		return timer.elapsedNanoseconds();
+	};
+
+	// Baseline: yaml-cpp's node tree and YAML::Emitter
+	Vector<ConfigNode> parsed(files.size());
+	const auto referenceParseTime = measure([&] (size_t j) { parsed[j] = ReferenceYAMLEmitter::parseConfig(files[j]); });
+	const auto parseTime = measure([&] (size_t j) { parsed[j] = YAMLConvert::parseConfig(files[j]); });
+
+	Vector<String> emitted(files.size());
+	const auto referenceEmitTime = measure([&] (size_t j) { emitted[j] = ReferenceYAMLEmitter::generateYAML(parsed[j]); });
+	const auto emitTime = measure([&] (size_t j) { emitted[j] = YAMLConvert::generateYAML(parsed[j]); });
+
+	for (size_t j = 0; j < files.size(); ++j) {
+		EXPECT_TRUE(YAMLConvert::parseConfig(emitted[j]) == parsed[j]);
+	}
+
+	auto ms = [] (int64_t ns) { return toString(double(ns) / 1000000.0, 2) + " ms"; };
+	std::cout << files.size() << " shared_assets YAML files (" << String::prettySize(totalSize) << ") x" << iterations << std::endl;
+	std::cout << "parse: yaml-cpp nodes " << ms(referenceParseTime) << ", events " << ms(parseTime) << std::endl;
+	std::cout << "emit: YAML::Emitter " << ms(referenceEmitTime) << ", direct " << ms(emitTime) << std::endl;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <halley.hpp>
+
+namespace Halley::Test {
+	// Looks like a sprite atlas: flat coloured sprites with soft edges, over transparent padding
+	inline std::unique_ptr<Image> makeAtlas(Vector2i size, int nColours)
+	{
+		auto img = std::make_unique<Image>(Image::Format::RGBA, size);
+		auto px = img->getPixels4BPP();
+		for (int y = 0; y < size.y; ++y) {
+			for (int x = 0; x < size.x; ++x) {
+				const int cellX = x % 64;
+				const int cellY = y % 64;
+				if (cellX < 4 || cellY < 4) {
+					continue;
+				}
+				const auto colour = static_cast<unsigned int>((x / 64 * 7 + y / 64 * 13) % nColours) * 0x010305u;
+				const auto alpha = static_cast<unsigned int>(std::min(255, std::min(cellX, cellY) * 40));
+				px[x + y * size.x] = static_cast<int>(Image::convertRGBAToInt(colour & 0xFF, (colour >> 8) & 0xFF, (colour >> 16) & 0xFF, alpha));
+			}
+		}
+		return img;
+	}
+
+	inline void expectSamePixels(const Image& a, const Image& b)
+	{
+		ASSERT_EQ(a.getSize(), b.getSize());
+		ASSERT_EQ(a.getFormat(), b.getFormat());
+		const auto n = size_t(a.getWidth()) * a.getHeight() * a.getBytesPerPixel();
+		EXPECT_EQ(0, memcmp(a.getPixelBytes().data(), b.getPixelBytes().data(), n));
+	}
+}
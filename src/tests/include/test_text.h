@@ -0,0 +1,32 @@
+#pragma once
+
+#include <halley.hpp>
+
+namespace Halley::Test {
+	// A fixed width font covering ASCII, with no texture
+	inline std::shared_ptr<Font> makeTextFont(const String& name = "test")
+	{
+		auto font = std::make_shared<Font>(name, "test.png", 10, 12, 12, 1, Vector2i(256, 256));
+		font->setMaterial(std::make_shared<Material>(std::make_shared<MaterialDefinition>()));
+		for (int c = 0; c < 128; ++c) {
+			font->addGlyph(Font::Glyph(c, Rect4f(0, 0, 1, 1), Vector2f(6, 10), Vector2f(), Vector2f(), Vector2f(7, 0), {}));
+		}
+		return font;
+	}
+
+	// Lots of short strings, like damage numbers or name plates
+	inline Vector<TextRenderer> makeTextRenderers(const std::shared_ptr<Font>& font, size_t n)
+	{
+		Vector<TextRenderer> result;
+		result.reserve(n);
+		for (size_t i = 0; i < n; ++i) {
+			auto& text = result.emplace_back();
+			text.setFont(font)
+				.setSize(12)
+				.setText("Player " + toString(i) + " took " + toString(i * 37 % 1000) + " damage")
+				.setPosition(Vector2f(float(i % 64) * 20.0f, float(i / 64) * 14.0f))
+				.setAlignment(0.5f);
+		}
+		return result;
+	}
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <halley.hpp>
+#include <thread>
+
+namespace Halley::Test {
+	// Installs CPU thread pools for the rest of the test run, so parallel code paths actually run in parallel
+	inline void setupThreads()
+	{
+		struct Threads {
+			Executors executors;
+			std::unique_ptr<ThreadPool> pool;
+			std::unique_ptr<ThreadPool> auxPool;
+
+			Threads()
+			{
+				Executors::setInstance(executors);
+				const auto makeThread = [] (String, std::function<void()> f)
+				{
+					return std::thread(std::move(f));
+				};
+				pool = std::make_unique<ThreadPool>("CPU", executors.getCPU(), std::max(2u, std::thread::hardware_concurrency()), makeThread);
+				auxPool = std::make_unique<ThreadPool>("CPUAux", executors.getCPUAux(), 2, makeThread);
+			}
+		};
+		static Threads threads;
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/game/frame_data.h"
+#include "test_text.h"
+
+namespace Halley::Test {
+	// A UIRoot with fonts and a style sheet, but no window, input devices or renderer
+	// The only font is "Ubuntu Bold" (the style sheet default), which is fixed width: each glyph advances 7
+	class TestUI {
+	public:
+		explicit TestUI(std::string_view styleYAML, Vector2f size = Vector2f(800, 600))
+		{
+			api.input = &input;
+			resources = std::make_unique<Resources>(std::unique_ptr<ResourceLocator>(), api, ResourceOptions());
+			resources->init<Font>();
+			resources->of<Font>().setResource(0, "Ubuntu Bold", makeTextFont("Ubuntu Bold"));
+
+			styleFile = std::make_unique<ConfigFile>(YAMLConvert::parseConfig(String(styleYAML)));
+			styleFile->setAssetId("test_style");
+			styleSheet = std::make_shared<UIStyleSheet>(*resources, *styleFile, std::make_shared<UIColourScheme>());
+
+			BaseFrameData::setThreadFrameData(&frameData);
+			root = std::make_unique<UIRoot>(api, Rect4f(Vector2f(), size));
+		}
+
+		~TestUI()
+		{
+			root.reset();
+			BaseFrameData::setThreadFrameData(nullptr);
+		}
+
+		UIRoot& getRoot() { return *root; }
+		UIStyle getStyle(const String& name) const { return UIStyle(name, styleSheet); }
+
+		void update(Time t = 0.016)
+		{
+			root->update(t, UIInputType::Mouse, {}, {});
+		}
+
+		// Draws into a sprite painter that is never rendered, and returns what the root reports about it
+		const UIRenderStats& draw()
+		{
+			painter.startFrame();
+			root->draw(painter, 1, 0);
+			return root->getRenderStats();
+		}
+
+	private:
+		class Input final : public InputAPI {
+		public:
+			size_t getNumberOfKeyboards() const override { return 0; }
+			std::shared_ptr<InputKeyboard> getKeyboard(int id) const override { return {}; }
+			size_t getNumberOfJoysticks() const override { return 0; }
+			std::shared_ptr<InputDevice> getJoystick(int id) const override { return {}; }
+			size_t getNumberOfMice() const override { return 0; }
+			std::shared_ptr<InputDevice> getMouse(int id) const override { return {}; }
+			Vector<std::shared_ptr<InputTouch>> getNewTouchEvents() override { return {}; }
+			Vector<std::shared_ptr<InputTouch>> getTouchEvents() override { return {}; }
+			void setMouseRemapping(std::function<Vector2f(Vector2i)> remapFunction) override {}
+		};
+
+		Input input;
+		HalleyAPI api{};
+		std::unique_ptr<Resources> resources;
+		std::unique_ptr<ConfigFile> styleFile;
+		std::shared_ptr<UIStyleSheet> styleSheet;
+		BaseFrameData frameData;
+		std::unique_ptr<UIRoot> root;
+		SpritePainter painter;
+	};
+}
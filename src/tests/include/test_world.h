@@ -0,0 +1,235 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/entity/components/transform_2d_component.h"
+#include "halley/entity/ecs_reflection_impl.h"
+#include "halley/entity/world_reflection.h"
+#include "components/velocity_component.h"
+
+// Written the same way codegen writes components: a component holding a reference to another entity, resolved by UUID
+class TestLinkComponent final : public Halley::Component {
+public:
+	static constexpr int componentIndex{ 2 };
+	static const constexpr char* componentName{ "TestLink" };
+
+	Halley::EntityId target{};
+	int value{};
+
+	TestLinkComponent() {
+	}
+
+	Halley::ConfigNode serialize(const Halley::EntitySerializationContext& _context) const {
+		using namespace Halley::EntitySerialization;
+		Halley::ConfigNode _node = Halley::ConfigNode::MapType();
+		Halley::EntityConfigNodeSerializer<decltype(target)>::serialize(target, Halley::EntityId{}, _context, _node, componentName, "target", makeMask(Type::Prefab, Type::SaveData, Type::Network));
+		Halley::EntityConfigNodeSerializer<decltype(value)>::serialize(value, int{}, _context, _node, componentName, "value", makeMask(Type::Prefab, Type::SaveData, Type::Network));
+		return _node;
+	}
+
+	void deserialize(const Halley::EntitySerializationContext& _context, const Halley::ConfigNode& _node) {
+		using namespace Halley::EntitySerialization;
+		Halley::EntityConfigNodeSerializer<decltype(target)>::deserialize(target, Halley::EntityId{}, _context, _node, componentName, "target", makeMask(Type::Prefab, Type::SaveData, Type::Network));
+		Halley::EntityConfigNodeSerializer<decltype(value)>::deserialize(value, int{}, _context, _node, componentName, "value", makeMask(Type::Prefab, Type::SaveData, Type::Network));
+	}
+
+	static void sanitize(Halley::ConfigNode& _node, int _mask) {
+		using namespace Halley::EntitySerialization;
+		if ((_mask & makeMask(Type::Prefab, Type::SaveData, Type::Network)) == 0) _node.removeKey("target");
+		if ((_mask & makeMask(Type::Prefab, Type::SaveData, Type::Network)) == 0) _node.removeKey("value");
+	}
+
+	Halley::ConfigNode serializeField(const Halley::EntitySerializationContext& _context, std::string_view _fieldName) const {
+		if (_fieldName == "target") {
+			return Halley::ConfigNodeHelper<decltype(target)>::serialize(target, _context);
+		}
+		if (_fieldName == "value") {
+			return Halley::ConfigNodeHelper<decltype(value)>::serialize(value, _context);
+		}
+		throw Halley::Exception("Unknown or non-serializable field \"" + Halley::String(_fieldName) + "\"", Halley::HalleyExceptions::Entity);
+	}
+
+	void deserializeField(const Halley::EntitySerializationContext& _context, std::string_view _fieldName, const Halley::ConfigNode& _node) {
+		if (_fieldName == "target") {
+			Halley::ConfigNodeHelper<decltype(target)>::deserialize(target, _context, _node);
+			return;
+		}
+		if (_fieldName == "value") {
+			Halley::ConfigNodeHelper<decltype(value)>::deserialize(value, _context, _node);
+			return;
+		}
+		throw Halley::Exception("Unknown or non-serializable field \"" + Halley::String(_fieldName) + "\"", Halley::HalleyExceptions::Entity);
+	}
+
+	void* operator new(std::size_t size, std::align_val_t align) {
+		return doNew<TestLinkComponent>(size, align);
+	}
+
+	void* operator new(std::size_t size) {
+		return doNew<TestLinkComponent>(size);
+	}
+
+	void operator delete(void* ptr) {
+		return doDelete<TestLinkComponent>(ptr);
+	}
+};
+
+// Written the same way codegen writes trackChanges components: the field is private, and every write bumps the change revision
+class TestCounterComponent final : public Halley::Component {
+public:
+	static constexpr int componentIndex{ 3 };
+	static const constexpr char* componentName{ "TestCounter" };
+
+	TestCounterComponent() {
+	}
+
+	TestCounterComponent(int count)
+		: count(std::move(count))
+	{
+	}
+
+	Halley::ConfigNode serialize(const Halley::EntitySerializationContext& _context) const {
+		using namespace Halley::EntitySerialization;
+		Halley::ConfigNode _node = Halley::ConfigNode::MapType();
+		Halley::EntityConfigNodeSerializer<decltype(count)>::serialize(count, int{}, _context, _node, componentName, "count", makeMask(Type::Prefab, Type::SaveData, Type::Network));
+		return _node;
+	}
+
+	void deserialize(const Halley::EntitySerializationContext& _context, const Halley::ConfigNode& _node) {
+		using namespace Halley::EntitySerialization;
+		Halley::EntityConfigNodeSerializer<decltype(count)>::deserialize(count, int{}, _context, _node, componentName, "count", makeMask(Type::Prefab, Type::SaveData, Type::Network));
+		++changeRevision;
+	}
+
+	static void sanitize(Halley::ConfigNode& _node, int _mask) {
+		using namespace Halley::EntitySerialization;
+		if ((_mask & makeMask(Type::Prefab, Type::SaveData, Type::Network)) == 0) _node.removeKey("count");
+	}
+
+	Halley::ConfigNode serializeField(const Halley::EntitySerializationContext& _context, std::string_view _fieldName) const {
+		if (_fieldName == "count") {
+			return Halley::ConfigNodeHelper<decltype(count)>::serialize(count, _context);
+		}
+		throw Halley::Exception("Unknown or non-serializable field \"" + Halley::String(_fieldName) + "\"", Halley::HalleyExceptions::Entity);
+	}
+
+	void deserializeField(const Halley::EntitySerializationContext& _context, std::string_view _fieldName, const Halley::ConfigNode& _node) {
+		if (_fieldName == "count") {
+			Halley::ConfigNodeHelper<decltype(count)>::deserialize(count, _context, _node);
+			++changeRevision;
+			return;
+		}
+		throw Halley::Exception("Unknown or non-serializable field \"" + Halley::String(_fieldName) + "\"", Halley::HalleyExceptions::Entity);
+	}
+
+	uint32_t getChangeRevision() const {
+		return changeRevision;
+	}
+
+	void markChanged() {
+		++changeRevision;
+	}
+
+	const int& getCount() const {
+		return count;
+	}
+
+	void setCount(int value) {
+		if (!(count == value)) {
+			count = std::move(value);
+			++changeRevision;
+		}
+	}
+
+	void* operator new(std::size_t size, std::align_val_t align) {
+		return doNew<TestCounterComponent>(size, align);
+	}
+
+	void* operator new(std::size_t size) {
+		return doNew<TestCounterComponent>(size);
+	}
+
+	void operator delete(void* ptr) {
+		return doDelete<TestCounterComponent>(ptr);
+	}
+
+private:
+	int count{};
+
+	uint32_t changeRevision{ 0 };
+};
+
+namespace Halley::Test {
+	// A World with no systems, no video/audio and no asset packs, for testing entity code headlessly.
+	// Knows the Transform2D, Velocity, TestLink and TestCounter components, and prefabs are added directly to its resources.
+	class TestWorld {
+	public:
+		TestWorld()
+		{
+			api.core = &core;
+			resources = std::make_unique<Resources>(std::unique_ptr<ResourceLocator>(), api, ResourceOptions());
+			resources->init<Prefab>();
+
+			Codegen codegen;
+			world = std::make_unique<World>(api, *resources, std::make_shared<WorldReflection>(codegen));
+		}
+
+		const HalleyAPI& getAPI() const { return api; }
+		World& getWorld() { return *world; }
+		Resources& getResources() { return *resources; }
+
+		std::shared_ptr<Prefab> addPrefab(const String& id, std::string_view yaml)
+		{
+			auto prefab = std::make_shared<Prefab>();
+			prefab->parseYAML(gsl::as_bytes(gsl::span<const char>(yaml.data(), yaml.size())));
+			prefab->setAssetId(id);
+			resources->of<Prefab>().setResource(0, id, prefab);
+			return prefab;
+		}
+
+	private:
+		class Core final : public CoreAPI {
+		public:
+			void quit(int) override {}
+			void setStage(StageID) override {}
+			void setStage(std::unique_ptr<Stage>) override {}
+			void initStage(Stage&) override {}
+			Stage& getCurrentStage() override { throw Exception("No stage in tests", HalleyExceptions::Core); }
+			HalleyStatics& getStatics() override { throw Exception("No statics in tests", HalleyExceptions::Core); }
+			const Environment& getEnvironment() override { return environment; }
+			void addProfilerCallback(IProfileCallback*) override {}
+			void removeProfilerCallback(IProfileCallback*) override {}
+			void addStartFrameCallback(IStartFrameCallback*) override {}
+			void removeStartFrameCallback(IStartFrameCallback*) override {}
+			Future<std::unique_ptr<RenderSnapshot>> requestRenderSnapshot() override { return {}; }
+			bool isDevMode() override { return false; }
+			DevConClient* getDevConClient() const override { return nullptr; }
+
+		private:
+			Environment environment;
+		};
+
+		class Codegen final : public CodegenFunctions {
+		public:
+			Vector<SystemReflector> makeSystemReflectors() override { return {}; }
+			Vector<std::unique_ptr<MessageReflector>> makeMessageReflectors() override { return {}; }
+			Vector<std::unique_ptr<SystemMessageReflector>> makeSystemMessageReflectors() override { return {}; }
+
+			Vector<std::unique_ptr<ComponentReflector>> makeComponentReflectors() override
+			{
+				// Indexed by componentIndex
+				Vector<std::unique_ptr<ComponentReflector>> result;
+				result.push_back(std::make_unique<ComponentReflectorImpl<Transform2DComponent>>());
+				result.push_back(std::make_unique<ComponentReflectorImpl<VelocityComponent>>());
+				result.push_back(std::make_unique<ComponentReflectorImpl<TestLinkComponent>>());
+				result.push_back(std::make_unique<ComponentReflectorImpl<TestCounterComponent>>());
+				return result;
+			}
+		};
+
+		Core core;
+		HalleyAPI api{};
+		std::unique_ptr<Resources> resources;
+		std::unique_ptr<World> world;
+	};
+}
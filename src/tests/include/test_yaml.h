@@ -0,0 +1,179 @@
+#pragma once
+
+#include <halley.hpp>
+#include "halley/file_formats/halley-yamlcpp.h"
+
+namespace Halley::Test {
+	// The YAML::Emitter based writer that YAMLConvert::generateYAML used to be, kept as a reference for its output
+	class ReferenceYAMLEmitter {
+	public:
+		static String generateYAML(const ConfigNode& node, const YAMLConvert::EmitOptions& options = {})
+		{
+			YAML::Emitter emitter;
+			emitNode(node, emitter, options);
+			if (!emitter.good()) {
+				throw Exception("Error generating YAML: " + emitter.GetLastError(), HalleyExceptions::Tools);
+			}
+			return emitter.c_str();
+		}
+
+		static ConfigNode parseConfig(const String& yaml)
+		{
+			return YAMLConvert::parseYAMLNode(YAML::Load(yaml.cppStr()));
+		}
+
+	private:
+		static void emitNode(const ConfigNode& node, YAML::Emitter& emitter, const YAMLConvert::EmitOptions& options)
+		{
+			switch (node.getType()) {
+			case ConfigNodeType::Int:
+				emitter << node.asInt();
+				return;
+
+			case ConfigNodeType::Int64:
+				emitter << node.asInt64();
+				return;
+
+			case ConfigNodeType::Bool:
+				emitter << node.asBool();
+				return;
+
+			case ConfigNodeType::Int2:
+				{
+					const auto vec = node.asVector2i();
+					emitter << YAML::Flow << YAML::BeginSeq << vec.x << vec.y << YAML::EndSeq;
+				}
+				return;
+
+			case ConfigNodeType::Float:
+				emitter << node.asFloat();
+				return;
+
+			case ConfigNodeType::Float2:
+				{
+					const auto vec = node.asVector2f();
+					emitter << YAML::Flow << YAML::BeginSeq << vec.x << vec.y << YAML::EndSeq;
+				}
+				return;
+
+			case ConfigNodeType::Sequence:
+			case ConfigNodeType::DeltaSequence:
+				emitSequence(node, emitter, options);
+				return;
+
+			case ConfigNodeType::Map:
+			case ConfigNodeType::DeltaMap:
+				emitMap(node, emitter, options);
+				return;
+
+			case ConfigNodeType::String:
+				emitter << node.asString().cppStr();
+				return;
+
+			case ConfigNodeType::Bytes:
+				emitter << YAML::Binary(node.asBytes().data(), node.asBytes().size());
+				return;
+
+			case ConfigNodeType::Noop:
+				emitter << "<noop>";
+				return;
+
+			case ConfigNodeType::Del:
+				emitter << "<del>";
+				return;
+
+			default:
+				emitter << YAML::Null;
+			}
+		}
+
+		static void emitSequence(const ConfigNode& node, YAML::Emitter& emitter, const YAMLConvert::EmitOptions& options)
+		{
+			if (isCompactSequence(node, 0, options)) {
+				emitter << YAML::Flow;
+			}
+
+			emitter << YAML::BeginSeq;
+			for (auto& n: node.asSequence()) {
+				emitNode(n, emitter, options);
+			}
+			emitter << YAML::EndSeq;
+		}
+
+		static void emitMap(const ConfigNode& node, YAML::Emitter& emitter, const YAMLConvert::EmitOptions& options)
+		{
+			const auto& map = node.asMap();
+
+			Vector<String> keys;
+			keys.reserve(map.size());
+			for (auto& kv: map) {
+				if (kv.second.getType() != ConfigNodeType::Undefined) {
+					keys.push_back(kv.first);
+				}
+			}
+
+			std::sort(keys.begin(), keys.end(), [&] (const String& a, const String& b)
+			{
+				const auto& mko = options.mapKeyOrder;
+				const auto idxA = std::find(mko.begin(), mko.end(), a);
+				const auto idxB = std::find(mko.begin(), mko.end(), b);
+				if (idxA != idxB) {
+					return idxA < idxB;
+				}
+				return a < b;
+			});
+
+			if (isCompactSequence(node, 0, options)) {
+				emitter << YAML::Flow;
+			}
+			emitter << YAML::BeginMap;
+			for (const auto& k: keys) {
+				emitter << YAML::Key << k.cppStr();
+				emitter << YAML::Value;
+				emitNode(map.find(k)->second, emitter, options);
+			}
+			emitter << YAML::EndMap;
+		}
+
+		static bool isCompactSequence(const ConfigNode& node, int depth, const YAMLConvert::EmitOptions& options)
+		{
+			bool ok = true;
+
+			switch (node.getType()) {
+			case ConfigNodeType::Map:
+				if (node.asMap().empty()) {
+					return true;
+				}
+				if (!options.compactMaps || depth >= 2) {
+					return false;
+				}
+				for (auto& [k, v]: node.asMap()) {
+					ok = ok && isCompactSequence(v, depth + 1, options);
+				}
+				return ok;
+
+			case ConfigNodeType::Int:
+			case ConfigNodeType::Bool:
+			case ConfigNodeType::Float:
+			case ConfigNodeType::String:
+				return true;
+
+			case ConfigNodeType::Int2:
+			case ConfigNodeType::Float2:
+				return depth <= 2;
+
+			case ConfigNodeType::Sequence:
+				if (depth >= 2) {
+					return false;
+				}
+				for (auto& n: node.asSequence()) {
+					ok = ok && isCompactSequence(n, depth + 1, options);
+				}
+				return ok;
+
+			default:
+				return false;
+			}
+		}
+	};
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+using namespace Halley;
+
+namespace {
+	AssetDatabase makeDatabase(int n)
+	{
+		AssetDatabase db;
+		for (int i = 0; i < n; ++i) {
+			Metadata meta;
+			meta.set("index", i);
+			db.addAsset("sprite_" + toString(i), AssetType::Sprite, AssetDatabase::Entry(toString(i * 100) + ":" + toString(i + 1), meta));
+			db.addAsset("image_" + toString(i), AssetType::Image, AssetDatabase::Entry(toString(i * 200) + ":" + toString(i + 2), Metadata()));
+		}
+		return db;
+	}
+}
+
+TEST(AssetPackIndex, Lookup)
+{
+	for (const int n: { 0, 1, 7, 1000 }) {
+		const auto db = makeDatabase(n);
+		const auto index = AssetPackIndex(AssetPackIndex::build(db));
+		ASSERT_TRUE(index.isValid());
+		EXPECT_EQ(size_t(n * 2), index.size());
+
+		for (int i = 0; i < n; ++i) {
+			const auto* sprite = index.find(AssetType::Sprite, "sprite_" + toString(i));
+			ASSERT_NE(nullptr, sprite);
+			EXPECT_EQ(uint64_t(i * 100), sprite->dataPos);
+			EXPECT_EQ(uint64_t(i + 1), sprite->dataSize);
+			EXPECT_EQ("sprite_" + toString(i), String(index.getName(*sprite)));
+
+			const auto* image = index.find(AssetType::Image, "image_" + toString(i));
+			ASSERT_NE(nullptr, image);
+			EXPECT_EQ(uint64_t(i * 200), image->dataPos);
+		}
+
+		EXPECT_EQ(nullptr, index.find(AssetType::Sprite, "image_0"));
+		EXPECT_EQ(nullptr, index.find(AssetType::Image, "sprite_0"));
+		EXPECT_EQ(nullptr, index.find(AssetType::Sprite, "missing"));
+	}
+}
+
+TEST(AssetPackIndex, Metadata)
+{
+	const auto db = makeDatabase(50);
+	const auto index = AssetPackIndex(AssetPackIndex::build(db));
+
+	const auto* entry = index.find(AssetType::Sprite, "sprite_42");
+	ASSERT_NE(nullptr, entry);
+	Metadata meta;
+	auto s = Deserializer(index.getMetadataBytes(*entry));
+	s >> meta;
+	EXPECT_EQ(42, meta.getInt("index"));
+
+	const auto rebuilt = index.makeAssetDatabase();
+	EXPECT_EQ(db.getAssets().size(), rebuilt->getAssets().size());
+	EXPECT_EQ(db.getDatabase(AssetType::Sprite).get("sprite_7").path, rebuilt->getDatabase(AssetType::Sprite).get("sprite_7").path);
+	EXPECT_EQ(7, rebuilt->getDatabase(AssetType::Sprite).get("sprite_7").meta.getInt("index"));
+}
+
+TEST(AssetPackIndex, InvalidImage)
+{
+	EXPECT_FALSE(AssetPackIndex(Bytes(4, 0)).isValid());
+	EXPECT_FALSE(AssetPackIndex(Bytes(256, 0)).isValid());
+}
+
+TEST(AssetPackIndex, CorruptEntry)
+{
+	auto bytes = AssetPackIndex::build(makeDatabase(10));
+	AssetPackIndex::Header header;
+	memcpy(&header, bytes.data(), sizeof(header));
+
+	auto corrupt = [&] (auto&& f)
+	{
+		auto copy = bytes;
+		AssetPackIndex::Entry entry;
+		memcpy(&entry, copy.data() + header.entriesOffset, sizeof(entry));
+		f(entry);
+		memcpy(copy.data() + header.entriesOffset, &entry, sizeof(entry));
+		return copy;
+	};
+
+	const uint32_t blobSize = header.totalSize - header.blobOffset;
+	EXPECT_THROW(AssetPackIndex(corrupt([&] (AssetPackIndex::Entry& e) { e.nameOffset = blobSize; })), Exception);
+	EXPECT_THROW(AssetPackIndex(corrupt([&] (AssetPackIndex::Entry& e) { e.nameLength = blobSize + 1; })), Exception);
+	EXPECT_THROW(AssetPackIndex(corrupt([&] (AssetPackIndex::Entry& e) { e.metadataOffset = 0xFFFFFFF0; e.metadataSize = 0x20; })), Exception);
+	EXPECT_TRUE(AssetPackIndex(corrupt([] (AssetPackIndex::Entry&) {})).isValid());
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/scripting/script_variables.h"
+#include <thread>
+using namespace Halley;
+
+TEST(HalleyAtom, Interning)
+{
+	const auto a = Atom("hello");
+	const auto b = Atom(String("hel") + "lo");
+	const auto c = Atom("world");
+
+	EXPECT_EQ(a, b);
+	EXPECT_NE(a, c);
+	EXPECT_EQ(a.getString(), "hello");
+	EXPECT_EQ(a.getHash(), std::hash<String>()(String("hello")));
+	EXPECT_TRUE(Atom("").isEmpty());
+	EXPECT_EQ(Atom(""), Atom());
+	EXPECT_TRUE(a < c);
+}
+
+TEST(HalleyAtom, HeterogeneousLookup)
+{
+	HashMap<Atom, int> map;
+	map[Atom("foo")] = 1;
+	map[Atom("bar")] = 2;
+
+	EXPECT_EQ(map.find(std::string_view("foo"))->second, 1);
+	EXPECT_EQ(map.find(String("bar"))->second, 2);
+	EXPECT_EQ(map.find(Atom("bar"))->second, 2);
+	EXPECT_TRUE(map.find(std::string_view("baz")) == map.end());
+}
+
+TEST(HalleyAtom, Concurrent)
+{
+	constexpr int nThreads = 4;
+	constexpr int nAtoms = 2000;
+	Vector<Vector<Atom>> results(nThreads);
+	Vector<std::thread> threads;
+	for (int i = 0; i < nThreads; ++i) {
+		threads.emplace_back([&results, i] ()
+		{
+			for (int j = 0; j < nAtoms; ++j) {
+				results[i].push_back(Atom("concurrent_" + toString(j)));
+			}
+		});
+	}
+	for (auto& t: threads) {
+		t.join();
+	}
+
+	for (int i = 1; i < nThreads; ++i) {
+		EXPECT_TRUE(results[i] == results[0]);
+	}
+}
+
+TEST(HalleyAtom, TryFindDoesNotIntern)
+{
+	const auto a = Atom("try_find_interned");
+	const auto count = Atom::getInternedCount();
+
+	EXPECT_EQ(Atom::tryFind("try_find_interned"), a);
+	EXPECT_EQ(Atom::tryFind(""), Atom());
+	EXPECT_FALSE(Atom::tryFind("try_find_never_interned").has_value());
+	EXPECT_EQ(Atom::getInternedCount(), count);
+}
+
+TEST(HalleyAtom, ScriptVariablesDeltaDoesNotIntern)
+{
+	ScriptVariables variables;
+	variables.setVariable("atom_test_kept", ConfigNode(1));
+	variables.setVariable("atom_test_removed", ConfigNode(2));
+	const auto count = Atom::getInternedCount();
+
+	// A delta removing names this side never had, as a peer could send
+	ConfigNode::MapType from;
+	from["atom_test_kept"] = ConfigNode(1);
+	from["atom_test_removed"] = ConfigNode(2);
+	from["atom_test_unknown"] = ConfigNode(3);
+	from["entity!atom_test_unknown_entity"] = ConfigNode(4);
+	ConfigNode::MapType to;
+	to["atom_test_kept"] = ConfigNode(1);
+	const auto delta = ConfigNode::createDelta(ConfigNode(std::move(from)), ConfigNode(std::move(to)));
+	ASSERT_EQ(delta.getType(), ConfigNodeType::DeltaMap);
+	variables.load(delta, EntitySerializationContext());
+
+	EXPECT_EQ(Atom::getInternedCount(), count);
+	EXPECT_TRUE(variables.hasVariable("atom_test_kept"));
+	EXPECT_FALSE(variables.hasVariable("atom_test_removed"));
+	EXPECT_FALSE(Atom::tryFind("atom_test_unknown").has_value());
+}
+
+TEST(HalleyAtom, ScriptVariablesDontInternUnknownNames)
+{
+	const auto count = Atom::getInternedCount();
+
+	ConfigNode::MapType saved;
+	saved["atom_test_loaded"] = ConfigNode(5);
+	ScriptVariables variables(ConfigNode(std::move(saved)), EntitySerializationContext());
+	variables.setVariable(std::string_view("atom_test_set"), ConfigNode(6));
+
+	EXPECT_EQ(Atom::getInternedCount(), count);
+	EXPECT_EQ(5, variables.getVariable("atom_test_loaded").asInt());
+	EXPECT_EQ(6, variables.getVariable("atom_test_set").asInt());
+	EXPECT_EQ(6, variables.toConfigNode(EntitySerializationContext())["atom_test_set"].asInt());
+
+	// Interning the name later doesn't hide the value, or add a second copy of it
+	const auto atom = Atom("atom_test_set");
+	EXPECT_EQ(6, variables.getVariable(atom).asInt());
+	variables.setVariable(atom, ConfigNode(7));
+	EXPECT_EQ(7, variables.getVariable("atom_test_set").asInt());
+	EXPECT_EQ(2, variables.toConfigNode(EntitySerializationContext()).asMap().size());
+
+	variables.eraseVariable("atom_test_set");
+	variables.eraseVariable("atom_test_loaded");
+	EXPECT_TRUE(variables.empty());
+}
@@ -30,3 +30,117 @@ TEST(HalleyConfigNode, Sequence)
 	EXPECT_TRUE(node.getType() == ConfigNodeType::Sequence);
 	EXPECT_EQ(node.asSequence().size(), 1);
 }
+
+TEST(HalleyConfigNode, Frozen)
+{
+	ConfigNode original = ConfigNode::MapType();
+	original["name"] = "hero";
+	original["speed"] = 4.5f;
+	original["tags"] = ConfigNode::SequenceType();
+	original["tags"].asSequence().push_back(ConfigNode("fast"));
+	original["tags"].asSequence().push_back(ConfigNode("hero"));
+	original["stats"] = ConfigNode::MapType();
+	original["stats"]["hp"] = 10;
+
+	ConfigNode node = ConfigNode(original);
+	const auto arena = ConfigNodeArena::freeze(node);
+	ASSERT_TRUE(arena);
+	EXPECT_TRUE(node.isFrozen());
+
+	const ConfigNode& frozen = node;
+	EXPECT_TRUE(frozen.hasKey("stats"));
+	EXPECT_FALSE(frozen.hasKey("missing"));
+	EXPECT_EQ(frozen["name"].asString(), "hero");
+	EXPECT_EQ(frozen["name"].asStringView(), frozen["tags"][1].asStringView());
+	EXPECT_EQ(frozen["stats"]["hp"].asInt(), 10);
+	EXPECT_EQ(frozen["tags"].getSequenceSize(), 2);
+	EXPECT_EQ(frozen["tags"].asSequence()[0].asString(), "fast");
+	EXPECT_EQ(frozen.asMap().size(), 4);
+	EXPECT_TRUE(frozen == original);
+
+	ConfigNode copy(frozen["stats"]);
+	EXPECT_FALSE(copy.isFrozen());
+	EXPECT_EQ(copy["hp"].asInt(), 10);
+
+	node["stats"]["hp"] = 20;
+	EXPECT_FALSE(node.isFrozen());
+	EXPECT_EQ(node["stats"]["hp"].asInt(), 20);
+	EXPECT_EQ(node["tags"][0].asString(), "fast");
+}
+
+TEST(HalleyConfigNode, CompiledView)
+{
+	ConfigNode original = ConfigNode::MapType();
+	original["name"] = "hero";
+	original["speed"] = 4.5f;
+	original["id"] = int64_t(1) << 40;
+	original["size"] = Vector2i(3, 4);
+	original["tags"] = ConfigNode::SequenceType();
+	original["tags"].asSequence().push_back(ConfigNode("fast"));
+	original["tags"].asSequence().push_back(ConfigNode("hero"));
+	original["stats"] = ConfigNode::MapType();
+	original["stats"]["hp"] = 10;
+
+	const auto bytes = ConfigNodeView::compile(original);
+	ASSERT_TRUE(ConfigNodeView::isCompiled(gsl::as_bytes(gsl::span<const Byte>(bytes))));
+	const auto view = ConfigNodeView(gsl::as_bytes(gsl::span<const Byte>(bytes)));
+
+	EXPECT_EQ(view.getType(), ConfigNodeType::Map);
+	EXPECT_EQ(view.getMapSize(), 6);
+	EXPECT_EQ(view["name"].asStringView(), "hero");
+	EXPECT_EQ(view["speed"].asFloat(), 4.5f);
+	EXPECT_EQ(view["id"].asInt64(), int64_t(1) << 40);
+	EXPECT_EQ(view["size"].asVector2i(), Vector2i(3, 4));
+	EXPECT_EQ(view["stats"]["hp"].asInt(), 10);
+	EXPECT_EQ(view["stats"]["mp"].asInt(7), 7);
+	EXPECT_FALSE(view.hasKey("missing"));
+	EXPECT_EQ(view["tags"].getSequenceSize(), 2);
+
+	Vector<String> tags;
+	for (const auto& tag: view["tags"]) {
+		tags.push_back(tag.asString());
+	}
+	EXPECT_EQ(tags, Vector<String>({ "fast", "hero" }));
+
+	EXPECT_TRUE(view.toConfigNode() == original);
+}
+
+TEST(HalleyConfigNode, CompiledViewBadTag)
+{
+	auto bytes = ConfigNodeView::compile(ConfigNode(5));
+
+	// Replace the root node's type tag with one that compiled data never contains
+	uint32_t rootOffset;
+	memcpy(&rootOffset, bytes.data() + 8, 4);
+	for (const uint32_t tag: { uint32_t(ConfigNodeType::DeltaMap), uint32_t(0xFF) }) {
+		memcpy(bytes.data() + rootOffset, &tag, 4);
+		const auto view = ConfigNodeView(gsl::as_bytes(gsl::span<const Byte>(bytes)));
+		EXPECT_THROW(view.toConfigNode(), Exception);
+		EXPECT_THROW(view.asInt(), Exception);
+		EXPECT_THROW(view.asString(), Exception);
+	}
+}
+
+TEST(HalleyConfigNode, ConfigFileView)
+{
+	ConfigNode root = ConfigNode::MapType();
+	root["name"] = "hero";
+	root["stats"] = ConfigNode::MapType();
+	root["stats"]["hp"] = 10;
+
+	// Files built from a node compile it when first viewed
+	ConfigFile file(std::move(root));
+	EXPECT_EQ(file.getView()["name"].asStringView(), "hero");
+	EXPECT_EQ(file.getView()["stats"]["hp"].asInt(), 10);
+
+	// Modifying the root invalidates the compiled view
+	file.getRoot()["stats"]["hp"] = 20;
+	EXPECT_EQ(file.getView()["stats"]["hp"].asInt(), 20);
+	EXPECT_TRUE(file.getView().toConfigNode() == std::as_const(file).getRoot());
+
+	// Files that start out empty and are filled in through getRoot() can be viewed too
+	ConfigFile empty;
+	empty.getRoot() = ConfigNode::MapType();
+	empty.getRoot()["name"] = "villain";
+	EXPECT_EQ(empty.getView()["name"].asStringView(), "villain");
+}
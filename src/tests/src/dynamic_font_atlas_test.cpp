@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include <thread>
+#include "test_threads.h"
+#include "../../engine/core/src/dummy/dummy_system.h"
+#include "../../engine/core/src/dummy/dummy_video.h"
+
+using namespace Halley;
+using namespace Halley::Test;
+
+namespace {
+	// Draws every glyph as a solid 6x8 box, advancing 7, and records which threads it ran on
+	class BoxRasterizer final : public IGlyphRasterizer {
+	public:
+		FontMetrics getFontMetrics() const override
+		{
+			FontMetrics result;
+			result.name = "Box";
+			result.ascender = 8;
+			result.height = 10;
+			result.sizePt = 10;
+			return result;
+		}
+
+		Vector2i getMaxGlyphSize() const override { return Vector2i(8, 10); }
+		bool hasGlyph(int charcode) const override { return charcode != '#'; }
+
+		std::optional<Glyph> rasterize(int charcode) const override
+		{
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				threads.push_back(std::this_thread::get_id());
+			}
+
+			Glyph result;
+			result.advance = Vector2f(7, 0);
+			if (charcode != ' ') {
+				result.image = std::make_unique<Image>(Image::Format::RGBA, Vector2i(6, 8));
+				result.image->clear(Image::convertRGBAToInt(255, 255, 255, 255));
+			}
+			return result;
+		}
+
+		Vector<std::thread::id> getThreads() const
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			return threads;
+		}
+
+	private:
+		mutable std::mutex mutex;
+		mutable Vector<std::thread::id> threads;
+	};
+
+	class DynamicFontAtlasTest : public ::testing::Test {
+	protected:
+		DummySystemAPI system;
+		DummyVideoAPI video{ system };
+		std::shared_ptr<BoxRasterizer> rasterizer = std::make_shared<BoxRasterizer>();
+
+		// Slots are 9x11, so each page holds 2x2 glyphs
+		std::shared_ptr<Font> makeFont(bool useWorkerThreads)
+		{
+			DynamicFontAtlasConfig config;
+			config.pageSize = Vector2i(18, 22);
+			config.maxPages = 2;
+			config.useWorkerThreads = useWorkerThreads;
+			auto material = std::make_shared<MaterialDefinition>();
+			material->setTextures({ MaterialTexture("tex0", "", TextureSamplerType::Texture2D) });
+			auto atlas = std::make_shared<DynamicFontAtlas>(video, std::move(material), rasterizer, config);
+			return std::make_shared<Font>(std::move(atlas));
+		}
+
+		static bool isInAtlas(const Font& font, int c)
+		{
+			return font.getGlyph(c).first.size != Vector2f();
+		}
+	};
+}
+
+TEST_F(DynamicFontAtlasTest, RasterizesOnWorkerThreads)
+{
+	setupThreads();
+	const auto font = makeFont(true);
+	auto& atlas = *font->getDynamicAtlas();
+
+	// Missing glyphs are queued, and drawn empty in the meantime
+	const auto& [pendingGlyph, pendingFont] = font->getGlyph('A');
+	EXPECT_EQ(pendingGlyph.size, Vector2f());
+	EXPECT_EQ(&pendingFont, font.get());
+	EXPECT_EQ(atlas.getStats().misses, 1);
+
+	atlas.waitForPending();
+	const auto version = font->getAssetVersion();
+	EXPECT_TRUE(font->updateDynamicGlyphs());
+	EXPECT_NE(font->getAssetVersion(), version);
+	EXPECT_FALSE(font->updateDynamicGlyphs());
+
+	const auto& [glyph, pageFont] = font->getGlyph('A');
+	EXPECT_EQ(glyph.size, Vector2f(6, 8));
+	EXPECT_EQ(glyph.advance, Vector2f(7, 0));
+	EXPECT_EQ(glyph.area, Rect4f(0, 0, 6.0f / 18.0f, 8.0f / 22.0f));
+	EXPECT_NE(&pageFont, font.get());
+	EXPECT_NE(pageFont.getMaterial()->getTexture(0), nullptr);
+
+	const auto stats = atlas.getStats();
+	EXPECT_EQ(stats.hits, 1);
+	EXPECT_EQ(stats.glyphs, 1);
+	EXPECT_EQ(stats.pending, 0);
+	EXPECT_FLOAT_EQ(stats.getHitRate(), 0.5f);
+
+	ASSERT_EQ(rasterizer->getThreads().size(), 1);
+	EXPECT_NE(rasterizer->getThreads()[0], std::this_thread::get_id());
+}
+
+TEST_F(DynamicFontAtlasTest, AddsPagesThenEvictsLeastRecentlyUsed)
+{
+	const auto font = makeFont(false);
+	auto& atlas = *font->getDynamicAtlas();
+
+	const auto chars = Vector<int>({ 'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H' });
+	atlas.prewarm(chars);
+	font->updateDynamicGlyphs();
+	EXPECT_EQ(atlas.getStats().pages, 2);
+	EXPECT_EQ(atlas.getStats().evictions, 0);
+	for (const int c: chars) {
+		EXPECT_TRUE(isInAtlas(*font, c));
+	}
+
+	// Every slot is taken, so 'I' evicts the glyph that went unused for longest
+	for (const int c: chars) {
+		if (c != 'B') {
+			font->getGlyph(c);
+		}
+	}
+	atlas.prewarm(Vector<int>({ 'I' }));
+	font->updateDynamicGlyphs();
+
+	const auto stats = atlas.getStats();
+	EXPECT_EQ(stats.pages, 2);
+	EXPECT_EQ(stats.evictions, 1);
+	EXPECT_EQ(stats.glyphs, 8);
+	EXPECT_TRUE(isInAtlas(*font, 'I'));
+	EXPECT_TRUE(isInAtlas(*font, 'A'));
+	EXPECT_FALSE(isInAtlas(*font, 'B'));
+}
+
+TEST_F(DynamicFontAtlasTest, PrewarmsFromStringTables)
+{
+	const auto font = makeFont(false);
+	auto& atlas = *font->getDynamicAtlas();
+
+	I18N i18n;
+	const auto strings = ConfigFile(YAMLConvert::parseConfig(String("en-GB:\n  title: \"Ab Ab\"\npt-PT:\n  title: \"Cd\"\n")));
+	i18n.loadLocalisationFile(strings);
+	atlas.prewarm(i18n, I18NLanguage("en-GB"));
+	font->updateDynamicGlyphs();
+
+	// Spaces have nothing to draw, so they don't take a slot
+	EXPECT_EQ(atlas.getStats().glyphs, 3);
+	EXPECT_EQ(font->getGlyph(' ').first.advance, Vector2f(7, 0));
+	EXPECT_TRUE(isInAtlas(*font, 'A'));
+	EXPECT_TRUE(isInAtlas(*font, 'b'));
+	EXPECT_FLOAT_EQ(atlas.getStats().getHitRate(), 1.0f);
+	EXPECT_FALSE(isInAtlas(*font, 'C'));
+}
+
+TEST_F(DynamicFontAtlasTest, TextIsReshapedWhenGlyphsArrive)
+{
+	const auto font = makeFont(false);
+	auto text = TextRenderer(font, "ABC", 10);
+	EXPECT_FLOAT_EQ(text.getExtents().x, 0);
+
+	font->updateDynamicGlyphs();
+	EXPECT_FLOAT_EQ(text.getExtents().x, 21);
+	EXPECT_FLOAT_EQ(font->getDynamicAtlas()->getStats().getHitRate(), 0.5f);
+}
+
+TEST_F(DynamicFontAtlasTest, CoverageComesFromTheRasterizer)
+{
+	const auto font = makeFont(false);
+	EXPECT_TRUE(font->hasGlyph(0x4E2D));
+	EXPECT_FALSE(font->hasGlyph('#'));
+	EXPECT_FLOAT_EQ(font->getCoverage(Vector<int>({ 'A', '#' })), 0.5f);
+}
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/entity/prefab_blueprint.h"
+#include "test_world.h"
+
+using namespace Halley;
+using namespace Halley::Test;
+
+namespace {
+	constexpr std::string_view heroPrefab = R"(---
+name: hero
+uuid: 6c1f4a50-3b0c-4d2a-9d0e-000000000001
+components:
+  - Transform2D:
+      position: [10, 20]
+  - TestLink:
+      target: 6c1f4a50-3b0c-4d2a-9d0e-000000000002
+      value: 1
+children:
+  - name: weapon
+    uuid: 6c1f4a50-3b0c-4d2a-9d0e-000000000002
+    components:
+      - Transform2D:
+          position: [5, 0]
+      - Velocity:
+          velocity: [3, 4]
+      - TestLink:
+          target: 6c1f4a50-3b0c-4d2a-9d0e-000000000001
+          value: 2
+    children:
+      - name: sparkle
+        uuid: 6c1f4a50-3b0c-4d2a-9d0e-000000000003
+        components:
+          - Transform2D:
+              position: [0, 1]
+          - TestLink:
+              target: 6c1f4a50-3b0c-4d2a-9d0e-000000000002
+              value: 3
+  - name: shadow
+    uuid: 6c1f4a50-3b0c-4d2a-9d0e-000000000004
+    components:
+      - Transform2D:
+          position: [0, -2]
+...
+)";
+
+	// References a prefab from one of its children, so it can't be compiled into a blueprint
+	constexpr std::string_view squadPrefab = R"(---
+name: squad
+uuid: 6c1f4a50-3b0c-4d2a-9d0e-000000000011
+components:
+  - Transform2D:
+      position: [100, 0]
+  - TestLink:
+      target: 6c1f4a50-3b0c-4d2a-9d0e-000000000012
+      value: 10
+children:
+  - prefab: hero
+    uuid: 6c1f4a50-3b0c-4d2a-9d0e-000000000012
+    components:
+      - Transform2D:
+          position: [7, 7]
+...
+)";
+
+	// Describes an entity hierarchy independently of the ids and instance UUIDs assigned to it,
+	// with entity references written as the path of their target relative to the root
+	class HierarchyDescription {
+	public:
+		explicit HierarchyDescription(EntityRef root)
+		{
+			collectPaths(root, "/");
+			describe(root, "/");
+		}
+
+		const Vector<String>& getLines() const { return lines; }
+
+	private:
+		HashMap<EntityId, String> paths;
+		Vector<String> lines;
+
+		void collectPaths(EntityRef entity, const String& path)
+		{
+			paths[entity.getEntityId()] = path;
+			int i = 0;
+			for (auto child: entity.getChildren()) {
+				collectPaths(child, path + toString(i++) + "/");
+			}
+		}
+
+		void describe(EntityRef entity, const String& path)
+		{
+			String line = path + " name=" + entity.getName() + " prefabUUID=" + entity.getPrefabUUID().toString() + " enabled=" + toString(entity.isEnabled());
+			if (const auto* transform = entity.tryGetComponent<Transform2DComponent>()) {
+				line += " position=" + toString(transform->getLocalPosition());
+			}
+			if (const auto* velocity = entity.tryGetComponent<VelocityComponent>()) {
+				line += " velocity=" + toString(velocity->velocity);
+			}
+			if (const auto* link = entity.tryGetComponent<TestLinkComponent>()) {
+				const auto iter = paths.find(link->target);
+				line += " link=" + toString(link->value) + "->" + (iter != paths.end() ? iter->second : String("outside"));
+			}
+			lines.push_back(std::move(line));
+
+			int i = 0;
+			for (auto child: entity.getChildren()) {
+				describe(child, path + toString(i++) + "/");
+			}
+		}
+	};
+
+	void expectBatchMatchesSingle(TestWorld& testWorld, const String& prefabName)
+	{
+		constexpr size_t count = 3;
+		EntityFactory factory(testWorld.getWorld(), testWorld.getResources());
+
+		Vector<EntityRef> singles;
+		for (size_t i = 0; i < count; ++i) {
+			singles.push_back(factory.createEntity(prefabName));
+		}
+		const auto batch = factory.instantiateBatch(prefabName, count);
+		ASSERT_EQ(batch.size(), count);
+
+		const auto expected = HierarchyDescription(singles[0]).getLines();
+		for (size_t i = 0; i < count; ++i) {
+			EXPECT_EQ(HierarchyDescription(singles[i]).getLines(), expected);
+			EXPECT_EQ(HierarchyDescription(batch[i]).getLines(), expected) << "batch instance " << i;
+		}
+
+		// Each copy is its own instance
+		for (size_t i = 0; i < count; ++i) {
+			for (size_t j = i + 1; j < count; ++j) {
+				EXPECT_NE(batch[i].getInstanceUUID(), batch[j].getInstanceUUID());
+				EXPECT_NE(batch[i].getEntityId(), batch[j].getEntityId());
+			}
+		}
+	}
+}
+
+TEST(EntityFactory, BatchMatchesSingleInstantiation)
+{
+	TestWorld testWorld;
+	const auto prefab = testWorld.addPrefab("hero", heroPrefab);
+	ASSERT_TRUE(prefab->getBlueprint(testWorld.getWorld().getReflection())->isCompiled());
+
+	expectBatchMatchesSingle(testWorld, "hero");
+}
+
+TEST(EntityFactory, BatchMatchesSingleInstantiationWithPrefabReferences)
+{
+	TestWorld testWorld;
+	testWorld.addPrefab("hero", heroPrefab);
+	const auto prefab = testWorld.addPrefab("squad", squadPrefab);
+	ASSERT_FALSE(prefab->getBlueprint(testWorld.getWorld().getReflection())->isCompiled());
+
+	expectBatchMatchesSingle(testWorld, "squad");
+}
+
+TEST(EntityFactory, BatchAppliesTransforms)
+{
+	TestWorld testWorld;
+	testWorld.addPrefab("hero", heroPrefab);
+	EntityFactory factory(testWorld.getWorld(), testWorld.getResources());
+
+	const std::array<EntityFactory::BatchTransform, 2> transforms = {{
+		{ Vector2f(1, 2), Angle1f::fromDegrees(90) },
+		{ Vector2f(3, 4), Angle1f::fromDegrees(0) }
+	}};
+	const auto batch = factory.instantiateBatch("hero", transforms.size(), transforms);
+	ASSERT_EQ(batch.size(), transforms.size());
+
+	for (size_t i = 0; i < transforms.size(); ++i) {
+		const auto& transform = batch[i].getComponent<Transform2DComponent>();
+		EXPECT_EQ(transform.getLocalPosition(), transforms[i].position);
+		EXPECT_FLOAT_EQ(transform.getLocalRotation().getDegrees(), transforms[i].rotation.getDegrees());
+
+		// Children keep their prefab transforms
+		const auto weapon = *batch[i].getChildren().begin();
+		EXPECT_EQ(weapon.getComponent<Transform2DComponent>().getLocalPosition(), Vector2f(5, 0));
+	}
+}
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "test_world.h"
+
+using namespace Halley;
+using namespace Halley::Test;
+
+namespace {
+	EntityRef makeTrackedEntity(World& world)
+	{
+		const auto id = world.createEntity("parent")
+			.addComponent(Transform2DComponent(Vector2f(1, 2)))
+			.getEntityId();
+		world.createEntity("child", id)
+			.addComponent(Transform2DComponent(Vector2f(0, 1)));
+		world.spawnPending();
+		return world.getEntity(id);
+	}
+}
+
+TEST(Entity, ChangeRevisionTracksLocalChanges)
+{
+	TestWorld testWorld;
+	auto entity = makeTrackedEntity(testWorld.getWorld());
+	auto child = *entity.getChildren().begin();
+
+	const auto initial = entity.getChangeRevision();
+	ASSERT_TRUE(initial.has_value());
+	EXPECT_EQ(entity.getChangeRevision(), initial);
+
+	// Nothing has read the global transform, so there's no cache to invalidate, but it still has to count as a change
+	child.getComponent<Transform2DComponent>().setLocalPosition(Vector2f(5, 5));
+	const auto moved = entity.getChangeRevision();
+	EXPECT_NE(moved, initial);
+
+	entity.getComponent<Transform2DComponent>().getGlobalPosition();
+	entity.getComponent<Transform2DComponent>().setLocalPosition(Vector2f(3, 4));
+	EXPECT_NE(entity.getChangeRevision(), moved);
+
+	// Untracked components make the entity always count as changed
+	child.addComponent(VelocityComponent());
+	EXPECT_FALSE(entity.getChangeRevision().has_value());
+}
+
+TEST(Entity, ChangeRevisionDoesNotWrap)
+{
+	TestWorld testWorld;
+	auto entity = makeTrackedEntity(testWorld.getWorld());
+	auto& transform = entity.getComponent<Transform2DComponent>();
+
+	// Enough changes to wrap the 8 and 16 bit counters these used to be, ending on the original values
+	const auto initial = entity.getChangeRevision();
+	for (int i = 0; i < 0xFFFF; ++i) {
+		transform.setLocalPosition(Vector2f(float(i + 2), 2));
+	}
+	transform.setLocalPosition(Vector2f(1, 2));
+	for (int i = 0; i < 0xFF; ++i) {
+		entity.setName("parent" + toString(i));
+	}
+	entity.setName("parent");
+
+	EXPECT_NE(entity.getChangeRevision(), initial);
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/tools/make_font/font_face_glyph_rasterizer.h"
+#include "test_threads.h"
+#include "../../engine/core/src/dummy/dummy_system.h"
+#include "../../engine/core/src/dummy/dummy_video.h"
+
+using namespace Halley;
+using namespace Halley::Test;
+
+namespace {
+	std::shared_ptr<FontFaceGlyphRasterizer> makeRasterizer()
+	{
+		return std::make_shared<FontFaceGlyphRasterizer>(Path::readFile(Path(HALLEY_TESTS_SHARED_ASSETS_DIR) / "font" / "ubuntub.ttf"), 32.0f, 4.0f);
+	}
+
+	int getAlpha(const Image& image, Vector2i pos)
+	{
+		return (image.getPixel4BPP(pos) >> 24) & 0xFF;
+	}
+}
+
+TEST(FontFaceGlyphRasterizer, RasterizesDistanceFields)
+{
+	const auto rasterizer = makeRasterizer();
+
+	const auto metrics = rasterizer->getFontMetrics();
+	EXPECT_EQ(metrics.name, "Ubuntu Bold");
+	EXPECT_FLOAT_EQ(metrics.sizePt, 32);
+	EXPECT_FLOAT_EQ(metrics.smoothRadius, 4);
+	EXPECT_TRUE(rasterizer->hasGlyph('I'));
+	EXPECT_FALSE(rasterizer->hasGlyph(0x4E2D));
+
+	// The alpha channel is the true distance field: inside in the middle of the stem, outside at the padded border
+	const auto glyph = rasterizer->rasterize('I');
+	ASSERT_TRUE(glyph && glyph->image);
+	const auto size = glyph->image->getSize();
+	EXPECT_LE(size.x, rasterizer->getMaxGlyphSize().x);
+	EXPECT_LE(size.y, rasterizer->getMaxGlyphSize().y);
+	EXPECT_GT(getAlpha(*glyph->image, size / 2), 127);
+	EXPECT_LT(getAlpha(*glyph->image, Vector2i()), 127);
+	EXPECT_GT(glyph->advance.x, 0);
+
+	const auto space = rasterizer->rasterize(' ');
+	ASSERT_TRUE(space);
+	EXPECT_EQ(space->image, nullptr);
+	EXPECT_GT(space->advance.x, 0);
+}
+
+TEST(FontFaceGlyphRasterizer, FillsDynamicAtlas)
+{
+	setupThreads();
+	DummySystemAPI system;
+	DummyVideoAPI video(system);
+	auto material = std::make_shared<MaterialDefinition>();
+	material->setTextures({ MaterialTexture("tex0", "", TextureSamplerType::Texture2D) });
+
+	const auto rasterizer = makeRasterizer();
+	DynamicFontAtlasConfig config;
+	config.pageSize = Vector2i(256, 256);
+	const auto font = std::make_shared<Font>(std::make_shared<DynamicFontAtlas>(video, material, rasterizer, config));
+	auto& atlas = *font->getDynamicAtlas();
+
+	const String text = "Halley";
+	Vector<int> chars;
+	for (const auto c: text.getUTF32()) {
+		chars.push_back(static_cast<int>(c));
+	}
+	atlas.prewarm(chars);
+	atlas.waitForPending();
+	EXPECT_TRUE(font->updateDynamicGlyphs());
+	EXPECT_EQ(atlas.getStats().glyphs, 5);
+
+	for (const int c: chars) {
+		const auto& [glyph, pageFont] = font->getGlyph(c);
+		EXPECT_EQ(glyph.size, Vector2f(rasterizer->rasterize(c)->image->getSize()));
+		EXPECT_NE(&pageFont, font.get());
+	}
+	EXPECT_FLOAT_EQ(atlas.getStats().getHitRate(), 1.0f);
+	EXPECT_GT(TextRenderer(font, text, 32).getExtents().x, 0);
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+using namespace Halley;
+
+namespace {
+	Font::Glyph makeGlyph(int code, float advance, HashMap<int32_t, Vector2f> kerning = {})
+	{
+		return Font::Glyph(code, Rect4f(0, 0, 1, 1), Vector2f(8, 8), Vector2f(), Vector2f(), Vector2f(advance, 0), std::move(kerning));
+	}
+
+	Font makeFont()
+	{
+		Font font("test", "test.png", 10, 12, 12, 1, Vector2i(64, 64));
+		font.addGlyph(makeGlyph(0, 1));
+		font.addGlyph(makeGlyph('A', 5, {{ 'V', Vector2f(-1, 0) }}));
+		font.addGlyph(makeGlyph('V', 6, {{ 'A', Vector2f(-2, 0) }}));
+		font.addGlyph(makeGlyph(0x4E2D, 12));
+		font.addGlyph(makeGlyph('B', 7, {{ 'A', Vector2f(-3, 0) }})); // Out of order
+		return font;
+	}
+}
+
+TEST(HalleyFont, GlyphLookup)
+{
+	const auto font = makeFont();
+
+	EXPECT_EQ(font.getGlyph('A').first.charcode, 'A');
+	EXPECT_EQ(font.getGlyph('B').first.advance.x, 7);
+	EXPECT_EQ(font.getGlyph('V').first.advance.x, 6);
+	EXPECT_EQ(font.getGlyph(0x4E2D).first.charcode, 0x4E2D);
+	EXPECT_EQ(&font.getGlyph('A').second, &font);
+
+	// Missing glyphs use the replacement character
+	EXPECT_EQ(font.tryGetGlyphHere('C'), nullptr);
+	EXPECT_EQ(font.tryGetGlyphHere(0x4E2E), nullptr);
+	EXPECT_EQ(font.getGlyph('C').first.charcode, 0);
+	EXPECT_EQ(font.getGlyph(0x10000).first.charcode, 0);
+}
+
+TEST(HalleyFont, Kerning)
+{
+	const auto font = makeFont();
+
+	EXPECT_EQ(font.getKerning('A', 'V'), Vector2f(-1, 0));
+	EXPECT_EQ(font.getKerning('V', 'A'), Vector2f(-2, 0));
+	EXPECT_EQ(font.getKerning('B', 'A'), Vector2f(-3, 0));
+	EXPECT_EQ(font.getKerning('A', 'B'), Vector2f());
+	EXPECT_EQ(font.getKerning('C', 'A'), Vector2f());
+}
+
+TEST(HalleyFont, SerializationKeepsKerning)
+{
+	const auto font = makeFont();
+	const auto bytes = Serializer::toBytes(font);
+
+	Font result;
+	Deserializer::fromBytes(result, bytes);
+
+	EXPECT_EQ(result.getGlyph('V').first.advance.x, 6);
+	EXPECT_EQ(result.getGlyph(0x4E2D).first.charcode, 0x4E2D);
+	EXPECT_EQ(result.getKerning('A', 'V'), Vector2f(-1, 0));
+	EXPECT_EQ(result.getKerning('B', 'A'), Vector2f(-3, 0));
+	EXPECT_EQ(result.getGlyph('C').first.charcode, 0);
+}
+
+TEST(HalleyFont, StringTableCoverage)
+{
+	const auto font = makeFont();
+
+	ConfigNode table = ConfigNode::MapType();
+	table["en-GB"]["title"] = ConfigNode(String("AVB"));
+	table["zh-CN"]["title"] = ConfigNode(String("A\xE4\xB8\xAD\xE4\xB8\xAE")); // A, U+4E2D, U+4E2E
+
+	EXPECT_EQ(I18N::getCharacters(table, { I18NLanguage("en-GB") }), Vector<int>({ 'A', 'B', 'V' }));
+	const auto all = I18N::getCharacters(table);
+	EXPECT_EQ(all, Vector<int>({ 'A', 'B', 'V', 0x4E2D, 0x4E2E }));
+
+	EXPECT_FLOAT_EQ(font.getCoverage(all), 0.8f);
+	EXPECT_EQ(font.getMissingCharacters(all), Vector<int>({ 0x4E2E }));
+}
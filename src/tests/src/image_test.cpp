@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "test_threads.h"
+#include "test_images.h"
+using namespace Halley;
+using namespace Halley::Test;
+
+TEST(Image, PreMultiply)
+{
+	setupThreads();
+
+	for (const auto size: { Vector2i(7, 3), Vector2i(1024, 1024) }) {
+		auto img = std::make_unique<Image>(Image::Format::RGBA, size);
+		auto px = img->getPixels4BPP();
+		Vector<unsigned int> expected(px.size());
+		for (size_t i = 0; i < px.size(); ++i) {
+			const unsigned int r = i & 0xFF;
+			const unsigned int g = (i * 7) & 0xFF;
+			const unsigned int b = (i * 13) & 0xFF;
+			const unsigned int a = (i * 31) & 0xFF;
+			px[i] = static_cast<int>(Image::convertRGBAToInt(r, g, b, a));
+			expected[i] = Image::convertRGBAToInt(r * (a + 1) >> 8, g * (a + 1) >> 8, b * (a + 1) >> 8, a);
+		}
+
+		img->preMultiply();
+		EXPECT_EQ(Image::Format::RGBAPremultiplied, img->getFormat());
+		EXPECT_EQ(0, memcmp(expected.data(), img->getPixels4BPP().data(), expected.size() * sizeof(int)));
+	}
+}
+
+TEST(Image, FlipAndBlit)
+{
+	setupThreads();
+
+	const auto src = makeAtlas(Vector2i(1024, 601), 50);
+	auto flipped = src->clone();
+	expectSamePixels(*src, *flipped);
+
+	flipped->flipVertically();
+	EXPECT_EQ(src->getPixels4BPP()[5 + 0 * 1024], flipped->getPixels4BPP()[5 + 600 * 1024]);
+	EXPECT_EQ(src->getPixels4BPP()[70 + 300 * 1024], flipped->getPixels4BPP()[70 + 300 * 1024]);
+	flipped->flipVertically();
+	expectSamePixels(*src, *flipped);
+
+	Image dst(Image::Format::RGBA, Vector2i(1100, 700));
+	dst.blitFrom(Vector2i(10, 20), *src);
+	EXPECT_EQ(src->getPixels4BPP()[100 + 200 * 1024], dst.getPixels4BPP()[110 + 220 * 1100]);
+	EXPECT_EQ(0, dst.getPixels4BPP()[5 + 5 * 1100]);
+
+	Image small(Image::Format::RGBA, Vector2i(512, 300));
+	small.blitDownsampled(*src, 2);
+	EXPECT_EQ(src->getPixels4BPP()[200 + 100 * 1024], small.getPixels4BPP()[100 + 50 * 512]);
+}
+
+TEST(Image, HLIFRoundTrip)
+{
+	setupThreads();
+
+	// Few colours (paletted), many colours (raw RGBA) and single channel
+	Vector<std::unique_ptr<Image>> images;
+	images.push_back(makeAtlas(Vector2i(1000, 777), 50));
+	images.push_back(makeAtlas(Vector2i(300, 200), 256 * 256));
+	images.push_back(std::make_unique<Image>(Image::Format::SingleChannel, Vector2i(123, 45)));
+	for (size_t i = 0; i < images.back()->getPixelBytes().size(); ++i) {
+		images.back()->getPixelBytes()[i] = static_cast<unsigned char>(i * i);
+	}
+
+	for (const auto& img: images) {
+		const auto bytes = img->saveHLIFToBytes("test", false);
+		const auto info = HLIFFile::getInfo(bytes.byte_span());
+		EXPECT_EQ(img->getSize(), info.size);
+
+		Image decoded(bytes.byte_span(), img->getFormat());
+		expectSamePixels(*img, decoded);
+	}
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/tools/assets/import_assets_task.h"
+#include "halley/tools/assets/asset_collector.h"
+#include "halley/tools/assets/asset_importer.h"
+#include "halley/tools/assets/import_assets_database.h"
+#include "halley/tools/file/filesystem.h"
+#include "halley/tools/project/project.h"
+#include "test_threads.h"
+using namespace Halley;
+
+namespace {
+	ImportingAsset makeImportingAsset(const String& id, ImportAssetType type)
+	{
+		ImportingAsset asset;
+		asset.assetId = id;
+		asset.assetType = type;
+		return asset;
+	}
+
+	// Collects the output of one (sub)asset into the parent's result, like ImportAssetsTask does when a job finishes
+	void collect(ImportAssetsTask::ImportResult& result, AssetCollector& collector)
+	{
+		for (auto& outFile: collector.collectOutFiles()) {
+			result.outFiles.push_back(std::move(outFile));
+		}
+		for (const auto& o: collector.getAssets()) {
+			result.out.push_back(o);
+		}
+	}
+
+	ImportAssetsTask::ImportResult importSpriteSheet(bool reverseDependencies)
+	{
+		ImportAssetsTask::ImportResult result;
+		Vector<Path> assetsSrc;
+		auto progress = [] (float, const String&) { return true; };
+
+		// The spritesheet outputs itself, and schedules its image and sprites as dependent assets
+		const auto sheet = makeImportingAsset("hero", ImportAssetType::SpriteSheet);
+		AssetCollector sheetCollector(sheet, Path("out"), assetsSrc, progress);
+		sheetCollector.output("hero", AssetType::SpriteSheet, Bytes(4, 1), {}, "pc", Path("hero.ase"));
+		sheetCollector.addAdditionalAsset(makeImportingAsset("hero.png", ImportAssetType::Image));
+		sheetCollector.addAdditionalAsset(makeImportingAsset("hero:idle", ImportAssetType::Sprite));
+		sheetCollector.addAdditionalAsset(makeImportingAsset("hero:walk", ImportAssetType::Sprite));
+		collect(result, sheetCollector);
+
+		auto dependencies = sheetCollector.collectAdditionalAssets();
+		EXPECT_EQ(3, dependencies.size());
+		if (reverseDependencies) {
+			std::reverse(dependencies.begin(), dependencies.end());
+		}
+
+		for (const auto& dependency: dependencies) {
+			AssetCollector collector(dependency, Path("out"), assetsSrc, progress);
+			const auto type = dependency.assetType == ImportAssetType::Image ? AssetType::Texture : AssetType::Sprite;
+			collector.output(dependency.assetId, type, Bytes(8, 2), {}, "pc", Path("hero.ase"));
+			collect(result, collector);
+		}
+
+		result.additionalInputs.push_back(TimestampedPath(Path("hero.ase"), 10));
+		if (reverseDependencies) {
+			result.additionalInputs.push_back(TimestampedPath(Path("hero.ase"), 10));
+			std::reverse(result.out.begin(), result.out.end());
+		}
+
+		ImportAssetsTask::sortResult(result);
+		return result;
+	}
+
+	class TestImportAssetsTask : public ImportAssetsTask {
+	public:
+		using ImportAssetsTask::ImportAssetsTask;
+
+		void runNow()
+		{
+			run();
+		}
+	};
+}
+
+TEST(ImportAssetsTask, DependentAssetsAreSorted)
+{
+	const auto a = importSpriteSheet(false);
+	const auto b = importSpriteSheet(true);
+
+	ASSERT_EQ(4, a.out.size());
+	ASSERT_EQ(a.out.size(), b.out.size());
+	for (size_t i = 0; i < a.out.size(); ++i) {
+		EXPECT_EQ(a.out[i].name, b.out[i].name);
+		EXPECT_EQ(a.out[i].type, b.out[i].type);
+	}
+
+	ASSERT_EQ(4, a.outFiles.size());
+	ASSERT_EQ(a.outFiles.size(), b.outFiles.size());
+	for (size_t i = 0; i < a.outFiles.size(); ++i) {
+		EXPECT_EQ(a.outFiles[i].first, b.outFiles[i].first);
+	}
+	for (size_t i = 1; i < a.outFiles.size(); ++i) {
+		EXPECT_TRUE(a.outFiles[i - 1].first < a.outFiles[i].first);
+	}
+
+	EXPECT_EQ(1, b.additionalInputs.size());
+}
+
+TEST(ImportAssetsTask, FailedAssetsDontHoldBackTheRest)
+{
+	Halley::Test::setupThreads();
+
+	const auto root = FileSystem::getTemporaryPath();
+	const auto srcDir = root / "assets_src";
+	const auto outDir = root / "assets";
+	{
+		Project project(root, root, {});
+		ImportAssetsDatabase db(outDir, outDir / "import.db", outDir / "assets.db", { "pc" }, 1);
+		auto importer = std::make_shared<AssetImporter>(project, Vector<Path>{ srcDir }, ConfigNode());
+
+		// The image is imported as a sprite, with its texture as a dependent job, and the broken config sits between the others in file order
+		Image image(Image::Format::RGBA, Vector2i(4, 4));
+		image.clear(0xFF00FFFF);
+		const auto sources = Vector<std::pair<Path, Bytes>>({
+			{ Path("config/first.yaml"), String("value: 1").toBytes() },
+			{ Path("config/broken.yaml"), String("value: [1, 2").toBytes() },
+			{ Path("image/pixel.png"), image.savePNGToBytes() },
+			{ Path("config/last.yaml"), String("value: 2").toBytes() },
+		});
+
+		Vector<ImportAssetsDatabaseEntry> files;
+		for (const auto& [path, data]: sources) {
+			FileSystem::writeFile(srcDir / path, data);
+			auto& rootImporter = importer->getRootImporter(path);
+			auto& entry = files.emplace_back(rootImporter.getAssetId(path, {}), srcDir, path, 1);
+			entry.assetType = rootImporter.getType();
+		}
+
+		TestImportAssetsTask task("Import", db, importer, outDir, std::move(files), {}, project, false);
+		task.runNow();
+
+		auto getOutputs = [&] (ImportAssetType type, const String& assetId)
+		{
+			Vector<Path> result;
+			for (const auto& out: db.getOutFiles(type, assetId)) {
+				for (const auto& [platform, version]: out.platformVersions) {
+					EXPECT_TRUE(FileSystem::exists(outDir / version.filepath)) << version.filepath;
+					result.push_back(version.filepath);
+				}
+			}
+			return result;
+		};
+
+		EXPECT_EQ(1, getOutputs(ImportAssetType::ConfigFile, "first.yaml").size());
+		EXPECT_EQ(1, getOutputs(ImportAssetType::ConfigFile, "last.yaml").size());
+		// The texture comes from the dependent job, so it being there means that job finished too
+		EXPECT_TRUE(std_ex::contains(getOutputs(ImportAssetType::Sprite, "pixel.png"), Path("pc/texture/pixel.png")));
+		EXPECT_TRUE(getOutputs(ImportAssetType::ConfigFile, "broken.yaml").empty());
+		EXPECT_EQ(Vector<Path>{ srcDir / "config/broken.yaml" }, db.getAllFailedFilenames());
+	}
+
+	FileSystem::remove(root);
+}
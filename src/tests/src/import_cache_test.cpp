@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/tools/assets/asset_importer.h"
+#include "halley/tools/assets/import_cache.h"
+#include "halley/tools/file/filesystem.h"
+#include "halley/tools/project/project.h"
+using namespace Halley;
+
+namespace {
+	ImportingAsset makeImage(Bytes data)
+	{
+		ImportingAsset asset;
+		asset.assetId = "pixel.png";
+		asset.assetType = ImportAssetType::Image;
+		asset.inputFiles.emplace_back(ImportingAssetFile(Path("image/pixel.png"), std::move(data), Metadata()));
+		return asset;
+	}
+
+	// Images import their texture as a dependent asset, so the entry depends on both importers
+	ImportCache::Entry makeEntry(const AssetImporter& importer)
+	{
+		ImportCache::Entry entry;
+		entry.assetId = "pixel.png";
+		entry.outFiles.emplace_back(Path("pixel.png"), Bytes(16, 1));
+		entry.importerVersions = ImportCache::getImporterVersions(importer, { ImportAssetType::Texture, ImportAssetType::Image });
+		return entry;
+	}
+}
+
+TEST(ImportCache, HitsMissesAndInvalidation)
+{
+	const auto root = FileSystem::getTemporaryPath();
+	{
+		Project project(root, root, {});
+		const AssetImporter importer(project, { root / "assets_src" }, ConfigNode());
+		ImportCache cache(root / "cache", 1);
+
+		const auto asset = makeImage(Bytes(32, 7));
+		const auto key = cache.computeKey(asset, importer);
+		EXPECT_FALSE(cache.load(key, asset.assetId, importer).has_value());
+
+		cache.store(key, makeEntry(importer));
+		const auto hit = cache.load(key, asset.assetId, importer);
+		ASSERT_TRUE(hit.has_value());
+		ASSERT_EQ(1, hit->outFiles.size());
+		EXPECT_EQ(Bytes(16, 1), hit->outFiles[0].second);
+
+		// Changing the source or the cache version changes the key
+		EXPECT_NE(key, cache.computeKey(makeImage(Bytes(32, 8)), importer));
+		EXPECT_NE(key, ImportCache(root / "cache", 2).computeKey(asset, importer));
+
+		// The texture importer isn't part of the key, but an entry it produced with another version is still invalid
+		auto stale = makeEntry(importer);
+		ASSERT_EQ(2, stale.importerVersions.size());
+		for (auto& [type, version]: stale.importerVersions) {
+			if (type == ImportAssetType::Texture) {
+				++version;
+			}
+		}
+		cache.store(key, stale);
+		EXPECT_FALSE(cache.load(key, asset.assetId, importer).has_value());
+
+		const auto stats = cache.getStats();
+		EXPECT_EQ(1, stats.hits);
+		EXPECT_EQ(2, stats.misses);
+		EXPECT_EQ(2, stats.stored);
+	}
+
+	FileSystem::remove(root);
+}
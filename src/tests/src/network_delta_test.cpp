@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/entity/ecs_reflection_impl.h"
+#include "halley/net/entity/entity_network_message.h"
+#include "halley/net/session/network_session.h"
+#include "halley/net/session/network_session_control_messages.h"
+#include "components/velocity_component.h"
+using namespace Halley;
+
+namespace {
+	SerializerOptions makeNetworkOptions()
+	{
+		SerializerOptions options;
+		options.version = SerializerOptions::maxVersion;
+		return options;
+	}
+
+	EntityData makeVelocityData(const UUID& uuid, const VelocityComponent& velocity)
+	{
+		EntitySerializationContext context;
+		context.entitySerializationTypeMask = EntitySerialization::makeMask(EntitySerialization::Type::Network);
+
+		EntityData data(uuid);
+		data.setComponents({ { VelocityComponent::componentName, velocity.serialize(context) } });
+		return data;
+	}
+}
+
+TEST(NetworkDelta, ComponentRoundTrip)
+{
+	const ComponentReflectorImpl<VelocityComponent> reflector;
+	ASSERT_TRUE(reflector.hasNetworkDelta());
+	const auto options = makeNetworkOptions();
+
+	VelocityComponent sent;
+	sent.velocity = Vector2f(1, 2);
+	VelocityComponent received;
+	received.velocity = sent.velocity;
+	const auto snapshot = reflector.makeNetworkDeltaSnapshot(sent);
+	EXPECT_EQ(reflector.getNetworkDeltaMask(sent, *snapshot), 0);
+
+	sent.velocity = Vector2f(3, -4);
+	const auto mask = reflector.getNetworkDeltaMask(sent, *snapshot);
+	ASSERT_NE(mask, 0);
+	const auto bytes = Serializer::toBytes([&] (Serializer& s) { reflector.serializeNetworkDelta(s, sent, *snapshot, mask); }, options);
+
+	// Serializing brings the snapshot up to date
+	EXPECT_EQ(reflector.getNetworkDeltaMask(sent, *snapshot), 0);
+
+	auto s = Deserializer(bytes, options);
+	reflector.applyNetworkDelta(s, received);
+	EXPECT_EQ(s.getBytesLeft(), 0);
+	EXPECT_EQ(received.velocity, sent.velocity);
+}
+
+TEST(NetworkDelta, UpdateMessageRoundTrip)
+{
+	const ComponentReflectorImpl<VelocityComponent> reflector;
+	const auto options = makeNetworkOptions();
+
+	VelocityComponent sent;
+	const auto snapshot = reflector.makeNetworkDeltaSnapshot(sent);
+	sent.velocity = Vector2f(-5, 0.5f);
+	const auto componentDeltas = Serializer::toBytes([&] (Serializer& s)
+	{
+		s << uint32_t(1);
+		s << VelocityComponent::componentIndex;
+		reflector.serializeNetworkDelta(s, sent, *snapshot, reflector.getNetworkDeltaMask(sent, *snapshot));
+	}, options);
+
+	const auto bytes = Serializer::toBytes(EntityNetworkMessage(EntityNetworkMessageUpdate(42, {}, componentDeltas)), options);
+	const auto msg = Deserializer::fromBytes<EntityNetworkMessage>(bytes, options);
+	ASSERT_EQ(msg.getType(), EntityNetworkHeaderType::Update);
+	const auto& update = msg.getMessage<EntityNetworkMessageUpdate>();
+	EXPECT_EQ(update.entityId, 42);
+	EXPECT_TRUE(update.bytes.empty());
+	ASSERT_EQ(update.componentDeltas, componentDeltas);
+
+	auto s = Deserializer(update.componentDeltas, options);
+	uint32_t count = 0;
+	int componentId = -1;
+	s >> count;
+	s >> componentId;
+	EXPECT_EQ(count, 1);
+	EXPECT_EQ(componentId, VelocityComponent::componentIndex);
+
+	VelocityComponent received;
+	reflector.applyNetworkDelta(s, received);
+	EXPECT_EQ(received.velocity, sent.velocity);
+}
+
+TEST(NetworkDelta, SmallerThanEntityDataDelta)
+{
+	const ComponentReflectorImpl<VelocityComponent> reflector;
+	const auto options = makeNetworkOptions();
+	const auto uuid = UUID::generate();
+
+	VelocityComponent velocity;
+	velocity.velocity = Vector2f(1, 2);
+	const auto before = makeVelocityData(uuid, velocity);
+	const auto snapshot = reflector.makeNetworkDeltaSnapshot(velocity);
+
+	velocity.velocity = Vector2f(1.5f, -2);
+	const auto after = makeVelocityData(uuid, velocity);
+
+	const auto configDelta = Serializer::toBytes(EntityDataDelta(before, after), options);
+	const auto binaryDelta = Serializer::toBytes([&] (Serializer& s)
+	{
+		s << uint32_t(1);
+		s << VelocityComponent::componentIndex;
+		reflector.serializeNetworkDelta(s, velocity, *snapshot, reflector.getNetworkDeltaMask(velocity, *snapshot));
+	}, options);
+
+	EXPECT_LT(binaryDelta.size(), configDelta.size());
+}
+
+TEST(NetworkDelta, JoinChecksEngineVersion)
+{
+	ControlMsgJoin msg;
+	msg.networkVersion = 3;
+	msg.userName = "player";
+	msg.engineNetworkVersion = NetworkSession::engineNetworkVersion;
+	const auto result = Deserializer::fromBytes<ControlMsgJoin>(Serializer::toBytes(msg));
+	EXPECT_EQ(result.networkVersion, 3);
+	EXPECT_EQ(result.userName, "player");
+	EXPECT_EQ(result.engineNetworkVersion, NetworkSession::engineNetworkVersion);
+
+	// Peers from before the engine version existed don't send it, and must not match
+	const auto legacy = Serializer::toBytes([&] (Serializer& s) { s << msg.networkVersion; s << msg.userName; });
+	const auto legacyResult = Deserializer::fromBytes<ControlMsgJoin>(legacy);
+	EXPECT_EQ(legacyResult.networkVersion, 3);
+	EXPECT_EQ(legacyResult.engineNetworkVersion, 0);
+	EXPECT_NE(legacyResult.engineNetworkVersion, NetworkSession::engineNetworkVersion);
+}
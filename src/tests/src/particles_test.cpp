@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "test_world.h"
+using namespace Halley;
+using namespace Halley::Test;
+
+namespace {
+	constexpr Time frameTime = 1.0 / 60.0;
+
+	Particles makeParticles(const ConfigNode& node)
+	{
+		static TestWorld world;
+		const EntitySerializationContext context;
+		Particles particles(node, world.getResources(), context);
+
+		Sprite base;
+		base.setMaterial(std::make_shared<Material>(std::make_shared<MaterialDefinition>())).setSize(Vector2f(4, 4));
+		particles.setSprites({ base });
+		return particles;
+	}
+
+	ConfigNode makeSprayConfig()
+	{
+		ConfigNode node = ConfigNode::MapType();
+		node["spawnRate"] = 200.0f;
+		node["ttl"] = ConfigNode(Vector<float>{ 0.5f, 1.5f });
+		node["speed"] = ConfigNode(Vector<float>{ 20.0f, 60.0f });
+		node["azimuth"] = ConfigNode(Vector<float>{ 0.0f, 360.0f });
+		node["initialScale"] = ConfigNode(Vector<float>{ 0.5f, 2.0f });
+		node["acceleration"] = Vector3f(0, 10, 0);
+		node["speedDamp"] = 0.5f;
+		node["stopTime"] = 0.2f;
+		node["directionScatter"] = 30.0f;
+		node["spawnArea"] = Vector2f(100, 50);
+		return node;
+	}
+
+	Vector<Vector2f> getPositions(const Particles& particles)
+	{
+		Vector<Vector2f> result;
+		for (const auto& sprite: particles.getSprites()) {
+			result.push_back(sprite.getPosition());
+		}
+		return result;
+	}
+}
+
+TEST(Particles, SeededSimulationIsReproducible)
+{
+	// Recorded from the simulation before particles were stored as one array per attribute
+	struct Expected {
+		size_t index;
+		Vector2f pos;
+		float scale;
+	};
+	constexpr size_t expectedCount = 191;
+	const auto expected = Vector<Expected>({
+		{ 0, Vector2f(6.7212f, 24.3182f), 0.74043f },
+		{ 25, Vector2f(49.7614f, 25.2663f), 0.85922f },
+		{ 50, Vector2f(74.8650f, 46.0321f), 1.99146f },
+		{ 75, Vector2f(38.4422f, 51.3906f), 0.89033f },
+		{ 100, Vector2f(75.4199f, 13.0471f), 0.52130f },
+		{ 125, Vector2f(-2.7498f, -1.0861f), 0.80463f },
+		{ 150, Vector2f(77.0128f, 15.5929f), 1.43586f },
+		{ 175, Vector2f(-15.2411f, 6.8519f), 1.90313f },
+	});
+
+	auto particles = makeParticles(makeSprayConfig());
+	particles.setPosition(Vector2f(10, 20));
+	particles.setRandomSeed(1234);
+	for (int i = 0; i < 90; ++i) {
+		particles.update(frameTime);
+		if (i == 60) {
+			particles.setPosition(Vector2f(40, 20));
+		}
+	}
+	particles.updateSprites(frameTime);
+
+	const auto sprites = particles.getSprites();
+	ASSERT_EQ(sprites.size(), expectedCount);
+	for (const auto& e: expected) {
+		EXPECT_NEAR(sprites[e.index].getPosition().x, e.pos.x, 0.01f);
+		EXPECT_NEAR(sprites[e.index].getPosition().y, e.pos.y, 0.01f);
+		EXPECT_NEAR(sprites[e.index].getScale().x, e.scale, 0.001f);
+	}
+}
+
+TEST(Particles, EmittersDontShareRandomState)
+{
+	auto alone = makeParticles(makeSprayConfig());
+	auto interleaved = makeParticles(makeSprayConfig());
+	auto other = makeParticles(makeSprayConfig());
+	alone.setRandomSeed(7);
+	interleaved.setRandomSeed(7);
+
+	// Updating another emitter in between (as happens when they share a worker thread) mustn't change the outcome
+	for (int i = 0; i < 30; ++i) {
+		alone.update(frameTime);
+		other.update(frameTime);
+		interleaved.update(frameTime);
+	}
+	alone.updateSprites(frameTime);
+	interleaved.updateSprites(frameTime);
+
+	EXPECT_FALSE(alone.getSprites().empty());
+	EXPECT_EQ(getPositions(alone), getPositions(interleaved));
+}
+
+TEST(Particles, CopiesCarryOnTheSameSimulation)
+{
+	auto original = makeParticles(makeSprayConfig());
+	original.setRandomSeed(99);
+	for (int i = 0; i < 10; ++i) {
+		original.update(frameTime);
+	}
+
+	auto copy = makeParticles(makeSprayConfig());
+	copy = original;
+	for (int i = 0; i < 20; ++i) {
+		original.update(frameTime);
+		copy.update(frameTime);
+	}
+	original.updateSprites(frameTime);
+	copy.updateSprites(frameTime);
+
+	EXPECT_FALSE(copy.getSprites().empty());
+	EXPECT_EQ(getPositions(copy), getPositions(original));
+}
+
+TEST(Particles, GridDestroyOverlappingMatchesLinearScan)
+{
+	auto config = makeSprayConfig();
+	config["spawnRate"] = 2000.0f;
+	auto linear = makeParticles(config);
+	auto grid = makeParticles(config);
+	grid.setOverlapGridCellSize(8.0f);
+
+	auto run = [] (Particles& particles, auto destroy)
+	{
+		particles.setRandomSeed(42);
+		for (int i = 0; i < 30; ++i) {
+			particles.update(frameTime);
+		}
+		destroy(particles);
+		particles.update(frameTime);
+		particles.updateSprites(frameTime);
+	};
+
+	const auto polygon = Polygon(VertexList{ Vertex(-20, -30), Vertex(35, -10), Vertex(5, 40) });
+	auto destroyAll = [&] (Particles& particles)
+	{
+		// The first few queries after an update scan every particle anyway, the grid only kicks in after them
+		for (int i = 0; i < 4; ++i) {
+			particles.destroyOverlapping(Circle(Vector2f(-40.0f + 25.0f * float(i), -35), 4));
+		}
+		particles.destroyOverlapping(Circle(Vector2f(-30, 0), 15));
+		particles.destroyOverlapping(Ellipse(Vector2f(30, 10), Vector2f(20, 8)));
+		particles.destroyOverlapping(polygon);
+	};
+
+	auto untouched = makeParticles(config);
+	run(untouched, [] (Particles&) {});
+	run(linear, destroyAll);
+	run(grid, destroyAll);
+
+	// Same seed, so the only difference between them is which particles were destroyed
+	EXPECT_GT(linear.getSprites().size(), 100);
+	EXPECT_LT(linear.getSprites().size(), untouched.getSprites().size() - 100);
+	EXPECT_EQ(getPositions(grid), getPositions(linear));
+}
+
+TEST(Particles, FastForwardCatchesUp)
+{
+	ConfigNode config = ConfigNode::MapType();
+	config["spawnRate"] = 300.0f;
+	config["ttl"] = 1.0f;
+	config["speed"] = 10.0f;
+	config["startScale"] = 1.0f;
+	config["endScale"] = 0.0f;
+
+	auto reference = makeParticles(config);
+	auto fastForward = makeParticles(config);
+	fastForward.setOffscreenUpdate(ParticleOffscreenUpdate::FastForward);
+
+	// Off screen, fast forwarded emitters only simulate once per lifetime of their particles
+	for (int i = 0; i < 60; ++i) {
+		reference.update(frameTime);
+		fastForward.update(frameTime);
+	}
+	fastForward.setVisible(false);
+	for (int i = 0; i < 150; ++i) {
+		reference.update(frameTime);
+		fastForward.update(frameTime);
+	}
+	fastForward.setVisible(true);
+	fastForward.update(frameTime);
+	reference.update(frameTime);
+	reference.updateSprites(frameTime);
+	fastForward.updateSprites(frameTime);
+
+	// Scale goes linearly from 1 to 0 over the lifetime, so it gives away each particle's age
+	auto getAges = [] (const Particles& particles)
+	{
+		Vector<float> ages;
+		for (const auto& sprite: particles.getSprites()) {
+			ages.push_back(1.0f - sprite.getScale().x);
+		}
+		std::sort(ages.begin(), ages.end());
+		return ages;
+	};
+
+	const auto expected = getAges(reference);
+	const auto ages = getAges(fastForward);
+	// A frame spawns 5 particles, so that's how far apart stepping per frame and catching up in one go can drift
+	ASSERT_NEAR(float(ages.size()), float(expected.size()), 6.0f);
+	EXPECT_GE(ages.front(), 0.0f);
+	EXPECT_LT(ages.front(), 0.05f);
+	EXPECT_LT(ages.back(), 1.0f);
+	EXPECT_GT(ages.back(), 0.95f);
+	for (const float q: { 0.25f, 0.5f, 0.75f }) {
+		const auto at = [&] (const Vector<float>& v) { return v[static_cast<size_t>(q * float(v.size() - 1))]; };
+		EXPECT_NEAR(at(ages), at(expected), 0.02f);
+	}
+}
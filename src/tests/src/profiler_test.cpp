@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+using namespace Halley;
+
+TEST(Profiler, BootTrace)
+{
+	auto& capture = ProfilerCapture::get();
+	capture.startBootTrace();
+	EXPECT_TRUE(capture.isBootTracing());
+
+	{
+		ProfilerEvent outer(ProfilerEventType::CoreStartup, "outer");
+		ProfilerEvent inner(ProfilerEventType::ResourcesOpenPack, "inner \"pack\"");
+		std::thread([] ()
+		{
+			ProfilerCapture::get().setThreadName("worker");
+			ProfilerEvent event(ProfilerEventType::ExecutorTask);
+		}).join();
+	}
+
+	const auto data = capture.endBootTrace();
+	EXPECT_FALSE(capture.isBootTracing());
+
+	ASSERT_EQ(3u, data.getEvents().size());
+	EXPECT_EQ(0, data.getEvents()[0].depth);
+	EXPECT_EQ(1, data.getEvents()[1].depth);
+	EXPECT_EQ(2u, data.getThreads().size());
+
+	const auto json = data.toChromeTrace();
+	EXPECT_TRUE(json.contains("\"name\":\"outer\",\"cat\":\"CoreStartup\""));
+	EXPECT_TRUE(json.contains("\"name\":\"inner \\\"pack\\\"\""));
+	EXPECT_TRUE(json.contains("\"args\":{\"name\":\"worker\"}"));
+	EXPECT_TRUE(json.contains("\"name\":\"ExecutorTask\""));
+}
+
+TEST(Profiler, BootTraceDuringFrameCapture)
+{
+	ProfilerCapture capture(64);
+	capture.startBootTrace();
+	capture.startFrame(true);
+
+	const auto id = capture.recordEventStart(ProfilerEventType::CoreStartup, "both");
+	capture.recordEventEnd(id);
+	const auto unfinished = capture.recordEventStart(ProfilerEventType::WorldInit, "unfinished");
+	EXPECT_TRUE(unfinished.isValid());
+
+	capture.endFrame();
+	const auto frame = capture.getCapture();
+	const auto boot = capture.endBootTrace();
+
+	ASSERT_EQ(2u, frame.getEvents().size());
+	EXPECT_EQ(String("both"), frame.getEvents()[0].name);
+	ASSERT_EQ(2u, boot.getEvents().size());
+	EXPECT_EQ(String("both"), boot.getEvents()[0].name);
+
+	// The event that never ended is closed at the end of the trace, so it doesn't get a negative duration
+	const auto& open = boot.getEvents()[1];
+	EXPECT_GE(open.endTime, open.startTime);
+	EXPECT_FALSE(boot.toChromeTrace().contains("\"dur\":-"));
+	EXPECT_FALSE(frame.toChromeTrace().contains("\"dur\":-"));
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include <thread>
+#include "halley/scripting/script_environment.h"
+#include "halley/scripting/script_graph.h"
+#include "halley/scripting/script_state.h"
+#include "test_world.h"
+
+using namespace Halley;
+using namespace Halley::Test;
+
+namespace {
+	// start -> set entity:count to entity:count + 1
+	std::shared_ptr<ScriptGraph> makeCounterGraph(ScriptEnvironment& environment)
+	{
+		auto graph = std::make_shared<ScriptGraph>();
+		ConfigNode varSettings = ConfigNode::MapType();
+		varSettings["scope"] = "entity";
+		varSettings["variable"] = "count";
+		ConfigNode oneSettings = ConfigNode::MapType();
+		oneSettings["value"] = 1;
+		ConfigNode sumSettings = ConfigNode::MapType();
+		sumSettings["operator"] = "+";
+
+		const auto start = graph->getStartNode().value(); // New graphs come with one
+		const auto set = graph->addNode("setVariable", {}, ConfigNode::MapType());
+		const auto read = graph->addNode("variable", {}, ConfigNode(varSettings));
+		const auto write = graph->addNode("variable", {}, ConfigNode(varSettings));
+		const auto one = graph->addNode("literal", {}, std::move(oneSettings));
+		const auto sum = graph->addNode("arithmetic", {}, std::move(sumSettings));
+		environment.assignTypes(*graph);
+
+		graph->connectPins(start, 0, set, 0);
+		graph->connectPins(set, 2, sum, 2);
+		graph->connectPins(sum, 0, read, 1);
+		graph->connectPins(sum, 1, one, 0);
+		graph->connectPins(set, 3, write, 0);
+		graph->updateHash();
+		return graph;
+	}
+
+	struct ScriptedEntity {
+		EntityId id;
+		std::shared_ptr<ScriptState> state;
+		ScriptVariables variables;
+	};
+
+	Vector<ScriptedEntity> makeEntities(World& world, const std::shared_ptr<ScriptGraph>& graph, int count)
+	{
+		// Entity variables can only be written on entities this side has authority over, so they need to exist
+		Vector<ScriptedEntity> result(count);
+		for (int i = 0; i < count; ++i) {
+			result[i].id = world.createEntity("scripted").getEntityId();
+			result[i].state = std::make_shared<ScriptState>(std::shared_ptr<const ScriptGraph>(graph));
+			result[i].variables.setVariable("count", ConfigNode(i * 10));
+		}
+		world.spawnPending();
+		return result;
+	}
+}
+
+TEST(ScriptEnvironment, MakesWorkersByDefault)
+{
+	TestWorld testWorld;
+	ScriptEnvironment environment(testWorld.getAPI(), testWorld.getWorld(), testWorld.getResources(), std::make_shared<ScriptNodeTypeCollection>());
+	EXPECT_NE(environment.makeWorker(), nullptr);
+}
+
+TEST(ScriptEnvironment, EntityLocalGraph)
+{
+	TestWorld testWorld;
+	const auto nodeTypes = std::make_shared<ScriptNodeTypeCollection>();
+	ScriptEnvironment environment(testWorld.getAPI(), testWorld.getWorld(), testWorld.getResources(), nodeTypes);
+
+	const auto graph = makeCounterGraph(environment);
+	EXPECT_TRUE(graph->isEntityLocal(*nodeTypes));
+
+	graph->addNode("sendMessage", {}, ConfigNode::MapType());
+	EXPECT_FALSE(graph->isEntityLocal(*nodeTypes));
+}
+
+TEST(ScriptEnvironment, WorkersMatchSerialUpdate)
+{
+	constexpr int nEntities = 32;
+	constexpr size_t nWorkers = 4;
+
+	TestWorld testWorld;
+	ScriptEnvironment environment(testWorld.getAPI(), testWorld.getWorld(), testWorld.getResources(), std::make_shared<ScriptNodeTypeCollection>());
+	const auto graph = makeCounterGraph(environment);
+
+	auto serial = makeEntities(testWorld.getWorld(), graph, nEntities);
+	for (auto& e: serial) {
+		environment.update(0.1, *e.state, e.id, e.variables);
+	}
+
+	auto parallel = makeEntities(testWorld.getWorld(), graph, nEntities);
+	Vector<std::unique_ptr<ScriptEnvironment>> workers;
+	for (size_t i = 0; i < nWorkers; ++i) {
+		workers.push_back(environment.makeWorker());
+		environment.prepareWorker(*workers.back());
+	}
+	Vector<std::thread> threads;
+	for (size_t i = 0; i < nWorkers; ++i) {
+		threads.emplace_back([&, i] ()
+		{
+			for (size_t j = nEntities * i / nWorkers; j < nEntities * (i + 1) / nWorkers; ++j) {
+				workers[i]->update(0.1, *parallel[j].state, parallel[j].id, parallel[j].variables);
+			}
+		});
+	}
+	for (auto& t: threads) {
+		t.join();
+	}
+	for (auto& worker: workers) {
+		environment.mergeWorker(*worker);
+	}
+
+	for (int i = 0; i < nEntities; ++i) {
+		EXPECT_EQ(serial[i].variables.getVariable("count").asInt(-1), i * 10 + 1);
+		EXPECT_EQ(parallel[i].variables.getVariable("count").asInt(-1), i * 10 + 1);
+	}
+}
+
+TEST(ScriptEnvironment, MergesWorkersInOrder)
+{
+	TestWorld testWorld;
+	ScriptEnvironment environment(testWorld.getAPI(), testWorld.getWorld(), testWorld.getResources(), std::make_shared<ScriptNodeTypeCollection>());
+	auto first = environment.makeWorker();
+	auto second = environment.makeWorker();
+	environment.prepareWorker(*first);
+	environment.prepareWorker(*second);
+
+	environment.sendEntityMessage({ EntityId(), "main" });
+	second->sendEntityMessage({ EntityId(), "second" });
+	first->sendEntityMessage({ EntityId(), "first" });
+	environment.mergeWorker(*first);
+	environment.mergeWorker(*second);
+
+	const auto messages = environment.getOutboundEntityMessages();
+	ASSERT_EQ(messages.size(), 3);
+	EXPECT_EQ(messages[0].messageName, "main");
+	EXPECT_EQ(messages[1].messageName, "first");
+	EXPECT_EQ(messages[2].messageName, "second");
+	EXPECT_TRUE(first->getOutboundEntityMessages().empty());
+}
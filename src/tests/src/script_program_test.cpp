@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/scripting/script_environment.h"
+#include "halley/scripting/script_graph.h"
+#include "halley/scripting/script_program.h"
+#include "halley/scripting/script_state.h"
+#include "test_world.h"
+
+using namespace Halley;
+using namespace Halley::Test;
+
+namespace {
+	struct SampleGraph {
+		std::shared_ptr<ScriptGraph> graph = std::make_shared<ScriptGraph>();
+		GraphNodeId two, three, product, x, sum, square, greater, vector, doubled, text, concat, colour;
+		Vector<std::pair<GraphNodeId, GraphPinId>> outputs;
+
+		SampleGraph(ScriptEnvironment& environment)
+		{
+			auto& g = *graph;
+			auto literal = [&] (ConfigNode value)
+			{
+				ConfigNode settings = ConfigNode::MapType();
+				settings["value"] = std::move(value);
+				return g.addNode("literal", {}, std::move(settings));
+			};
+			auto binary = [&] (const String& type, const String& op)
+			{
+				ConfigNode settings = ConfigNode::MapType();
+				settings["operator"] = op;
+				return g.addNode(type, {}, std::move(settings));
+			};
+
+			two = literal(ConfigNode(2));
+			three = literal(ConfigNode(3));
+			product = binary("arithmetic", "*");
+			ConfigNode varSettings = ConfigNode::MapType();
+			varSettings["scope"] = "local";
+			varSettings["variable"] = "x";
+			x = g.addNode("variable", {}, std::move(varSettings));
+			sum = binary("arithmetic", "+");
+			square = binary("arithmetic", "*");
+			greater = binary("comparison", ">");
+			vector = g.addNode("toVector", {}, ConfigNode::MapType());
+			doubled = binary("arithmetic", "+");
+			text = literal(ConfigNode(String("x = ")));
+			concat = binary("arithmetic", "+");
+			ConfigNode colourSettings = ConfigNode::MapType();
+			colourSettings["value"] = "#FF0000";
+			colour = g.addNode("colourLiteral", {}, std::move(colourSettings));
+			environment.assignTypes(g);
+
+			// Inputs are pins 0 and 1 on all of these, literals output on pin 0 and variables on pin 1
+			g.connectPins(product, 0, two, 0);
+			g.connectPins(product, 1, three, 0);
+			g.connectPins(sum, 0, product, 2);
+			g.connectPins(sum, 1, x, 1);
+			g.connectPins(square, 0, sum, 2);
+			g.connectPins(square, 1, x, 1);
+			g.connectPins(greater, 0, square, 2);
+			g.connectPins(greater, 1, two, 0);
+			g.connectPins(vector, 0, x, 1);
+			g.connectPins(vector, 1, square, 2);
+			g.connectPins(doubled, 0, vector, 2);
+			g.connectPins(doubled, 1, vector, 2);
+			g.connectPins(concat, 0, text, 0);
+			g.connectPins(concat, 1, x, 1);
+			g.updateHash();
+			environment.assignTypes(g);
+
+			outputs = { { two, 0 }, { product, 2 }, { x, 1 }, { sum, 2 }, { square, 2 }, { greater, 2 }, { vector, 2 }, { doubled, 2 }, { concat, 2 }, { colour, 0 } };
+		}
+	};
+
+	class ScriptProgramTest : public ::testing::Test {
+	protected:
+		TestWorld testWorld;
+		ScriptEnvironment environment{ testWorld.getAPI(), testWorld.getWorld(), testWorld.getResources(), std::make_shared<ScriptNodeTypeCollection>() };
+		ScriptVariables entityVariables;
+	};
+}
+
+TEST_F(ScriptProgramTest, CompiledMatchesInterpreted)
+{
+	SampleGraph sample(environment);
+	ScriptState state(std::shared_ptr<const ScriptGraph>(sample.graph));
+	state.prepareStates(EntitySerializationContext(), 0);
+
+	for (const auto& value: { ConfigNode(1), ConfigNode(-4), ConfigNode(7), ConfigNode(2.5f), ConfigNode() }) {
+		state.getLocalVariables().setVariable("x", ConfigNode(value));
+
+		for (const auto& [nodeId, pinId]: sample.outputs) {
+			environment.setCompiledExpressionsEnabled(false);
+			const auto interpreted = environment.readNodeElementDevConData(state, EntityId(), entityVariables, nodeId, pinId);
+			environment.setCompiledExpressionsEnabled(true);
+			const auto compiled = environment.readNodeElementDevConData(state, EntityId(), entityVariables, nodeId, pinId);
+
+			EXPECT_EQ(compiled.getType(), interpreted.getType()) << "node " << nodeId << ", x = " << value.asString("undefined");
+			EXPECT_TRUE(compiled == interpreted) << "node " << nodeId << ", x = " << value.asString("undefined") << ": " << compiled.asString("") << " vs " << interpreted.asString("");
+		}
+	}
+
+	state.getLocalVariables().setVariable("x", ConfigNode(5));
+	EXPECT_EQ(environment.readNodeElementDevConData(state, EntityId(), entityVariables, sample.square, 2).asInt(), 55);
+	EXPECT_EQ(environment.readNodeElementDevConData(state, EntityId(), entityVariables, sample.doubled, 2).asVector2f(), Vector2f(10, 110));
+}
+
+TEST_F(ScriptProgramTest, LowersToInstructions)
+{
+	using OpCode = ScriptProgram::OpCode;
+
+	SampleGraph sample(environment);
+	const auto& program = sample.graph->getProgram();
+
+	// 2 * 3 is folded into a single constant
+	const auto product = program.getExpression(sample.product, 2);
+	ASSERT_GE(product, 0);
+	ASSERT_EQ(program.getInstructions(product).size(), 1);
+	EXPECT_EQ(program.getInstructions(product)[0].op, OpCode::PushConstant);
+
+	// (6 + x) * x reads x twice, through the same slot
+	const auto square = program.getExpression(sample.square, 2);
+	ASSERT_GE(square, 0);
+	ASSERT_EQ(program.getVariableSlots(square).size(), 1);
+	EXPECT_EQ(program.getVariableSlots(square)[0].name, Atom("x"));
+	EXPECT_EQ(program.getVariableSlots(square)[0].scope, ScriptVariableScope::Local);
+	const auto squareInstructions = program.getInstructions(square);
+	ASSERT_EQ(squareInstructions.size(), 5);
+	EXPECT_EQ(squareInstructions[0].op, OpCode::PushConstant);
+	EXPECT_EQ(squareInstructions[1].op, OpCode::LoadVariable);
+	EXPECT_EQ(squareInstructions[2].op, OpCode::Arithmetic);
+	EXPECT_EQ(squareInstructions[3].op, OpCode::LoadVariable);
+	EXPECT_EQ(squareInstructions[3].arg, squareInstructions[1].arg);
+	EXPECT_EQ(squareInstructions[4].op, OpCode::Arithmetic);
+
+	// toVector can't be lowered, so it's read through its node type
+	EXPECT_EQ(program.getExpression(sample.vector, 2), -1);
+	const auto doubled = program.getExpression(sample.doubled, 2);
+	ASSERT_GE(doubled, 0);
+	const auto doubledInstructions = program.getInstructions(doubled);
+	ASSERT_EQ(doubledInstructions.size(), 3);
+	EXPECT_EQ(doubledInstructions[0].op, OpCode::ReadPin);
+	EXPECT_EQ(doubledInstructions[0].arg, sample.vector);
+	EXPECT_EQ(doubledInstructions[0].pin, 2);
+}
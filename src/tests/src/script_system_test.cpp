@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/entity/components/transform_2d_component.h"
+#include "halley/entity/ecs_reflection_impl.h"
+#include "halley/entity/world_reflection.h"
+#include "halley/entity/services/dev_service.h"
+#include "halley/entity/services/scripting_service.h"
+#include "halley/scripting/script_environment.h"
+#include "halley/scripting/script_graph.h"
+#include "components/audio_listener_component.h"
+#include "components/audio_source_component.h"
+#include "components/camera_component.h"
+#include "components/colour_component.h"
+#include "components/embedded_script_component.h"
+#include "components/network_component.h"
+#include "components/particles_component.h"
+#include "components/script_tag_target_component.h"
+#include "components/script_target_component.h"
+#include "components/scriptable_component.h"
+#include "components/sprite_animation_component.h"
+#include "components/sprite_animation_replicator_component.h"
+#include "components/sprite_component.h"
+#include "components/text_label_component.h"
+#include "components/timeline_component.h"
+#include "components/velocity_component.h"
+#include "test_threads.h"
+#include "test_world.h"
+
+using namespace Halley;
+using namespace Halley::Test;
+
+Halley::System* halleyCreateScriptSystem();
+
+namespace {
+	class ScriptCodegen final : public CodegenFunctions {
+	public:
+		Vector<SystemReflector> makeSystemReflectors() override { return {}; }
+		Vector<std::unique_ptr<MessageReflector>> makeMessageReflectors() override { return {}; }
+		Vector<std::unique_ptr<SystemMessageReflector>> makeSystemMessageReflectors() override { return {}; }
+
+		Vector<std::unique_ptr<ComponentReflector>> makeComponentReflectors() override
+		{
+			// Indexed by componentIndex
+			Vector<std::unique_ptr<ComponentReflector>> result;
+			result.push_back(std::make_unique<ComponentReflectorImpl<Transform2DComponent>>());
+			result.push_back(std::make_unique<ComponentReflectorImpl<VelocityComponent>>());
+			result.push_back(std::make_unique<ComponentReflectorImpl<SpriteComponent>>());
+			result.push_back(std::make_unique<ComponentReflectorImpl<ColourComponent>>());
+			result.push_back(std::make_unique<ComponentReflectorImpl<TextLabelComponent>>());
+			result.push_back(std::make_unique<ComponentReflectorImpl<SpriteAnimationComponent>>());
+			result.push_back(std::make_unique<ComponentReflectorImpl<CameraComponent>>());
+			result.push_back(std::make_unique<ComponentReflectorImpl<ParticlesComponent>>());
+			result.push_back(std::make_unique<ComponentReflectorImpl<SpriteAnimationReplicatorComponent>>());
+			result.push_back(std::make_unique<ComponentReflectorImpl<AudioListenerComponent>>());
+			result.push_back(std::make_unique<ComponentReflectorImpl<AudioSourceComponent>>());
+			result.push_back(std::make_unique<ComponentReflectorImpl<ScriptableComponent>>());
+			result.push_back(std::make_unique<ComponentReflectorImpl<EmbeddedScriptComponent>>());
+			result.push_back(std::make_unique<ComponentReflectorImpl<ScriptTargetComponent>>());
+			result.push_back(std::make_unique<ComponentReflectorImpl<ScriptTagTargetComponent>>());
+			result.push_back(std::make_unique<ComponentReflectorImpl<NetworkComponent>>());
+			result.push_back(std::make_unique<ComponentReflectorImpl<TimelineComponent>>());
+			return result;
+		}
+	};
+
+	// A World running ScriptSystem on its own, with the engine's components
+	class ScriptTestWorld {
+	public:
+		ScriptTestWorld()
+		{
+			// ScriptingService's Lua state always loads the halley module, which isn't needed here
+			auto& resources = testWorld.getResources();
+			resources.init<BinaryFile>();
+			resources.of<BinaryFile>().setResource(0, "lua/halley/halley.lua", std::make_shared<BinaryFile>());
+
+			ScriptCodegen codegen;
+			world = std::make_unique<World>(testWorld.getAPI(), testWorld.getResources(), std::make_shared<WorldReflection>(codegen));
+			auto scripting = std::make_shared<ScriptingService>(makeEnvironment(), testWorld.getResources());
+			environment = &scripting->getEnvironment();
+			world->addService(std::move(scripting));
+			world->addService(std::make_shared<DevService>(false, false));
+			world->addSystem(std::unique_ptr<System>(halleyCreateScriptSystem()), TimeLine::VariableUpdate);
+		}
+
+		World& getWorld() { return *world; }
+		ScriptEnvironment& getEnvironment() { return *environment; }
+
+		EntityId addEntity(Vector<std::shared_ptr<const ScriptGraph>> scripts, int count)
+		{
+			ScriptableComponent scriptable;
+			for (auto& script: scripts) {
+				scriptable.scripts.emplace_back(std::move(script));
+			}
+			scriptable.variables.setVariable("count", ConfigNode(count));
+			return world->createEntity("scripted").addComponent(std::move(scriptable)).getEntityId();
+		}
+
+		int getCount(EntityId id)
+		{
+			return world->getEntity(id).getComponent<ScriptableComponent>().variables.getVariable("count").asInt(-1);
+		}
+
+	private:
+		TestWorld testWorld;
+		std::unique_ptr<World> world;
+		ScriptEnvironment* environment = nullptr;
+
+		std::unique_ptr<ScriptEnvironment> makeEnvironment()
+		{
+			return std::make_unique<ScriptEnvironment>(testWorld.getAPI(), *world, testWorld.getResources(), std::make_shared<ScriptNodeTypeCollection>());
+		}
+	};
+
+	// start -> every frame -> set entity:count to entity:count <op> value
+	std::shared_ptr<ScriptGraph> makeEveryFrameGraph(ScriptEnvironment& environment, const String& id, const String& op, int value)
+	{
+		auto graph = std::make_shared<ScriptGraph>();
+		ConfigNode varSettings = ConfigNode::MapType();
+		varSettings["scope"] = "entity";
+		varSettings["variable"] = "count";
+		ConfigNode valueSettings = ConfigNode::MapType();
+		valueSettings["value"] = value;
+		ConfigNode opSettings = ConfigNode::MapType();
+		opSettings["operator"] = op;
+
+		const auto start = graph->getStartNode().value();
+		const auto everyFrame = graph->addNode("everyFrame", {}, ConfigNode::MapType());
+		const auto set = graph->addNode("setVariable", {}, ConfigNode::MapType());
+		const auto read = graph->addNode("variable", {}, ConfigNode(varSettings));
+		const auto write = graph->addNode("variable", {}, ConfigNode(varSettings));
+		const auto literal = graph->addNode("literal", {}, std::move(valueSettings));
+		const auto arithmetic = graph->addNode("arithmetic", {}, std::move(opSettings));
+		environment.assignTypes(*graph);
+
+		graph->connectPins(start, 0, everyFrame, 0);
+		graph->connectPins(everyFrame, 1, set, 0);
+		graph->connectPins(set, 2, arithmetic, 2);
+		graph->connectPins(arithmetic, 0, read, 1);
+		graph->connectPins(arithmetic, 1, literal, 0);
+		graph->connectPins(set, 3, write, 0);
+		graph->setAssetId(id);
+		graph->updateHash();
+		return graph;
+	}
+}
+
+TEST(ScriptSystem, EntityLocalScriptsKeepTheirOrder)
+{
+	setupThreads();
+	ScriptTestWorld testWorld;
+	auto& environment = testWorld.getEnvironment();
+
+	const auto increment = makeEveryFrameGraph(environment, "increment", "+", 1);
+	const auto multiply = makeEveryFrameGraph(environment, "multiply", "*", 10);
+	// Never runs, but it stops the graph from being entity-local
+	multiply->addNode("sendMessage", {}, ConfigNode::MapType());
+	environment.assignTypes(*multiply);
+	multiply->updateHash();
+	ASSERT_TRUE(increment->isEntityLocal(environment.getNodeTypeCollection()));
+	ASSERT_FALSE(multiply->isEntityLocal(environment.getNodeTypeCollection()));
+
+	// Enough entity-local entities for the system to split them between workers
+	Vector<EntityId> counters;
+	for (int i = 0; i < 40; ++i) {
+		counters.push_back(testWorld.addEntity({ increment }, i * 100));
+	}
+	// The entity-local script comes after one that has to stay on the main thread, so it has to wait for it
+	const auto mixed = testWorld.addEntity({ multiply, increment }, 0);
+
+	// Every frame node fires once per step
+	constexpr int nSteps = 3;
+	for (int i = 0; i < nSteps; ++i) {
+		testWorld.getWorld().step(TimeLine::VariableUpdate, 1.0 / 60.0);
+	}
+
+	for (int i = 0; i < 40; ++i) {
+		EXPECT_EQ(testWorld.getCount(counters[i]), i * 100 + nSteps);
+	}
+	// Multiplying then incrementing on every step appends a 1 each time; the other way around would give 10, 110, 1110
+	EXPECT_EQ(testWorld.getCount(mixed), 111);
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <halley.hpp>
+#include <thread>
 using namespace Halley;
 
 namespace {
@@ -73,3 +74,81 @@ TEST(Serializer, UInt64Conversion)
 		EXPECT_EQ(n, convertBackAndForth(n));
 	}
 }
+
+TEST(Serializer, SinglePassMatchesTwoPass)
+{
+	Vector<EntityData> entities;
+	entities.reserve(1000);
+	for (int i = 0; i < 1000; ++i) {
+		auto& entity = entities.emplace_back(UUID::generate());
+		entity.setName("entity_" + toString(i));
+
+		ConfigNode::MapType transform;
+		transform["position"] = Vector2f(float(i), float(i * 2));
+		transform["rotation"] = float(i) * 0.1f;
+		ConfigNode::MapType sprite;
+		sprite["image"] = "sprites/image_" + toString(i % 100) + ".png";
+		sprite["layer"] = i % 8;
+		entity.setComponents({ { "Transform2D", ConfigNode(std::move(transform)) }, { "SpriteComponent", ConfigNode(std::move(sprite)) } });
+	}
+
+	// Dry run to measure, then serialize into an exact-size buffer
+	const auto size = Serializer::getSize(entities);
+	Bytes twoPass(size);
+	auto s = Serializer(twoPass.byte_span(), SerializerOptions());
+	s << entities;
+
+	const auto singlePass = Serializer::toBytes(entities);
+	auto pooled = Serializer::toPooledBytes(entities, {}, OutboundNetworkPacket::headerSpace);
+
+	EXPECT_EQ(twoPass, singlePass);
+	EXPECT_TRUE(SerializerBufferPool::isTight(singlePass));
+	ASSERT_EQ(twoPass.size() + OutboundNetworkPacket::headerSpace, pooled.size());
+	EXPECT_EQ(0, memcmp(twoPass.data(), pooled.data() + OutboundNetworkPacket::headerSpace, twoPass.size()));
+
+	const auto packet = OutboundNetworkPacket(std::move(pooled), OutboundNetworkPacket::headerSpace);
+	EXPECT_EQ(twoPass.size(), packet.getSize());
+
+	Vector<EntityData> result;
+	Deserializer::fromBytes(result, singlePass);
+	ASSERT_EQ(entities.size(), result.size());
+	EXPECT_EQ(entities[123].getName(), result[123].getName());
+	EXPECT_EQ(entities[123].getInstanceUUID(), result[123].getInstanceUUID());
+}
+
+TEST(Serializer, BufferPoolIsSharedAcrossThreads)
+{
+	SerializerBufferPool::clear();
+
+	// Packets are built on the game thread and released on the network thread, the buffer must still come back
+	auto buffer = SerializerBufferPool::acquire();
+	buffer.resize(1000);
+	const auto* data = buffer.data();
+	std::thread([&] ()
+	{
+		SerializerBufferPool::release(std::move(buffer));
+	}).join();
+
+	const auto reused = SerializerBufferPool::acquire();
+	EXPECT_EQ(data, reused.data());
+	EXPECT_TRUE(reused.empty());
+	EXPECT_GE(reused.capacity(), 1000u);
+}
+
+TEST(Serializer, LoosePooledBufferIsKeptInThePool)
+{
+	SerializerBufferPool::clear();
+
+	// A buffer that grew large for an earlier message shouldn't be handed out as the result of a small one
+	auto large = SerializerBufferPool::acquire();
+	large.reserve(100000);
+	const auto* data = large.data();
+	SerializerBufferPool::release(std::move(large));
+
+	const auto result = Serializer::toBytes(String("small"));
+	EXPECT_NE(data, result.data());
+	EXPECT_LE(result.capacity(), result.size() * 2);
+
+	const auto reused = SerializerBufferPool::acquire();
+	EXPECT_EQ(data, reused.data());
+}
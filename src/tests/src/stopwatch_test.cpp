@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+using namespace Halley;
+
+namespace {
+	void waitForClockToAdvance()
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+		while (std::chrono::high_resolution_clock::now() == start) {}
+	}
+}
+
+TEST(Stopwatch, ElapsedIncludesRunningInterval)
+{
+	Stopwatch timer;
+	waitForClockToAdvance();
+	const auto running = timer.elapsedNanoseconds();
+	EXPECT_GT(running, 0);
+	EXPECT_GE(timer.elapsedNanoseconds(), running);
+
+	timer.pause();
+	const auto paused = timer.elapsedNanoseconds();
+	EXPECT_GE(paused, running);
+	waitForClockToAdvance();
+	EXPECT_EQ(timer.elapsedNanoseconds(), paused);
+}
+
+TEST(Stopwatch, ResetRestartsRunningInterval)
+{
+	Stopwatch timer;
+	waitForClockToAdvance();
+
+	// Started after the timer, so it can only be shorter if the reset didn't restart the timer
+	Stopwatch bracket;
+	timer.reset();
+	timer.pause();
+	bracket.pause();
+	EXPECT_LE(timer.elapsedNanoseconds(), bracket.elapsedNanoseconds());
+
+	timer.reset();
+	EXPECT_EQ(timer.elapsedNanoseconds(), 0);
+}
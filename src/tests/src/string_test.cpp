@@ -0,0 +1,23 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+using namespace Halley;
+
+TEST(HalleyString, CodePoints)
+{
+	const Vector<String> strings = {
+		"",
+		"hello",
+		"caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80",
+		"bad \x80 continuation \xC3\x41",
+		"truncated \xE2\x82"
+	};
+
+	for (const auto& str: strings) {
+		StringUTF32 decoded;
+		for (const char32_t c: str.getCodePoints()) {
+			decoded.push_back(c);
+		}
+		EXPECT_EQ(decoded, str.getUTF32());
+		EXPECT_EQ(str.getCodePoints().size(), str.getUTF32Len());
+	}
+}
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "test_threads.h"
+#include "test_text.h"
+using namespace Halley;
+using namespace Halley::Test;
+
+namespace {
+	void expectSameSprites(gsl::span<const Sprite> a, gsl::span<const Sprite> b)
+	{
+		ASSERT_EQ(a.size(), b.size());
+		for (size_t i = 0; i < a.size(); ++i) {
+			EXPECT_EQ(a[i].getPosition(), b[i].getPosition());
+			EXPECT_EQ(a[i].getSize(), b[i].getSize());
+			EXPECT_EQ(a[i].getColour(), b[i].getColour());
+		}
+	}
+}
+
+TEST(TextRenderer, BatchedSpritesMatchSerial)
+{
+	setupThreads();
+
+	// Both below and above the size where batches start being spread over threads
+	const auto font = makeTextFont();
+	const size_t n = TextRenderer::minParallelBatchSize * 2;
+	const auto serial = makeTextRenderers(font, n);
+	auto batched = makeTextRenderers(font, n);
+	auto small = makeTextRenderers(font, 10);
+
+	for (const auto& text: serial) {
+		text.generateSprites();
+	}
+	TextRenderer::generateSprites(batched);
+	TextRenderer::generateSprites(small);
+
+	for (size_t i = 0; i < serial.size(); ++i) {
+		expectSameSprites(serial[i].getSprites(), batched[i].getSprites());
+	}
+	for (size_t i = 0; i < small.size(); ++i) {
+		expectSameSprites(serial[i].getSprites(), small[i].getSprites());
+	}
+
+	// Renderers that changed since the last batch are generated again
+	Vector<const TextRenderer*> pointers;
+	for (const auto& text: batched) {
+		pointers.push_back(&text);
+	}
+	batched[7].setPosition(serial[7].getPosition() + Vector2f(100, 50));
+	TextRenderer::generateSprites(pointers);
+	const auto delta = batched[7].getSprites()[0].getPosition() - serial[7].getSprites()[0].getPosition();
+	EXPECT_FLOAT_EQ(delta.x, 100.0f);
+	EXPECT_FLOAT_EQ(delta.y, 50.0f);
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "test_ui.h"
+
+using namespace Halley;
+using namespace Halley::Test;
+
+namespace {
+	constexpr std::string_view labelStyle = R"(
+uiStyle:
+  label:
+    label: { font: Ubuntu Bold, size: 12, colour: "#FFFFFF" }
+)";
+
+	class UILayoutTest : public ::testing::Test {
+	protected:
+		TestUI ui{ labelStyle };
+		std::shared_ptr<UIWidget> panel = std::make_shared<UIWidget>("panel", Vector2f(400, 300), UISizer(UISizerType::Vertical));
+		std::shared_ptr<UIWidget> rowA = std::make_shared<UIWidget>("rowA", Vector2f(), UISizer(UISizerType::Vertical));
+		std::shared_ptr<UIWidget> rowB = std::make_shared<UIWidget>("rowB", Vector2f(), UISizer(UISizerType::Vertical));
+		std::shared_ptr<UILabel> labelA1;
+		std::shared_ptr<UILabel> labelA2;
+		std::shared_ptr<UILabel> labelB1;
+		std::shared_ptr<UILabel> labelB2;
+
+		void SetUp() override
+		{
+			labelA1 = makeLabel("labelA1");
+			labelA2 = makeLabel("labelA2");
+			labelB1 = makeLabel("labelB1");
+			labelB2 = makeLabel("labelB2");
+
+			// Rows and labels fill the width of the panel, so a longer label doesn't resize anything
+			rowA->add(labelA1);
+			rowA->add(labelA2);
+			rowB->add(labelB1);
+			rowB->add(labelB2);
+			panel->add(rowA);
+			panel->add(rowB);
+			ui.getRoot().addChild(panel);
+
+			ui.update();
+			ui.update();
+		}
+
+		std::shared_ptr<UILabel> makeLabel(const String& id)
+		{
+			return std::make_shared<UILabel>(id, ui.getStyle("label"), LocalisedString::fromHardcodedString("a"));
+		}
+	};
+}
+
+TEST_F(UILayoutTest, NothingChangedSkipsEverything)
+{
+	ui.update();
+	const auto& stats = ui.getRoot().getLayoutStats();
+	EXPECT_EQ(stats.invalidations, 0);
+	EXPECT_EQ(stats.widgetsMeasured, 0);
+	EXPECT_EQ(stats.widgetsArranged, 0);
+	EXPECT_EQ(stats.widgetsSkipped, 1); // The panel
+}
+
+TEST_F(UILayoutTest, LabelChangeOnlyArrangesItsPath)
+{
+	labelA1->setText(LocalisedString::fromHardcodedString("abc"));
+	ui.update();
+
+	const auto& stats = ui.getRoot().getLayoutStats();
+	EXPECT_EQ(stats.invalidations, 1);
+	EXPECT_EQ(stats.firstInvalidatedBy, "labelA1");
+	EXPECT_EQ(stats.widgetsMeasured, 2); // panel and rowA
+	EXPECT_EQ(stats.widgetsArranged, 3); // panel, rowA and labelA1
+	EXPECT_EQ(stats.widgetsSkipped, 2); // labelA2 and rowB
+
+	// Turning incremental layout off arranges everything
+	ui.getRoot().setIncrementalLayout(false);
+	ui.update();
+	EXPECT_EQ(ui.getRoot().getLayoutStats().widgetsArranged, 7);
+	EXPECT_EQ(ui.getRoot().getLayoutStats().widgetsSkipped, 0);
+}
+
+TEST_F(UILayoutTest, MovingLeafInSizerIsPlacedBack)
+{
+	const auto sizerPos = labelB2->getPosition();
+	labelB2->setPosition(sizerPos + Vector2f(5, 0));
+	ui.update();
+
+	// Only its row places it again, nothing has to be measured
+	const auto& stats = ui.getRoot().getLayoutStats();
+	EXPECT_EQ(stats.invalidations, 0);
+	EXPECT_EQ(stats.widgetsMeasured, 0);
+	EXPECT_EQ(stats.widgetsArranged, 3); // panel, rowB and labelB2
+	EXPECT_EQ(stats.widgetsSkipped, 2); // rowA and labelB1
+	EXPECT_EQ(labelB2->getPosition(), sizerPos);
+}
+
+TEST_F(UILayoutTest, MovingWidgetWithChildrenInvalidates)
+{
+	rowB->setPosition(rowB->getPosition() + Vector2f(5, 0));
+	ui.update();
+
+	const auto& stats = ui.getRoot().getLayoutStats();
+	EXPECT_EQ(stats.invalidations, 1);
+	EXPECT_EQ(stats.firstInvalidatedBy, "rowB");
+	EXPECT_EQ(stats.widgetsArranged, 2); // panel and rowB, which is placed back
+	EXPECT_EQ(stats.widgetsSkipped, 3); // rowA and rowB's labels, which never moved
+}
+
+TEST_F(UILayoutTest, MovingRootWidgetOnlyArrangesItself)
+{
+	// Like a tooltip, moved by its anchor every frame without being in a sizer
+	auto tooltip = makeLabel("tooltip");
+	ui.getRoot().addChild(tooltip);
+	ui.update();
+	ui.update();
+
+	tooltip->setPosition(Vector2f(100, 100));
+	ui.update();
+
+	const auto& stats = ui.getRoot().getLayoutStats();
+	EXPECT_EQ(stats.invalidations, 1);
+	EXPECT_EQ(stats.firstInvalidatedBy, "tooltip");
+	EXPECT_EQ(stats.widgetsArranged, 1);
+	EXPECT_EQ(stats.widgetsSkipped, 1); // The panel
+	EXPECT_EQ(tooltip->getPosition(), Vector2f(100, 100));
+}
+
+TEST_F(UILayoutTest, ScrollingNestedPaneMovesItsChildren)
+{
+	auto pane = std::make_shared<UIScrollPane>("pane", Vector2f(100, 50), UISizer(UISizerType::Vertical));
+	Vector<std::shared_ptr<UIWidget>> items;
+	for (int i = 0; i < 5; ++i) {
+		items.push_back(std::make_shared<UIWidget>("item" + toString(i), Vector2f(50, 40)));
+		pane->add(items.back());
+	}
+	rowB->add(pane);
+	ui.update();
+	ui.update();
+
+	const auto before = items[2]->getPosition();
+	pane->scrollTo(Vector2f(0, 20));
+	ui.update();
+
+	EXPECT_EQ(pane->getScrollPosition(), Vector2f(0, 20));
+	EXPECT_EQ(items[2]->getPosition(), before - Vector2f(0, 20));
+	EXPECT_EQ(ui.getRoot().getLayoutStats().widgetsMeasured, 0);
+}
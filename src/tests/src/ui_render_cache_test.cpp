@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "test_ui.h"
+
+using namespace Halley;
+using namespace Halley::Test;
+
+namespace {
+	constexpr std::string_view labelStyle = R"(
+uiStyle:
+  label:
+    label: { font: Ubuntu Bold, size: 12, colour: "#FFFFFF" }
+)";
+
+	// Draws its children with a clip and colour that it changes without marking anything as needing redraw,
+	// the same way a cached subtree sees a scrolling or fading ancestor
+	class PaintStateWidget final : public UIWidget {
+	public:
+		PaintStateWidget()
+			: UIWidget("paintState", {}, UISizer())
+		{}
+
+		std::optional<Rect4f> clip;
+		std::optional<Colour4f> colour;
+
+	protected:
+		void drawChildren(UIPainter& painter) const override
+		{
+			auto p = painter.withClip(clip);
+			if (colour) {
+				p = p.withColour(*colour);
+			}
+			UIWidget::drawChildren(p);
+		}
+	};
+
+	class UIRenderCacheTest : public ::testing::Test {
+	protected:
+		TestUI ui{ labelStyle };
+		std::shared_ptr<PaintStateWidget> paintState = std::make_shared<PaintStateWidget>();
+		std::shared_ptr<UIWidget> panel = std::make_shared<UIWidget>("panel", Vector2f(), UISizer(UISizerType::Vertical));
+		std::shared_ptr<UILabel> title;
+		std::shared_ptr<UILabel> body;
+
+		void SetUp() override
+		{
+			title = std::make_shared<UILabel>("title", ui.getStyle("label"), LocalisedString::fromHardcodedString("Title"));
+			body = std::make_shared<UILabel>("body", ui.getStyle("label"), LocalisedString::fromHardcodedString("Some text"));
+			panel->add(title);
+			panel->add(body);
+			panel->setRenderCached(true);
+			paintState->add(panel);
+			ui.getRoot().addChild(paintState);
+		}
+
+		// Updates and draws a frame
+		UIRenderStats frame()
+		{
+			ui.update();
+			return ui.draw();
+		}
+	};
+}
+
+TEST_F(UIRenderCacheTest, SecondDrawReplays)
+{
+	const auto first = frame();
+	EXPECT_EQ(first.subtreesRecorded, 1);
+	EXPECT_EQ(first.subtreesReused, 0);
+	EXPECT_EQ(first.widgetsDrawn, 4); // paintState, panel and both labels
+
+	const auto second = frame();
+	EXPECT_EQ(second.subtreesRecorded, 0);
+	EXPECT_EQ(second.subtreesReused, 1);
+	EXPECT_EQ(second.widgetsDrawn, 1);
+	EXPECT_EQ(second.widgetsReused, 3);
+}
+
+TEST_F(UIRenderCacheTest, ChangedLabelRerecords)
+{
+	frame();
+	frame();
+
+	body->setText(LocalisedString::fromHardcodedString("Some other text"));
+	const auto changed = frame();
+	EXPECT_EQ(changed.subtreesRecorded, 1);
+	EXPECT_EQ(changed.subtreesReused, 0);
+	EXPECT_EQ(changed.widgetsDrawn, 4);
+
+	// Setting the same text doesn't invalidate anything
+	body->setText(LocalisedString::fromHardcodedString("Some other text"));
+	const auto same = frame();
+	EXPECT_EQ(same.subtreesRecorded, 0);
+	EXPECT_EQ(same.subtreesReused, 1);
+}
+
+TEST_F(UIRenderCacheTest, ChangedClipOrColourBlocksReplay)
+{
+	frame();
+	ASSERT_EQ(frame().subtreesReused, 1);
+
+	paintState->clip = Rect4f(0, 0, 400, 300);
+	EXPECT_EQ(frame().subtreesRecorded, 1);
+	EXPECT_EQ(frame().subtreesReused, 1);
+
+	paintState->clip = Rect4f(0, 10, 400, 300);
+	EXPECT_EQ(frame().subtreesRecorded, 1);
+	EXPECT_EQ(frame().subtreesReused, 1);
+
+	paintState->colour = Colour4f(1, 0, 0, 1);
+	EXPECT_EQ(frame().subtreesRecorded, 1);
+	EXPECT_EQ(frame().subtreesReused, 1);
+
+	paintState->colour = Colour4f(1, 1, 1, 0.5f);
+	EXPECT_EQ(frame().subtreesRecorded, 1);
+	EXPECT_EQ(frame().subtreesReused, 1);
+}
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "test_ui.h"
+
+using namespace Halley;
+using namespace Halley::Test;
+
+namespace {
+	constexpr std::string_view listStyle = R"(
+uiStyle:
+  list:
+    background: ""
+    innerBorder: [0, 0, 0, 0]
+    scrollBorder: [0, 0, 0, 0]
+    gap: 0
+    rowHeight: 20
+    label: { font: Ubuntu Bold, size: 12, colour: "#FFFFFF" }
+    item:
+      innerBorder: [2, 2, 2, 2]
+      normal: ""
+      hover: ""
+      selected: ""
+)";
+
+	class ItemSource final : public IUIVirtualListSource {
+	public:
+		explicit ItemSource(size_t count)
+		{
+			for (size_t i = 0; i < count; ++i) {
+				items.push_back("item" + toString(i));
+			}
+		}
+
+		size_t getCount() const override { return items.size(); }
+		String getId(size_t idx) const override { return items[idx]; }
+		LocalisedString getLabel(size_t idx) const override { return LocalisedString::fromUserString(items[idx]); }
+
+		Vector<String> items;
+	};
+
+	class UIVirtualListTest : public ::testing::Test {
+	protected:
+		static constexpr size_t nItems = 10000;
+		static constexpr float rowHeight = 20;
+		static constexpr float viewHeight = 200;
+
+		TestUI ui{ listStyle };
+		std::shared_ptr<ItemSource> source = std::make_shared<ItemSource>(nItems);
+		std::shared_ptr<UIVirtualList> list;
+		std::shared_ptr<UIScrollPane> pane;
+
+		void SetUp() override
+		{
+			list = std::make_shared<UIVirtualList>("list", ui.getStyle("list"), source);
+			list->setMinSize(Vector2f(100, 0));
+			pane = std::make_shared<UIScrollPane>("pane", Vector2f(100, viewHeight), UISizer());
+			pane->add(list, 1);
+			ui.getRoot().addChild(pane);
+
+			// The pane only knows the size of its contents after the first layout
+			ui.update();
+			ui.update();
+		}
+
+		// Index of each row widget that currently shows a row
+		Vector<int> getBoundRows() const
+		{
+			Vector<int> result;
+			for (const auto& c: list->getChildren()) {
+				if (c->isActive()) {
+					result.push_back(std::dynamic_pointer_cast<UIVirtualListRow>(c)->getIndex());
+				}
+			}
+			return result;
+		}
+
+		std::pair<int, int> getVisibleRows() const
+		{
+			const auto rows = getBoundRows();
+			return { *std::min_element(rows.begin(), rows.end()), *std::max_element(rows.begin(), rows.end()) };
+		}
+	};
+}
+
+TEST_F(UIVirtualListTest, OnlyCreatesVisibleRows)
+{
+	EXPECT_FLOAT_EQ(list->getSize().y, nItems * rowHeight);
+	EXPECT_EQ(list->getNumberOfRowWidgets(), size_t(viewHeight / rowHeight));
+	EXPECT_EQ(list->getChildren().size(), list->getNumberOfRowWidgets());
+	EXPECT_EQ(getVisibleRows(), std::make_pair(0, 9));
+
+	// Row widgets are bound to the rows they show
+	for (const auto& c: list->getChildren()) {
+		const auto& row = dynamic_cast<const UIVirtualListRow&>(*c);
+		EXPECT_EQ(row.getId(), source->items[row.getIndex()]);
+	}
+}
+
+TEST_F(UIVirtualListTest, RecyclesRowsWhenScrolling)
+{
+	const auto before = getBoundRows();
+
+	// Scrolling by one row rebinds a single widget, from the row that went out of view to the one that came in
+	pane->scrollTo(Vector2f(0, rowHeight));
+	ui.update();
+	const auto after = getBoundRows();
+	ASSERT_EQ(after.size(), before.size());
+	int changed = 0;
+	for (size_t i = 0; i < before.size(); ++i) {
+		if (before[i] != after[i]) {
+			EXPECT_EQ(before[i], 0);
+			EXPECT_EQ(after[i], 10);
+			++changed;
+		}
+	}
+	EXPECT_EQ(changed, 1);
+
+	// Jumping far away reuses the same widgets
+	pane->scrollTo(Vector2f(0, 5000 * rowHeight));
+	ui.update();
+	EXPECT_EQ(getVisibleRows(), std::make_pair(5000, 5009));
+	EXPECT_EQ(list->getNumberOfRowWidgets(), size_t(viewHeight / rowHeight));
+}
+
+TEST_F(UIVirtualListTest, ScrollsToSelection)
+{
+	list->setSelectedOptionId("item7000");
+	ui.update();
+	ui.update();
+
+	EXPECT_EQ(list->getSelectedOption(), 7000);
+	const auto scroll = pane->getScrollPosition().y;
+	EXPECT_LE(scroll, 7000 * rowHeight);
+	EXPECT_GE(scroll + viewHeight, 7001 * rowHeight);
+
+	const auto [first, last] = getVisibleRows();
+	EXPECT_LE(first, 7000);
+	EXPECT_GE(last, 7000);
+}
+
+TEST_F(UIVirtualListTest, SelectionFollowsIds)
+{
+	list->setMultiSelect(true);
+	list->setSelectedOption(10);
+	list->setSelectedOption(14, UIVirtualList::SelectionMode::ShiftSelect);
+	list->setSelectedOption(20, UIVirtualList::SelectionMode::CtrlSelect);
+	EXPECT_EQ(list->getSelectedOptions(), Vector<int>({ 10, 11, 12, 13, 14, 20 }));
+
+	// Reversing the source moves the selection with the items, once the list is refreshed
+	std::reverse(source->items.begin(), source->items.end());
+	list->refresh();
+	const int n = int(nItems) - 1;
+	EXPECT_EQ(list->getSelectedOptions(), Vector<int>({ n - 20, n - 14, n - 13, n - 12, n - 11, n - 10 }));
+	EXPECT_EQ(list->getSelectedOptionIds().size(), 6);
+	EXPECT_TRUE(list->isSelected(n - 12));
+
+	// Removed items are dropped from the selection
+	source->items.erase(source->items.begin() + (n - 20));
+	list->refresh();
+	EXPECT_EQ(list->getSelectedOptionIds().size(), 5);
+	EXPECT_FALSE(std_ex::contains(list->getSelectedOptionIds(), String("item20")));
+}
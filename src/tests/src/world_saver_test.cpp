@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/entity/world_saver.h"
+#include "test_world.h"
+
+using namespace Halley;
+using namespace Halley::Test;
+
+namespace {
+	Vector<EntityRef> makeRoots(World& world)
+	{
+		const auto first = world.createEntity("first")
+			.addComponent(Transform2DComponent(Vector2f(1, 2)))
+			.addComponent(TestCounterComponent(1))
+			.getEntityId();
+		world.createEntity("child", first)
+			.addComponent(Transform2DComponent(Vector2f(0, 1)))
+			.addComponent(TestCounterComponent(2));
+		const auto second = world.createEntity("second")
+			.addComponent(Transform2DComponent(Vector2f(3, 4)))
+			.addComponent(TestCounterComponent(3))
+			.getEntityId();
+		world.spawnPending();
+
+		return { world.getEntity(first), world.getEntity(second) };
+	}
+}
+
+TEST(WorldSaver, ReencodesOnlyChangedComponents)
+{
+	TestWorld testWorld;
+	auto roots = makeRoots(testWorld.getWorld());
+	WorldSaver saver(testWorld.getWorld(), testWorld.getResources());
+
+	const auto first = saver.capture(roots);
+	EXPECT_EQ(first->getReport().entitiesSerialized, 2);
+	EXPECT_EQ(first->getReport().componentsSerialized, 6);
+	EXPECT_EQ(first->getReport().componentsReused, 0);
+
+	roots[0].getComponent<TestCounterComponent>().setCount(10);
+
+	const auto second = saver.capture(roots);
+	EXPECT_EQ(second->getReport().entitiesSerialized, 1);
+	EXPECT_EQ(second->getReport().entitiesReused, 1);
+	EXPECT_EQ(second->getReport().componentsSerialized, 1);
+	EXPECT_EQ(second->getReport().componentsReused, 3);
+	EXPECT_EQ(second->getEntities()[1], first->getEntities()[1]);
+
+	// Nothing changed since
+	const auto third = saver.capture(roots);
+	EXPECT_EQ(third->getReport().entitiesSerialized, 0);
+	EXPECT_EQ(third->getReport().componentsSerialized, 0);
+}
+
+TEST(WorldSaver, AddedComponentIsReencoded)
+{
+	TestWorld testWorld;
+	auto roots = makeRoots(testWorld.getWorld());
+	WorldSaver saver(testWorld.getWorld(), testWorld.getResources());
+	saver.capture(roots);
+
+	// A new component starts at the same revision as the one it replaces, so it must not be mistaken for it
+	roots[1].removeComponent<TestCounterComponent>();
+	roots[1].addComponent(TestCounterComponent(30));
+
+	const auto snapshot = saver.capture(roots);
+	EXPECT_EQ(snapshot->getReport().componentsSerialized, 2);
+	EXPECT_EQ(snapshot->getEntities()[1]->getComponents()[1].second["count"].asInt(), 30);
+}
+
+TEST(WorldSaver, EncodesAsScene)
+{
+	TestWorld testWorld;
+	auto roots = makeRoots(testWorld.getWorld());
+	WorldSaver saver(testWorld.getWorld(), testWorld.getResources());
+	saver.capture(roots);
+	roots[0].getComponent<TestCounterComponent>().setCount(10);
+
+	const auto scene = WorldSaver::decode(saver.capture(roots)->encode());
+	ASSERT_TRUE(scene->isScene());
+	ASSERT_EQ(scene->getEntityDatas().size(), 2);
+
+	TestWorld loadedWorld;
+	EntityFactory factory(loadedWorld.getWorld(), loadedWorld.getResources());
+	const auto loaded = factory.createScene(scene, false);
+	loadedWorld.getWorld().spawnPending();
+
+	ASSERT_EQ(loaded.getEntities().size(), 2);
+	auto entity = loadedWorld.getWorld().getEntity(loaded.getEntities()[0]);
+	EXPECT_EQ(entity.getName(), "first");
+	EXPECT_EQ(entity.getComponent<TestCounterComponent>().getCount(), 10);
+	EXPECT_EQ((*entity.getChildren().begin()).getComponent<TestCounterComponent>().getCount(), 2);
+}
@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include <random>
+#include "test_yaml.h"
+using namespace Halley;
+using namespace Halley::Test;
+
+TEST(YAMLConvert, Parse)
+{
+	const auto node = YAMLConvert::parseConfig(String(
+		"name: hero\n"
+		"speed: 4.5\n"
+		"count: 3\n"
+		"enabled: true\n"
+		"\"quoted: key\": '12'\n"
+		"tags: [fast, \"with, comma\"]\n"
+		"base: &base\n"
+		"  hp: 10\n"
+		"copy: *base\n"
+		"children:\n"
+		"  - a: 1\n"
+		"  - ~\n"));
+
+	EXPECT_EQ(node["name"].asString(), "hero");
+	EXPECT_EQ(node["speed"].getType(), ConfigNodeType::Float);
+	EXPECT_EQ(node["count"].getType(), ConfigNodeType::Int);
+	EXPECT_EQ(node["enabled"].getType(), ConfigNodeType::Bool);
+	EXPECT_EQ(node["quoted: key"].asInt(), 12);
+	EXPECT_EQ(node["tags"][1].asString(), "with, comma");
+	EXPECT_EQ(node["copy"]["hp"].asInt(), 10);
+	EXPECT_EQ(node["children"][0]["a"].asInt(), 1);
+	EXPECT_EQ(node["children"][1].getType(), ConfigNodeType::Undefined);
+
+	const auto pairs = YAMLConvert::parseConfig(String("b: 1\na: 2\n"), YAMLConvert::ParseOptions(true));
+	ASSERT_EQ(pairs.getSequenceSize(), 2);
+	EXPECT_EQ(pairs[0]["key"].asString(), "b");
+	EXPECT_EQ(pairs[0]["value"].asInt(), 1);
+}
+
+TEST(YAMLConvert, Emit)
+{
+	ConfigNode node = ConfigNode::MapType();
+	node["name"] = "hero";
+	node["position"] = Vector2f(1.5f, 2.0f);
+	node["tags"] = ConfigNode::SequenceType();
+	node["tags"].asSequence().push_back(ConfigNode("a: b"));
+	node["tags"].asSequence().push_back(ConfigNode(""));
+	node["children"] = ConfigNode::SequenceType();
+	auto& child = node["children"].asSequence().emplace_back(ConfigNode::MapType());
+	child["x"] = 1;
+	child["y"] = ConfigNode::MapType();
+	child["y"]["z"] = ConfigNode::SequenceType();
+	child["y"]["z"].asSequence().push_back(ConfigNode::SequenceType());
+	node["empty"] = ConfigNode::MapType();
+
+	const auto yaml = YAMLConvert::generateYAML(node, YAMLConvert::EmitOptions({ "name" }));
+	EXPECT_EQ(yaml,
+		"name: hero\n"
+		"children:\n"
+		"  - x: 1\n"
+		"    y:\n"
+		"      z: [[]]\n"
+		"empty: {}\n"
+		"position: [1.5, 2]\n"
+		"tags: [\"a: b\", \"\"]");
+
+	EXPECT_TRUE(YAMLConvert::parseConfig(yaml) == node);
+}
+
+namespace {
+	void expectSameAsReference(const ConfigNode& node)
+	{
+		for (const bool compactMaps: { false, true }) {
+			const auto options = YAMLConvert::EmitOptions({}, compactMaps);
+			const auto yaml = YAMLConvert::generateYAML(node, options);
+			EXPECT_EQ(yaml, ReferenceYAMLEmitter::generateYAML(node, options)) << "compactMaps: " << compactMaps;
+		}
+	}
+
+	ConfigNode makeRandomNode(std::mt19937& rng, int depth, bool allowInt64 = true)
+	{
+		constexpr const char* pieces[] = { "a", "hello", " ", ":", ": ", "#", " #", "- ", "?", ",", "[", "]", "{", "}", "'", "\"", "\\", "\n", "\t", "\r\n", "~", "null", "true", "1", "2.5", "\xC3\xA9", "\x01", "&", "*", "!", "|", ">", "%", "@", "`" };
+		auto makeString = [&]
+		{
+			String result;
+			for (int i = static_cast<int>(rng() % 4); i > 0; --i) {
+				result += pieces[rng() % std::size(pieces)];
+			}
+			return result;
+		};
+
+		switch (rng() % (depth > 3 ? 8 : 12)) {
+		case 0:
+			return ConfigNode(static_cast<int>(rng() % 2000) - 1000);
+		case 1:
+			return ConfigNode(static_cast<float>(static_cast<int>(rng() % 20000) - 10000) / static_cast<float>(1 + rng() % 100));
+		case 2:
+			return ConfigNode(rng() % 2 == 0);
+		case 3:
+		case 4:
+			return ConfigNode(makeString());
+		case 5:
+			return ConfigNode(Vector2i(static_cast<int>(rng() % 10), static_cast<int>(rng() % 10)));
+		case 6:
+			return ConfigNode(Vector2f(0.1f * static_cast<float>(rng() % 10), 0.3f));
+		case 7:
+			if (!allowInt64) {
+				return ConfigNode(static_cast<int>(rng() % 2000) - 1000);
+			}
+			return ConfigNode(static_cast<int64_t>(rng()) << 20);
+		case 8:
+		case 9:
+		{
+			ConfigNode::SequenceType seq;
+			for (int i = static_cast<int>(rng() % 4); i > 0; --i) {
+				seq.push_back(rng() % 10 == 0 ? ConfigNode() : makeRandomNode(rng, depth + 1, allowInt64));
+			}
+			return ConfigNode(std::move(seq));
+		}
+		default:
+		{
+			ConfigNode::MapType map;
+			for (int i = static_cast<int>(rng() % 4); i > 0; --i) {
+				map[makeString()] = rng() % 10 == 0 ? ConfigNode() : makeRandomNode(rng, depth + 1, allowInt64);
+			}
+			return ConfigNode(std::move(map));
+		}
+		}
+	}
+}
+
+TEST(YAMLConvert, EmitMatchesYAMLCpp)
+{
+	// Strings that need quoting or escaping
+	for (const auto* str: { "", " ", "plain", " leading", "trailing ", "a: b", "a:b", "#comment", "a #b", "- item", "-", "?", "[x]", "{x}", "x, y", "'single'", "\"double\"", "back\\slash",
+		"true", "False", "yes", "no", "null", "~", "1", "-2", "3.5", "1e10", ".inf", "0x1F", "&anchor", "*alias", "!tag", "|", ">", "%", "@", "`", "tab\there", "\x01", "\xC3\xA9t\xC3\xA9" }) {
+		expectSameAsReference(ConfigNode(String(str)));
+		ConfigNode::MapType map;
+		map[str] = str;
+		expectSameAsReference(ConfigNode(std::move(map)));
+	}
+
+	// Multiline strings
+	for (const auto* str: { "line\n", "two\nlines", "\nleading", "windows\r\nlines", "trailing\n\n", "  indented\n  block" }) {
+		expectSameAsReference(ConfigNode(String(str)));
+		ConfigNode::SequenceType seq;
+		seq.push_back(ConfigNode(String(str)));
+		seq.push_back(ConfigNode(ConfigNode::MapType{ { "text", ConfigNode(String(str)) } }));
+		expectSameAsReference(ConfigNode(std::move(seq)));
+	}
+
+	// Empty containers, on their own and nested
+	{
+		ConfigNode node = ConfigNode::MapType();
+		expectSameAsReference(node);
+		node["map"] = ConfigNode::MapType();
+		node["seq"] = ConfigNode::SequenceType();
+		node["nested"] = ConfigNode::SequenceType();
+		node["nested"].asSequence().push_back(ConfigNode::MapType());
+		node["nested"].asSequence().push_back(ConfigNode::SequenceType());
+		node["undefined"] = ConfigNode();
+		expectSameAsReference(node);
+		expectSameAsReference(ConfigNode(ConfigNode::SequenceType()));
+	}
+
+	// Floats, including special values
+	for (const float value: { 0.0f, -0.0f, 1.0f, 0.1f, 1.5e-7f, 3.0e20f, -123.456f, std::numeric_limits<float>::max(), std::numeric_limits<float>::min(),
+		std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::quiet_NaN() }) {
+		expectSameAsReference(ConfigNode(value));
+		expectSameAsReference(ConfigNode(Vector2f(value, 1.0f)));
+	}
+
+	// Other scalars
+	expectSameAsReference(ConfigNode(std::numeric_limits<int>::min()));
+	expectSameAsReference(ConfigNode(std::numeric_limits<int64_t>::max()));
+	expectSameAsReference(ConfigNode(Vector2i(-1, 2)));
+	expectSameAsReference(ConfigNode(Bytes{ 0, 1, 2, 255 }));
+
+	// Random trees
+	std::mt19937 rng(42);
+	for (int i = 0; i < 500; ++i) {
+		expectSameAsReference(makeRandomNode(rng, 0));
+	}
+}
+
+TEST(YAMLConvert, ParseMatchesYAMLCpp)
+{
+	// Both parsers read integers as int32, so 64-bit values can't round trip through either
+	std::mt19937 rng(7);
+	for (int i = 0; i < 200; ++i) {
+		const auto yaml = ReferenceYAMLEmitter::generateYAML(makeRandomNode(rng, 0, false));
+		EXPECT_TRUE(YAMLConvert::parseConfig(yaml) == ReferenceYAMLEmitter::parseConfig(yaml)) << yaml;
+	}
+}
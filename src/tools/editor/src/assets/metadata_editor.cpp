@@ -115,6 +115,8 @@ void MetadataEditor::makeUI()
 		addStringField("Fallback", "fallback", "");
 		addFloatField("Fallback Scale", "replacementScale", 1.0f);
 		addStringField("Extra characters", "extraCharacters", "");
+		addStringField("String Tables", "stringTables", "");
+		addStringField("String Languages", "stringLanguages", "");
 		addBoolField("Floor Glyph Pos.", "floorGlyphPosition", false);
 		break;
 	}
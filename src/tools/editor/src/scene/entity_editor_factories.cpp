@@ -1381,6 +1381,12 @@ public:
 		systemContainer->add(context.makeField("bool", pars.withSubKey("destroyWhenDone", "false"), ComponentEditorLabelCreation::Never));
 		systemContainer->add(context.makeLabel("Relative Position"));
 		systemContainer->add(context.makeField("bool", pars.withSubKey("relativePosition", "false"), ComponentEditorLabelCreation::Never));
+		systemContainer->add(context.makeLabel("Offscreen Update"));
+		systemContainer->add(context.makeField("Halley::ParticleOffscreenUpdate", pars.withSubKey("offscreenUpdate"), ComponentEditorLabelCreation::Never));
+		systemContainer->add(context.makeLabel("Offscreen Interval"));
+		systemContainer->add(context.makeField("float", pars.withSubKey("offscreenUpdateInterval", "0.25"), ComponentEditorLabelCreation::Never));
+		systemContainer->add(context.makeLabel("Overlap Grid Cell Size"));
+		systemContainer->add(context.makeField("std::optional<float>", pars.withSubKey("overlapGridCellSize", ""), ComponentEditorLabelCreation::Never));
 		multiSystemContainer->add(context.makeLabel("On Spawn"));
 		multiSystemContainer->add(context.makeField("Halley::EntityId", pars.withSubKey("onSpawn", ""), ComponentEditorLabelCreation::Never));
 		multiSystemContainer->add(context.makeLabel("On Death"));
@@ -2437,6 +2443,7 @@ Vector<std::unique_ptr<IComponentEditorFieldFactory>> EntityEditorFactories::get
 	factories.emplace_back(EnumFieldFactory::makeEnumFactory<TweenCurve>("Halley::TweenCurve"));
 	factories.emplace_back(EnumFieldFactory::makeEnumFactory<LoggerLevel>("Halley::LoggerLevel"));
 	factories.emplace_back(EnumFieldFactory::makeEnumFactory<ParticleSpawnAreaShape>("Halley::ParticleSpawnAreaShape"));
+	factories.emplace_back(EnumFieldFactory::makeEnumFactory<ParticleOffscreenUpdate>("Halley::ParticleOffscreenUpdate"));
 	factories.emplace_back(EnumFieldFactory::makeEnumFactory<AssetType>("Halley::AssetType"));
 	factories.emplace_back(EnumFieldFactory::makeEnumFactory<AudioAttenuationCurve>("Halley::AudioAttenuationCurve", AudioAttenuationCurve::Linear));
 
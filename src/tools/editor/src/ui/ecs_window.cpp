@@ -5,6 +5,22 @@
 #include "halley/tools/project/project.h"
 using namespace Halley;
 
+namespace {
+	class NameListSource final : public IUIVirtualListSource {
+	public:
+		explicit NameListSource(Vector<String> names)
+			: names(std::move(names))
+		{}
+
+		size_t getCount() const override { return names.size(); }
+		String getId(size_t idx) const override { return names[idx]; }
+		LocalisedString getLabel(size_t idx) const override { return LocalisedString::fromUserString(names[idx]); }
+
+	private:
+		Vector<String> names;
+	};
+}
+
 ECSWindow::ECSWindow(UIFactory& factory, Project& project)
 	: UIWidget("ecs_window", Vector2f(), UISizer())
 	, factory(factory)
@@ -15,8 +31,8 @@ ECSWindow::ECSWindow(UIFactory& factory, Project& project)
 
 void ECSWindow::onMakeUI()
 {
-	auto systemList = getWidgetAs<UIList>("systemList");
-	auto componentList = getWidgetAs<UIList>("componentList");
+	auto systemList = getWidgetAs<UIVirtualList>("systemList");
+	auto componentList = getWidgetAs<UIVirtualList>("componentList");
 	const auto& ecsData = project.getECSData();
 
 	setHandle(UIEventType::ListSelectionChanged, "systemList", [=] (const UIEvent& event)
@@ -34,18 +50,14 @@ void ECSWindow::onMakeUI()
 		systemNames.push_back(system.first);
 	}
 	std::sort(systemNames.begin(), systemNames.end());
-	for (const auto& system: systemNames) {
-		systemList->addTextItem(system, LocalisedString::fromUserString(system));
-	}
+	systemList->setSource(std::make_shared<NameListSource>(std::move(systemNames)));
 
 	Vector<String> componentNames;
 	for (const auto& component: ecsData.getComponents()) {
 		componentNames.push_back(component.first);
 	}
 	std::sort(componentNames.begin(), componentNames.end());
-	for (const auto& component: componentNames) {
-		componentList->addTextItem(component, LocalisedString::fromUserString(component));
-	}
+	componentList->setSource(std::make_shared<NameListSource>(std::move(componentNames)));
 
 	setHandle(UIEventType::ListSelectionChanged, "tabs", [=] (const UIEvent& event)
 	{
@@ -321,7 +321,7 @@ std::unique_ptr<UIFactory> EditorUIFactory::make(const HalleyAPI& api, Resources
 
 void EditorUIFactory::setColourSchemeByAssetId(const String& assetId)
 {
-	colourScheme = std::make_shared<UIColourScheme>(getResources().get<ConfigFile>(assetId)->getRoot(), getResources());
+	colourScheme = std::make_shared<UIColourScheme>(getResources().get<ConfigFile>(assetId)->getView(), getResources());
 }
 
 void EditorUIFactory::reloadStyleSheet()
@@ -1,5 +1,6 @@
 #pragma once
 #include "halley/plugin/iasset_importer.h"
+#include "import_cache.h"
 
 namespace Halley {
 	class AssetCollector final : public IAssetCollector
@@ -22,6 +23,7 @@ namespace Halley {
 		Vector<std::pair<Path, std::optional<Bytes>>> collectOutFiles();
 		const Vector<AssetResource>& getAssets() const;
 		const Vector<TimestampedPath>& getAdditionalInputs() const;
+		const Vector<ImportCache::AdditionalInput>& getAdditionalInputContents() const;
 		
 	private:
 		const ImportingAsset& asset;
@@ -32,6 +34,7 @@ namespace Halley {
 		Vector<AssetResource> assets;
 		Vector<ImportingAsset> additionalAssets;
 		Vector<TimestampedPath> additionalInputs;
+		Vector<ImportCache::AdditionalInput> additionalInputContents;
 		Vector<std::pair<Path, std::optional<Bytes>>> outFiles;
 
 		AssetResource& getAsset(const String& name, AssetType type, const Path& primaryInputFile = {});
@@ -17,6 +17,7 @@ namespace Halley
 		IAssetImporter& getRootImporter(const Path& path) const;
 		Vector<std::reference_wrapper<IAssetImporter>> getImporters(ImportAssetType type) const;
 		const Vector<Path>& getAssetsSrc() const;
+		const ConfigNode& getImporterOptions() const;
 
 	private:
 		std::map<ImportAssetType, Vector<std::unique_ptr<IAssetImporter>>> importers;
@@ -3,14 +3,18 @@
 #include "halley/file/path.h"
 #include "import_assets_database.h"
 #include "halley/data_structures/vector.h"
+#include "halley/data_structures/hash_map.h"
+#include "halley/time/stopwatch.h"
+#include <condition_variable>
 #include <set>
 
 #include "asset_collector.h"
+#include "import_cache.h"
 
 namespace Halley
 {
 	class Project;
-	
+
 	class ImportAssetsTask : public Task
 	{
 	public:
@@ -22,13 +26,39 @@ namespace Halley
 			String errorMsg;
 		};
 		using MetadataFetchCallback = std::function<std::optional<Metadata>(const Path&)>;
-		
+
 		ImportAssetsTask(String taskName, ImportAssetsDatabase& db, std::shared_ptr<AssetImporter> importer, Path assetsPath, Vector<ImportAssetsDatabaseEntry> files, Vector<String> deletedAssets, Project& project, bool packAfter);
 
+		// Sub-assets finish in whatever order the jobs ran, so results are sorted before being cached or written
+		static void sortResult(ImportResult& result);
+
 	protected:
 		void run() override;
 
 	private:
+		// All the state for importing one top-level asset.
+		// The import is split into jobs: load, one import job per (sub)asset, then finalize once every import job is done.
+		struct AssetImport {
+			ImportAssetsDatabaseEntry* entry = nullptr;
+			ImportResult result;
+			std::optional<uint64_t> cacheKey;
+			Vector<ImportCache::AdditionalInput> additionalInputContents;
+			Vector<ImportAssetType> importedTypes;
+			int64_t estimatedCost = 0;
+
+			std::atomic<int> pendingJobs{0};
+			std::atomic<int64_t> workTime{0};
+			bool finalized = false;
+			bool skipped = false; // Cancelled before it produced anything, so there's nothing to record
+			std::mutex mutex;
+		};
+
+		struct Job {
+			int64_t priority;
+			uint64_t order;
+			std::function<void()> run;
+		};
+
 		ImportAssetsDatabase& db;
 		std::shared_ptr<AssetImporter> importer;
 		Path assetsPath;
@@ -38,19 +68,45 @@ namespace Halley
 		Vector<ImportAssetsDatabaseEntry> files;
 		Vector<String> deletedAssets;
 		std::set<String> outputAssets;
-		
+
 		std::atomic<int64_t> totalImportTime;
 		std::atomic<size_t> assetsImported{};
 		size_t assetsToImport{};
 
 		std::mutex mutex;
-		
+
+		// Files are written as soon as each asset is finalized, but logs and the db are updated in the order of files, so they don't depend on job timing
+		Vector<std::unique_ptr<AssetImport>> imports;
+		size_t nextToWrite = 0;
+		std::mutex writeMutex;
+
+		std::mutex jobMutex;
+		std::condition_variable jobCondition;
+		Vector<Job> readyJobs;
+		size_t outstandingJobs = 0;
+		uint64_t nextJobOrder = 0;
+
+		HashMap<String, int64_t> previousTimings;
+		HashMap<String, int64_t> assetTimings;
+		std::map<ImportAssetType, int64_t> importerTimings;
+		std::chrono::steady_clock::time_point lastSave;
+
 		std::string curFileLabel;
 
-		bool doImportAsset(ImportAssetsDatabaseEntry& asset);
+		void scheduleJob(int64_t priority, std::function<void()> job);
+		void runNextJob();
+
+		void loadAsset(AssetImport& asset);
+		void importSubAsset(AssetImport& asset, ImportingAsset importingAsset);
+		void onSubAssetDone(AssetImport& asset);
+		void finalizeAsset(AssetImport& asset);
+		void writeFinalizedAssets(AssetImport& asset);
+		void writeAssetFiles(const ImportAssetsDatabaseEntry& asset, ImportResult& result);
+		bool recordAssetOutput(AssetImport& asset);
 
-		Vector<Path> loadFont(const ImportAssetsDatabaseEntry& asset, Path dstDir);
-		Vector<Path> genericImporter(const ImportAssetsDatabaseEntry& asset, Path dstDir);
-		ImportResult importAsset(const ImportAssetsDatabaseEntry& asset, const MetadataFetchCallback& metadataFetcher, const AssetImporter& importer, Path assetsPath, AssetCollector::ProgressReporter progressReporter = {});
+		void loadTimings();
+		void saveTimings() const;
+		void reportTimings();
+		Path getTimingsPath() const;
 	};
 }
@@ -0,0 +1,73 @@
+#pragma once
+#include "halley/file/path.h"
+#include "halley/plugin/iasset_importer.h"
+#include <atomic>
+
+namespace Halley
+{
+	class AssetImporter;
+
+	// Content-addressed store of importer outputs.
+	// Entries are keyed by a hash of the source bytes, metadata and importer versions, so they survive branch switches and
+	// fresh checkouts, and the directory can be shared between machines over a network filesystem.
+	// Dependent assets are only discovered while importing, so the versions of their importers are stored in the entry and checked on load.
+	class ImportCache
+	{
+	public:
+		struct AdditionalInput {
+			Path path; // Relative to the assets source directories
+			uint64_t hash = 0;
+
+			void serialize(Serializer& s) const;
+			void deserialize(Deserializer& s);
+		};
+
+		struct Entry {
+			String assetId;
+			Vector<AssetResource> out;
+			Vector<std::pair<Path, Bytes>> outFiles;
+			Vector<AdditionalInput> additionalInputs;
+			Vector<std::pair<ImportAssetType, int>> importerVersions; // Of every importer that ran, including for dependent assets
+			int64_t importTime = 0;
+
+			void serialize(Serializer& s) const;
+			void deserialize(Deserializer& s);
+		};
+
+		struct Stats {
+			size_t hits = 0;
+			size_t misses = 0;
+			size_t stored = 0;
+			int64_t timeSaved = 0;
+
+			float getHitRate() const;
+			String toString() const;
+		};
+
+		ImportCache(Path directory, int version);
+
+		uint64_t computeKey(const ImportingAsset& asset, const AssetImporter& importer) const;
+
+		std::optional<Entry> load(uint64_t key, const String& assetId, const AssetImporter& importer);
+		void store(uint64_t key, const Entry& entry);
+
+		void addTimeSaved(int64_t nanoseconds);
+		Stats getStats() const;
+		void resetStats();
+
+		static Vector<std::pair<ImportAssetType, int>> getImporterVersions(const AssetImporter& importer, Vector<ImportAssetType> types);
+		static uint64_t hashBytes(gsl::span<const gsl::byte> bytes);
+		static std::optional<Path> resolveAdditionalInput(const Path& path, const Vector<Path>& assetsSrc);
+
+	private:
+		Path directory;
+		const int version;
+
+		std::atomic<size_t> hits{};
+		std::atomic<size_t> misses{};
+		std::atomic<size_t> stored{};
+		std::atomic<int64_t> timeSaved{};
+
+		Path getEntryPath(uint64_t key) const;
+	};
+}
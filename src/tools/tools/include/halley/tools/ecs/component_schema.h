@@ -25,6 +25,8 @@ namespace Halley
 		std::optional<String> customImplementation;
 		Vector<String> componentDependencies;
 		Vector<String> componentDependenciesInAncestors;
+		bool networkDelta = false;
+		bool trackChanges = false;
 		bool generate = false;
 
 		bool operator<(const ComponentSchema& other) const;
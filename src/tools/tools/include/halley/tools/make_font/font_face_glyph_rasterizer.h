@@ -0,0 +1,37 @@
+#pragma once
+
+#include <mutex>
+#include <halley/graphics/text/dynamic_font_atlas.h>
+#include "font_face.h"
+
+namespace Halley
+{
+	// Rasterizes multi-channel distance field glyphs from a TrueType/OpenType font with FreeType and msdfgen, for DynamicFontAtlas
+	// Produces the same glyphs FontGenerator bakes, one at a time
+	class FontFaceGlyphRasterizer final : public IGlyphRasterizer {
+	public:
+		FontFaceGlyphRasterizer(Bytes fontData, float fontSize, float radius, String name = "");
+
+		FontMetrics getFontMetrics() const override;
+		Vector2i getMaxGlyphSize() const override;
+		bool hasGlyph(int charcode) const override;
+		std::optional<Glyph> rasterize(int charcode) const override;
+
+	private:
+		Bytes fontData;
+		float fontSize;
+		float radius;
+		int border;
+		FontMetrics metrics;
+		Vector2i maxGlyphSize;
+		HashSet<int> charcodes;
+
+		// FreeType faces can't be used from several threads at once, so each concurrent rasterization takes its own
+		mutable std::mutex mutex;
+		mutable Vector<std::unique_ptr<FontFace>> freeFaces;
+
+		std::unique_ptr<FontFace> makeFace() const;
+		std::unique_ptr<FontFace> acquireFace() const;
+		void releaseFace(std::unique_ptr<FontFace> face) const;
+	};
+}
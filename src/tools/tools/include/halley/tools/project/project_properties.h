@@ -31,6 +31,9 @@ namespace Halley {
     	void setDefaultZoom(float zoom);
 		float getDefaultZoom() const;
 
+		const String& getImportCachePath() const;
+		void setImportCachePath(String path);
+
 		const I18NLanguage& getOriginalLanguage() const;
 		const Vector<I18NLanguage>& getLanguages() const;
 
@@ -44,6 +47,7 @@ namespace Halley {
         Vector<I18NLanguage> languages;
     	bool importByExtension = false;
     	float defaultZoom = 1.0f;
+		String importCachePath;
     	Vector<String> platforms;
 
     	bool dirty = false;
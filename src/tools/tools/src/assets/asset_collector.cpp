@@ -101,10 +101,12 @@ Bytes AssetCollector::readAdditionalFile(const Path& filePath)
 	for (const auto& path: assetsSrc) {
 		Path f = path / filePath;
 		if (FileSystem::exists(f)) {
+			auto data = FileSystem::readFile(f);
 			if (!std_ex::contains_if(additionalInputs, [&] (const auto& e) { return e.first == f; })) {
-				additionalInputs.push_back(TimestampedPath(f, FileSystem::getLastWriteTime(f)));			
+				additionalInputs.push_back(TimestampedPath(f, FileSystem::getLastWriteTime(f)));
+				additionalInputContents.push_back(ImportCache::AdditionalInput{ filePath, ImportCache::hashBytes(data.byte_span()) });
 			}
-			return FileSystem::readFile(f);
+			return data;
 		}
 	}
 	throw Exception("Unable to find asset dependency: \"" + filePath.getString() + "\"", HalleyExceptions::Tools);
@@ -129,3 +131,8 @@ const Vector<TimestampedPath>& AssetCollector::getAdditionalInputs() const
 {
 	return additionalInputs;
 }
+
+const Vector<ImportCache::AdditionalInput>& AssetCollector::getAdditionalInputContents() const
+{
+	return additionalInputContents;
+}
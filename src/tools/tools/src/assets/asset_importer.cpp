@@ -155,3 +155,8 @@ const Vector<Path>& AssetImporter::getAssetsSrc() const
 {
 	return assetsSrc;
 }
+
+const ConfigNode& AssetImporter::getImporterOptions() const
+{
+	return importerOptions;
+}
@@ -29,42 +29,41 @@ ImportAssetsTask::ImportAssetsTask(String taskName, ImportAssetsDatabase& db, st
 void ImportAssetsTask::run()
 {
 	Stopwatch timer;
-	using namespace std::chrono_literals;
-	auto lastSave = std::chrono::steady_clock::now();
+	lastSave = std::chrono::steady_clock::now();
 
 	assetsImported = 0;
 	assetsToImport = files.size();
-	Vector<Future<void>> tasks;
 
-	constexpr bool parallelImport = !Debug::isDebug();
-
-	for (size_t i = 0; i < files.size(); ++i) {
-		auto importFunc = [&, i] () {
-			if (isCancelled()) {
-				return;
-			}
-
-			setProgressLabel(files[i].assetId);
-			if (doImportAsset(files[i])) {
-				++assetsImported;
-				setProgress(float(assetsImported) * 0.98f / float(assetsToImport));
-			}
+	auto* cache = project.getImportCache();
+	if (cache) {
+		cache->resetStats();
+	}
 
-			auto now = std::chrono::steady_clock::now();
-			if (now - lastSave > 1s) {
-				db.save();
-				lastSave = now;
-			}
-		};
+	loadTimings();
+
+	// Every asset is a small DAG of jobs (load -> import (sub)assets -> finalize), scheduled longest-estimated-first
+	imports.clear();
+	imports.reserve(files.size());
+	nextToWrite = 0;
+	for (auto& file: files) {
+		auto asset = std::make_unique<AssetImport>();
+		asset->entry = &file;
+		const auto iter = previousTimings.find(file.assetId);
+		asset->estimatedCost = iter != previousTimings.end() ? iter->second : 0;
+		imports.push_back(std::move(asset));
+	}
 
-		if (parallelImport) {
-			tasks.push_back(Concurrent::execute(Executors::getCPUAux(), importFunc));
-		} else {
-			importFunc();
-		}
+	for (auto& asset: imports) {
+		scheduleJob(asset->estimatedCost, [this, asset = asset.get()] ()
+		{
+			loadAsset(*asset);
+		});
 	}
 
-	Concurrent::whenAll(tasks.begin(), tasks.end()).wait();
+	{
+		std::unique_lock<std::mutex> lock(jobMutex);
+		jobCondition.wait(lock, [&] { return outstandingJobs == 0; });
+	}
 	db.save();
 
 	if (!isCancelled()) {
@@ -94,28 +93,316 @@ void ImportAssetsTask::run()
 	const Time realTime = timer.elapsedNanoseconds() / 1000000000.0;
 	const Time importTime = totalImportTime / 1000000000.0;
 	logInfo("Import took " + toString(realTime) + " seconds, on which " + toString(importTime) + " seconds of work were performed (" + toString(importTime / realTime) + "x realtime)");
+	if (cache) {
+		logInfo("Import cache: " + cache->getStats().toString());
+	}
+
+	reportTimings();
+	saveTimings();
 }
 
-bool ImportAssetsTask::doImportAsset(ImportAssetsDatabaseEntry& asset)
+void ImportAssetsTask::sortResult(ImportResult& result)
 {
-	auto& fs = project.getFileSystemCache();
+	std::sort(result.out.begin(), result.out.end(), [] (const AssetResource& a, const AssetResource& b)
+	{
+		return a.type != b.type ? a.type < b.type : a.name < b.name;
+	});
+	std::sort(result.outFiles.begin(), result.outFiles.end(), [] (const auto& a, const auto& b)
+	{
+		return a.first < b.first;
+	});
+	std::sort(result.additionalInputs.begin(), result.additionalInputs.end());
+	result.additionalInputs.erase(std::unique(result.additionalInputs.begin(), result.additionalInputs.end()), result.additionalInputs.end());
+}
+
+void ImportAssetsTask::scheduleJob(int64_t priority, std::function<void()> job)
+{
+	{
+		std::unique_lock<std::mutex> lock(jobMutex);
+		readyJobs.push_back(Job{ priority, nextJobOrder++, std::move(job) });
+		std::push_heap(readyJobs.begin(), readyJobs.end(), [] (const Job& a, const Job& b)
+		{
+			return a.priority != b.priority ? a.priority < b.priority : a.order > b.order;
+		});
+		++outstandingJobs;
+	}
+
+	// Each scheduled runner picks whichever ready job is currently the most expensive, not necessarily the one that was just added
+	Concurrent::execute(Executors::getCPUAux(), [this] ()
+	{
+		runNextJob();
+	});
+}
+
+void ImportAssetsTask::runNextJob()
+{
+	Job job;
+	{
+		std::unique_lock<std::mutex> lock(jobMutex);
+		std::pop_heap(readyJobs.begin(), readyJobs.end(), [] (const Job& a, const Job& b)
+		{
+			return a.priority != b.priority ? a.priority < b.priority : a.order > b.order;
+		});
+		job = std::move(readyJobs.back());
+		readyJobs.pop_back();
+	}
+
+	try {
+		job.run();
+	} catch (const std::exception& e) {
+		logError(String("Unhandled exception while importing: ") + e.what());
+	}
+
+	std::unique_lock<std::mutex> lock(jobMutex);
+	--outstandingJobs;
+	if (outstandingJobs == 0) {
+		jobCondition.notify_all();
+	}
+}
+
+void ImportAssetsTask::loadAsset(AssetImport& asset)
+{
+	if (isCancelled()) {
+		// Still has to be finalized, or every asset after it would be waiting for it forever
+		asset.skipped = true;
+		writeFinalizedAssets(asset);
+		return;
+	}
+
 	Stopwatch timer;
+	const auto& entry = *asset.entry;
+	auto* cache = project.getImportCache();
+	setProgressLabel(entry.assetId);
 
-	auto result = importAsset(asset, [&] (const Path& path) { return db.getMetadata(path); }, *importer, assetsPath, [=] (float, const String&) -> bool { return !isCancelled(); });
-	
-	if (!result.success) {
-		logError("\"" + asset.assetId + "\" - " + result.errorMsg);
-		asset.additionalInputFiles = std::move(result.additionalInputs);
-		db.markFailed(asset);
+	try {
+		// Load files from disk
+		ImportingAsset importingAsset;
+		importingAsset.assetId = entry.assetId;
+		importingAsset.assetType = entry.assetType;
+		for (const auto& f: entry.inputFiles) {
+			auto meta = db.getMetadata(f.getPath());
+			auto data = FileSystem::readFile(entry.srcDir / f.getDataPath());
+			if (data.empty()) {
+				// Give it a bit and try again if it was empty
+				using namespace std::chrono_literals;
+				std::this_thread::sleep_for(5ms);
+				data = FileSystem::readFile(entry.srcDir / f.getDataPath());
 
-		return false;
+				if (data.empty()) {
+					logError("Data for \"" + toString(entry.srcDir / f.getPath()) + "\" is empty.");
+				}
+			}
+			importingAsset.inputFiles.emplace_back(ImportingAssetFile(f.getPath(), std::move(data), meta ? std::move(meta.value()) : Metadata()));
+		}
+
+		// Check the cache
+		if (cache) {
+			asset.cacheKey = cache->computeKey(importingAsset, *importer);
+			if (auto cached = cache->load(*asset.cacheKey, entry.assetId, *importer)) {
+				auto& result = asset.result;
+				result.out = std::move(cached->out);
+				for (auto& outFile: cached->outFiles) {
+					result.outFiles.emplace_back(std::move(outFile.first), std::move(outFile.second));
+				}
+				for (const auto& additional: cached->additionalInputs) {
+					if (auto path = ImportCache::resolveAdditionalInput(additional.path, importer->getAssetsSrc())) {
+						result.additionalInputs.push_back(TimestampedPath(*path, FileSystem::getLastWriteTime(*path)));
+					}
+				}
+				result.success = true;
+				asset.cacheKey.reset();
+				cache->addTimeSaved(std::max(int64_t(0), cached->importTime - timer.elapsedNanoseconds()));
+
+				asset.workTime += timer.elapsedNanoseconds();
+				finalizeAsset(asset);
+				return;
+			}
+		}
+
+		asset.result.success = true;
+		asset.pendingJobs = 1;
+		asset.workTime += timer.elapsedNanoseconds();
+		scheduleJob(asset.estimatedCost, [this, &asset, importingAsset = std::move(importingAsset)] () mutable
+		{
+			importSubAsset(asset, std::move(importingAsset));
+		});
+	} catch (const Exception& e) {
+		asset.result.errorMsg = e.getMessage();
+		asset.result.success = false;
+		finalizeAsset(asset);
+	} catch (const std::exception& e) {
+		asset.result.errorMsg = e.what();
+		asset.result.success = false;
+		finalizeAsset(asset);
 	}
-	
-	// Check if it didn't get cancelled
+}
+
+void ImportAssetsTask::importSubAsset(AssetImport& asset, ImportingAsset importingAsset)
+{
 	if (isCancelled()) {
-		return false;
+		onSubAssetDone(asset);
+		return;
+	}
+
+	Stopwatch timer;
+	AssetCollector collector(importingAsset, assetsPath, importer->getAssetsSrc(), [=] (float, const String&) -> bool { return !isCancelled(); });
+
+	String errorMsg;
+	bool success = true;
+	try {
+		for (const auto& assetImporter: importer->getImporters(importingAsset.assetType)) {
+			assetImporter.get().import(importingAsset, collector);
+		}
+	} catch (const Exception& e) {
+		errorMsg = e.getMessage();
+		success = false;
+	} catch (const std::exception& e) {
+		errorMsg = e.what();
+		success = false;
+	}
+
+	timer.pause();
+	asset.workTime += timer.elapsedNanoseconds();
+
+	{
+		std::unique_lock<std::mutex> lock(asset.mutex);
+		auto& result = asset.result;
+		asset.importedTypes.push_back(importingAsset.assetType);
+
+		for (const auto& i: collector.getAdditionalInputs()) {
+			result.additionalInputs.push_back(i);
+		}
+
+		if (success) {
+			for (auto& outFile: collector.collectOutFiles()) {
+				result.outFiles.push_back(std::move(outFile));
+			}
+			for (const auto& o: collector.getAssets()) {
+				result.out.push_back(o);
+			}
+			for (const auto& i: collector.getAdditionalInputContents()) {
+				asset.additionalInputContents.push_back(i);
+			}
+		} else if (result.success) {
+			result.success = false;
+			result.errorMsg = std::move(errorMsg);
+		}
 	}
 
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		importerTimings[importingAsset.assetType] += timer.elapsedNanoseconds();
+	}
+
+	// Secondary assets become their own jobs; the parent can only finalize after all of them are done
+	if (success) {
+		for (auto& additional: collector.collectAdditionalAssets()) {
+			++asset.pendingJobs;
+			scheduleJob(asset.estimatedCost, [this, &asset, additional = std::move(additional)] () mutable
+			{
+				importSubAsset(asset, std::move(additional));
+			});
+		}
+	}
+
+	onSubAssetDone(asset);
+}
+
+void ImportAssetsTask::onSubAssetDone(AssetImport& asset)
+{
+	if (--asset.pendingJobs == 0) {
+		scheduleJob(asset.estimatedCost, [this, &asset] ()
+		{
+			finalizeAsset(asset);
+		});
+	}
+}
+
+void ImportAssetsTask::finalizeAsset(AssetImport& asset)
+{
+	Stopwatch timer;
+	auto* cache = project.getImportCache();
+	auto& result = asset.result;
+
+	sortResult(result);
+	std::sort(asset.additionalInputContents.begin(), asset.additionalInputContents.end(), [] (const ImportCache::AdditionalInput& a, const ImportCache::AdditionalInput& b)
+	{
+		return a.path < b.path;
+	});
+
+	// Store in cache, unless the importer wrote files by itself
+	const bool cacheable = std::all_of(result.outFiles.begin(), result.outFiles.end(), [] (const auto& f) { return f.second.has_value(); });
+	if (cache && asset.cacheKey && result.success && cacheable && !isCancelled()) {
+		try {
+			ImportCache::Entry entry;
+			entry.assetId = asset.entry->assetId;
+			entry.out = result.out;
+			for (const auto& outFile: result.outFiles) {
+				entry.outFiles.emplace_back(outFile.first, *outFile.second);
+			}
+			entry.additionalInputs = std::move(asset.additionalInputContents);
+			entry.importerVersions = ImportCache::getImporterVersions(*importer, asset.importedTypes);
+			entry.importTime = asset.workTime;
+			cache->store(*asset.cacheKey, entry);
+		} catch (const std::exception& e) {
+			logWarning("Unable to store \"" + asset.entry->assetId + "\" in the import cache: " + e.what());
+		}
+	}
+
+	// Write the files right away, rather than holding them in memory until every asset before this one is done
+	if (result.success && !isCancelled()) {
+		try {
+			writeAssetFiles(*asset.entry, result);
+		} catch (const Exception& e) {
+			result.errorMsg = e.getMessage();
+			result.success = false;
+		} catch (const std::exception& e) {
+			result.errorMsg = e.what();
+			result.success = false;
+		}
+	}
+
+	timer.pause();
+	asset.workTime += timer.elapsedNanoseconds();
+	totalImportTime += asset.workTime;
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		assetTimings[asset.entry->assetId] = asset.workTime;
+	}
+
+	writeFinalizedAssets(asset);
+}
+
+void ImportAssetsTask::writeFinalizedAssets(AssetImport& asset)
+{
+	std::unique_lock<std::mutex> lock(writeMutex);
+	asset.finalized = true;
+
+	// Whoever finalizes the next asset in line records it, along with any later ones that were already waiting
+	while (nextToWrite < imports.size() && imports[nextToWrite]->finalized) {
+		auto& next = *imports[nextToWrite++];
+		try {
+			if (recordAssetOutput(next)) {
+				++assetsImported;
+				setProgress(float(assetsImported) * 0.98f / float(assetsToImport));
+			}
+		} catch (const std::exception& e) {
+			logError("\"" + next.entry->assetId + "\" - " + e.what());
+		}
+	}
+
+	auto now = std::chrono::steady_clock::now();
+	if (now - lastSave > std::chrono::seconds(1)) {
+		db.save();
+		lastSave = now;
+	}
+}
+
+void ImportAssetsTask::writeAssetFiles(const ImportAssetsDatabaseEntry& asset, ImportResult& result)
+{
+	auto& fs = project.getFileSystemCache();
+
 	// Retrieve previous output from this asset, and remove any files which went missing
 	HashSet<Path> outFiles;
 	outFiles.reserve(result.outFiles.size());
@@ -126,7 +413,6 @@ bool ImportAssetsTask::doImportAsset(ImportAssetsDatabaseEntry& asset)
 	for (auto& f: previous) {
 		for (auto& v: f.platformVersions) {
 			const Path& curPath = v.second.filepath;
-			//if (!std_ex::contains(result.outFiles, [&] (const std::pair<Path, Bytes>& r) { return r.first == curPath; })) {
 			if (!outFiles.contains(curPath)) {
 				// File no longer exists as part of this asset, remove it
 				fs.remove(assetsPath / curPath);
@@ -138,10 +424,33 @@ bool ImportAssetsTask::doImportAsset(ImportAssetsDatabaseEntry& asset)
 	for (auto& outFile: result.outFiles) {
 		if (outFile.second) {
 			auto path = assetsPath / outFile.first;
-			//logInfo("- " + asset.assetId + " -> " + path + " (" + String::prettySize(outFile.second.size()) + ")");
 			fs.writeFile(path, std::move(*outFile.second));
+			outFile.second.reset();
 		}
 	}
+}
+
+bool ImportAssetsTask::recordAssetOutput(AssetImport& assetImport)
+{
+	auto& asset = *assetImport.entry;
+	auto& result = assetImport.result;
+
+	if (assetImport.skipped) {
+		return false;
+	}
+
+	if (!result.success) {
+		logError("\"" + asset.assetId + "\" - " + result.errorMsg);
+		asset.additionalInputFiles = std::move(result.additionalInputs);
+		db.markFailed(asset);
+
+		return false;
+	}
+	
+	// Check if it didn't get cancelled
+	if (isCancelled()) {
+		return false;
+	}
 
 	// Add to list of output assets
 	{
@@ -156,84 +465,59 @@ bool ImportAssetsTask::doImportAsset(ImportAssetsDatabaseEntry& asset)
 	asset.outputFiles = std::move(result.out);
 	db.markAsImported(asset);
 
-	timer.pause();
-	totalImportTime += timer.elapsedNanoseconds();
-
 	return true;
 }
 
-ImportAssetsTask::ImportResult ImportAssetsTask::importAsset(const ImportAssetsDatabaseEntry& asset, const MetadataFetchCallback& metadataFetcher, const AssetImporter& importer, Path assetsPath, AssetCollector::ProgressReporter progressReporter)
+void ImportAssetsTask::loadTimings()
 {
-	ImportResult result;
-	
-	try {
-		// Create queue
-		std::list<ImportingAsset> toLoad;
+	const auto data = FileSystem::readFile(getTimingsPath());
+	if (!data.empty()) {
+		try {
+			Deserializer::fromBytes(previousTimings, data);
+		} catch (...) {
+			previousTimings.clear();
+		}
+	}
+}
 
-		// Load files from disk
-		ImportingAsset importingAsset;
-		importingAsset.assetId = asset.assetId;
-		importingAsset.assetType = asset.assetType;
-		for (const auto& f: asset.inputFiles) {
-			auto meta = metadataFetcher(f.getPath());
-			auto data = FileSystem::readFile(asset.srcDir / f.getDataPath());
-			if (data.empty()) {
-				// Give it a bit and try again if it was empty
-				using namespace std::chrono_literals;
-				std::this_thread::sleep_for(5ms);
-				data = FileSystem::readFile(asset.srcDir / f.getDataPath());
+void ImportAssetsTask::saveTimings() const
+{
+	if (assetTimings.empty()) {
+		return;
+	}
 
-				if (data.empty()) {
-					logError("Data for \"" + toString(asset.srcDir / f.getPath()) + "\" is empty.");
-				}
-			}
-			importingAsset.inputFiles.emplace_back(ImportingAssetFile(f.getPath(), std::move(data), meta ? std::move(meta.value()) : Metadata()));
-		}
-		toLoad.emplace_back(std::move(importingAsset));
-
-		// Import
-		while (!toLoad.empty()) {
-			auto cur = std::move(toLoad.front());
-			toLoad.pop_front();
-			
-			AssetCollector collector(cur, assetsPath, importer.getAssetsSrc(), progressReporter);
-
-			for (const auto& assetImporter: importer.getImporters(cur.assetType)) {
-				try {
-					assetImporter.get().import(cur, collector);
-				} catch (...) {
-					for (const auto& i: collector.getAdditionalInputs()) {
-						result.additionalInputs.push_back(i);
-					}
-					throw;
-				}
-			}
-			
-			for (auto& additional: collector.collectAdditionalAssets()) {
-				toLoad.emplace_front(std::move(additional));
-			}
+	auto timings = previousTimings;
+	for (const auto& [k, v]: assetTimings) {
+		timings[k] = v;
+	}
+	FileSystem::writeFile(getTimingsPath(), Serializer::toBytes(timings));
+}
 
-			for (auto& outFile: collector.collectOutFiles()) {
-				result.outFiles.push_back(std::move(outFile));
-			}
+void ImportAssetsTask::reportTimings()
+{
+	constexpr size_t maxEntries = 10;
+	if (assetTimings.size() <= 1) {
+		return;
+	}
 
-			for (const auto& o: collector.getAssets()) {
-				result.out.push_back(o);
-			}
+	Vector<std::pair<String, int64_t>> slowest(assetTimings.begin(), assetTimings.end());
+	std::sort(slowest.begin(), slowest.end(), [] (const auto& a, const auto& b) { return a.second > b.second; });
+	if (slowest.size() > maxEntries) {
+		slowest.resize(maxEntries);
+	}
 
-			for (const auto& i: collector.getAdditionalInputs()) {
-				result.additionalInputs.push_back(i);
-			}
-		}
-		
-		result.success = true;
-	} catch (const Exception& e) {
-		result.errorMsg = e.getMessage();
-		result.success = false;
-	} catch (const std::exception& e) {
-		result.errorMsg = e.what();
-		result.success = false;
+	String report = "Slowest assets:";
+	for (const auto& [id, time]: slowest) {
+		report += "\n\t" + id + ": " + toString(time / 1000000) + " ms";
 	}
+	report += "\nTime by importer:";
+	for (const auto& [type, time]: importerTimings) {
+		report += "\n\t" + toString(type) + ": " + toString(time / 1000000) + " ms";
+	}
+	logInfo(report);
+}
 
-	return result;
+Path ImportAssetsTask::getTimingsPath() const
+{
+	return assetsPath / "import_timings.db";
 }
@@ -0,0 +1,225 @@
+#include "halley/tools/assets/import_cache.h"
+#include "halley/tools/assets/asset_importer.h"
+#include "halley/tools/file/filesystem.h"
+#include "halley/bytes/byte_serializer.h"
+#include "halley/support/logger.h"
+#include "halley/text/string_converter.h"
+#include "halley/utils/hash.h"
+#include "halley/maths/uuid.h"
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace Halley;
+
+namespace {
+	// Changing Entry's layout changes every key, so old entries are never read with the new layout
+	constexpr int entryFormatVersion = 2;
+
+	int64_t getProcessId()
+	{
+#ifdef _WIN32
+		return _getpid();
+#else
+		return getpid();
+#endif
+	}
+}
+
+void ImportCache::AdditionalInput::serialize(Serializer& s) const
+{
+	s << path;
+	s << hash;
+}
+
+void ImportCache::AdditionalInput::deserialize(Deserializer& s)
+{
+	s >> path;
+	s >> hash;
+}
+
+void ImportCache::Entry::serialize(Serializer& s) const
+{
+	s << assetId;
+	s << out;
+	s << outFiles;
+	s << additionalInputs;
+	s << importerVersions;
+	s << importTime;
+}
+
+void ImportCache::Entry::deserialize(Deserializer& s)
+{
+	s >> assetId;
+	s >> out;
+	s >> outFiles;
+	s >> additionalInputs;
+	s >> importerVersions;
+	s >> importTime;
+}
+
+float ImportCache::Stats::getHitRate() const
+{
+	const auto total = hits + misses;
+	return total > 0 ? float(hits) / float(total) : 0.0f;
+}
+
+String ImportCache::Stats::toString() const
+{
+	return Halley::toString(hits) + " hits, " + Halley::toString(misses) + " misses (" + Halley::toString(lroundf(getHitRate() * 100.0f)) + "% hit rate), "
+		+ Halley::toString(stored) + " stored, saved " + Halley::toString(double(timeSaved) / 1000000000.0) + " seconds";
+}
+
+ImportCache::ImportCache(Path directory, int version)
+	: directory(std::move(directory))
+	, version(version)
+{
+	FileSystem::createDir(this->directory);
+}
+
+uint64_t ImportCache::computeKey(const ImportingAsset& asset, const AssetImporter& importer) const
+{
+	Hash::Hasher hasher;
+	hasher.feed(entryFormatVersion);
+	hasher.feed(version);
+	hasher.feed(static_cast<int>(asset.assetType));
+	hasher.feed(asset.assetId);
+
+	for (const auto& assetImporter: importer.getImporters(asset.assetType)) {
+		hasher.feed(static_cast<int>(assetImporter.get().getType()));
+		hasher.feed(assetImporter.get().getVersion());
+	}
+	hasher.feed(hashBytes(Serializer::toBytes(importer.getImporterOptions()).byte_span()));
+	hasher.feed(hashBytes(Serializer::toBytes(asset.options).byte_span()));
+
+	for (const auto& file: asset.inputFiles) {
+		hasher.feed(file.name.getString());
+		hasher.feed(hashBytes(file.data.byte_span()));
+		hasher.feed(hashBytes(Serializer::toBytes(file.metadata).byte_span()));
+	}
+
+	return hasher.digest();
+}
+
+std::optional<ImportCache::Entry> ImportCache::load(uint64_t key, const String& assetId, const AssetImporter& importer)
+{
+	const auto path = getEntryPath(key);
+	const auto bytes = FileSystem::readFile(path);
+	if (bytes.empty()) {
+		++misses;
+		return std::nullopt;
+	}
+
+	Entry entry;
+	try {
+		Deserializer::fromBytes(entry, bytes);
+	} catch (...) {
+		Logger::logWarning("Discarding corrupted import cache entry \"" + path.getString() + "\"");
+		FileSystem::remove(path);
+		++misses;
+		return std::nullopt;
+	}
+
+	// Guard against hash collisions, and validate the importers and files that were only known once the asset was imported
+	bool valid = entry.assetId == assetId;
+	if (valid) {
+		Vector<ImportAssetType> types;
+		for (const auto& [type, importerVersion]: entry.importerVersions) {
+			types.push_back(type);
+		}
+		valid = getImporterVersions(importer, std::move(types)) == entry.importerVersions;
+	}
+	for (const auto& additional: entry.additionalInputs) {
+		if (!valid) {
+			break;
+		}
+		const auto resolved = resolveAdditionalInput(additional.path, importer.getAssetsSrc());
+		valid = resolved && hashBytes(FileSystem::readFile(*resolved).byte_span()) == additional.hash;
+	}
+
+	if (!valid) {
+		++misses;
+		return std::nullopt;
+	}
+
+	++hits;
+	return entry;
+}
+
+void ImportCache::store(uint64_t key, const Entry& entry)
+{
+	const auto path = getEntryPath(key);
+	// Other processes (possibly on other machines) may be storing the same entry, so the temporary name must be unique across all of them
+	const auto tmpPath = path.replaceExtension(".tmp" + toString(getProcessId()) + "-" + UUID::generate().toString());
+
+	// Write to a temporary file and then rename, so other machines sharing the cache never see partial entries
+	if (FileSystem::writeFile(tmpPath, Serializer::toBytes(entry))) {
+		if (FileSystem::rename(tmpPath, path)) {
+			++stored;
+		} else {
+			FileSystem::remove(tmpPath);
+		}
+	}
+}
+
+Vector<std::pair<ImportAssetType, int>> ImportCache::getImporterVersions(const AssetImporter& importer, Vector<ImportAssetType> types)
+{
+	std::sort(types.begin(), types.end());
+	types.erase(std::unique(types.begin(), types.end()), types.end());
+
+	Vector<std::pair<ImportAssetType, int>> result;
+	for (const auto type: types) {
+		for (const auto& assetImporter: importer.getImporters(type)) {
+			result.emplace_back(type, assetImporter.get().getVersion());
+		}
+	}
+	return result;
+}
+
+void ImportCache::addTimeSaved(int64_t nanoseconds)
+{
+	timeSaved += nanoseconds;
+}
+
+ImportCache::Stats ImportCache::getStats() const
+{
+	Stats stats;
+	stats.hits = hits;
+	stats.misses = misses;
+	stats.stored = stored;
+	stats.timeSaved = timeSaved;
+	return stats;
+}
+
+void ImportCache::resetStats()
+{
+	hits = 0;
+	misses = 0;
+	stored = 0;
+	timeSaved = 0;
+}
+
+uint64_t ImportCache::hashBytes(gsl::span<const gsl::byte> bytes)
+{
+	return Hash::hash(bytes);
+}
+
+std::optional<Path> ImportCache::resolveAdditionalInput(const Path& path, const Vector<Path>& assetsSrc)
+{
+	for (const auto& src: assetsSrc) {
+		auto f = src / path;
+		if (FileSystem::exists(f)) {
+			return f;
+		}
+	}
+	return std::nullopt;
+}
+
+Path ImportCache::getEntryPath(uint64_t key) const
+{
+	const auto name = toString(key, 16, 16);
+	return directory / name.substr(0, 2) / (name + ".bin");
+}
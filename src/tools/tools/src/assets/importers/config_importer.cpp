@@ -14,7 +14,7 @@ void ConfigImporter::import(const ImportingAsset& asset, IAssetCollector& collec
 	Metadata meta = asset.inputFiles.at(0).metadata;
 	meta.set("asset_compression", "lz4");
 
-	collector.output(Path(asset.assetId).replaceExtension("").string(), AssetType::ConfigFile, Serializer::toBytes(config), meta);
+	collector.output(Path(asset.assetId).replaceExtension("").string(), AssetType::ConfigFile, ConfigNodeView::compile(config.getRoot()), meta);
 }
 
 void PrefabImporter::import(const ImportingAsset& asset, IAssetCollector& collector)
@@ -10,6 +10,7 @@ namespace Halley
 	{
 	public:
 		ImportAssetType getType() const override { return ImportAssetType::ConfigFile; }
+		int getVersion() const override { return 1; }
 
 		void import(const ImportingAsset& asset, IAssetCollector& collector) override;
 	};
@@ -6,6 +6,8 @@
 #include "halley/file_formats/image.h"
 #include "halley/tools/file/filesystem.h"
 #include "halley/graphics/text/font.h"
+#include "halley/file_formats/yaml_convert.h"
+#include "halley/text/i18n.h"
 
 using namespace Halley;
 
@@ -46,6 +48,23 @@ void FontImporter::import(const ImportingAsset& asset, IAssetCollector& collecto
 	for (int c: extraChars.getUTF32()) {
 		characterSet.insert(c);
 	}
+
+	// Only bake the characters that the game's string tables actually use, instead of entire CJK ranges
+	Vector<I18NLanguage> languages;
+	for (auto lang: meta.getString("stringLanguages", "").split(',')) {
+		if (!lang.trimBoth().isEmpty()) {
+			languages.push_back(I18NLanguage(lang));
+		}
+	}
+	for (auto table: meta.getString("stringTables", "").split(',')) {
+		if (!table.trimBoth().isEmpty()) {
+			const auto config = YAMLConvert::parseConfig(collector.readAdditionalFile(table));
+			for (int c: I18N::getCharacters(config.getRoot(), languages)) {
+				characterSet.insert(c);
+			}
+		}
+	}
+
 	Vector<int> characters;
 	characters.reserve(characterSet.size());
 	for (auto& c: characterSet) {
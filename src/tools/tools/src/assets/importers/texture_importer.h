@@ -8,6 +8,7 @@ namespace Halley
 	public:
 		explicit TextureImporter(bool lz4hc);
 		ImportAssetType getType() const override { return ImportAssetType::Texture; }
+		int getVersion() const override { return 1; }
 
 		void import(const ImportingAsset& asset, IAssetCollector& collector) override;
 
@@ -204,6 +204,9 @@ Vector<String> CodegenCPP::generateComponentHeader(ComponentSchema component)
 		"#include \"halley/support/exception.h\"",
 		""
 	};
+	if (component.networkDelta) {
+		contents.insert(contents.end() - 1, "#include \"halley/bytes/byte_serializer.h\"");
+	}
 
 	for (auto& includeFile: component.includeFiles) {
 		contents.push_back("#include \"" + includeFile + "\"");
@@ -241,6 +244,9 @@ Vector<String> CodegenCPP::generateComponentHeader(ComponentSchema component)
 		}
 	}
 	serializeBody += lineBreak + "return _node;";
+	if (component.trackChanges) {
+		deserializeBody += lineBreak + "++changeRevision;";
+	}
 
 	String serializeFieldBody;
 	String deserializeFieldBody;
@@ -265,6 +271,7 @@ Vector<String> CodegenCPP::generateComponentHeader(ComponentSchema component)
 				+ lineBreak + "}";
 			deserializeFieldBody += "if (_fieldName == \"" + member.name + "\") {"
 				+ lineBreak + "\tHalley::ConfigNodeHelper<decltype(" + member.name + ")>::deserialize(" + member.name + ", _context, _node);"
+				+ (component.trackChanges ? lineBreak + "\t++changeRevision;" : "")
 				+ lineBreak + "\treturn;"
 				+ lineBreak + "}";
 		}
@@ -272,10 +279,50 @@ Vector<String> CodegenCPP::generateComponentHeader(ComponentSchema component)
 		deserializeFieldBody += lineBreak + "throw Halley::Exception(\"Unknown or non-serializable field \\\"\" + Halley::String(_fieldName) + \"\\\"\", Halley::HalleyExceptions::Entity);";
 	}
 
+	// Binary network deltas, over a bitmask of the networked fields that changed
+	String deltaMaskBody = "uint64_t _mask = 0;";
+	String serializeDeltaBody = "_s << _mask;";
+	String applyDeltaBody = "uint64_t _mask = 0;" + lineBreak + "_s >> _mask;";
+	String copyDeltaBody;
+	if (component.networkDelta) {
+		size_t bit = 0;
+		for (auto& member : component.members) {
+			if (!std_ex::contains(member.serializationTypes, EntitySerialization::Type::Network) || member.type.isStatic || member.type.isConst) {
+				continue;
+			}
+			if (bit == 64) {
+				throw Exception("Component " + component.name + " has more than 64 networked fields, which networkDelta doesn't support.", HalleyExceptions::Tools);
+			}
+
+			const String bitMask = "(uint64_t(1) << " + toString(bit) + ")";
+			deltaMaskBody += lineBreak + "if (!(" + member.name + " == _previous." + member.name + ")) _mask |= " + bitMask + ";";
+			serializeDeltaBody += lineBreak + "if (_mask & " + bitMask + ") _s << " + member.name + ";";
+			applyDeltaBody += lineBreak + "if (_mask & " + bitMask + ") _s >> " + member.name + ";";
+			copyDeltaBody += String(bit == 0 ? "" : lineBreak) + "if (_mask & " + bitMask + ") " + member.name + " = _other." + member.name + ";";
+			++bit;
+		}
+		deltaMaskBody += lineBreak + "return _mask;";
+		if (component.trackChanges) {
+			applyDeltaBody += lineBreak + "if (_mask != 0) ++changeRevision;";
+		}
+	}
+
 	if (component.customImplementation) {
 		contents.push_back("template <typename T>");
 	}
 
+	// Tracked fields can only be written through their setters, so that every change bumps the revision
+	const auto trackedAccess = component.customImplementation ? MemberAccess::Protected : MemberAccess::Private;
+	auto isTracked = [&] (const ComponentFieldSchema& member)
+	{
+		return component.trackChanges && !member.serializationTypes.empty() && !member.type.isStatic && !member.type.isConst;
+	};
+	for (auto& member: component.members) {
+		if (isTracked(member)) {
+			member.access = trackedAccess;
+		}
+	}
+
 	gen
 		.setAccessLevel(MemberAccess::Public)
 		.addMember(MemberSchema(TypeSchema("int", false, true, true), "componentIndex", toString(component.id)))
@@ -340,6 +387,58 @@ Vector<String> CodegenCPP::generateComponentHeader(ComponentSchema component)
 		}, "deserializeField"), deserializeFieldBody)
 		.addBlankLine();
 
+	if (component.networkDelta) {
+		gen
+			.addMethodDefinition(MethodSchema(TypeSchema("uint64_t"), {
+				VariableSchema(TypeSchema(className + "&", true), "_previous")
+			}, "getNetworkDeltaMask", true), deltaMaskBody)
+			.addBlankLine()
+			.addMethodDefinition(MethodSchema(TypeSchema("void"), {
+				VariableSchema(TypeSchema("Halley::Serializer&"), "_s"), VariableSchema(TypeSchema("uint64_t"), "_mask")
+			}, "serializeDelta", true), serializeDeltaBody)
+			.addBlankLine()
+			.addMethodDefinition(MethodSchema(TypeSchema("void"), {
+				VariableSchema(TypeSchema("Halley::Deserializer&"), "_s")
+			}, "applyDelta"), applyDeltaBody)
+			.addBlankLine()
+			.addMethodDefinition(MethodSchema(TypeSchema("void"), {
+				VariableSchema(TypeSchema(className + "&", true), "_other"), VariableSchema(TypeSchema("uint64_t"), "_mask")
+			}, "copyDelta"), copyDeltaBody)
+			.addBlankLine();
+	}
+
+	// Change tracking, through setters for the serialized fields, and markChanged() for anything modified in place
+	if (component.trackChanges) {
+		gen
+			.addMethodDefinition(MethodSchema(TypeSchema("uint32_t"), {}, "getChangeRevision", true), "return changeRevision;")
+			.addBlankLine()
+			.addMethodDefinition(MethodSchema(TypeSchema("void"), {}, "markChanged"), "++changeRevision;")
+			.addBlankLine();
+
+		for (auto& member : component.members) {
+			if (!isTracked(member)) {
+				continue;
+			}
+
+			const String setBody = "if (!(" + member.name + " == value)) {"
+				+ lineBreak + "\t" + member.name + " = std::move(value);"
+				+ lineBreak + "\t++changeRevision;"
+				+ lineBreak + "}";
+			gen
+				.addMethodDefinition(MethodSchema(TypeSchema(member.type.name + "&", true), {}, "get" + upperFirst(member.name), true), "return " + member.name + ";")
+				.addBlankLine()
+				.addMethodDefinition(MethodSchema(TypeSchema("void"), {
+					VariableSchema(TypeSchema(member.type.name), "value")
+				}, "set" + upperFirst(member.name)), setBody)
+				.addBlankLine();
+		}
+
+		gen
+			.setAccessLevel(trackedAccess)
+			.addMember(MemberSchema(TypeSchema("uint32_t"), "changeRevision", "0"))
+			.setAccessLevel(MemberAccess::Public);
+	}
+
 	// New and delete methods
 	String newBody;
 	String newBody2;
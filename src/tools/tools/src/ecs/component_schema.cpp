@@ -100,6 +100,9 @@ ComponentSchema::ComponentSchema(YAML::Node node, bool generate)
 		customImplementation = node["customImplementation"].as<std::string>();
 	}
 
+	networkDelta = node["networkDelta"].as<bool>(false);
+	trackChanges = node["trackChanges"].as<bool>(false);
+
 	const auto deps = node["componentDependencies"];
 	if (deps.IsSequence()) {
 		for (auto n = deps.begin(); n != deps.end(); ++n) {
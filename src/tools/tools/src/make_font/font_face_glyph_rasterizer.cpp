@@ -0,0 +1,104 @@
+#include "halley/tools/make_font/font_face_glyph_rasterizer.h"
+#include "halley/tools/distance_field/distance_field_generator.h"
+#include <halley/file_formats/image.h>
+#include <halley/support/logger.h>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+using namespace Halley;
+
+FontFaceGlyphRasterizer::FontFaceGlyphRasterizer(Bytes data, float fontSize, float radius, String name)
+	: fontData(std::move(data))
+	, fontSize(fontSize)
+	, radius(radius)
+	, border(static_cast<int>(std::ceil(radius)))
+{
+	auto face = makeFace();
+
+	metrics.name = name.isEmpty() ? face->getName() : std::move(name);
+	metrics.ascender = face->getAscender();
+	metrics.height = face->getHeight();
+	metrics.sizePt = fontSize;
+	metrics.smoothRadius = radius;
+
+	for (const int c: face->getCharCodes()) {
+		charcodes.insert(c);
+	}
+
+	// Every glyph fits the bounding box of the face, plus the same padding FontGenerator uses
+	const auto ftFace = static_cast<FT_Face>(face->getFreeTypeFace());
+	const float scale = fontSize / static_cast<float>(std::max(ftFace->units_per_EM, FT_UShort(1)));
+	const auto bboxSize = Vector2f(static_cast<float>(ftFace->bbox.xMax - ftFace->bbox.xMin), static_cast<float>(ftFace->bbox.yMax - ftFace->bbox.yMin)) * scale;
+	maxGlyphSize = Vector2i(bboxSize.ceil()) + Vector2i(1, 1) * (2 * border + 2);
+
+	releaseFace(std::move(face));
+}
+
+IGlyphRasterizer::FontMetrics FontFaceGlyphRasterizer::getFontMetrics() const
+{
+	return metrics;
+}
+
+Vector2i FontFaceGlyphRasterizer::getMaxGlyphSize() const
+{
+	return maxGlyphSize;
+}
+
+bool FontFaceGlyphRasterizer::hasGlyph(int charcode) const
+{
+	return charcodes.contains(charcode);
+}
+
+std::optional<IGlyphRasterizer::Glyph> FontFaceGlyphRasterizer::rasterize(int charcode) const
+{
+	auto face = acquireFace();
+	std::optional<Glyph> result;
+
+	try {
+		const auto glyphSize = face->getGlyphSize(charcode);
+		const auto fontMetrics = face->getMetrics(charcode);
+		const float padding = std::floor(radius);
+
+		result = Glyph();
+		result->horizontalBearing = fontMetrics.bearingHorizontal + Vector2f(-padding, padding);
+		result->verticalBearing = fontMetrics.bearingVertical + Vector2f(-padding, padding);
+		result->advance = fontMetrics.advance;
+		if (glyphSize.x > 0 && glyphSize.y > 0) {
+			const auto imageSize = Vector2i::min(glyphSize + Vector2i(1, 1) * (2 * border + 1), maxGlyphSize);
+			result->image = DistanceFieldGenerator::generateMSDF(DistanceFieldGenerator::Type::MTSDF, *face, fontSize, charcode, imageSize, radius);
+		}
+	} catch (const std::exception& e) {
+		Logger::logException(e);
+		result.reset();
+	}
+
+	releaseFace(std::move(face));
+	return result;
+}
+
+std::unique_ptr<FontFace> FontFaceGlyphRasterizer::makeFace() const
+{
+	auto face = std::make_unique<FontFace>(gsl::as_bytes(gsl::span<const Byte>(fontData)));
+	face->setSize(fontSize);
+	return face;
+}
+
+std::unique_ptr<FontFace> FontFaceGlyphRasterizer::acquireFace() const
+{
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		if (!freeFaces.empty()) {
+			auto face = std::move(freeFaces.back());
+			freeFaces.pop_back();
+			return face;
+		}
+	}
+	return makeFace();
+}
+
+void FontFaceGlyphRasterizer::releaseFace(std::unique_ptr<FontFace> face) const
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	freeFaces.push_back(std::move(face));
+}
@@ -23,6 +23,7 @@ void AssetPackInspector::parse(const Bytes& bytes)
 	auto headerSpan = gsl::as_writable_bytes(gsl::span<AssetPackHeader>(&header, 1));
 	s >> headerSpan;
 	dataStartPos = header.dataStartPos;
+	s.skipBytes(size_t(header.assetDbStartPos) - sizeof(AssetPackHeader));
 
 	Bytes tableData(header.dataStartPos - header.assetDbStartPos);
 	auto tableSpan = gsl::as_writable_bytes(gsl::span<Byte>(tableData.data(), tableData.size()));
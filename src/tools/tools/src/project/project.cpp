@@ -1,5 +1,6 @@
 #include <utility>
 #include "halley/tools/assets/import_assets_database.h"
+#include "halley/tools/assets/import_cache.h"
 #include "halley/tools/project/project.h"
 
 #include "halley/api/halley_api.h"
@@ -49,6 +50,16 @@ Project::Project(Path projectRootPath, Path halleyRootPath, Vector<String> disab
 	importAssetsDatabase = std::make_unique<ImportAssetsDatabase>(getUnpackedAssetsPath(), getUnpackedAssetsPath() / "import.db", getUnpackedAssetsPath() / "assets.db", platforms, currentAssetVersion);
 	codegenDatabase = std::make_unique<ImportAssetsDatabase>(getGenPath(), getGenPath() / "import.db", getGenPath() / "assets.db", Vector<String>{ "" }, currentCodegenVersion + currentAssetVersion);
 	sharedCodegenDatabase = std::make_unique<ImportAssetsDatabase>(getSharedGenPath(), getSharedGenPath() / "import.db", getSharedGenPath() / "assets.db", Vector<String>{ "" }, currentCodegenVersion + currentAssetVersion);
+
+	// HALLEY_IMPORT_CACHE overrides the project setting, so each machine can point at its own (or a shared) cache
+	String importCachePath = properties->getImportCachePath();
+	if (const char* envCachePath = getenv("HALLEY_IMPORT_CACHE")) {
+		importCachePath = envCachePath;
+	}
+	if (!importCachePath.isEmpty()) {
+		const auto cachePath = Path(importCachePath);
+		importCache = std::make_unique<ImportCache>(cachePath.isAbsolute() ? cachePath : rootPath / cachePath, currentAssetVersion);
+	}
 }
 
 Project::~Project()
@@ -204,6 +215,11 @@ ImportAssetsDatabase& Project::getImportAssetsDatabase() const
 	return *importAssetsDatabase;
 }
 
+ImportCache* Project::getImportCache() const
+{
+	return importCache.get();
+}
+
 ImportAssetsDatabase& Project::getCodegenDatabase() const
 {
 	return *codegenDatabase;
@@ -83,6 +83,17 @@ float ProjectProperties::getDefaultZoom() const
 	return defaultZoom;
 }
 
+const String& ProjectProperties::getImportCachePath() const
+{
+	return importCachePath;
+}
+
+void ProjectProperties::setImportCachePath(String path)
+{
+	importCachePath = std::move(path);
+	dirty = true;
+}
+
 const I18NLanguage& ProjectProperties::getOriginalLanguage() const
 {
 	return originalLanguage;
@@ -101,6 +112,7 @@ void ProjectProperties::loadDefaults()
 	binName = "";
 	importByExtension = false;
 	defaultZoom = 1.0f;
+	importCachePath = "";
 	platforms = {"pc"};
 	originalLanguage = I18NLanguage("en");
 	languages.clear();
@@ -134,6 +146,9 @@ void ProjectProperties::load()
 		if (node.hasKey("defaultZoom")) {
 			defaultZoom = node["defaultZoom"].asFloat();
 		}
+		if (node.hasKey("importCachePath")) {
+			importCachePath = node["importCachePath"].asString();
+		}
 		if (node.hasKey("platforms")) {
 			platforms = node["platforms"].asVector<String>();
 		}
@@ -156,6 +171,9 @@ void ProjectProperties::save()
 	node["binName"] = binName;
 	node["importByExtension"] = importByExtension;
 	node["defaultZoom"] = defaultZoom;
+	if (!importCachePath.isEmpty()) {
+		node["importCachePath"] = importCachePath;
+	}
 	node["platforms"] = platforms;
 	node["originalLanguage"] = originalLanguage;
 	node["languages"] = languages;